@@ -88,10 +88,29 @@ extern uint32_t SystemCoreClock;
 #define configUSE_DAEMON_TASK_STARTUP_HOOK      0
 
 /* Run time and task stats gathering related definitions. */
-#define configGENERATE_RUN_TIME_STATS           0
+#define configGENERATE_RUN_TIME_STATS           1
 #define configUSE_TRACE_FACILITY                1
 #define configUSE_STATS_FORMATTING_FUNCTIONS    0
 
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+    #ifndef RUN_TIME_STATS_PROTOTYPES_ADDED
+    #define RUN_TIME_STATS_PROTOTYPES_ADDED
+        /* Skip C-only declarations when assembling */
+        #ifndef __IASMARM__
+            extern void setup_run_time_stats_timer(void);
+            #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() setup_run_time_stats_timer()
+            extern uint32_t get_run_time_counter_value(void);
+            #define portGET_RUN_TIME_COUNTER_VALUE() get_run_time_counter_value()
+        #endif /* __IASMARM__ */
+    #endif /* RUN_TIME_STATS_PROTOTYPES_ADDED */
+#endif /* configGENERATE_RUN_TIME_STATS */
+
+/* Per-task context switch counting for shared/source/cpu_load.c */
+#ifndef __IASMARM__
+    extern void cpu_load_task_switched_in(uint32_t task_number);
+    #define traceTASK_SWITCHED_IN() cpu_load_task_switched_in(pxCurrentTCB->uxTCBNumber)
+#endif /* __IASMARM__ */
+
 /* Co-routine related definitions. */
 #define configUSE_CO_ROUTINES                   0
 #define configMAX_CO_ROUTINE_PRIORITIES         1
@@ -10,6 +10,9 @@
 
 #include "cm33_ipc_pipe.h"
 #include "../../shared/include/ipc_communication.h"
+#include "../../shared/include/mem_stats.h"
+#include "../../shared/include/cpu_load.h"
+#include "../../shared/include/lat_trace.h"
 #include "cy_ipc_pipe.h"
 #include "cy_syslib.h"
 #include <string.h>
@@ -45,6 +48,9 @@ static uint32_t tx_count = 0;
 static uint32_t rx_count = 0;
 static uint32_t error_count = 0;
 
+/* Samples in the last latency report printed */
+static uint32_t lat_report_samples = 0;
+
 /*******************************************************************************
  * IPC Callback (called from ISR context)
  ******************************************************************************/
@@ -55,6 +61,7 @@ static void cm33_ipc_callback(uint32_t *msgData)
 
     /* Copy to buffer (ISR-safe) */
     memcpy(&rx_buffer, msg, sizeof(ipc_msg_t));
+    lat_trace_stamp_rx(&rx_buffer);     /* Clock sync receive time */
     msg_received = true;
     rx_count++;
 }
@@ -74,7 +81,10 @@ cy_en_ipc_pipe_status_t cm33_ipc_init(void)
     /* Initialize IPC Pipe infrastructure (Semaphores + Config + Init) */
     cm33_ipc_communication_setup();
 
-    /* Delay for IPC hardware stabilization (matches reference project) */
+    /* Delay for IPC hardware stabilization (matches reference project).
+     * This runs before CM55 is enabled, so there is no CM55 readiness to
+     * wait on, and the endpoint is never busy yet - polling it would
+     * return at once without covering what this delay is for. */
     Cy_SysLib_Delay(50U);
 
     /* Register callback for incoming messages */
@@ -228,6 +238,62 @@ void cm33_ipc_process(void)
                 }
                 break;
 
+            case IPC_CMD_MEM_REQ:
+                /* Dump this core's memory figures to the requester */
+                {
+                    ipc_msg_t report;
+                    IPC_MSG_INIT(&report, IPC_CMD_MEM_REPORT);
+                    report.value = msg.value;
+                    mem_stats_fill_report((ipc_mem_report_t *)report.data);
+                    cm33_ipc_send_retry(&report, 0);
+                }
+                break;
+
+            case IPC_CMD_CPU_REQ:
+                /* Send this core's per-task CPU load */
+                {
+                    ipc_msg_t report;
+                    IPC_MSG_INIT(&report, IPC_CMD_CPU_REPORT);
+                    cpu_load_fill_report((ipc_cpu_report_t *)report.data);
+                    cm33_ipc_send_retry(&report, 0);
+                }
+                break;
+
+            case IPC_CMD_CPU_REPORT:
+                /* Keep the other core's load for the overlay (polled - not printed) */
+                cpu_load_set_remote((const ipc_cpu_report_t *)msg.data);
+                break;
+
+            case IPC_CMD_MEM_REPORT:
+                /* Keep the other core's figures for the memory panel
+                 * (polled - printed only for a dump request) */
+                mem_stats_set_remote((const ipc_mem_report_t *)msg.data);
+                if (msg.value == IPC_MEM_PRINT) {
+                    mem_stats_print_report("CM55", (const ipc_mem_report_t *)msg.data);
+                }
+                break;
+
+            case IPC_CMD_LAT_SYNC:
+                /* Latency tracer clock sync - reply at once, no retry delay */
+                {
+                    ipc_msg_t reply;
+                    lat_trace_sync_reply(&msg, &reply);
+                    cm33_ipc_send(&reply);
+                }
+                break;
+
+            case IPC_CMD_LAT_REPORT:
+                /* Print only when samples were traced since the last one */
+                {
+                    const ipc_lat_report_t *report = (const ipc_lat_report_t *)msg.data;
+
+                    if (report->samples != lat_report_samples) {
+                        lat_report_samples = report->samples;
+                        lat_trace_print_report("CM55", report);
+                    }
+                }
+                break;
+
             case IPC_CMD_LOG:
             case IPC_CMD_LOG_ERROR:
             case IPC_CMD_LOG_WARN:
@@ -263,6 +329,7 @@ void cm33_ipc_process(void)
             case IPC_CMD_BT_DISCONNECT:
             case IPC_CMD_BT_STATUS:
             case IPC_CMD_BT_GET_HARDWARE:
+            case IPC_CMD_BT_SCAN_FILTER:
                 cm33_ipc_send_cmd(IPC_CMD_BT_ERROR, BT_ERR_NOT_READY);
                 break;
 
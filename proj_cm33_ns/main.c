@@ -41,6 +41,9 @@
 /* CAPSENSE Module (read via I2C, send via IPC) */
 #include "source/capsense_task.h"
 
+/* BLE sensor streaming (samples are dropped unless a phone subscribed) */
+#include "source/bt_sensor_gatt.h"
+
 /*******************************************************************************
  * IPC Communication (CM33-NS <-> CM55)
  ******************************************************************************/
@@ -50,6 +53,14 @@
 #include "ipc/cm33_ipc_pipe.h"
 #endif
 
+/* Boot-phase profiling and CPU load monitor */
+#include "boot_profile.h"
+#include "cpu_load.h"
+#include "lat_trace.h"
+#include "static_mem.h"
+#include "periodic.h"
+#include "uart_buf.h"
+
 
 /*******************************************************************************
 * Macros
@@ -59,6 +70,7 @@
                                         CYBSP_MCUBOOT_HEADER_SIZE)
 
 #define IMU_POLL_INTERVAL_MS        (100U)
+#define IMU_STREAM_INTERVAL_MS      (10U)   /* BMI270 accel ODR (100 Hz default config) */
 
 /* Task stack sizes and priorities */
 #define IMU_TASK_STACK_SIZE         (512U)
@@ -66,6 +78,7 @@
 
 #define IPC_TASK_STACK_SIZE         (512U)
 #define IPC_TASK_PRIORITY           (3U)
+#define IPC_POLL_INTERVAL_MS        (10U)
 
 /*******************************************************************************
 * BMI270 Configuration
@@ -94,16 +107,45 @@ static bool first_read = true;
 #define ACCEL_MAX_VALUE     (20.0f)
 #define ACCEL_MAX_DELTA     (15.0f)
 
+/* Task stacks and TCBs (static, no heap) */
+STATIC_TASK_DEFINE(imu, IMU_TASK_STACK_SIZE);
+STATIC_TASK_DEFINE(ipc, IPC_TASK_STACK_SIZE);
+STATIC_TASK_DEFINE(wifi, WIFI_TASK_STACK_SIZE);
+
 
 /*******************************************************************************
 * Function Prototypes
 *******************************************************************************/
 static bool imu_init(void);
 static void imu_read_and_update(void);
+static void adc_stream_sample(void);
 static void imu_task(void *pvParameters);
 static void ipc_processing_task(void *pvParameters);
 
 
+/*******************************************************************************
+* Run-Time Stats Timer (FreeRTOS configGENERATE_RUN_TIME_STATS)
+*******************************************************************************/
+/* TCPWM 0 group 0 counter 2, free running on the clock of CM55's run-time
+ * timer. Unlike the DWT cycle counter it keeps counting while CM33 is in
+ * tickless CPU Sleep, so idle time is counted. */
+void setup_run_time_stats_timer(void)
+{
+    if (CY_TCPWM_SUCCESS != Cy_TCPWM_Counter_Init(CYBSP_CM33_RUN_TIME_TIMER_HW,
+                                                  CYBSP_CM33_RUN_TIME_TIMER_NUM,
+                                                  &CYBSP_CM33_RUN_TIME_TIMER_config)) {
+        CY_ASSERT(0);
+    }
+    Cy_TCPWM_Counter_Enable(CYBSP_CM33_RUN_TIME_TIMER_HW, CYBSP_CM33_RUN_TIME_TIMER_NUM);
+    Cy_TCPWM_TriggerStart_Single(CYBSP_CM33_RUN_TIME_TIMER_HW, CYBSP_CM33_RUN_TIME_TIMER_NUM);
+}
+
+uint32_t get_run_time_counter_value(void)
+{
+    return Cy_TCPWM_Counter_GetCounter(CYBSP_CM33_RUN_TIME_TIMER_HW,
+                                       CYBSP_CM33_RUN_TIME_TIMER_NUM);
+}
+
 /*******************************************************************************
 * IMU Initialization
 *******************************************************************************/
@@ -199,12 +241,24 @@ static void imu_read_and_update(void)
     if (!bmi270_initialized) return;
 
     cy_rslt_t result = mtb_bmi270_read(&bmi270_dev, &bmi270_data);
+    uint32_t read_us = lat_trace_now_us();
 
     if (CY_RSLT_SUCCESS != result) {
         imu_shared_error();
         return;
     }
 
+    /* Raw sample for the BLE sensor service */
+    if (bt_sensor_active(BT_SENSOR_IMU)) {
+        bt_sensor_imu_t raw = {
+            { bmi270_data.sensor_data.acc.x, bmi270_data.sensor_data.acc.y,
+              bmi270_data.sensor_data.acc.z },
+            { bmi270_data.sensor_data.gyr.x, bmi270_data.sensor_data.gyr.y,
+              bmi270_data.sensor_data.gyr.z }
+        };
+        bt_sensor_push(BT_SENSOR_IMU, read_us, &raw);
+    }
+
     /* Convert to physical units */
     float ax = lsb_to_mps2(bmi270_data.sensor_data.acc.x, ACC_RANGE_2G,
                            bmi270_dev.sensor.resolution);
@@ -239,12 +293,28 @@ static void imu_read_and_update(void)
         first_read = false;
     }
 
-    /* Update shared memory (use FreeRTOS tick as timestamp) */
+    /* Update shared memory (use FreeRTOS tick as timestamp); the trace
+     * stamps let CM55 time the sample to the screen */
+    imu_shared_set_trace(read_us, lat_trace_now_us());
     imu_shared_update(ax, ay, az, gx, gy, gz,
                       (uint32_t)xTaskGetTickCount());
 }
 
 
+/*******************************************************************************
+* Potentiometer sample for the BLE sensor service
+*******************************************************************************/
+static void adc_stream_sample(void)
+{
+    if (!bt_sensor_active(BT_SENSOR_ADC)) return;
+
+    bt_sensor_adc_t adc = {
+        (uint16_t)Cy_AutAnalog_SAR_ReadResult(0U, CY_AUTANALOG_SAR_INPUT_GPIO, 0U)
+    };
+    bt_sensor_push(BT_SENSOR_ADC, lat_trace_now_us(), &adc);
+}
+
+
 /*******************************************************************************
 * IMU Task - Periodic IMU reading via FreeRTOS
 *******************************************************************************/
@@ -254,6 +324,7 @@ static void imu_task(void *pvParameters)
 
     /* Initialize IMU (I2C + BMI270) inside task context */
     bmi270_initialized = imu_init();
+    boot_profile_mark("imu_init");
 
     if (bmi270_initialized) {
         printf("[CM33] IMU initialized (BMI270)\r\n");
@@ -266,11 +337,37 @@ static void imu_task(void *pvParameters)
         printf("[CM33] IMU init failed - sensor data unavailable\r\n");
     }
 
+    boot_profile_report("CM33");
+    static_mem_seal();
+    static_mem_print("CM33");
+    periodic_print_previous("CM33");
+
+    /* Boot reports are out; from here a log burst must not stall the loops */
+    uart_buf_set_policy(UART_BUF_DROP);
+
+    /* IMU read + CAPSENSE poll, released every IMU_POLL_INTERVAL_MS.
+     * While a phone streams IMU or ADC samples the IMU is read at its
+     * ODR instead, so every sample it produces goes out; CAPSENSE keeps
+     * its own rate */
+    static periodic_task_t imu_timing;
+    periodic_init(&imu_timing, "IMU", IMU_POLL_INTERVAL_MS, 0);
+    uint32_t capsense_due_ms = 0;
+
     for (;;)
     {
+        bool streaming = bt_sensor_active(BT_SENSOR_IMU) || bt_sensor_active(BT_SENSOR_ADC);
+        uint32_t period_ms = streaming ? IMU_STREAM_INTERVAL_MS : IMU_POLL_INTERVAL_MS;
+
+        periodic_set_period(&imu_timing, period_ms);
+        periodic_wait(&imu_timing);
         imu_read_and_update();
-        capsense_module_poll();
-        vTaskDelay(pdMS_TO_TICKS(IMU_POLL_INTERVAL_MS));
+        adc_stream_sample();
+
+        capsense_due_ms += period_ms;
+        if (capsense_due_ms >= IMU_POLL_INTERVAL_MS) {
+            capsense_due_ms = 0;
+            capsense_module_poll();
+        }
     }
 }
 
@@ -284,12 +381,18 @@ static void ipc_processing_task(void *pvParameters)
 
     printf("[CM33] IPC processing task started\r\n");
 
+    static periodic_task_t ipc_timing;
+    periodic_init(&ipc_timing, "IPC", IPC_POLL_INTERVAL_MS, 0);
+
     for (;;)
     {
+        periodic_wait(&ipc_timing);
 #if IPC_ENABLED
         cm33_ipc_process();
 #endif
-        vTaskDelay(pdMS_TO_TICKS(10));  /* 10ms polling interval */
+        /* The latency trace us clock must be read once per DWT wrap;
+         * the IMU loop does not run without a sensor */
+        (void)lat_trace_now_us();
     }
 }
 
@@ -302,12 +405,14 @@ void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName)
 {
     (void)xTask;
     printf("[CM33] FATAL: Stack overflow in task '%s'\r\n", pcTaskName);
+    uart_buf_flush();
     CY_ASSERT(0);
 }
 
 void vApplicationMallocFailedHook(void)
 {
     printf("[CM33] FATAL: Malloc failed\r\n");
+    uart_buf_flush();
     CY_ASSERT(0);
 }
 
@@ -319,6 +424,8 @@ int main(void)
 {
     cy_rslt_t result = CY_RSLT_SUCCESS;
 
+    boot_profile_start();
+
     /* Initialize board */
     result = cybsp_init();
     if (CY_RSLT_SUCCESS != result) {
@@ -348,6 +455,7 @@ int main(void)
         Cy_AutAnalog_StartAutonomousControl();
         printf("[CM33] ADC initialized (autonomous mode)\r\n");
     }
+    boot_profile_mark("adc_init");
 
     /* Enable interrupts BEFORE IPC init (reference project pattern) */
     __enable_irq();
@@ -356,34 +464,34 @@ int main(void)
     /* Initialize IPC Pipe infrastructure BEFORE enabling CM55 */
     cm33_ipc_init();
     printf("[CM33] IPC Pipe initialized\r\n");
+    boot_profile_mark("ipc_init");
 #endif
 
     /* Enable CM55 (must be AFTER IPC init to avoid race condition) */
     Cy_SysEnableCM55(MXCM55, CM55_APP_BOOT_ADDR, CM55_BOOT_WAIT_TIME_USEC);
     printf("[CM33] CM55 enabled at 0x%08X\r\n", (unsigned int)CM55_APP_BOOT_ADDR);
+    boot_profile_mark("cm55_enabled");
 
     /***************************************************************************
      * Create FreeRTOS Tasks
      ***************************************************************************/
 
     /* IMU Task: Periodic sensor reading (I2C + BMI270) */
-    xTaskCreate(imu_task, "IMU Task",
-                IMU_TASK_STACK_SIZE, NULL,
-                IMU_TASK_PRIORITY, NULL);
+    STATIC_TASK_CREATE(imu, imu_task, "IMU Task", NULL, IMU_TASK_PRIORITY);
 
     /* IPC Task: Process incoming IPC messages from CM55 */
-    xTaskCreate(ipc_processing_task, "IPC Task",
-                IPC_TASK_STACK_SIZE, NULL,
-                IPC_TASK_PRIORITY, NULL);
+    STATIC_TASK_CREATE(ipc, ipc_processing_task, "IPC Task", NULL, IPC_TASK_PRIORITY);
 
     /* WiFi Task: WiFi scanning and connection management */
-    xTaskCreate(wifi_task, "WiFi Task",
-                WIFI_TASK_STACK_SIZE, NULL,
-                WIFI_TASK_PRIORITY, NULL);
+    STATIC_TASK_CREATE(wifi, wifi_task, "WiFi Task", NULL, WIFI_TASK_PRIORITY);
+
+    /* Per-task CPU load sampling (reported to CM55 on IPC_CMD_CPU_REQ) */
+    cpu_load_init();
 
         printf("[CM33] Starting FreeRTOS scheduler...\r\n\r\n");
 
     /* Start FreeRTOS scheduler - does not return */
+    boot_profile_mark("scheduler");
     vTaskStartScheduler();
 
     /* Should never reach here */
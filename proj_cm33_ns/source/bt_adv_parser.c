@@ -0,0 +1,225 @@
+/*******************************************************************************
+ * File: bt_adv_parser.c
+ * Description: BLE advertising data parser for CM33-NS
+ *
+ * An AD structure is [length][type][length - 1 bytes of data]; a length
+ * of zero ends the data (the stack pads the buffer with zeros).
+ *
+ * Part of BiiL Course: Embedded C for IoT - Week 7
+ ******************************************************************************/
+
+#include "bt_adv_parser.h"
+
+#include <string.h>
+
+/*******************************************************************************
+ * UUID Helpers
+ ******************************************************************************/
+
+/* Bluetooth base UUID 00000000-0000-1000-8000-00805F9B34FB, little endian;
+ * a 16/32-bit UUID goes in bytes 12-15 */
+static const uint8_t base_uuid[BT_UUID_MAX_LEN] =
+{
+    0xFB, 0x34, 0x9B, 0x5F, 0x80, 0x00, 0x00, 0x80,
+    0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+static void uuid_to_128(const uint8_t *uuid, uint8_t uuid_len, uint8_t *out)
+{
+    if (uuid_len == BT_UUID_MAX_LEN)
+    {
+        memcpy(out, uuid, BT_UUID_MAX_LEN);
+        return;
+    }
+    memcpy(out, base_uuid, BT_UUID_MAX_LEN);
+    memcpy(&out[12], uuid, uuid_len);
+}
+
+static bool list_has_uuid(const bt_adv_info_t *info, const bt_adv_ref_t *list,
+                          uint8_t size, const uint8_t *uuid128)
+{
+    uint8_t full[BT_UUID_MAX_LEN];
+    const uint8_t *p = &info->data[list->offset];
+
+    for (uint32_t i = 0; (i + size) <= list->len; i += size)
+    {
+        uuid_to_128(&p[i], size, full);
+        if (memcmp(full, uuid128, BT_UUID_MAX_LEN) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*******************************************************************************
+ * Public Functions
+ ******************************************************************************/
+bool bt_adv_parse(const uint8_t *data, uint32_t max_len, bt_adv_info_t *info)
+{
+    memset(info, 0, sizeof(bt_adv_info_t));
+    info->data = data;
+
+    if (data == NULL)
+    {
+        return true;
+    }
+    if (max_len > BT_ADV_MAX_LEN)
+    {
+        max_len = BT_ADV_MAX_LEN;
+    }
+
+    uint32_t pos = 0;
+    while ((pos < max_len) && (data[pos] != 0U))
+    {
+        uint32_t len = data[pos];
+        if ((pos + 1U + len) > max_len)
+        {
+            return false;       /* Truncated structure */
+        }
+
+        uint8_t type = data[pos + 1U];
+        bt_adv_ref_t ref = { (uint8_t)(pos + 2U), (uint8_t)(len - 1U) };
+        const uint8_t *p = &data[pos + 2U];
+
+        switch (type)
+        {
+            case BT_AD_TYPE_FLAGS:
+                if (ref.len >= 1U)
+                {
+                    info->flags = p[0];
+                    info->present |= BT_ADV_HAS_FLAGS;
+                }
+                break;
+
+            case BT_AD_TYPE_NAME_SHORT:
+            case BT_AD_TYPE_NAME_COMPLETE:
+                if (!info->name_complete)
+                {
+                    info->name = ref;
+                    info->name_complete = (type == BT_AD_TYPE_NAME_COMPLETE);
+                    info->present |= BT_ADV_HAS_NAME;
+                }
+                break;
+
+            case BT_AD_TYPE_UUID16_INCOMPLETE:
+            case BT_AD_TYPE_UUID16_COMPLETE:
+                if ((info->present & BT_ADV_HAS_UUID16) == 0U)
+                {
+                    info->uuid16 = ref;
+                    info->present |= BT_ADV_HAS_UUID16;
+                }
+                break;
+
+            case BT_AD_TYPE_UUID32_INCOMPLETE:
+            case BT_AD_TYPE_UUID32_COMPLETE:
+                if ((info->present & BT_ADV_HAS_UUID32) == 0U)
+                {
+                    info->uuid32 = ref;
+                    info->present |= BT_ADV_HAS_UUID32;
+                }
+                break;
+
+            case BT_AD_TYPE_UUID128_INCOMPLETE:
+            case BT_AD_TYPE_UUID128_COMPLETE:
+                if ((info->present & BT_ADV_HAS_UUID128) == 0U)
+                {
+                    info->uuid128 = ref;
+                    info->present |= BT_ADV_HAS_UUID128;
+                }
+                break;
+
+            case BT_AD_TYPE_TX_POWER:
+                if (ref.len >= 1U)
+                {
+                    info->tx_power = (int8_t)p[0];
+                    info->present |= BT_ADV_HAS_TX_POWER;
+                }
+                break;
+
+            case BT_AD_TYPE_APPEARANCE:
+                if (ref.len >= 2U)
+                {
+                    info->appearance = (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+                    info->present |= BT_ADV_HAS_APPEARANCE;
+                }
+                break;
+
+            case BT_AD_TYPE_MANUFACTURER:
+                if ((ref.len >= 2U) && ((info->present & BT_ADV_HAS_MANUFACTURER) == 0U))
+                {
+                    info->company_id = (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+                    info->manufacturer.offset = (uint8_t)(ref.offset + 2U);
+                    info->manufacturer.len = (uint8_t)(ref.len - 2U);
+                    info->present |= BT_ADV_HAS_MANUFACTURER;
+                }
+                break;
+
+            default:
+                break;
+        }
+
+        pos += 1U + len;
+        info->length = (uint8_t)pos;
+    }
+    return true;
+}
+
+bool bt_adv_has_uuid(const bt_adv_info_t *info, const uint8_t *uuid, uint8_t uuid_len)
+{
+    uint8_t want[BT_UUID_MAX_LEN];
+
+    if ((uuid_len != 2U) && (uuid_len != 4U) && (uuid_len != BT_UUID_MAX_LEN))
+    {
+        return false;
+    }
+    uuid_to_128(uuid, uuid_len, want);
+
+    return (((info->present & BT_ADV_HAS_UUID16) != 0U) &&
+            list_has_uuid(info, &info->uuid16, 2U, want)) ||
+           (((info->present & BT_ADV_HAS_UUID32) != 0U) &&
+            list_has_uuid(info, &info->uuid32, 4U, want)) ||
+           (((info->present & BT_ADV_HAS_UUID128) != 0U) &&
+            list_has_uuid(info, &info->uuid128, BT_UUID_MAX_LEN, want));
+}
+
+bool bt_adv_filter_match(const ipc_bt_scan_filter_t *filter, const bt_adv_info_t *info)
+{
+    if (((filter->match & BT_SCAN_FILTER_NAMED) != 0U) &&
+        (((info->present & BT_ADV_HAS_NAME) == 0U) || (info->name.len == 0U)))
+    {
+        return false;
+    }
+    if (((filter->match & BT_SCAN_FILTER_COMPANY) != 0U) &&
+        (((info->present & BT_ADV_HAS_MANUFACTURER) == 0U) ||
+         (info->company_id != filter->company_id)))
+    {
+        return false;
+    }
+    if (((filter->match & BT_SCAN_FILTER_UUID) != 0U) &&
+        !bt_adv_has_uuid(info, filter->uuid, filter->uuid_len))
+    {
+        return false;
+    }
+    return true;
+}
+
+uint32_t bt_adv_copy_name(const bt_adv_info_t *info, char *out, uint32_t size)
+{
+    if ((out == NULL) || (size == 0U))
+    {
+        return 0;
+    }
+
+    uint32_t len = ((info->present & BT_ADV_HAS_NAME) != 0U) ? info->name.len : 0U;
+    if (len > (size - 1U))
+    {
+        len = size - 1U;
+    }
+    if (len > 0U)
+    {
+        memcpy(out, &info->data[info->name.offset], len);
+    }
+    out[len] = '\0';
+    return len;
+}
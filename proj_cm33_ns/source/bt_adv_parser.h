@@ -0,0 +1,139 @@
+/*******************************************************************************
+ * File: bt_adv_parser.h
+ * Description: BLE advertising data parser for CM33-NS - Header
+ *
+ * Walks the AD structures of an advertisement (or scan response) once and
+ * records what the scanner uses: flags, local name, 16/32/128-bit service
+ * UUID lists, manufacturer data, TX power and appearance. Nothing is
+ * copied: variable-length fields are kept as offset/length pairs into the
+ * caller's buffer, which has to stay valid while the result is used (in
+ * the scan callback, for the duration of the call).
+ *
+ * bt_adv_filter_match() checks a parsed advertisement against the scan
+ * filter from CM55, so the scan callback can drop a device before it
+ * reaches the device table.
+ *
+ * Part of BiiL Course: Embedded C for IoT - Week 7
+ ******************************************************************************/
+
+#ifndef BT_ADV_PARSER_H
+#define BT_ADV_PARSER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../../shared/bt_shared.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define BT_ADV_MAX_LEN                  (62U)   /* Advertisement + scan response */
+
+/* AD types (Bluetooth Assigned Numbers, Common Data Types) */
+#define BT_AD_TYPE_FLAGS                (0x01U)
+#define BT_AD_TYPE_UUID16_INCOMPLETE    (0x02U)
+#define BT_AD_TYPE_UUID16_COMPLETE      (0x03U)
+#define BT_AD_TYPE_UUID32_INCOMPLETE    (0x04U)
+#define BT_AD_TYPE_UUID32_COMPLETE      (0x05U)
+#define BT_AD_TYPE_UUID128_INCOMPLETE   (0x06U)
+#define BT_AD_TYPE_UUID128_COMPLETE     (0x07U)
+#define BT_AD_TYPE_NAME_SHORT           (0x08U)
+#define BT_AD_TYPE_NAME_COMPLETE        (0x09U)
+#define BT_AD_TYPE_TX_POWER             (0x0AU)
+#define BT_AD_TYPE_APPEARANCE           (0x19U)
+#define BT_AD_TYPE_MANUFACTURER         (0xFFU)
+
+/* AD flags bits */
+#define BT_AD_FLAG_LE_LIMITED           (0x01U)
+#define BT_AD_FLAG_LE_GENERAL           (0x02U)
+#define BT_AD_FLAG_NO_BREDR             (0x04U)
+#define BT_AD_FLAG_DUAL_MODE            (0x18U) /* LE + BR/EDR, controller or host */
+
+/* bt_adv_info_t.present bits */
+#define BT_ADV_HAS_FLAGS                (0x0001U)
+#define BT_ADV_HAS_NAME                 (0x0002U)
+#define BT_ADV_HAS_UUID16               (0x0004U)
+#define BT_ADV_HAS_UUID32               (0x0008U)
+#define BT_ADV_HAS_UUID128              (0x0010U)
+#define BT_ADV_HAS_MANUFACTURER         (0x0020U)
+#define BT_ADV_HAS_TX_POWER             (0x0040U)
+#define BT_ADV_HAS_APPEARANCE           (0x0080U)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+
+/**
+ * @brief Part of the advertisement buffer
+ */
+typedef struct
+{
+    uint8_t offset;             /* From bt_adv_info_t.data */
+    uint8_t len;
+} bt_adv_ref_t;
+
+/**
+ * @brief One parsed advertisement
+ *
+ * Only the first list of each UUID size and the first manufacturer data
+ * are kept; a complete name replaces a shortened one.
+ */
+typedef struct
+{
+    const uint8_t *data;        /* The parsed buffer */
+    uint16_t     present;       /* BT_ADV_HAS_* */
+    uint8_t      length;        /* Bytes of well-formed AD structures */
+    uint8_t      flags;         /* BT_AD_FLAG_* */
+    int8_t       tx_power;      /* dBm */
+    bool         name_complete;
+    uint16_t     appearance;
+    uint16_t     company_id;    /* Manufacturer data, Bluetooth SIG company ID */
+    bt_adv_ref_t name;          /* UTF-8, not terminated */
+    bt_adv_ref_t uuid16;        /* Little endian, 2 bytes each */
+    bt_adv_ref_t uuid32;        /* 4 bytes each */
+    bt_adv_ref_t uuid128;       /* 16 bytes each */
+    bt_adv_ref_t manufacturer;  /* Payload after the company ID */
+} bt_adv_info_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Parse advertising data in one pass
+ *
+ * Stops at a zero-length structure (end of data) or at max_len.
+ *
+ * @param data     AD structures
+ * @param max_len  Buffer size (at most BT_ADV_MAX_LEN is read)
+ * @param info     Out
+ * @return false if a structure ran past the end (fields before it are kept)
+ */
+bool bt_adv_parse(const uint8_t *data, uint32_t max_len, bt_adv_info_t *info);
+
+/**
+ * @brief Check for a service UUID in any of the UUID lists
+ *
+ * UUIDs are compared as 128-bit values, so a 16-bit UUID also matches its
+ * form on the Bluetooth base UUID in a 128-bit list, and the other way.
+ *
+ * @param uuid      Little endian, as sent over the air
+ * @param uuid_len  2, 4 or 16
+ */
+bool bt_adv_has_uuid(const bt_adv_info_t *info, const uint8_t *uuid, uint8_t uuid_len);
+
+/**
+ * @brief Check an advertisement against a scan filter
+ *
+ * Tests the UUID, company and name rules; the RSSI rule is left to the
+ * caller, to be checked before parsing.
+ */
+bool bt_adv_filter_match(const ipc_bt_scan_filter_t *filter, const bt_adv_info_t *info);
+
+/**
+ * @brief Copy the local name as a C string
+ *
+ * @return Characters copied (0 if there is no name)
+ */
+uint32_t bt_adv_copy_name(const bt_adv_info_t *info, char *out, uint32_t size);
+
+#endif /* BT_ADV_PARSER_H */
@@ -0,0 +1,284 @@
+/*******************************************************************************
+ * File: bt_scan_table.c
+ * Description: BLE scan device table for CM33-NS
+ *
+ * Devices live in a fixed pool. The hash table is an array of pool
+ * indexes (+1, 0 = empty) with linear probing, twice the pool size so it
+ * never runs more than half full. An evicted device is taken out with
+ * backward-shift deletion, which keeps every probe sequence unbroken
+ * without tombstones.
+ *
+ * The pool is also a doubly linked list in order of last advertisement;
+ * an update moves the device to the head, eviction takes the tail.
+ *
+ * Part of BiiL Course: Embedded C for IoT - Week 7
+ ******************************************************************************/
+
+#include "bt_scan_table.h"
+
+#include <string.h>
+
+#if ((BT_SCAN_TABLE_SIZE & (BT_SCAN_TABLE_SIZE - 1U)) != 0U) || (BT_SCAN_TABLE_SIZE > 128U)
+#error "BT_SCAN_TABLE_SIZE must be a power of 2, at most 128"
+#endif
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+#define TABLE_NONE          (0xFFU)
+#define SLOT_EMPTY          (0U)
+#define SLOT_MASK           (BT_SCAN_TABLE_SLOTS - 1U)
+
+typedef struct
+{
+    ipc_bt_device_t dev;                /* dev.rssi = rounded rssi_avg */
+    int16_t         rssi_avg;           /* dBm x 16 */
+    uint16_t        home;               /* Hash slot */
+    uint8_t         prev;               /* LRU list, TABLE_NONE = end */
+    uint8_t         next;
+} table_dev_t;
+
+/*******************************************************************************
+ * Static Variables
+ ******************************************************************************/
+static table_dev_t devs[BT_SCAN_TABLE_SIZE];
+static uint8_t slots[BT_SCAN_TABLE_SLOTS];  /* devs index + 1 */
+static uint32_t dev_count = 0;
+static uint8_t lru_head = TABLE_NONE;       /* Heard most recently */
+static uint8_t lru_tail = TABLE_NONE;       /* Next to evict */
+static bt_scan_table_stats_t stats;
+
+/*******************************************************************************
+ * Hash Table
+ ******************************************************************************/
+static uint16_t addr_hash(const uint8_t *addr, uint8_t addr_type)
+{
+    uint32_t h = 2166136261UL;
+
+    for (uint32_t i = 0; i < BT_ADDR_LEN; i++)
+    {
+        h = (h ^ addr[i]) * 16777619UL;
+    }
+    h = (h ^ addr_type) * 16777619UL;
+    return (uint16_t)((h ^ (h >> 16)) & SLOT_MASK);
+}
+
+/* Slot holding the device, or the empty slot where it would go */
+static uint32_t slot_find(const uint8_t *addr, uint8_t addr_type, uint16_t home)
+{
+    uint32_t s = home;
+    uint32_t probes = 1;
+
+    while (slots[s] != SLOT_EMPTY)
+    {
+        const ipc_bt_device_t *dev = &devs[slots[s] - 1U].dev;
+        if ((dev->addr_type == addr_type) && (memcmp(dev->addr, addr, BT_ADDR_LEN) == 0))
+        {
+            break;
+        }
+        s = (s + 1U) & SLOT_MASK;
+        probes++;
+    }
+
+    stats.probes += probes;
+    if (probes > stats.max_probe)
+    {
+        stats.max_probe = probes;
+    }
+    return s;
+}
+
+/* Empty a slot and pull back the entries whose probe ran through it */
+static void slot_remove(uint32_t hole)
+{
+    uint32_t s = hole;
+
+    for (;;)
+    {
+        s = (s + 1U) & SLOT_MASK;
+        if (slots[s] == SLOT_EMPTY)
+        {
+            break;
+        }
+
+        /* The entry may fill the hole unless its home lies in (hole, s] */
+        uint32_t home = devs[slots[s] - 1U].home;
+        bool stays = (hole <= s) ? ((home > hole) && (home <= s))
+                                 : ((home > hole) || (home <= s));
+        if (!stays)
+        {
+            slots[hole] = slots[s];
+            hole = s;
+        }
+    }
+    slots[hole] = SLOT_EMPTY;
+}
+
+/*******************************************************************************
+ * LRU List
+ ******************************************************************************/
+static void lru_unlink(uint8_t i)
+{
+    if (devs[i].prev != TABLE_NONE)
+    {
+        devs[devs[i].prev].next = devs[i].next;
+    }
+    else
+    {
+        lru_head = devs[i].next;
+    }
+
+    if (devs[i].next != TABLE_NONE)
+    {
+        devs[devs[i].next].prev = devs[i].prev;
+    }
+    else
+    {
+        lru_tail = devs[i].prev;
+    }
+}
+
+static void lru_push_head(uint8_t i)
+{
+    devs[i].prev = TABLE_NONE;
+    devs[i].next = lru_head;
+    if (lru_head != TABLE_NONE)
+    {
+        devs[lru_head].prev = i;
+    }
+    lru_head = i;
+    if (lru_tail == TABLE_NONE)
+    {
+        lru_tail = i;
+    }
+}
+
+/*******************************************************************************
+ * RSSI Average
+ ******************************************************************************/
+static int8_t rssi_round(int16_t avg)
+{
+    return (int8_t)((avg >= 0) ? ((avg + 8) / 16) : ((avg - 8) / 16));
+}
+
+/*******************************************************************************
+ * Public Functions
+ ******************************************************************************/
+void bt_scan_table_reset(void)
+{
+    memset(slots, 0, sizeof(slots));
+    memset(&stats, 0, sizeof(stats));
+    dev_count = 0;
+    lru_head = TABLE_NONE;
+    lru_tail = TABLE_NONE;
+}
+
+ipc_bt_device_t *bt_scan_table_update(const uint8_t *addr, uint8_t addr_type,
+                                      int8_t rssi, bool *is_new)
+{
+    uint16_t home = addr_hash(addr, addr_type);
+    uint32_t s = slot_find(addr, addr_type, home);
+    uint8_t i;
+
+    stats.adverts++;
+
+    if (slots[s] != SLOT_EMPTY)
+    {
+        i = slots[s] - 1U;
+        if (i != lru_head)
+        {
+            lru_unlink(i);
+            lru_push_head(i);
+        }
+
+        devs[i].rssi_avg += (int16_t)(((int16_t)rssi * 16 - devs[i].rssi_avg) / BT_SCAN_RSSI_AVG_DIV);
+        devs[i].dev.rssi = rssi_round(devs[i].rssi_avg);
+        if (is_new != NULL)
+        {
+            *is_new = false;
+        }
+        return &devs[i].dev;
+    }
+
+    if (dev_count < BT_SCAN_TABLE_SIZE)
+    {
+        i = (uint8_t)dev_count++;
+    }
+    else
+    {
+        /* Full: drop the device heard longest ago. Its removal may shift
+         * entries back, so the insert slot has to be looked up again */
+        i = lru_tail;
+        slot_remove(slot_find(devs[i].dev.addr, devs[i].dev.addr_type, devs[i].home));
+        lru_unlink(i);
+        s = slot_find(addr, addr_type, home);
+        stats.evictions++;
+    }
+
+    memset(&devs[i], 0, sizeof(table_dev_t));
+    memcpy(devs[i].dev.addr, addr, BT_ADDR_LEN);
+    devs[i].dev.addr_type = addr_type;
+    devs[i].dev.rssi = rssi;
+    devs[i].rssi_avg = (int16_t)rssi * 16;
+    devs[i].home = home;
+    slots[s] = i + 1U;
+    lru_push_head(i);
+    stats.devices++;
+
+    if (is_new != NULL)
+    {
+        *is_new = true;
+    }
+    return &devs[i].dev;
+}
+
+ipc_bt_device_t *bt_scan_table_find(const uint8_t *addr, uint8_t addr_type)
+{
+    uint32_t s = slot_find(addr, addr_type, addr_hash(addr, addr_type));
+
+    return (slots[s] != SLOT_EMPTY) ? &devs[slots[s] - 1U].dev : NULL;
+}
+
+uint32_t bt_scan_table_count(void)
+{
+    return dev_count;
+}
+
+uint32_t bt_scan_table_export(ipc_bt_device_t *out, uint32_t max)
+{
+    uint32_t n = 0;
+
+    /* Insertion into the top-max list, walked most recent first so that
+     * equal RSSI keeps the device heard last ahead */
+    for (uint8_t i = lru_head; i != TABLE_NONE; i = devs[i].next)
+    {
+        int8_t rssi = devs[i].dev.rssi;
+        uint32_t j = (n < max) ? n : max;
+
+        while ((j > 0U) && (out[j - 1U].rssi < rssi))
+        {
+            if (j < max)
+            {
+                out[j] = out[j - 1U];
+            }
+            j--;
+        }
+        if (j < max)
+        {
+            out[j] = devs[i].dev;
+            if (n < max)
+            {
+                n++;
+            }
+        }
+    }
+    return n;
+}
+
+void bt_scan_table_get_stats(bt_scan_table_stats_t *out)
+{
+    if (out != NULL)
+    {
+        memcpy(out, &stats, sizeof(bt_scan_table_stats_t));
+    }
+}
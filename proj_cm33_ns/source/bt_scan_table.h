@@ -0,0 +1,106 @@
+/*******************************************************************************
+ * File: bt_scan_table.h
+ * Description: BLE scan device table for CM33-NS - Header
+ *
+ * Deduplicates advertisements during a BLE scan. Devices are keyed by
+ * address and address type in an open-addressing hash table, so each
+ * advertisement costs one hash and (almost always) one or two probes,
+ * however many devices are on the air.
+ *
+ * The table holds up to BT_SCAN_TABLE_SIZE devices. When it is full the
+ * device heard least recently is evicted (LRU), so a flood of one-shot
+ * advertisers (random addresses, beacons) cannot lock out the devices
+ * that keep advertising. RSSI is smoothed per device with an exponential
+ * moving average (weight 1/BT_SCAN_RSSI_AVG_DIV for each new sample).
+ *
+ * Not thread-safe: the BLE scan callback updates it while a scan runs,
+ * bt_task.c resets and exports it only while no scan is running.
+ *
+ * Part of BiiL Course: Embedded C for IoT - Week 7
+ ******************************************************************************/
+
+#ifndef BT_SCAN_TABLE_H
+#define BT_SCAN_TABLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../../shared/bt_shared.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#ifndef BT_SCAN_TABLE_SIZE
+#define BT_SCAN_TABLE_SIZE              (64U)   /* Devices kept: power of 2, max 128 */
+#endif
+
+#define BT_SCAN_TABLE_SLOTS             (BT_SCAN_TABLE_SIZE * 2U)  /* Load <= 50% */
+#define BT_SCAN_RSSI_AVG_DIV            (4)     /* EWMA weight 1/4 */
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+
+/**
+ * @brief Table counters since the last reset
+ */
+typedef struct
+{
+    uint32_t adverts;           /* Advertisements seen */
+    uint32_t devices;           /* Devices added (including evicted ones) */
+    uint32_t evictions;         /* Devices dropped to make room */
+    uint32_t probes;            /* Slots compared over all lookups */
+    uint32_t max_probe;         /* Longest single lookup */
+} bt_scan_table_stats_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Forget all devices and counters
+ */
+void bt_scan_table_reset(void);
+
+/**
+ * @brief Record one advertisement
+ *
+ * Finds or adds the device and folds rssi into its average. A new device
+ * is returned zeroed except for addr, addr_type and rssi; the caller fills
+ * in the rest (device type, flags, name).
+ *
+ * @param addr       Device address (BT_ADDR_LEN bytes)
+ * @param addr_type  bt_addr_type_t
+ * @param rssi       RSSI of this advertisement (dBm)
+ * @param is_new     Out: true if the device was added (may be NULL)
+ * @return The device entry, valid until the next update or reset
+ */
+ipc_bt_device_t *bt_scan_table_update(const uint8_t *addr, uint8_t addr_type,
+                                      int8_t rssi, bool *is_new);
+
+/**
+ * @brief Look up a device without recording an advertisement
+ *
+ * @return The device entry, or NULL if it is not in the table
+ */
+ipc_bt_device_t *bt_scan_table_find(const uint8_t *addr, uint8_t addr_type);
+
+/**
+ * @brief Devices in the table
+ */
+uint32_t bt_scan_table_count(void);
+
+/**
+ * @brief Copy out the strongest devices (smoothed RSSI), strongest first
+ *
+ * @param out  Room for max entries
+ * @param max  Entries wanted
+ * @return Entries copied
+ */
+uint32_t bt_scan_table_export(ipc_bt_device_t *out, uint32_t max);
+
+/**
+ * @brief Copy the counters
+ */
+void bt_scan_table_get_stats(bt_scan_table_stats_t *stats);
+
+#endif /* BT_SCAN_TABLE_H */
@@ -0,0 +1,566 @@
+/*******************************************************************************
+ * File: bt_sensor_gatt.c
+ * Description: BLE GATT sensor streaming service for CM33-NS
+ *
+ * Three contexts touch the streams: producers (imu_task) add samples, the
+ * stream timer (timer task, once per connection interval) closes stale
+ * packets and sends, and the BT stack thread frees transmitted packets
+ * and sends more. Stream state changes in short critical sections; the
+ * sending itself is serialized by pump_busy, so packets of a stream reach
+ * the stack, and come back, in order.
+ *
+ * Part of BiiL Course: Embedded C for IoT - Week 7
+ ******************************************************************************/
+
+#include "bt_sensor_gatt.h"
+#include "bt_stream.h"
+#include "../../shared/include/static_mem.h"
+#include "lat_trace.h"
+
+/* WICED BT Stack */
+#include "wiced_bt_ble.h"
+#include "wiced_bt_l2c.h"
+#include "wiced_bt_uuid.h"
+#include "wiced_bt_cfg.h"
+
+/* FreeRTOS */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+/* Standard */
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ * GATT Database
+ ******************************************************************************/
+enum
+{
+    HDLS_GATT                       = 0x0001,
+    HDLS_GAP                        = 0x0002,
+    HDLC_GAP_DEVICE_NAME            = 0x0003,
+    HDLC_GAP_DEVICE_NAME_VALUE      = 0x0004,
+    HDLC_GAP_APPEARANCE             = 0x0005,
+    HDLC_GAP_APPEARANCE_VALUE       = 0x0006,
+
+    HDLS_SENSOR                     = 0x0010,
+    HDLC_SENSOR_IMU                 = 0x0011,
+    HDLC_SENSOR_IMU_VALUE           = 0x0012,
+    HDLD_SENSOR_IMU_CCCD            = 0x0013,
+    HDLC_SENSOR_ADC                 = 0x0014,
+    HDLC_SENSOR_ADC_VALUE           = 0x0015,
+    HDLD_SENSOR_ADC_CCCD            = 0x0016,
+    HDLC_SENSOR_CAPSENSE            = 0x0017,
+    HDLC_SENSOR_CAPSENSE_VALUE      = 0x0018,
+    HDLD_SENSOR_CAPSENSE_CCCD       = 0x0019
+};
+
+#define SENSOR_CHAR(hdl, uuid)                                                  \
+    CHARACTERISTIC_UUID128(hdl, hdl##_VALUE, uuid,                              \
+                           GATT_CHAR_PROPERTIES_READ | GATT_CHAR_PROPERTIES_NOTIFY, \
+                           GATT_PERMISSION_READABLE)
+
+#define SENSOR_CCCD(hdl)                                                        \
+    CHAR_DESCRIPTOR_UUID16_WRITABLE(hdl, UUID_DESCRIPTOR_CLIENT_CHARACTERISTIC_CONFIGURATION, \
+                                    GATT_PERMISSION_READABLE | GATT_PERMISSION_WRITE_REQ)
+
+static const uint8_t gatt_database[] =
+{
+    PRIMARY_SERVICE_UUID16(HDLS_GATT, UUID_SERVICE_GATT),
+
+    PRIMARY_SERVICE_UUID16(HDLS_GAP, UUID_SERVICE_GAP),
+        CHARACTERISTIC_UUID16(HDLC_GAP_DEVICE_NAME, HDLC_GAP_DEVICE_NAME_VALUE,
+                              UUID_CHARACTERISTIC_DEVICE_NAME,
+                              GATT_CHAR_PROPERTIES_READ, GATT_PERMISSION_READABLE),
+        CHARACTERISTIC_UUID16(HDLC_GAP_APPEARANCE, HDLC_GAP_APPEARANCE_VALUE,
+                              UUID_CHARACTERISTIC_APPEARANCE,
+                              GATT_CHAR_PROPERTIES_READ, GATT_PERMISSION_READABLE),
+
+    PRIMARY_SERVICE_UUID128(HDLS_SENSOR, UUID_BT_SENSOR_SERVICE),
+        SENSOR_CHAR(HDLC_SENSOR_IMU, UUID_BT_SENSOR_IMU),
+            SENSOR_CCCD(HDLD_SENSOR_IMU_CCCD),
+        SENSOR_CHAR(HDLC_SENSOR_ADC, UUID_BT_SENSOR_ADC),
+            SENSOR_CCCD(HDLD_SENSOR_ADC_CCCD),
+        SENSOR_CHAR(HDLC_SENSOR_CAPSENSE, UUID_BT_SENSOR_CAPSENSE),
+            SENSOR_CCCD(HDLD_SENSOR_CAPSENSE_CCCD),
+};
+
+static const uint8_t service_uuid[] = { UUID_BT_SENSOR_SERVICE };
+static const uint8_t appearance[2] =
+{
+    (uint8_t)(APPEARANCE_GENERIC_TAG & 0xFFU), (uint8_t)(APPEARANCE_GENERIC_TAG >> 8)
+};
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef struct
+{
+    bt_stream_t stream;
+    uint16_t    value_handle;
+    uint16_t    cccd_handle;
+    uint8_t     cccd[2];
+    uint8_t     sample_size;
+    uint8_t     last[sizeof(bt_sensor_imu_t)];  /* Latest sample, for reads */
+    volatile bool notify;
+} sensor_char_t;
+
+/*******************************************************************************
+ * Static Variables
+ ******************************************************************************/
+static sensor_char_t sensors[BT_SENSOR_COUNT];
+
+static const char *device_name = "";
+static uint16_t conn_id = 0;
+static uint16_t conn_mtu = BT_STREAM_DEFAULT_MTU;
+static bt_stream_rate_t rate;
+static uint8_t next_sensor = 0;         /* Round-robin between streams */
+static bool pump_busy = false;
+static bool pump_again = false;
+
+static TimerHandle_t stream_timer = NULL;
+STATIC_TIMER_DEFINE(bt_sensor);
+
+static uint8_t rsp_buffer[BT_STREAM_MAX_MTU];
+
+/*******************************************************************************
+ * Helpers
+ ******************************************************************************/
+static sensor_char_t *sensor_by_handle(uint16_t handle, bool *is_cccd)
+{
+    for (uint32_t i = 0; i < BT_SENSOR_COUNT; i++)
+    {
+        if (handle == sensors[i].value_handle)
+        {
+            *is_cccd = false;
+            return &sensors[i];
+        }
+        if (handle == sensors[i].cccd_handle)
+        {
+            *is_cccd = true;
+            return &sensors[i];
+        }
+    }
+    return NULL;
+}
+
+static bool any_notify(void)
+{
+    for (uint32_t i = 0; i < BT_SENSOR_COUNT; i++)
+    {
+        if (sensors[i].notify)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint32_t interval_ticks(void)
+{
+    TickType_t ticks = pdMS_TO_TICKS(rate.interval_us / 1000U);
+    return (ticks > 0U) ? ticks : 1U;
+}
+
+static void start_advertising(void)
+{
+    uint8_t flags = BTM_BLE_GENERAL_DISCOVERABLE_FLAG | BTM_BLE_BREDR_NOT_SUPPORTED;
+    wiced_bt_ble_advert_elem_t adv[2];
+    wiced_bt_ble_advert_elem_t rsp[1];
+
+    adv[0].advert_type = BTM_BLE_ADVERT_TYPE_FLAG;
+    adv[0].len = 1;
+    adv[0].p_data = &flags;
+    adv[1].advert_type = BTM_BLE_ADVERT_TYPE_128SRV_COMPLETE;
+    adv[1].len = sizeof(service_uuid);
+    adv[1].p_data = (uint8_t *)service_uuid;
+
+    /* The name does not fit next to a 128-bit UUID; it goes in the scan response */
+    rsp[0].advert_type = BTM_BLE_ADVERT_TYPE_NAME_COMPLETE;
+    rsp[0].len = (uint16_t)strlen(device_name);
+    rsp[0].p_data = (uint8_t *)device_name;
+
+    wiced_bt_ble_set_raw_advertisement_data(2, adv);
+    wiced_bt_ble_set_raw_scan_response_data(1, rsp);
+
+    wiced_result_t result = wiced_bt_start_advertisements(BTM_BLE_ADVERT_UNDIRECTED_HIGH,
+                                                          BLE_ADDR_PUBLIC, NULL);
+    if (result != WICED_BT_SUCCESS)
+    {
+        printf("[CM33-BT] Advertising start failed: %d\r\n", (int)result);
+    }
+}
+
+/*******************************************************************************
+ * Notification Pump
+ ******************************************************************************/
+
+/* Send packets while there are credits and the stack takes them */
+static void pump(void)
+{
+    taskENTER_CRITICAL();
+    if (pump_busy)
+    {
+        pump_again = true;
+        taskEXIT_CRITICAL();
+        return;
+    }
+    pump_busy = true;
+    taskEXIT_CRITICAL();
+
+    for (;;)
+    {
+        sensor_char_t *sn = NULL;
+        uint8_t *packet = NULL;
+        uint16_t len = 0;
+        uint32_t now = lat_trace_now_us();
+
+        taskENTER_CRITICAL();
+        for (uint32_t i = 0; (conn_id != 0U) && (i < BT_SENSOR_COUNT); i++)
+        {
+            uint32_t idx = (next_sensor + i) % BT_SENSOR_COUNT;
+            if (sensors[idx].notify &&
+                ((packet = bt_stream_next(&sensors[idx].stream, &len)) != NULL))
+            {
+                sn = &sensors[idx];
+                next_sensor = (uint8_t)((idx + 1U) % BT_SENSOR_COUNT);
+                break;
+            }
+        }
+        if ((sn != NULL) && bt_stream_rate_take(&rate, now))
+        {
+            bt_stream_sent(&sn->stream);
+        }
+        else
+        {
+            sn = NULL;
+            if (!pump_again)
+            {
+                pump_busy = false;
+                taskEXIT_CRITICAL();
+                return;
+            }
+            pump_again = false;     /* Work arrived meanwhile: one more pass */
+        }
+        taskEXIT_CRITICAL();
+
+        if ((sn != NULL) &&
+            (wiced_bt_gatt_server_send_notification(conn_id, sn->value_handle, len,
+                                                    packet, &sn->stream) != WICED_BT_GATT_SUCCESS))
+        {
+            /* Out of stack buffers: the next transmitted event or tick retries */
+            taskENTER_CRITICAL();
+            bt_stream_unsent(&sn->stream);
+            bt_stream_rate_return(&rate);
+            pump_busy = false;
+            pump_again = false;
+            taskEXIT_CRITICAL();
+            return;
+        }
+    }
+}
+
+/* Once per connection interval: send what waited too long to fill up */
+static void stream_timer_cb(TimerHandle_t timer)
+{
+    (void)timer;
+    uint32_t now = lat_trace_now_us();
+
+    taskENTER_CRITICAL();
+    for (uint32_t i = 0; i < BT_SENSOR_COUNT; i++)
+    {
+        if (sensors[i].notify)
+        {
+            bt_stream_flush(&sensors[i].stream, now, BT_SENSOR_FLUSH_MS * 1000U);
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    pump();
+}
+
+/*******************************************************************************
+ * GATT Requests
+ ******************************************************************************/
+static wiced_bt_gatt_status_t send_error(wiced_bt_gatt_attribute_request_t *req,
+                                         uint16_t handle, wiced_bt_gatt_status_t status)
+{
+    wiced_bt_gatt_server_send_error_rsp(req->conn_id, req->opcode, handle, status);
+    return status;
+}
+
+static wiced_bt_gatt_status_t handle_read(wiced_bt_gatt_attribute_request_t *req)
+{
+    uint16_t handle = req->data.read_req.handle;
+    uint16_t offset = (req->opcode == GATT_REQ_READ_BLOB) ? req->data.read_req.offset : 0U;
+    const uint8_t *value = NULL;
+    uint16_t len = 0;
+    bool is_cccd = false;
+    sensor_char_t *sn = sensor_by_handle(handle, &is_cccd);
+
+    if (handle == HDLC_GAP_DEVICE_NAME_VALUE)
+    {
+        value = (const uint8_t *)device_name;
+        len = (uint16_t)strlen(device_name);
+    }
+    else if (handle == HDLC_GAP_APPEARANCE_VALUE)
+    {
+        value = appearance;
+        len = sizeof(appearance);
+    }
+    else if (sn != NULL)
+    {
+        value = is_cccd ? sn->cccd : sn->last;
+        len = is_cccd ? sizeof(sn->cccd) : sn->sample_size;
+    }
+    else
+    {
+        return send_error(req, handle, WICED_BT_GATT_INVALID_HANDLE);
+    }
+
+    if (offset > len)
+    {
+        return send_error(req, handle, WICED_BT_GATT_INVALID_OFFSET);
+    }
+
+    uint16_t rsp_len = (uint16_t)(len - offset);
+    if (rsp_len > req->len_requested)
+    {
+        rsp_len = req->len_requested;
+    }
+    wiced_bt_gatt_server_send_read_handle_rsp(req->conn_id, req->opcode, rsp_len,
+                                              (uint8_t *)&value[offset], NULL);
+    return WICED_BT_GATT_SUCCESS;
+}
+
+static wiced_bt_gatt_status_t handle_write(wiced_bt_gatt_attribute_request_t *req)
+{
+    wiced_bt_gatt_write_req_t *wr = &req->data.write_req;
+    bool is_cccd = false;
+    sensor_char_t *sn = sensor_by_handle(wr->handle, &is_cccd);
+
+    if ((sn == NULL) || !is_cccd)
+    {
+        return send_error(req, wr->handle, WICED_BT_GATT_WRITE_NOT_PERMIT);
+    }
+    if ((wr->val_len != sizeof(sn->cccd)) || (wr->offset != 0U))
+    {
+        return send_error(req, wr->handle, WICED_BT_GATT_INVALID_ATTR_LEN);
+    }
+
+    bool notify = (wr->p_val[0] & GATT_CLIENT_CONFIG_NOTIFICATION) != 0U;
+
+    taskENTER_CRITICAL();
+    memcpy(sn->cccd, wr->p_val, sizeof(sn->cccd));
+    if (notify && !sn->notify)
+    {
+        bt_stream_reset(&sn->stream);   /* Drop stale samples; sent packets finish */
+    }
+    sn->notify = notify;
+    taskEXIT_CRITICAL();
+
+    printf("[CM33-BT] Sensor %u notifications %s\r\n",
+           (unsigned int)(sn - sensors), notify ? "on" : "off");
+
+    if (any_notify())
+    {
+        xTimerStart(stream_timer, 0);
+    }
+    else
+    {
+        xTimerStop(stream_timer, 0);
+    }
+
+    if (req->opcode == GATT_REQ_WRITE)
+    {
+        wiced_bt_gatt_server_send_write_rsp(req->conn_id, req->opcode, wr->handle);
+    }
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Public Functions
+ ******************************************************************************/
+bool bt_sensor_gatt_init(const char *name)
+{
+    static const uint8_t sizes[BT_SENSOR_COUNT] =
+    {
+        sizeof(bt_sensor_imu_t), sizeof(bt_sensor_adc_t), sizeof(bt_sensor_capsense_t)
+    };
+    static const uint16_t handles[BT_SENSOR_COUNT] =
+    {
+        HDLC_SENSOR_IMU_VALUE, HDLC_SENSOR_ADC_VALUE, HDLC_SENSOR_CAPSENSE_VALUE
+    };
+
+    device_name = (name != NULL) ? name : "";
+
+    for (uint32_t i = 0; i < BT_SENSOR_COUNT; i++)
+    {
+        memset(&sensors[i], 0, sizeof(sensor_char_t));
+        bt_stream_init(&sensors[i].stream, sizes[i]);
+        sensors[i].sample_size = sizes[i];
+        sensors[i].value_handle = handles[i];
+        sensors[i].cccd_handle = (uint16_t)(handles[i] + 1U);
+    }
+    bt_stream_rate_init(&rate, BT_SENSOR_NOTIFY_PER_INTERVAL, BT_SENSOR_DEFAULT_INTERVAL_US,
+                        lat_trace_now_us());
+
+    if (wiced_bt_gatt_db_init(gatt_database, sizeof(gatt_database), NULL) != WICED_BT_GATT_SUCCESS)
+    {
+        printf("[CM33-BT] GATT database init failed\r\n");
+        return false;
+    }
+
+    if (stream_timer == NULL)
+    {
+        stream_timer = STATIC_TIMER_CREATE(bt_sensor, "BT Stream", interval_ticks(),
+                                           true, NULL, stream_timer_cb);
+        if (stream_timer == NULL)
+        {
+            return false;
+        }
+    }
+
+    start_advertising();
+    return true;
+}
+
+void bt_sensor_gatt_connection(const wiced_bt_gatt_connection_status_t *status)
+{
+    if (status->connected)
+    {
+        conn_id = status->conn_id;
+        conn_mtu = BT_STREAM_DEFAULT_MTU;
+        for (uint32_t i = 0; i < BT_SENSOR_COUNT; i++)
+        {
+            bt_stream_set_mtu(&sensors[i].stream, conn_mtu);
+        }
+        bt_stream_rate_init(&rate, BT_SENSOR_NOTIFY_PER_INTERVAL, BT_SENSOR_DEFAULT_INTERVAL_US,
+                            lat_trace_now_us());
+
+        /* Ask for a short interval; the central decides and reports back */
+        wiced_bt_l2cap_update_ble_conn_params(status->bd_addr,
+                                              BT_SENSOR_CONN_INTERVAL_MIN,
+                                              BT_SENSOR_CONN_INTERVAL_MAX,
+                                              BT_SENSOR_CONN_LATENCY,
+                                              BT_SENSOR_CONN_TIMEOUT);
+        return;
+    }
+
+    xTimerStop(stream_timer, 0);
+
+    /* The stack reports the notifications it still holds as transmitted
+     * when it frees them, which releases their packets */
+    taskENTER_CRITICAL();
+    conn_id = 0;
+    for (uint32_t i = 0; i < BT_SENSOR_COUNT; i++)
+    {
+        sensors[i].notify = false;
+        memset(sensors[i].cccd, 0, sizeof(sensors[i].cccd));
+        bt_stream_reset(&sensors[i].stream);
+    }
+    taskEXIT_CRITICAL();
+
+    start_advertising();
+}
+
+void bt_sensor_gatt_conn_interval(uint16_t interval)
+{
+    uint32_t interval_us = (uint32_t)interval * 1250U;
+
+    taskENTER_CRITICAL();
+    rate.interval_us = (interval_us > 0U) ? interval_us : BT_SENSOR_DEFAULT_INTERVAL_US;
+    taskEXIT_CRITICAL();
+
+    printf("[CM33-BT] Connection interval %lu us\r\n", (unsigned long)rate.interval_us);
+    xTimerChangePeriod(stream_timer, interval_ticks(), 0);
+    if (!any_notify())
+    {
+        xTimerStop(stream_timer, 0);    /* ChangePeriod also starts it */
+    }
+}
+
+wiced_bt_gatt_status_t bt_sensor_gatt_request(wiced_bt_gatt_attribute_request_t *req)
+{
+    switch (req->opcode)
+    {
+        case GATT_REQ_READ:
+        case GATT_REQ_READ_BLOB:
+            return handle_read(req);
+
+        case GATT_REQ_WRITE:
+        case GATT_CMD_WRITE:
+            return handle_write(req);
+
+        case GATT_REQ_MTU:
+        {
+            uint16_t mtu = req->data.remote_mtu;
+            conn_mtu = (mtu < BT_STREAM_MAX_MTU) ? mtu : BT_STREAM_MAX_MTU;
+
+            taskENTER_CRITICAL();
+            for (uint32_t i = 0; i < BT_SENSOR_COUNT; i++)
+            {
+                bt_stream_set_mtu(&sensors[i].stream, conn_mtu);
+            }
+            taskEXIT_CRITICAL();
+
+            printf("[CM33-BT] MTU %u\r\n", (unsigned int)conn_mtu);
+            wiced_bt_gatt_server_send_mtu_rsp(req->conn_id, mtu, BT_STREAM_MAX_MTU);
+            return WICED_BT_GATT_SUCCESS;
+        }
+
+        case GATT_HANDLE_VALUE_CONF:
+            return WICED_BT_GATT_SUCCESS;
+
+        default:
+            return send_error(req, 0, WICED_BT_GATT_REQ_NOT_SUPPORTED);
+    }
+}
+
+wiced_bt_gatt_status_t bt_sensor_gatt_get_buffer(wiced_bt_gatt_buffer_request_t *req)
+{
+    if (req->len_requested > sizeof(rsp_buffer))
+    {
+        return WICED_BT_GATT_INSUF_RESOURCE;
+    }
+    req->buffer.p_app_rsp_buffer = rsp_buffer;
+    req->buffer.p_app_ctx = NULL;
+    return WICED_BT_GATT_SUCCESS;
+}
+
+void bt_sensor_gatt_transmitted(const wiced_bt_gatt_buffer_transmitted_t *xmit)
+{
+    bt_stream_t *stream = (bt_stream_t *)xmit->p_app_ctx;
+
+    if (stream == NULL)
+    {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    bt_stream_released(stream);
+    taskEXIT_CRITICAL();
+
+    pump();
+}
+
+bool bt_sensor_active(bt_sensor_t sensor)
+{
+    return (sensor < BT_SENSOR_COUNT) && sensors[sensor].notify;
+}
+
+void bt_sensor_push(bt_sensor_t sensor, uint32_t t_us, const void *sample)
+{
+    if (!bt_sensor_active(sensor))
+    {
+        return;
+    }
+
+    sensor_char_t *sn = &sensors[sensor];
+
+    taskENTER_CRITICAL();
+    memcpy(sn->last, sample, sn->sample_size);
+    (void)bt_stream_add(&sn->stream, t_us, sample);
+    taskEXIT_CRITICAL();
+}
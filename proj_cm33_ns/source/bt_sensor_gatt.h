@@ -0,0 +1,138 @@
+/*******************************************************************************
+ * File: bt_sensor_gatt.h
+ * Description: BLE GATT sensor streaming service for CM33-NS - Header
+ *
+ * GATT server with one service and a notify characteristic per sensor:
+ *
+ *   Service   a1c0ee00-5345-4e53-4f52-000000000001
+ *   IMU       ...0002   bt_sensor_imu_t (raw BMI270 LSB), every IMU read
+ *   ADC       ...0003   bt_sensor_adc_t (potentiometer), every IMU read
+ * (the IMU loop runs at the sensor ODR while either of these is on)
+ *   CAPSENSE  ...0004   bt_sensor_capsense_t, every CAPSENSE poll
+ *
+ * Samples are batched by bt_stream.c: a notification carries as many
+ * timestamped samples as the negotiated MTU holds (see bt_stream.h for
+ * the payload format). Notifications are paced to the connection
+ * interval, BT_SENSOR_NOTIFY_PER_INTERVAL per connection event, and a
+ * partly filled packet goes out after BT_SENSOR_FLUSH_MS.
+ *
+ * Producers call bt_sensor_push() from their own task; it only copies
+ * the sample, and does nothing unless a phone has enabled notifications.
+ *
+ * Part of BiiL Course: Embedded C for IoT - Week 7
+ ******************************************************************************/
+
+#ifndef BT_SENSOR_GATT_H
+#define BT_SENSOR_GATT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "wiced_bt_gatt.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define BT_SENSOR_NOTIFY_PER_INTERVAL   (4U)    /* Notifications per connection event */
+#define BT_SENSOR_FLUSH_MS              (100U)  /* Longest a sample waits for company */
+#define BT_SENSOR_DEFAULT_INTERVAL_US   (30000U)
+
+/* Connection parameters requested after connect (1.25 ms / 10 ms units) */
+#define BT_SENSOR_CONN_INTERVAL_MIN     (6U)    /* 7.5 ms */
+#define BT_SENSOR_CONN_INTERVAL_MAX     (12U)   /* 15 ms */
+#define BT_SENSOR_CONN_LATENCY          (0U)
+#define BT_SENSOR_CONN_TIMEOUT          (200U)  /* 2 s */
+
+/* 128-bit UUIDs, little endian as in the GATT database */
+#define BT_SENSOR_UUID(n) \
+    (n), 0x00, 0x00, 0x00, 0x00, 0x00, 0x52, 0x4F, \
+    0x53, 0x4E, 0x45, 0x53, 0x00, 0xEE, 0xC0, 0xA1
+
+#define UUID_BT_SENSOR_SERVICE          BT_SENSOR_UUID(0x01)
+#define UUID_BT_SENSOR_IMU              BT_SENSOR_UUID(0x02)
+#define UUID_BT_SENSOR_ADC              BT_SENSOR_UUID(0x03)
+#define UUID_BT_SENSOR_CAPSENSE         BT_SENSOR_UUID(0x04)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+
+typedef enum
+{
+    BT_SENSOR_IMU = 0,
+    BT_SENSOR_ADC,
+    BT_SENSOR_CAPSENSE,
+    BT_SENSOR_COUNT
+} bt_sensor_t;
+
+typedef struct __attribute__((packed))
+{
+    int16_t acc[3];             /* x, y, z, raw LSB (+-2 g range) */
+    int16_t gyr[3];             /* x, y, z, raw LSB (+-2000 dps range) */
+} bt_sensor_imu_t;
+
+typedef struct __attribute__((packed))
+{
+    uint16_t raw;               /* SAR ADC count, channel 0 */
+} bt_sensor_adc_t;
+
+typedef struct __attribute__((packed))
+{
+    uint8_t btn0;
+    uint8_t btn1;
+    uint8_t slider;             /* 0-100 */
+    uint8_t slider_active;
+} bt_sensor_capsense_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Register the GATT database and start advertising
+ *
+ * Called once from BTM_ENABLED_EVT.
+ *
+ * @param name  Device name for the scan response
+ * @return true on success
+ */
+bool bt_sensor_gatt_init(const char *name);
+
+/**
+ * @brief Connection state from GATT_CONNECTION_STATUS_EVT
+ */
+void bt_sensor_gatt_connection(const wiced_bt_gatt_connection_status_t *status);
+
+/**
+ * @brief Connection interval from BTM_BLE_CONNECTION_PARAM_UPDATE (1.25 ms units)
+ */
+void bt_sensor_gatt_conn_interval(uint16_t interval);
+
+/**
+ * @brief Serve GATT_ATTRIBUTE_REQUEST_EVT
+ */
+wiced_bt_gatt_status_t bt_sensor_gatt_request(wiced_bt_gatt_attribute_request_t *req);
+
+/**
+ * @brief Serve GATT_GET_RESPONSE_BUFFER_EVT
+ */
+wiced_bt_gatt_status_t bt_sensor_gatt_get_buffer(wiced_bt_gatt_buffer_request_t *req);
+
+/**
+ * @brief GATT_APP_BUFFER_TRANSMITTED_EVT: a notification went out
+ */
+void bt_sensor_gatt_transmitted(const wiced_bt_gatt_buffer_transmitted_t *xmit);
+
+/**
+ * @brief True if a phone has notifications on for the sensor
+ */
+bool bt_sensor_active(bt_sensor_t sensor);
+
+/**
+ * @brief Queue one sample
+ *
+ * @param t_us    Sample time (lat_trace_now_us clock)
+ * @param sample  bt_sensor_imu_t / bt_sensor_adc_t / bt_sensor_capsense_t
+ */
+void bt_sensor_push(bt_sensor_t sensor, uint32_t t_us, const void *sample);
+
+#endif /* BT_SENSOR_GATT_H */
@@ -0,0 +1,219 @@
+/*******************************************************************************
+ * File: bt_stream.c
+ * Description: Sensor sample packetizer for BLE notifications
+ *
+ * Timestamps are encoded as deltas rounded to BT_STREAM_DT_UNIT_US from
+ * the previous encoded time (not the previous true time), so rounding
+ * never accumulates: every decoded timestamp is within half a unit.
+ *
+ * Part of BiiL Course: Embedded C for IoT - Week 7
+ ******************************************************************************/
+
+#include "bt_stream.h"
+
+#include <string.h>
+
+/*******************************************************************************
+ * Helpers
+ ******************************************************************************/
+static uint8_t *open_slot(bt_stream_t *s)
+{
+    return s->pkt[(s->head + s->count) % BT_STREAM_QUEUE_DEPTH];
+}
+
+static void close_open(bt_stream_t *s)
+{
+    s->pkt_len[(s->head + s->count) % BT_STREAM_QUEUE_DEPTH] = s->open_len;
+    s->count++;
+    s->seq++;
+    s->packets++;
+    s->open_len = 0;
+}
+
+static uint32_t sample_space(const bt_stream_t *s)
+{
+    return BT_STREAM_DT_SIZE + s->sample_size;
+}
+
+/*******************************************************************************
+ * Public Functions
+ ******************************************************************************/
+void bt_stream_init(bt_stream_t *s, uint8_t sample_size)
+{
+    memset(s, 0, sizeof(bt_stream_t));
+    s->sample_size = sample_size;
+    s->payload_max = BT_STREAM_DEFAULT_MTU - BT_STREAM_ATT_HEADER;
+}
+
+void bt_stream_reset(bt_stream_t *s)
+{
+    /* The stack still reads the packets it holds; they stay at the front
+     * of the ring until bt_stream_released() frees them in order */
+    s->count = s->in_flight;
+    s->open_len = 0;
+}
+
+void bt_stream_set_mtu(bt_stream_t *s, uint16_t mtu)
+{
+    if (mtu < BT_STREAM_DEFAULT_MTU)
+    {
+        mtu = BT_STREAM_DEFAULT_MTU;
+    }
+    if (mtu > BT_STREAM_MAX_MTU)
+    {
+        mtu = BT_STREAM_MAX_MTU;
+    }
+    s->payload_max = (uint16_t)(mtu - BT_STREAM_ATT_HEADER);
+
+    if (s->open_len > s->payload_max)
+    {
+        close_open(s);      /* Built for a larger MTU; cannot be split now */
+    }
+}
+
+bool bt_stream_add(bt_stream_t *s, uint32_t t_us, const void *sample)
+{
+    uint32_t dt = 0;
+
+    if ((BT_STREAM_HEADER_SIZE + sample_space(s)) > s->payload_max)
+    {
+        s->dropped++;
+        return false;
+    }
+
+    if (s->open_len != 0U)
+    {
+        int32_t elapsed = (int32_t)(t_us - s->last_us);
+        dt = (elapsed > 0) ? (((uint32_t)elapsed + (BT_STREAM_DT_UNIT_US / 2U)) /
+                              BT_STREAM_DT_UNIT_US) : 0U;
+
+        if ((dt > 0xFFFFU) || ((s->open_len + sample_space(s)) > s->payload_max))
+        {
+            close_open(s);
+            dt = 0;
+        }
+    }
+
+    if (s->open_len == 0U)
+    {
+        if (s->count >= BT_STREAM_QUEUE_DEPTH)
+        {
+            s->dropped++;
+            return false;
+        }
+
+        uint8_t *p = open_slot(s);
+        p[0] = s->seq;
+        p[1] = 0;
+        p[2] = (uint8_t)t_us;
+        p[3] = (uint8_t)(t_us >> 8);
+        p[4] = (uint8_t)(t_us >> 16);
+        p[5] = (uint8_t)(t_us >> 24);
+        s->open_len = BT_STREAM_HEADER_SIZE;
+        s->open_t0_us = t_us;
+        s->last_us = t_us;
+    }
+
+    uint8_t *p = open_slot(s);
+    p[s->open_len] = (uint8_t)dt;
+    p[s->open_len + 1U] = (uint8_t)(dt >> 8);
+    memcpy(&p[s->open_len + BT_STREAM_DT_SIZE], sample, s->sample_size);
+    s->open_len = (uint16_t)(s->open_len + sample_space(s));
+    s->last_us += dt * BT_STREAM_DT_UNIT_US;
+    p[1]++;
+    s->samples++;
+
+    if ((s->open_len + sample_space(s)) > s->payload_max)
+    {
+        close_open(s);
+    }
+    return true;
+}
+
+void bt_stream_flush(bt_stream_t *s, uint32_t now_us, uint32_t max_age_us)
+{
+    if ((s->open_len != 0U) && ((now_us - s->open_t0_us) >= max_age_us))
+    {
+        close_open(s);
+    }
+}
+
+uint8_t *bt_stream_next(bt_stream_t *s, uint16_t *len)
+{
+    if (s->in_flight >= s->count)
+    {
+        return NULL;
+    }
+
+    uint32_t slot = (s->head + s->in_flight) % BT_STREAM_QUEUE_DEPTH;
+    *len = s->pkt_len[slot];
+    return s->pkt[slot];
+}
+
+void bt_stream_sent(bt_stream_t *s)
+{
+    if (s->in_flight < s->count)
+    {
+        s->in_flight++;
+    }
+}
+
+void bt_stream_unsent(bt_stream_t *s)
+{
+    if (s->in_flight > 0U)
+    {
+        s->in_flight--;
+    }
+}
+
+void bt_stream_released(bt_stream_t *s)
+{
+    if (s->in_flight > 0U)
+    {
+        s->head = (uint8_t)((s->head + 1U) % BT_STREAM_QUEUE_DEPTH);
+        s->count--;
+        s->in_flight--;
+    }
+}
+
+uint32_t bt_stream_pending(const bt_stream_t *s)
+{
+    return (uint32_t)(s->count - s->in_flight);
+}
+
+void bt_stream_rate_init(bt_stream_rate_t *r, uint8_t per_interval, uint32_t interval_us,
+                         uint32_t now_us)
+{
+    r->interval_us = interval_us;
+    r->per_interval = per_interval;
+    r->credits = per_interval;
+    r->last_us = now_us;
+}
+
+bool bt_stream_rate_take(bt_stream_rate_t *r, uint32_t now_us)
+{
+    uint32_t elapsed = now_us - r->last_us;
+
+    /* A new interval starts with a full allowance; unused credits of an
+     * idle interval are not saved up into a burst */
+    if ((r->interval_us != 0U) && (elapsed >= r->interval_us))
+    {
+        r->credits = r->per_interval;
+        r->last_us = now_us - (elapsed % r->interval_us);
+    }
+
+    if (r->credits == 0U)
+    {
+        return false;
+    }
+    r->credits--;
+    return true;
+}
+
+void bt_stream_rate_return(bt_stream_rate_t *r)
+{
+    if (r->credits < r->per_interval)
+    {
+        r->credits++;
+    }
+}
@@ -0,0 +1,167 @@
+/*******************************************************************************
+ * File: bt_stream.h
+ * Description: Sensor sample packetizer for BLE notifications - Header
+ *
+ * Packs fixed-size, timestamped samples into notification payloads that
+ * fill the negotiated ATT MTU, so one notification carries several samples
+ * instead of one. No BT stack or RTOS calls: bt_sensor_gatt.c does the
+ * sending and locking, and the same code runs on a host.
+ *
+ * Payload (little endian):
+ *   [0]    seq         Packet counter, per stream (gaps = lost packets)
+ *   [1]    count       Samples in this packet
+ *   [2..5] t0_us       Timestamp of the first sample (local us clock)
+ *   then per sample:
+ *   [0..1] dt          Time since the previous sample, BT_STREAM_DT_UNIT_US
+ *                      units (0 for the first)
+ *   [2..]  sample      sample_size bytes
+ *
+ * Packets are built in place in a small ring and handed to the stack
+ * without copying; a packet is reused only after the stack reports it
+ * transmitted, even across a reset. When the ring is full, new samples
+ * are dropped (counted).
+ *
+ * bt_stream_rate_t paces notifications to the connection interval: each
+ * interval grants per_interval credits, one per notification.
+ *
+ * Part of BiiL Course: Embedded C for IoT - Week 7
+ ******************************************************************************/
+
+#ifndef BT_STREAM_H
+#define BT_STREAM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define BT_STREAM_ATT_HEADER            (3U)    /* Opcode + handle */
+#define BT_STREAM_DEFAULT_MTU           (23U)   /* Before the MTU exchange */
+#define BT_STREAM_MAX_MTU               (247U)  /* One LE data packet with DLE */
+#define BT_STREAM_MAX_PAYLOAD           (BT_STREAM_MAX_MTU - BT_STREAM_ATT_HEADER)
+#define BT_STREAM_QUEUE_DEPTH           (4U)    /* Packets per stream */
+
+#define BT_STREAM_HEADER_SIZE           (6U)
+#define BT_STREAM_DT_SIZE               (2U)
+#define BT_STREAM_DT_UNIT_US            (100U)  /* 100 us steps, up to 6.5 s */
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+
+/**
+ * @brief One sample stream (one characteristic)
+ */
+typedef struct
+{
+    uint8_t  pkt[BT_STREAM_QUEUE_DEPTH][BT_STREAM_MAX_PAYLOAD];
+    uint16_t pkt_len[BT_STREAM_QUEUE_DEPTH];
+    uint8_t  head;              /* Oldest closed packet */
+    uint8_t  count;             /* Closed packets, in flight included */
+    uint8_t  in_flight;         /* Oldest packets held by the stack */
+    uint8_t  seq;
+    uint8_t  sample_size;
+    uint16_t payload_max;       /* From the MTU */
+    uint16_t open_len;          /* Packet being filled (slot head + count), 0 = none */
+    uint32_t open_t0_us;
+    uint32_t last_us;           /* Previous sample time as encoded */
+    uint32_t samples;
+    uint32_t packets;
+    uint32_t dropped;           /* Samples lost to a full ring */
+} bt_stream_t;
+
+/**
+ * @brief Notification pacing
+ */
+typedef struct
+{
+    uint32_t interval_us;       /* Connection interval */
+    uint32_t last_us;           /* Last refill */
+    uint8_t  per_interval;      /* Notifications per connection event */
+    uint8_t  credits;
+} bt_stream_rate_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Set up an empty stream at the default MTU
+ */
+void bt_stream_init(bt_stream_t *s, uint8_t sample_size);
+
+/**
+ * @brief Drop the open and queued packets (disconnect, subscribe); keeps the MTU
+ *
+ * Packets held by the stack are kept until bt_stream_released().
+ */
+void bt_stream_reset(bt_stream_t *s);
+
+/**
+ * @brief Use the negotiated ATT MTU, from the next packet on
+ */
+void bt_stream_set_mtu(bt_stream_t *s, uint16_t mtu);
+
+/**
+ * @brief Add one sample
+ *
+ * Starts a new packet when the sample does not fit or is too far from
+ * the previous one for dt, and closes a packet once no further sample
+ * fits.
+ *
+ * @return false if the sample was dropped (ring full)
+ */
+bool bt_stream_add(bt_stream_t *s, uint32_t t_us, const void *sample);
+
+/**
+ * @brief Close the open packet if its first sample is max_age_us old
+ */
+void bt_stream_flush(bt_stream_t *s, uint32_t now_us, uint32_t max_age_us);
+
+/**
+ * @brief Next closed packet not yet given to the stack
+ *
+ * @return Payload, or NULL if none
+ */
+uint8_t *bt_stream_next(bt_stream_t *s, uint16_t *len);
+
+/**
+ * @brief Mark the packet from bt_stream_next() as held by the stack
+ */
+void bt_stream_sent(bt_stream_t *s);
+
+/**
+ * @brief Take back the last bt_stream_sent() (the stack refused it)
+ */
+void bt_stream_unsent(bt_stream_t *s);
+
+/**
+ * @brief Free the oldest packet held by the stack (transmitted)
+ */
+void bt_stream_released(bt_stream_t *s);
+
+/**
+ * @brief Closed packets waiting to be sent
+ */
+uint32_t bt_stream_pending(const bt_stream_t *s);
+
+/**
+ * @brief Set up pacing with per_interval notifications per interval
+ */
+void bt_stream_rate_init(bt_stream_rate_t *r, uint8_t per_interval, uint32_t interval_us,
+                         uint32_t now_us);
+
+/**
+ * @brief Take a credit for one notification
+ *
+ * @return false if this connection interval's credits are used up
+ */
+bool bt_stream_rate_take(bt_stream_rate_t *r, uint32_t now_us);
+
+/**
+ * @brief Give back a credit (the send failed)
+ */
+void bt_stream_rate_return(bt_stream_rate_t *r);
+
+#endif /* BT_STREAM_H */
@@ -3,6 +3,7 @@
  * Description: Bluetooth task for CM33-NS - Implementation
  *
  * Manages WICED BT Stack initialization, BLE scanning,
+ * the GATT sensor streaming service (bt_sensor_gatt.c),
  * and processes BT IPC commands from CM55.
  *
  * Based on IoT Gateway reference project (btstack-integration).
@@ -11,8 +12,13 @@
  ******************************************************************************/
 
 #include "bt_task.h"
+#include "bt_scan_table.h"
+#include "bt_adv_parser.h"
+#include "bt_sensor_gatt.h"
+#include "bt_stream.h"
 #include "../../shared/bt_shared.h"
 #include "../ipc/cm33_ipc_pipe.h"
+#include "../../shared/include/static_mem.h"
 
 /* WICED BT Stack */
 #include "wiced_bt_stack.h"
@@ -87,7 +93,7 @@ static const wiced_bt_cfg_ble_advert_settings_t bt_adv_settings =
 static const wiced_bt_cfg_ble_t bt_ble_cfg =
 {
     .ble_max_simultaneous_links = 1,
-    .ble_max_rx_pdu_size = 65,
+    .ble_max_rx_pdu_size = 251,       /* Data length extension, for full-MTU notifications */
     .appearance = APPEARANCE_GENERIC_TAG,
     .rpa_refresh_timeout = WICED_BT_CFG_DEFAULT_RANDOM_ADDRESS_CHANGE_TIMEOUT,
     .host_addr_resolution_db_size = 3,
@@ -98,6 +104,9 @@ static const wiced_bt_cfg_ble_t bt_ble_cfg =
 
 static const wiced_bt_cfg_gatt_t bt_gatt_cfg =
 {
+    .server_max_links = 1,
+    .max_attr_len = BT_STREAM_MAX_PAYLOAD,
+    .max_mtu_size = BT_STREAM_MAX_MTU,
     .max_db_service_modules = 0,
     .max_eatt_bearers = 0
 };
@@ -119,16 +128,22 @@ static const wiced_bt_cfg_settings_t cy_bt_cfg_settings =
 
 /* Command queue for IPC messages */
 static QueueHandle_t bt_cmd_queue = NULL;
+STATIC_QUEUE_DEFINE(bt_cmd, BT_CMD_QUEUE_LENGTH, sizeof(ipc_msg_t));
 
 /* BT state */
 static bt_state_t bt_state = BT_STATE_OFF;
 static bool bt_initialized = false;
 static bool bt_scanning = false;
 
-/* Scan results buffer */
+/* Strongest devices of the last scan, as sent to CM55 */
 static ipc_bt_device_t scan_results[BT_SCAN_MAX_RESULTS];
 static uint8_t scan_result_count = 0;
 
+/* Scan filter from CM55; copied to active_filter when a scan starts */
+static ipc_bt_scan_filter_t scan_filter = { .min_rssi = BT_SCAN_FILTER_RSSI_ANY };
+static ipc_bt_scan_filter_t active_filter = { .min_rssi = BT_SCAN_FILTER_RSSI_ANY };
+static uint32_t scan_filtered = 0;
+
 /* Task handle for notifications */
 static TaskHandle_t bt_task_handle = NULL;
 
@@ -146,6 +161,7 @@ static wiced_bt_gatt_status_t bt_gatt_callback(wiced_bt_gatt_evt_t event,
 static void handle_bt_scan(void);
 static void handle_bt_get_status(void);
 static void handle_bt_get_hardware(void);
+static void handle_bt_scan_filter(const ipc_msg_t *msg);
 static void process_bt_command(const ipc_msg_t *msg);
 
 /*******************************************************************************
@@ -166,8 +182,9 @@ static wiced_result_t bt_management_callback(wiced_bt_management_evt_t event,
                 bt_initialized = true;
                 bt_state = BT_STATE_READY;
 
-                /* Register GATT callback */
+                /* Register GATT callback and the sensor service */
                 wiced_bt_gatt_register(bt_gatt_callback);
+                bt_sensor_gatt_init((const char *)bt_device_name);
 
                 /* Notify task that stack is ready */
                 if (bt_task_handle != NULL)
@@ -190,11 +207,17 @@ static wiced_result_t bt_management_callback(wiced_bt_management_evt_t event,
             break;
 
         case BTM_BLE_ADVERT_STATE_CHANGED_EVT:
-            /* Not advertising in scanner mode, but handle gracefully */
+            printf("[CM33-BT] Advertising state: %d\r\n",
+                   (int)p_event_data->ble_advert_state_changed);
             break;
 
         case BTM_BLE_CONNECTION_PARAM_UPDATE:
             printf("[CM33-BT] Connection param update\r\n");
+            if (p_event_data->ble_connection_param_update.status == WICED_BT_SUCCESS)
+            {
+                bt_sensor_gatt_conn_interval(
+                    p_event_data->ble_connection_param_update.conn_interval);
+            }
             break;
 
         case BTM_BLE_PHY_UPDATE_EVT:
@@ -212,7 +235,7 @@ static wiced_result_t bt_management_callback(wiced_bt_management_evt_t event,
 }
 
 /*******************************************************************************
- * GATT Callback (minimal for scanner)
+ * GATT Callback
  ******************************************************************************/
 
 static wiced_bt_gatt_status_t bt_gatt_callback(wiced_bt_gatt_evt_t event,
@@ -229,6 +252,7 @@ static wiced_bt_gatt_status_t bt_gatt_callback(wiced_bt_gatt_evt_t event,
                 bt_state = BT_STATE_CONNECTED;
                 printf("[CM33-BT] Device connected (conn_id=%d)\r\n",
                        (int)bt_connection_id);
+                bt_sensor_gatt_connection(&p_event_data->connection_status);
 
                 /* Send connected notification to CM55 */
                 ipc_msg_t resp;
@@ -242,6 +266,7 @@ static wiced_bt_gatt_status_t bt_gatt_callback(wiced_bt_gatt_evt_t event,
                        (int)bt_connection_id);
                 bt_connection_id = 0;
                 bt_state = BT_STATE_READY;
+                bt_sensor_gatt_connection(&p_event_data->connection_status);
 
                 /* Send disconnected notification to CM55 */
                 cm33_ipc_send_cmd(IPC_CMD_BT_DISCONNECTED, 0);
@@ -249,7 +274,15 @@ static wiced_bt_gatt_status_t bt_gatt_callback(wiced_bt_gatt_evt_t event,
             break;
 
         case GATT_ATTRIBUTE_REQUEST_EVT:
-            /* Minimal handling - no custom attributes in scanner mode */
+            status = bt_sensor_gatt_request(&p_event_data->attribute_request);
+            break;
+
+        case GATT_GET_RESPONSE_BUFFER_EVT:
+            status = bt_sensor_gatt_get_buffer(&p_event_data->buffer_request);
+            break;
+
+        case GATT_APP_BUFFER_TRANSMITTED_EVT:
+            bt_sensor_gatt_transmitted(&p_event_data->buffer_xmitted);
             break;
 
         default:
@@ -270,7 +303,7 @@ static void ble_scan_result_callback(wiced_bt_ble_scan_results_t *p_scan_result,
     {
         /* Scan complete */
         printf("[CM33-BT] Scan complete, %d devices found\r\n",
-               (int)scan_result_count);
+               (int)bt_scan_table_count());
         bt_scanning = false;
         bt_state = BT_STATE_READY;
 
@@ -282,58 +315,48 @@ static void ble_scan_result_callback(wiced_bt_ble_scan_results_t *p_scan_result,
         return;
     }
 
-    /* Check for duplicates */
-    for (uint8_t i = 0; i < scan_result_count; i++)
+    /* Filter before anything is copied: RSSI first, then the AD fields.
+     * A device already listed still takes its scan responses */
+    if (p_scan_result->rssi < active_filter.min_rssi)
     {
-        if (memcmp(scan_results[i].addr, p_scan_result->remote_bd_addr, BT_ADDR_LEN) == 0)
-        {
-            /* Update RSSI for existing device */
-            scan_results[i].rssi = p_scan_result->rssi;
-            return;
-        }
+        scan_filtered++;
+        return;
     }
 
-    /* Add new device if space available */
-    if (scan_result_count < BT_SCAN_MAX_RESULTS)
-    {
-        ipc_bt_device_t *dev = &scan_results[scan_result_count];
-        memset(dev, 0, sizeof(ipc_bt_device_t));
-
-        memcpy(dev->addr, p_scan_result->remote_bd_addr, BT_ADDR_LEN);
-        dev->addr_type = p_scan_result->ble_addr_type;
-        dev->rssi = p_scan_result->rssi;
-        dev->device_type = BT_DEVICE_TYPE_LE;
-
-        /* Set connectable flag based on advertising type */
-        if (p_scan_result->ble_evt_type == BTM_BLE_EVT_CONNECTABLE_ADVERTISEMENT ||
-            p_scan_result->ble_evt_type == BTM_BLE_EVT_CONNECTABLE_DIRECTED_ADVERTISEMENT)
-        {
-            dev->flags |= 0x01;  /* connectable */
-        }
+    bt_adv_info_t adv;
+    (void)bt_adv_parse(p_adv_data, BT_ADV_MAX_LEN, &adv);
 
-        /* Extract device name from advertisement data */
-        if (p_adv_data != NULL)
-        {
-            uint8_t adv_name_len = 0;
-            uint8_t *p_name = wiced_bt_ble_check_advertising_data(
-                p_adv_data, BTM_BLE_ADVERT_TYPE_NAME_COMPLETE, &adv_name_len);
+    if (!bt_adv_filter_match(&active_filter, &adv) &&
+        (bt_scan_table_find(p_scan_result->remote_bd_addr,
+                            (uint8_t)p_scan_result->ble_addr_type) == NULL))
+    {
+        scan_filtered++;
+        return;
+    }
 
-            if (p_name == NULL)
-            {
-                p_name = wiced_bt_ble_check_advertising_data(
-                    p_adv_data, BTM_BLE_ADVERT_TYPE_NAME_SHORT, &adv_name_len);
-            }
+    /* Find or add the device (hash lookup, smoothed RSSI, LRU eviction) */
+    bool is_new = false;
+    ipc_bt_device_t *dev = bt_scan_table_update(p_scan_result->remote_bd_addr,
+                                                (uint8_t)p_scan_result->ble_addr_type,
+                                                p_scan_result->rssi, &is_new);
+    if (is_new)
+    {
+        dev->device_type = (((adv.present & BT_ADV_HAS_FLAGS) != 0U) &&
+                            ((adv.flags & BT_AD_FLAG_DUAL_MODE) != 0U)) ?
+                           BT_DEVICE_TYPE_DUAL : BT_DEVICE_TYPE_LE;
+    }
 
-            if (p_name != NULL && adv_name_len > 0)
-            {
-                uint8_t copy_len = (adv_name_len < BT_DEVICE_NAME_MAX_LEN - 1) ?
-                                    adv_name_len : (BT_DEVICE_NAME_MAX_LEN - 1);
-                memcpy(dev->name, p_name, copy_len);
-                dev->name[copy_len] = '\0';
-            }
-        }
+    /* Set connectable flag based on advertising type */
+    if (p_scan_result->ble_evt_type == BTM_BLE_EVT_CONNECTABLE_ADVERTISEMENT ||
+        p_scan_result->ble_evt_type == BTM_BLE_EVT_CONNECTABLE_DIRECTED_ADVERTISEMENT)
+    {
+        dev->flags |= 0x01;  /* connectable */
+    }
 
-        scan_result_count++;
+    /* Take the name until one is heard (it may come in a scan response) */
+    if (dev->name[0] == '\0')
+    {
+        (void)bt_adv_copy_name(&adv, dev->name, sizeof(dev->name));
     }
 }
 
@@ -358,6 +381,9 @@ static void handle_bt_scan(void)
     }
 
     /* Reset scan results */
+    bt_scan_table_reset();
+    active_filter = scan_filter;
+    scan_filtered = 0;
     scan_result_count = 0;
     memset(scan_results, 0, sizeof(scan_results));
 
@@ -393,6 +419,15 @@ static void handle_bt_scan(void)
         printf("[CM33-BT] Scan timeout\r\n");
     }
 
+    /* Keep the strongest devices; the table can hold more than CM55 shows */
+    bt_scan_table_stats_t stats;
+    bt_scan_table_get_stats(&stats);
+    scan_result_count = (uint8_t)bt_scan_table_export(scan_results, BT_SCAN_MAX_RESULTS);
+    printf("[CM33-BT] %lu adverts, %lu filtered, %lu devices (%lu evicted), max probe %lu\r\n",
+           (unsigned long)(stats.adverts + scan_filtered), (unsigned long)scan_filtered,
+           (unsigned long)stats.devices, (unsigned long)stats.evictions,
+           (unsigned long)stats.max_probe);
+
     /* Send scan results one-by-one via IPC */
     printf("[CM33-BT] Sending %d scan results via IPC\r\n", (int)scan_result_count);
 
@@ -456,6 +491,29 @@ static void handle_bt_get_hardware(void)
     cm33_ipc_send_retry(&resp, 0);
 }
 
+/*******************************************************************************
+ * Handle BT Scan Filter Command
+ ******************************************************************************/
+
+static void handle_bt_scan_filter(const ipc_msg_t *msg)
+{
+    ipc_bt_scan_filter_t filter;
+    memcpy(&filter, msg->data, sizeof(ipc_bt_scan_filter_t));
+
+    if (((filter.match & BT_SCAN_FILTER_UUID) != 0U) &&
+        (filter.uuid_len != 2U) && (filter.uuid_len != 4U) &&
+        (filter.uuid_len != BT_UUID_MAX_LEN))
+    {
+        printf("[CM33-BT] Scan filter rejected: UUID length %u\r\n",
+               (unsigned int)filter.uuid_len);
+        return;
+    }
+
+    scan_filter = filter;
+    printf("[CM33-BT] Scan filter: rules 0x%02X, min RSSI %d\r\n",
+           (unsigned int)filter.match, (int)filter.min_rssi);
+}
+
 /*******************************************************************************
  * Process BT IPC Command
  ******************************************************************************/
@@ -476,6 +534,10 @@ static void process_bt_command(const ipc_msg_t *msg)
             handle_bt_get_hardware();
             break;
 
+        case IPC_CMD_BT_SCAN_FILTER:
+            handle_bt_scan_filter(msg);
+            break;
+
         case IPC_CMD_BT_CONNECT:
         case IPC_CMD_BT_DISCONNECT:
             /* Connection management - placeholder for future */
@@ -504,7 +566,7 @@ void bt_task(void *pvParameters)
     bt_state = BT_STATE_INITIALIZING;
 
     /* Create command queue */
-    bt_cmd_queue = xQueueCreate(BT_CMD_QUEUE_LENGTH, sizeof(ipc_msg_t));
+    bt_cmd_queue = STATIC_QUEUE_CREATE(bt_cmd, "bt_cmd", sizeof(ipc_msg_t));
     if (bt_cmd_queue == NULL)
     {
         printf("[CM33-BT] FATAL: Queue creation failed\r\n");
@@ -24,7 +24,7 @@
 #define BT_CMD_QUEUE_LENGTH             (8U)
 
 /* Scan configuration */
-#define BT_SCAN_MAX_RESULTS             (16U)
+#define BT_SCAN_MAX_RESULTS             (16U)   /* Strongest sent to CM55 */
 #define BT_SCAN_DURATION_SEC            (10U)
 
 /*******************************************************************************
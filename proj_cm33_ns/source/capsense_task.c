@@ -21,6 +21,8 @@
 #include "capsense_task.h"
 #include "../../shared/ipc_shared.h"
 #include "../ipc/cm33_ipc_pipe.h"
+#include "bt_sensor_gatt.h"
+#include "lat_trace.h"
 #include <string.h>
 
 /*******************************************************************************
@@ -142,6 +144,12 @@ void capsense_module_poll(void)
     cur_slider = sp;
     cur_slider_active = sa;
 
+    /* Every poll to the BLE sensor service, not just the edges */
+    if (bt_sensor_active(BT_SENSOR_CAPSENSE)) {
+        bt_sensor_capsense_t cs = { b0, b1, sp, sa };
+        bt_sensor_push(BT_SENSOR_CAPSENSE, lat_trace_now_us(), &cs);
+    }
+
     /* Edge detection: only send IPC when state changes */
     if (b0 != prev_btn0 || b1 != prev_btn1 ||
         sp != prev_slider || sa != prev_slider_active) {
@@ -0,0 +1,345 @@
+/*******************************************************************************
+ * File: sntp_client.c
+ * Description: SNTP client protocol logic for CM33-NS
+ *
+ * All times are int64 microseconds: server timestamps are converted from
+ * NTP 32.32 fixed point to Unix time, local ones are the caller's counter.
+ * The offset is therefore "Unix time - local counter", a large but exact
+ * number, and the clock model is
+ *
+ *   unix(local) = local + offset + (local - local_at_sync) * drift
+ *
+ * Part of BiiL Course: Embedded C for IoT - Week 7
+ ******************************************************************************/
+
+#include "sntp_client.h"
+
+#include <string.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define NTP_UNIX_OFFSET_S       (2208988800UL)  /* 1900-01-01 to 1970-01-01 */
+#define NTP_UNIX_MIN_S          (1577836800UL)  /* 2020-01-01, sanity floor */
+
+#define NTP_LI_UNSYNC           (3U)
+#define NTP_MODE_CLIENT         (3U)
+#define NTP_MODE_SERVER         (4U)
+#define NTP_VERSION             (4U)
+
+/* Field offsets in the 48-byte header */
+#define NTP_OFS_ORIGIN          (24U)
+#define NTP_OFS_RECEIVE         (32U)
+#define NTP_OFS_TRANSMIT        (40U)
+
+/*******************************************************************************
+ * Static Variables
+ ******************************************************************************/
+static sntp_status_t status;
+static uint64_t sync_local_us = 0;      /* Local clock of the last round */
+static uint32_t poll_log2 = SNTP_MIN_POLL_LOG2;
+static uint32_t stable_rounds = 0;
+
+/*******************************************************************************
+ * Timestamp Conversion
+ ******************************************************************************/
+static uint32_t read_be32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static void write_be32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+/* NTP timestamp -> Unix microseconds; 0 for an empty timestamp.
+ * Seconds are taken modulo 2^32 from the Unix epoch, which covers
+ * 1970-2106 across the 2036 NTP era change. */
+static int64_t ntp_to_unix_us(const uint8_t *p)
+{
+    uint32_t sec = read_be32(p);
+    uint32_t frac = read_be32(p + 4);
+
+    if ((sec == 0U) && (frac == 0U))
+    {
+        return 0;
+    }
+
+    uint32_t unix_s = sec - (uint32_t)NTP_UNIX_OFFSET_S;
+    uint32_t us = (uint32_t)(((uint64_t)frac * 1000000ULL) >> 32);
+    return ((int64_t)unix_s * 1000000LL) + (int64_t)us;
+}
+
+static int32_t clamp_i32(int64_t v, int32_t limit)
+{
+    if (v > limit)
+    {
+        return limit;
+    }
+    if (v < -limit)
+    {
+        return -limit;
+    }
+    return (int32_t)v;
+}
+
+/*******************************************************************************
+ * Clock Model
+ ******************************************************************************/
+
+/* Offset the model predicts at a local time */
+static int64_t model_offset(uint64_t local_us)
+{
+    int64_t elapsed = (int64_t)(local_us - sync_local_us);
+    return status.offset_us + ((elapsed * status.drift_ppb) / 1000000000LL);
+}
+
+static void poll_adjust(bool stable)
+{
+    if (!stable)
+    {
+        poll_log2 = SNTP_MIN_POLL_LOG2;
+        stable_rounds = 0;
+    }
+    else if (++stable_rounds >= SNTP_STABLE_ROUNDS)
+    {
+        stable_rounds = 0;
+        if (poll_log2 < SNTP_MAX_POLL_LOG2)
+        {
+            poll_log2++;
+        }
+    }
+    status.poll_s = 1UL << poll_log2;
+}
+
+/* Median offset, for outlier rejection (count <= SNTP_MAX_SAMPLES) */
+static int64_t median_offset(const sntp_sample_t *samples, uint32_t count)
+{
+    int64_t sorted[SNTP_MAX_SAMPLES];
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        int64_t v = samples[i].offset_us;
+        uint32_t j = i;
+        while ((j > 0) && (sorted[j - 1] > v))
+        {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = v;
+    }
+
+    if ((count & 1U) != 0U)
+    {
+        return sorted[count / 2];
+    }
+    return (sorted[count / 2 - 1] + sorted[count / 2]) / 2;
+}
+
+/*******************************************************************************
+ * Public Functions
+ ******************************************************************************/
+void sntp_client_reset(void)
+{
+    memset(&status, 0, sizeof(status));
+    sync_local_us = 0;
+    poll_log2 = SNTP_MIN_POLL_LOG2;
+    stable_rounds = 0;
+    status.poll_s = 1UL << poll_log2;
+}
+
+void sntp_build_request(uint8_t *packet, uint64_t local_us, sntp_request_t *req)
+{
+    memset(packet, 0, SNTP_PACKET_SIZE);
+    packet[0] = (uint8_t)((NTP_VERSION << 3) | NTP_MODE_CLIENT);   /* LI=0, VN=4, Mode=3 */
+
+    /* The transmit field only has to come back unchanged as the origin;
+     * the local clock makes it unique per request */
+    write_be32(&req->xmt[0], (uint32_t)(local_us / 1000000ULL));
+    write_be32(&req->xmt[4], (uint32_t)((((local_us % 1000000ULL) << 32)) / 1000000ULL));
+    memcpy(&packet[NTP_OFS_TRANSMIT], req->xmt, sizeof(req->xmt));
+
+    req->t1_local_us = local_us;
+}
+
+sntp_result_t sntp_parse_reply(const uint8_t *packet, int len, const sntp_request_t *req,
+                               uint64_t local_us, sntp_sample_t *sample)
+{
+    if ((packet == NULL) || (len < (int)SNTP_PACKET_SIZE))
+    {
+        return SNTP_ERR_SHORT;
+    }
+
+    uint8_t li = packet[0] >> 6;
+    uint8_t vn = (packet[0] >> 3) & 0x07U;
+    uint8_t mode = packet[0] & 0x07U;
+    uint8_t stratum = packet[1];
+
+    if ((mode != NTP_MODE_SERVER) || (vn < 3U) || (vn > 4U))
+    {
+        return SNTP_ERR_MODE;
+    }
+    if (memcmp(&packet[NTP_OFS_ORIGIN], req->xmt, sizeof(req->xmt)) != 0)
+    {
+        return SNTP_ERR_ORIGIN;
+    }
+    if (stratum == 0U)
+    {
+        return SNTP_ERR_KOD;
+    }
+    if ((li == NTP_LI_UNSYNC) || (stratum > 15U))
+    {
+        return SNTP_ERR_UNSYNC;
+    }
+
+    int64_t t2 = ntp_to_unix_us(&packet[NTP_OFS_RECEIVE]);
+    int64_t t3 = ntp_to_unix_us(&packet[NTP_OFS_TRANSMIT]);
+    if ((t2 < (int64_t)NTP_UNIX_MIN_S * 1000000LL) || (t3 < t2) || (local_us < req->t1_local_us))
+    {
+        return SNTP_ERR_TIME;
+    }
+
+    int64_t t1 = (int64_t)req->t1_local_us;
+    int64_t t4 = (int64_t)local_us;
+    int64_t delay = (t4 - t1) - (t3 - t2);
+    if (delay < 0)
+    {
+        delay = 0;      /* Server processing longer than the local round trip: clock jitter */
+    }
+    if (delay > (int64_t)SNTP_MAX_DELAY_US)
+    {
+        return SNTP_ERR_DELAY;
+    }
+
+    sample->offset_us = ((t2 - t1) + (t3 - t4)) / 2;
+    sample->delay_us = (uint32_t)delay;
+    sample->local_us = local_us;
+    sample->stratum = stratum;
+    sample->server = 0;
+    return SNTP_OK;
+}
+
+bool sntp_client_update(const sntp_sample_t *samples, uint32_t count)
+{
+    if (status.poll_s == 0U)
+    {
+        status.poll_s = 1UL << poll_log2;
+    }
+    if (count > SNTP_MAX_SAMPLES)
+    {
+        count = SNTP_MAX_SAMPLES;
+    }
+
+    /* With three or more samples the majority decides; fewer cannot vote */
+    const sntp_sample_t *best = NULL;
+    int64_t median = (count >= 3U) ? median_offset(samples, count) : 0;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const sntp_sample_t *s = &samples[i];
+
+        if (count >= 3U)
+        {
+            int64_t dist = s->offset_us - median;
+            if (dist < 0)
+            {
+                dist = -dist;
+            }
+            if (dist > (int64_t)SNTP_OUTLIER_US + (int64_t)(s->delay_us / 2U))
+            {
+                status.rejected++;
+                continue;
+            }
+        }
+
+        /* The shortest round trip has the smallest error bound */
+        if ((best == NULL) || (s->delay_us < best->delay_us))
+        {
+            best = s;
+        }
+    }
+
+    if (best == NULL)
+    {
+        status.failures++;
+        poll_adjust(false);
+        return false;
+    }
+
+    int64_t residual = 0;
+    if (status.synced)
+    {
+        residual = best->offset_us - model_offset(best->local_us);
+        int64_t interval = (int64_t)(best->local_us - sync_local_us);
+
+        if ((residual > SNTP_STEP_US) || (residual < -SNTP_STEP_US))
+        {
+            /* A step (clock set elsewhere, bad round before): keep the drift */
+        }
+        else if (interval >= (int64_t)SNTP_DRIFT_MIN_INTERVAL_US)
+        {
+            /* Half of the rate error seen over the interval, to ride out jitter */
+            int64_t rate_ppb = (residual * 1000000000LL) / interval;
+            status.drift_ppb = clamp_i32((int64_t)status.drift_ppb + rate_ppb / 2,
+                                         SNTP_MAX_DRIFT_PPB);
+        }
+    }
+
+    status.synced = true;
+    status.offset_us = best->offset_us;
+    status.delay_us = best->delay_us;
+    status.residual_us = clamp_i32(residual, INT32_MAX);
+    status.stratum = best->stratum;
+    status.server = best->server;
+    status.rounds++;
+    sync_local_us = best->local_us;
+
+    poll_adjust((residual <= SNTP_STABLE_US) && (residual >= -SNTP_STABLE_US));
+    return true;
+}
+
+bool sntp_client_now_us(uint64_t local_us, int64_t *unix_us)
+{
+    if (!status.synced || (unix_us == NULL))
+    {
+        return false;
+    }
+
+    *unix_us = (int64_t)local_us + model_offset(local_us);
+    return true;
+}
+
+uint32_t sntp_client_poll_s(void)
+{
+    return (status.poll_s != 0U) ? status.poll_s : (1UL << poll_log2);
+}
+
+void sntp_client_get_status(sntp_status_t *out)
+{
+    if (out != NULL)
+    {
+        memcpy(out, &status, sizeof(sntp_status_t));
+        out->poll_s = sntp_client_poll_s();
+    }
+}
+
+const char *sntp_result_str(sntp_result_t result)
+{
+    switch (result)
+    {
+        case SNTP_OK:           return "ok";
+        case SNTP_ERR_SHORT:    return "short packet";
+        case SNTP_ERR_MODE:     return "not a server reply";
+        case SNTP_ERR_ORIGIN:   return "origin mismatch";
+        case SNTP_ERR_KOD:      return "kiss-o'-death";
+        case SNTP_ERR_UNSYNC:   return "server unsynchronized";
+        case SNTP_ERR_TIME:     return "bad timestamps";
+        case SNTP_ERR_DELAY:    return "round trip too long";
+        default:                return "?";
+    }
+}
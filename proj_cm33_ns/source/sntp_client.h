@@ -0,0 +1,177 @@
+/*******************************************************************************
+ * File: sntp_client.h
+ * Description: SNTP client protocol logic for CM33-NS - Header
+ *
+ * Protocol and clock discipline only, no sockets or RTOS: wifi_task.c does
+ * the UDP exchange and passes the packets and local timestamps in, so the
+ * same code runs on a host against a local UDP stand-in server.
+ *
+ * Each exchange gives the four NTP timestamps:
+ *   T1 request sent (local)    T2 request received (server)
+ *   T3 reply sent (server)     T4 reply received (local)
+ * offset = ((T2 - T1) + (T3 - T4)) / 2, delay = (T4 - T1) - (T3 - T2),
+ * kept in microseconds, fractions included.
+ *
+ * One exchange per server makes a round. Samples far from the median
+ * offset are rejected and the one with the shortest delay is used. The
+ * local clock drift is estimated from the offset error over the interval
+ * between rounds, and the poll interval doubles while the clock holds
+ * within SNTP_STABLE_US (up to 2^SNTP_MAX_POLL_LOG2 s) and drops back on
+ * errors or failures.
+ *
+ * The local clock is any monotonic 64-bit microsecond counter that keeps
+ * running while the core sleeps (wifi_task uses tick_clock_now_us64();
+ * a cycle counter that stops in sleep reads as a huge drift).
+ *
+ * Usage:
+ *   sntp_request_t req;
+ *   sntp_build_request(packet, local_us(), &req);
+ *   ... send, receive ...
+ *   if (sntp_parse_reply(packet, len, &req, local_us(), &samples[n]) == SNTP_OK) n++;
+ *   ... other servers ...
+ *   sntp_client_update(samples, n);
+ *   sntp_client_now_us(local_us(), &unix_us);
+ *
+ * Part of BiiL Course: Embedded C for IoT - Week 7
+ ******************************************************************************/
+
+#ifndef SNTP_CLIENT_H
+#define SNTP_CLIENT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define SNTP_PACKET_SIZE                (48U)
+#define SNTP_MAX_SAMPLES                (8U)        /* Per round */
+
+#define SNTP_MIN_POLL_LOG2              (6U)        /* 64 s */
+#define SNTP_MAX_POLL_LOG2              (10U)       /* 1024 s */
+#define SNTP_STABLE_US                  (5000)      /* Error that lets the poll grow */
+#define SNTP_STABLE_ROUNDS              (2U)        /* Stable rounds per doubling */
+#define SNTP_STEP_US                    (128000)    /* Error treated as a step, not drift */
+#define SNTP_OUTLIER_US                 (50000)     /* Distance from median (+ delay/2) */
+#define SNTP_MAX_DELAY_US               (1000000U)  /* Slower round trips are useless */
+#define SNTP_MAX_DRIFT_PPB              (500000)    /* 500 ppm */
+#define SNTP_DRIFT_MIN_INTERVAL_US      (16000000U) /* Shorter gaps are all noise */
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+
+/**
+ * @brief Result of parsing a reply
+ */
+typedef enum
+{
+    SNTP_OK = 0,
+    SNTP_ERR_SHORT,             /* Less than SNTP_PACKET_SIZE bytes */
+    SNTP_ERR_MODE,              /* Not a server reply */
+    SNTP_ERR_ORIGIN,            /* Not the answer to our request (stale, spoofed) */
+    SNTP_ERR_KOD,               /* Kiss-o'-death (stratum 0): back off */
+    SNTP_ERR_UNSYNC,            /* Server clock not synchronized */
+    SNTP_ERR_TIME,              /* Timestamps missing or out of order */
+    SNTP_ERR_DELAY              /* Round trip above SNTP_MAX_DELAY_US */
+} sntp_result_t;
+
+/**
+ * @brief An outstanding request
+ */
+typedef struct
+{
+    uint64_t t1_local_us;       /* Local clock when sent */
+    uint8_t  xmt[8];            /* Transmit timestamp, echoed as the origin */
+} sntp_request_t;
+
+/**
+ * @brief One exchange
+ */
+typedef struct
+{
+    int64_t  offset_us;         /* Unix time - local clock */
+    uint32_t delay_us;          /* Round trip without server processing */
+    uint64_t local_us;          /* Local clock at T4 */
+    uint8_t  stratum;
+    uint8_t  server;            /* Caller's server index */
+} sntp_sample_t;
+
+/**
+ * @brief Client state
+ */
+typedef struct
+{
+    bool     synced;
+    int64_t  offset_us;         /* Unix time - local clock at the last round */
+    uint32_t delay_us;          /* Of the sample used */
+    int32_t  residual_us;       /* Error of the clock model found by the last round */
+    int32_t  drift_ppb;         /* Local clock rate error estimate */
+    uint32_t poll_s;
+    uint8_t  stratum;
+    uint8_t  server;
+    uint32_t rounds;
+    uint32_t failures;          /* Rounds without a usable sample */
+    uint32_t rejected;          /* Samples dropped as outliers */
+} sntp_status_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Forget the sync, drift and poll interval
+ */
+void sntp_client_reset(void);
+
+/**
+ * @brief Build a client request (NTPv4, mode 3)
+ *
+ * @param packet    SNTP_PACKET_SIZE bytes
+ * @param local_us  Local clock now (T1)
+ * @param req       Out: what the reply has to match
+ */
+void sntp_build_request(uint8_t *packet, uint64_t local_us, sntp_request_t *req);
+
+/**
+ * @brief Check a reply and compute its offset and delay
+ *
+ * @param packet    Received bytes
+ * @param len       Received length
+ * @param req       The request it answers
+ * @param local_us  Local clock at receive (T4)
+ * @param sample    Out (server is left 0)
+ */
+sntp_result_t sntp_parse_reply(const uint8_t *packet, int len, const sntp_request_t *req,
+                               uint64_t local_us, sntp_sample_t *sample);
+
+/**
+ * @brief Feed the samples of one round
+ *
+ * @return true if a sample was used; false counts a failure
+ */
+bool sntp_client_update(const sntp_sample_t *samples, uint32_t count);
+
+/**
+ * @brief Unix time in microseconds for a local clock reading
+ *
+ * @return false before the first sync
+ */
+bool sntp_client_now_us(uint64_t local_us, int64_t *unix_us);
+
+/**
+ * @brief Seconds until the next round should run
+ */
+uint32_t sntp_client_poll_s(void);
+
+/**
+ * @brief Copy the client state
+ */
+void sntp_client_get_status(sntp_status_t *status);
+
+/**
+ * @brief Short text for a parse result
+ */
+const char *sntp_result_str(sntp_result_t result);
+
+#endif /* SNTP_CLIENT_H */
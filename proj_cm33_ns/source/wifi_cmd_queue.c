@@ -0,0 +1,231 @@
+/*******************************************************************************
+ * File: wifi_cmd_queue.c
+ * Description: WiFi command queue with priority classes for CM33-NS
+ *
+ * The queue is a small slot array; pop picks the pending slot with the
+ * highest class and, within it, the lowest sequence number. With at most
+ * one slot per command a linear pass over WIFI_CMD_QUEUE_SIZE is cheaper
+ * than keeping per-class lists in order.
+ *
+ * Part of BiiL Course: Embedded C for IoT - Week 7
+ ******************************************************************************/
+
+#include "wifi_cmd_queue.h"
+#include "../../shared/wifi_shared.h"
+
+#include <string.h>
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef struct
+{
+    bool        used;
+    uint8_t     id;                 /* wifi_cmd_id_t */
+    uint32_t    seq;                /* Arrival order */
+    uint32_t    queued_us;
+    ipc_msg_t   msg;
+} cmd_slot_t;
+
+typedef struct
+{
+    uint32_t    cmd;
+    uint8_t     cls;                /* wifi_cmd_class_t */
+    const char *name;
+} cmd_info_t;
+
+/*******************************************************************************
+ * Static Variables
+ ******************************************************************************/
+
+/* Indexed by wifi_cmd_id_t */
+static const cmd_info_t cmd_info[WIFI_CMD_ID_COUNT] =
+{
+    { IPC_CMD_WIFI_STATUS,          WIFI_CMD_CLASS_QUERY,       "status"     },
+    { IPC_CMD_WIFI_GET_TCPIP,       WIFI_CMD_CLASS_QUERY,       "tcpip"      },
+    { IPC_CMD_WIFI_GET_HARDWARE,    WIFI_CMD_CLASS_QUERY,       "hardware"   },
+    { IPC_CMD_WIFI_CONNECT,         WIFI_CMD_CLASS_LINK,        "connect"    },
+    { IPC_CMD_WIFI_DISCONNECT,      WIFI_CMD_CLASS_LINK,        "disconnect" },
+    { IPC_CMD_WIFI_SCAN_START,      WIFI_CMD_CLASS_BACKGROUND,  "scan"       },
+    { IPC_CMD_NTP_SYNC,             WIFI_CMD_CLASS_BACKGROUND,  "ntp"        },
+};
+
+static cmd_slot_t slots[WIFI_CMD_QUEUE_SIZE];
+static wifi_cmd_stats_t stats[WIFI_CMD_ID_COUNT];
+static uint32_t next_seq = 0;
+
+/*******************************************************************************
+ * Helpers
+ ******************************************************************************/
+static int32_t cmd_id(uint32_t cmd)
+{
+    for (uint32_t i = 0; i < WIFI_CMD_ID_COUNT; i++)
+    {
+        if (cmd_info[i].cmd == cmd)
+        {
+            return (int32_t)i;
+        }
+    }
+    return -1;
+}
+
+static cmd_slot_t *find_pending(uint8_t id)
+{
+    for (uint32_t i = 0; i < WIFI_CMD_QUEUE_SIZE; i++)
+    {
+        if (slots[i].used && (slots[i].id == id))
+        {
+            return &slots[i];
+        }
+    }
+    return NULL;
+}
+
+/* Pending slot served next among classes up to max_class, or NULL */
+static cmd_slot_t *find_next(wifi_cmd_class_t max_class)
+{
+    cmd_slot_t *best = NULL;
+
+    for (uint32_t i = 0; i < WIFI_CMD_QUEUE_SIZE; i++)
+    {
+        cmd_slot_t *s = &slots[i];
+        if (!s->used || (cmd_info[s->id].cls > (uint8_t)max_class))
+        {
+            continue;
+        }
+        if ((best == NULL) ||
+            (cmd_info[s->id].cls < cmd_info[best->id].cls) ||
+            ((cmd_info[s->id].cls == cmd_info[best->id].cls) &&
+             ((int32_t)(s->seq - best->seq) < 0)))
+        {
+            best = s;
+        }
+    }
+    return best;
+}
+
+/*******************************************************************************
+ * Public Functions
+ ******************************************************************************/
+void wifi_cmd_queue_init(void)
+{
+    memset(slots, 0, sizeof(slots));
+    memset(stats, 0, sizeof(stats));
+    next_seq = 0;
+}
+
+wifi_cmd_push_t wifi_cmd_queue_push(const ipc_msg_t *msg, uint32_t now_us)
+{
+    int32_t id = cmd_id(msg->cmd);
+    if (id < 0)
+    {
+        return WIFI_CMD_UNKNOWN;
+    }
+
+    /* A disconnect makes a connect still waiting pointless */
+    if (id == WIFI_CMD_ID_DISCONNECT)
+    {
+        cmd_slot_t *conn = find_pending(WIFI_CMD_ID_CONNECT);
+        if (conn != NULL)
+        {
+            conn->used = false;
+            stats[WIFI_CMD_ID_CONNECT].coalesced++;
+        }
+    }
+
+    /* Same command waiting: the new one takes its place in line */
+    cmd_slot_t *s = find_pending((uint8_t)id);
+    if (s != NULL)
+    {
+        uint32_t old_value = s->msg.value;
+        memcpy(&s->msg, msg, sizeof(ipc_msg_t));
+        if (id == WIFI_CMD_ID_SCAN)
+        {
+            s->msg.value |= (old_value & WIFI_SCAN_FLAG_FULL);
+        }
+        stats[id].coalesced++;
+        return WIFI_CMD_COALESCED;
+    }
+
+    for (uint32_t i = 0; i < WIFI_CMD_QUEUE_SIZE; i++)
+    {
+        if (!slots[i].used)
+        {
+            s = &slots[i];
+            s->used = true;
+            s->id = (uint8_t)id;
+            s->seq = next_seq++;
+            s->queued_us = now_us;
+            memcpy(&s->msg, msg, sizeof(ipc_msg_t));
+            return WIFI_CMD_QUEUED;
+        }
+    }
+    return WIFI_CMD_FULL;
+}
+
+bool wifi_cmd_queue_pop(wifi_cmd_class_t max_class, ipc_msg_t *msg, uint32_t *queued_us)
+{
+    cmd_slot_t *s = find_next(max_class);
+    if (s == NULL)
+    {
+        return false;
+    }
+
+    memcpy(msg, &s->msg, sizeof(ipc_msg_t));
+    *queued_us = s->queued_us;
+    s->used = false;
+    return true;
+}
+
+bool wifi_cmd_queue_pending(wifi_cmd_class_t max_class)
+{
+    return find_next(max_class) != NULL;
+}
+
+void wifi_cmd_queue_record(uint32_t cmd, uint32_t wait_us, uint32_t run_us)
+{
+    int32_t id = cmd_id(cmd);
+    if (id < 0)
+    {
+        return;
+    }
+
+    wifi_cmd_stats_t *st = &stats[id];
+    st->count++;
+    st->wait_total_us += wait_us;
+    st->run_total_us += run_us;
+    if (wait_us > st->wait_max_us)
+    {
+        st->wait_max_us = wait_us;
+    }
+    if (run_us > st->run_max_us)
+    {
+        st->run_max_us = run_us;
+    }
+}
+
+void wifi_cmd_queue_cancelled(uint32_t cmd)
+{
+    int32_t id = cmd_id(cmd);
+    if (id >= 0)
+    {
+        stats[id].cancelled++;
+    }
+}
+
+void wifi_cmd_queue_get_stats(wifi_cmd_id_t id, wifi_cmd_stats_t *out)
+{
+    if ((uint32_t)id < WIFI_CMD_ID_COUNT)
+    {
+        memcpy(out, &stats[id], sizeof(wifi_cmd_stats_t));
+    }
+    else
+    {
+        memset(out, 0, sizeof(wifi_cmd_stats_t));
+    }
+}
+
+const char *wifi_cmd_queue_name(wifi_cmd_id_t id)
+{
+    return ((uint32_t)id < WIFI_CMD_ID_COUNT) ? cmd_info[id].name : "?";
+}
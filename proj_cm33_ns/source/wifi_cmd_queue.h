@@ -0,0 +1,143 @@
+/*******************************************************************************
+ * File: wifi_cmd_queue.h
+ * Description: WiFi command queue with priority classes for CM33-NS - Header
+ *
+ * Holds the IPC commands waiting for wifi_task. Commands are served by
+ * class, then in arrival order:
+ *
+ *   QUERY       status, TCP/IP, hardware info    answered from state, fast
+ *   LINK        connect, disconnect
+ *   BACKGROUND  scan, NTP sync                   may take seconds
+ *
+ * A command already waiting is not queued twice: the new one takes over
+ * its place in line (a scan keeps WIFI_SCAN_FLAG_FULL if either asked for
+ * it, a connect uses the newer credentials), and a disconnect drops a
+ * connect still waiting. So at most one of each command is ever pending
+ * and the queue cannot fill up.
+ *
+ * Per command, the time spent waiting (queued -> started) and running
+ * (started -> done) is recorded, along with coalesced and cancelled counts.
+ *
+ * Not thread-safe: wifi_task.c calls it in critical sections, from the
+ * IPC task (push) and wifi_task (pop, record).
+ *
+ * Part of BiiL Course: Embedded C for IoT - Week 7
+ ******************************************************************************/
+
+#ifndef WIFI_CMD_QUEUE_H
+#define WIFI_CMD_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../../shared/ipc_shared.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define WIFI_CMD_QUEUE_SIZE             (8U)    /* >= WIFI_CMD_ID_COUNT */
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+
+typedef enum
+{
+    WIFI_CMD_CLASS_QUERY = 0,
+    WIFI_CMD_CLASS_LINK,
+    WIFI_CMD_CLASS_BACKGROUND,
+    WIFI_CMD_CLASS_COUNT
+} wifi_cmd_class_t;
+
+/**
+ * @brief Commands wifi_task serves (stats index)
+ */
+typedef enum
+{
+    WIFI_CMD_ID_STATUS = 0,
+    WIFI_CMD_ID_TCPIP,
+    WIFI_CMD_ID_HARDWARE,
+    WIFI_CMD_ID_CONNECT,
+    WIFI_CMD_ID_DISCONNECT,
+    WIFI_CMD_ID_SCAN,
+    WIFI_CMD_ID_NTP,
+    WIFI_CMD_ID_COUNT
+} wifi_cmd_id_t;
+
+typedef enum
+{
+    WIFI_CMD_QUEUED = 0,
+    WIFI_CMD_COALESCED,             /* Merged into a pending command */
+    WIFI_CMD_FULL,
+    WIFI_CMD_UNKNOWN                /* Not a WiFi task command */
+} wifi_cmd_push_t;
+
+/**
+ * @brief Latency figures of one command
+ */
+typedef struct
+{
+    uint32_t count;                 /* Served */
+    uint32_t coalesced;
+    uint32_t cancelled;             /* Cut short for a higher class */
+    uint32_t wait_max_us;
+    uint64_t wait_total_us;
+    uint32_t run_max_us;
+    uint64_t run_total_us;
+} wifi_cmd_stats_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Empty the queue and clear the stats
+ */
+void wifi_cmd_queue_init(void);
+
+/**
+ * @brief Add a command, or merge it into the same command pending
+ *
+ * @param msg     IPC message as received
+ * @param now_us  Arrival time (tick_clock_now_us clock)
+ */
+wifi_cmd_push_t wifi_cmd_queue_push(const ipc_msg_t *msg, uint32_t now_us);
+
+/**
+ * @brief Take the next command, of class max_class or higher
+ *
+ * @param max_class  Lowest class to consider (BACKGROUND = any)
+ * @param msg        Out
+ * @param queued_us  Out: arrival time of the command
+ * @return false if none is pending
+ */
+bool wifi_cmd_queue_pop(wifi_cmd_class_t max_class, ipc_msg_t *msg, uint32_t *queued_us);
+
+/**
+ * @brief True if a command of class max_class or higher is pending
+ */
+bool wifi_cmd_queue_pending(wifi_cmd_class_t max_class);
+
+/**
+ * @brief Record a served command
+ *
+ * @param wait_us  Queued -> started
+ * @param run_us   Started -> done
+ */
+void wifi_cmd_queue_record(uint32_t cmd, uint32_t wait_us, uint32_t run_us);
+
+/**
+ * @brief Count a command stopped before it finished
+ */
+void wifi_cmd_queue_cancelled(uint32_t cmd);
+
+/**
+ * @brief Stats of one command
+ */
+void wifi_cmd_queue_get_stats(wifi_cmd_id_t id, wifi_cmd_stats_t *stats);
+
+/**
+ * @brief Short name of a command for logs ("status", "scan", ...)
+ */
+const char *wifi_cmd_queue_name(wifi_cmd_id_t id);
+
+#endif /* WIFI_CMD_QUEUE_H */
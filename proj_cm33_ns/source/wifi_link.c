@@ -0,0 +1,223 @@
+/*******************************************************************************
+ * File: wifi_link.c
+ * Description: WiFi reconnect manager for CM33-NS
+ *
+ * The profile is written through to the .noinit record on every change;
+ * a record with a bad magic or checksum (cold boot) is ignored.
+ *
+ * Part of BiiL Course: Embedded C for IoT - Week 7
+ ******************************************************************************/
+
+#include "wifi_link.h"
+#include "cy_pdl.h"
+
+#include <string.h>
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+#define LINK_RECORD_MAGIC       (0x574C4E4BUL)  /* "WLNK" */
+
+typedef struct
+{
+    uint32_t            magic;
+    wifi_link_profile_t profile;
+    uint32_t            check;
+} link_record_t;
+
+/*******************************************************************************
+ * Static Variables
+ ******************************************************************************/
+
+/* Survives warm resets (watchdog, fault, software reset) */
+CY_NOINIT static link_record_t record;
+
+static bool profile_valid = false;
+
+static bool reconnecting = false;
+static uint32_t down_ms = 0;        /* Link lost */
+static uint32_t next_ms = 0;        /* Next attempt */
+static uint32_t backoff_ms = 0;     /* Wait after the next failure */
+
+static wifi_link_stats_t stats;
+
+/*******************************************************************************
+ * Record
+ ******************************************************************************/
+static uint32_t profile_check(const wifi_link_profile_t *p)
+{
+    const uint8_t *b = (const uint8_t *)p;
+    uint32_t h = 2166136261UL;
+
+    for (uint32_t i = 0; i < sizeof(wifi_link_profile_t); i++)
+    {
+        h ^= b[i];
+        h *= 16777619UL;
+    }
+    return h;
+}
+
+static void record_write(void)
+{
+    record.magic = LINK_RECORD_MAGIC;
+    record.check = profile_check(&record.profile);
+}
+
+/* Wrap-safe: 0 if to_ms is not after from_ms */
+static uint32_t elapsed_ms(uint32_t from_ms, uint32_t to_ms)
+{
+    return ((int32_t)(to_ms - from_ms) > 0) ? (to_ms - from_ms) : 0U;
+}
+
+/*******************************************************************************
+ * Public Functions
+ ******************************************************************************/
+bool wifi_link_init(void)
+{
+    memset(&stats, 0, sizeof(stats));
+    reconnecting = false;
+
+    profile_valid = (record.magic == LINK_RECORD_MAGIC) &&
+                    (record.check == profile_check(&record.profile)) &&
+                    (record.profile.ssid[0] != '\0');
+    if (!profile_valid)
+    {
+        memset(&record, 0, sizeof(record));
+        return false;
+    }
+
+    /* Terminate strings a bad write may have left open */
+    record.profile.ssid[WIFI_SSID_MAX_LEN - 1] = '\0';
+    record.profile.password[WIFI_PASSWORD_MAX_LEN - 1] = '\0';
+    record_write();
+    return record.profile.auto_connect;
+}
+
+bool wifi_link_get_profile(wifi_link_profile_t *profile)
+{
+    if (!profile_valid)
+    {
+        return false;
+    }
+    memcpy(profile, &record.profile, sizeof(wifi_link_profile_t));
+    return true;
+}
+
+void wifi_link_save(const wifi_link_profile_t *profile)
+{
+    memcpy(&record.profile, profile, sizeof(wifi_link_profile_t));
+    record_write();
+    profile_valid = true;
+}
+
+void wifi_link_set_auto(bool on)
+{
+    if (profile_valid)
+    {
+        record.profile.auto_connect = on;
+        record_write();
+    }
+}
+
+void wifi_link_start(uint32_t since_ms, bool dropped)
+{
+    if (dropped)
+    {
+        stats.drops++;
+    }
+    reconnecting = true;
+    down_ms = since_ms;
+    next_ms = since_ms + WIFI_LINK_FIRST_DELAY_MS;
+    backoff_ms = WIFI_LINK_BACKOFF_MIN_MS;
+}
+
+void wifi_link_wcm_retry(uint32_t now_ms)
+{
+    uint32_t hold_ms = now_ms + WIFI_LINK_WCM_GRACE_MS;
+
+    if (reconnecting && (elapsed_ms(next_ms, hold_ms) > 0U))
+    {
+        next_ms = hold_ms;
+    }
+}
+
+void wifi_link_cancel(void)
+{
+    reconnecting = false;
+}
+
+bool wifi_link_reconnecting(void)
+{
+    return reconnecting;
+}
+
+bool wifi_link_due(uint32_t now_ms)
+{
+    return reconnecting && (elapsed_ms(now_ms, next_ms) == 0U);
+}
+
+uint32_t wifi_link_wait_ms(uint32_t now_ms)
+{
+    if (!reconnecting)
+    {
+        return UINT32_MAX;
+    }
+    return elapsed_ms(now_ms, next_ms);
+}
+
+uint32_t wifi_link_failed(uint32_t now_ms)
+{
+    uint32_t wait_ms = backoff_ms;
+
+    stats.attempts++;
+    next_ms = now_ms + wait_ms;
+
+    backoff_ms = (backoff_ms >= (WIFI_LINK_BACKOFF_MAX_MS / 2U)) ?
+                 WIFI_LINK_BACKOFF_MAX_MS : (backoff_ms * 2U);
+    return wait_ms;
+}
+
+void wifi_link_targeted(bool ok)
+{
+    if (ok)
+    {
+        stats.targeted_ok++;
+    }
+    else
+    {
+        stats.targeted_failed++;
+    }
+}
+
+void wifi_link_reconnected(uint32_t assoc_ms, uint32_t ip_ms)
+{
+    if (!reconnecting)
+    {
+        return;
+    }
+    reconnecting = false;
+
+    /* An association reported before this outage, or none, counts as
+     * happening together with the IP address */
+    if (((int32_t)(assoc_ms - down_ms) < 0) || ((int32_t)(assoc_ms - ip_ms) > 0))
+    {
+        assoc_ms = ip_ms;
+    }
+
+    stats.reconnects++;
+    stats.last_assoc_ms = elapsed_ms(down_ms, assoc_ms);
+    stats.last_ip_ms = elapsed_ms(down_ms, ip_ms);
+    if (stats.last_assoc_ms > stats.max_assoc_ms)
+    {
+        stats.max_assoc_ms = stats.last_assoc_ms;
+    }
+    if (stats.last_ip_ms > stats.max_ip_ms)
+    {
+        stats.max_ip_ms = stats.last_ip_ms;
+    }
+}
+
+void wifi_link_get_stats(wifi_link_stats_t *out)
+{
+    memcpy(out, &stats, sizeof(wifi_link_stats_t));
+}
@@ -0,0 +1,164 @@
+/*******************************************************************************
+ * File: wifi_link.h
+ * Description: WiFi reconnect manager for CM33-NS - Header
+ *
+ * Remembers the last network joined successfully (credentials, BSSID,
+ * channel, band) and drives reconnects when the link drops:
+ *
+ *   - The profile lives in a .noinit record with a checksum, so it
+ *     survives warm resets (watchdog, fault, software reset) and the
+ *     network is rejoined at boot without the UI.
+ *   - After a drop the first attempt follows WIFI_LINK_FIRST_DELAY_MS
+ *     later (or WIFI_LINK_WCM_GRACE_MS, if WCM started its own retry);
+ *     each failed attempt doubles the wait, from WIFI_LINK_BACKOFF_MIN_MS
+ *     up to WIFI_LINK_BACKOFF_MAX_MS.
+ *   - wifi_task tries the remembered AP first (BSSID and band given to
+ *     WCM, so no full scan), then falls back to a join by SSID.
+ *
+ * Time to reconnect (drop -> associated) and time to IP (drop -> IP
+ * address) are measured per reconnect.
+ *
+ * Not thread-safe: used by wifi_task only. Times are milliseconds of the
+ * FreeRTOS tick count, which keeps counting through tickless sleep; they
+ * wrap after 49 days and are compared as differences.
+ *
+ * Part of BiiL Course: Embedded C for IoT - Week 7
+ ******************************************************************************/
+
+#ifndef WIFI_LINK_H
+#define WIFI_LINK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../../shared/wifi_shared.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define WIFI_LINK_FIRST_DELAY_MS        (500U)
+#define WIFI_LINK_WCM_GRACE_MS          (5000U)     /* Room for WCM's own retry */
+#define WIFI_LINK_BACKOFF_MIN_MS        (1000U)
+#define WIFI_LINK_BACKOFF_MAX_MS        (60000U)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+
+/**
+ * @brief Last network joined successfully
+ */
+typedef struct
+{
+    char        ssid[WIFI_SSID_MAX_LEN];
+    char        password[WIFI_PASSWORD_MAX_LEN];
+    uint8_t     security;                   /* wifi_security_t, as requested */
+    uint8_t     bssid[WIFI_MAC_ADDR_LEN];   /* All zero = unknown */
+    uint8_t     channel;
+    uint8_t     band;                       /* wifi_band_t */
+    bool        auto_connect;               /* Off after a disconnect request */
+} wifi_link_profile_t;
+
+/**
+ * @brief Reconnect figures
+ */
+typedef struct
+{
+    uint32_t drops;                 /* Link lost while auto_connect was on */
+    uint32_t reconnects;
+    uint32_t attempts;              /* Failed attempts */
+    uint32_t targeted_ok;           /* Joins that went straight to the BSSID */
+    uint32_t targeted_failed;
+    uint32_t last_assoc_ms;         /* Drop -> associated */
+    uint32_t max_assoc_ms;
+    uint32_t last_ip_ms;            /* Drop -> IP address */
+    uint32_t max_ip_ms;
+} wifi_link_stats_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Check the record left by the previous boot
+ *
+ * @return true if a profile with auto_connect on was kept
+ */
+bool wifi_link_init(void);
+
+/**
+ * @brief Remembered profile
+ *
+ * @return false if none
+ */
+bool wifi_link_get_profile(wifi_link_profile_t *profile);
+
+/**
+ * @brief Remember a profile after a successful join
+ */
+void wifi_link_save(const wifi_link_profile_t *profile);
+
+/**
+ * @brief Turn rejoining the remembered network on or off
+ */
+void wifi_link_set_auto(bool on);
+
+/**
+ * @brief Start reconnecting
+ *
+ * @param since_ms  When the link went down (or boot)
+ * @param dropped   Count as a drop (false at boot)
+ */
+void wifi_link_start(uint32_t since_ms, bool dropped);
+
+/**
+ * @brief WCM started its own retry: hold off the next attempt
+ */
+void wifi_link_wcm_retry(uint32_t now_ms);
+
+/**
+ * @brief Stop reconnecting (a connect or disconnect request took over)
+ */
+void wifi_link_cancel(void);
+
+/**
+ * @brief True while reconnecting
+ */
+bool wifi_link_reconnecting(void);
+
+/**
+ * @brief True if the next attempt is due
+ */
+bool wifi_link_due(uint32_t now_ms);
+
+/**
+ * @brief Milliseconds until the next attempt (UINT32_MAX if none)
+ */
+uint32_t wifi_link_wait_ms(uint32_t now_ms);
+
+/**
+ * @brief An attempt failed: schedule the next one
+ *
+ * @return Wait before the next attempt, ms
+ */
+uint32_t wifi_link_failed(uint32_t now_ms);
+
+/**
+ * @brief Count a join to the remembered BSSID
+ */
+void wifi_link_targeted(bool ok);
+
+/**
+ * @brief The link is back: record the times and stop reconnecting
+ *
+ * @param assoc_ms  When WCM reported the association (before the drop =
+ *                  not seen)
+ * @param ip_ms     When the IP address was obtained
+ */
+void wifi_link_reconnected(uint32_t assoc_ms, uint32_t ip_ms);
+
+/**
+ * @brief Reconnect figures
+ */
+void wifi_link_get_stats(wifi_link_stats_t *stats);
+
+#endif /* WIFI_LINK_H */
@@ -0,0 +1,121 @@
+/*******************************************************************************
+ * File: wifi_link_quality.c
+ * Description: WiFi link-quality smoothing and change detection
+ *
+ * The RSSI average is kept in 1/16 dB, as in bt_scan_table.c, so the
+ * EWMA does not stall on integer rounding near the target.
+ *
+ * Part of BiiL Course: Embedded C for IoT - Week 7
+ ******************************************************************************/
+
+#include "wifi_link_quality.h"
+
+#include <string.h>
+
+/*******************************************************************************
+ * Static Variables
+ ******************************************************************************/
+static bool have_avg = false;
+static int32_t rssi_avg_q4 = 0;             /* dBm * 16 */
+
+static bool have_published = false;
+static wifi_link_quality_t published;       /* As last sent */
+static uint32_t published_ms = 0;
+
+static wifi_link_quality_t last;            /* Last sample, smoothed */
+
+/*******************************************************************************
+ * Helpers
+ ******************************************************************************/
+static int8_t rssi_avg_dbm(void)
+{
+    /* Round to nearest; the average is negative */
+    int32_t q = (rssi_avg_q4 < 0) ? (rssi_avg_q4 - 8) : (rssi_avg_q4 + 8);
+    return (int8_t)(q / 16);
+}
+
+static bool rate_changed(uint32_t from, uint32_t to)
+{
+    uint32_t diff = (to > from) ? (to - from) : (from - to);
+    return diff >= ((from / 4U) + 1U);
+}
+
+static bool significant(const wifi_link_quality_t *q, uint32_t now_ms)
+{
+    if (!have_published)
+    {
+        return true;
+    }
+
+    int32_t rssi_step = (int32_t)q->rssi - (int32_t)published.rssi;
+    if (rssi_step < 0)
+    {
+        rssi_step = -rssi_step;
+    }
+
+    return (q->state != published.state) ||
+           (q->channel != published.channel) ||
+           (q->band != published.band) ||
+           (q->security != published.security) ||
+           (rssi_step >= WIFI_LQ_RSSI_DELTA) ||
+           ((q->link_speed_kbps != published.link_speed_kbps) &&
+            rate_changed(published.link_speed_kbps, q->link_speed_kbps)) ||
+           ((now_ms - published_ms) >= WIFI_LQ_HEARTBEAT_MS);
+}
+
+/*******************************************************************************
+ * Public Functions
+ ******************************************************************************/
+void wifi_link_quality_reset(void)
+{
+    have_avg = false;
+    have_published = false;
+    memset(&last, 0, sizeof(last));
+}
+
+bool wifi_link_quality_sample(const wifi_link_quality_t *sample, uint32_t now_ms,
+                              wifi_link_quality_t *out)
+{
+    wifi_link_quality_t q;
+    memcpy(&q, sample, sizeof(q));
+
+    if (q.state == WIFI_STATE_CONNECTED)
+    {
+        int32_t raw_q4 = (int32_t)q.rssi_raw * 16;
+
+        if (!have_avg)
+        {
+            rssi_avg_q4 = raw_q4;
+            have_avg = true;
+        }
+        else
+        {
+            rssi_avg_q4 += (raw_q4 - rssi_avg_q4) / WIFI_LQ_RSSI_AVG_DIV;
+        }
+        q.rssi = rssi_avg_dbm();
+    }
+    else
+    {
+        /* Next connection starts a new average */
+        have_avg = false;
+        q.rssi = 0;
+    }
+    q.time_ms = now_ms;
+    memcpy(&last, &q, sizeof(last));
+
+    if (!significant(&q, now_ms))
+    {
+        return false;
+    }
+
+    memcpy(&published, &q, sizeof(published));
+    published_ms = now_ms;
+    have_published = true;
+    memcpy(out, &q, sizeof(q));
+    return true;
+}
+
+void wifi_link_quality_last(wifi_link_quality_t *out)
+{
+    memcpy(out, &last, sizeof(last));
+}
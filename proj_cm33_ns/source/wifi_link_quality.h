@@ -0,0 +1,66 @@
+/*******************************************************************************
+ * File: wifi_link_quality.h
+ * Description: WiFi link-quality smoothing and change detection - Header
+ *
+ * wifi_task samples the link (RSSI, channel, TX rate) every
+ * WIFI_LQ_SAMPLE_MS. A single RSSI reading jumps by several dB from one
+ * second to the next, so it is smoothed (EWMA, 1/WIFI_LQ_RSSI_AVG_DIV of
+ * each new reading) and a sample is published to CM55 only if:
+ *
+ *   - the state, channel, band or security changed,
+ *   - the smoothed RSSI moved WIFI_LQ_RSSI_DELTA dB from the last
+ *     published value,
+ *   - the TX rate changed by a quarter or more, or
+ *   - nothing was published for WIFI_LQ_HEARTBEAT_MS.
+ *
+ * The first reading after (re)connecting seeds the average, so the icon
+ * does not climb up from zero.
+ *
+ * No RTOS or WCM calls (wifi_task.c does the sampling and publishing);
+ * used by wifi_task only.
+ *
+ * Part of BiiL Course: Embedded C for IoT - Week 7
+ ******************************************************************************/
+
+#ifndef WIFI_LINK_QUALITY_H
+#define WIFI_LINK_QUALITY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../../shared/wifi_shared.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define WIFI_LQ_SAMPLE_MS               (1000U)
+#define WIFI_LQ_HEARTBEAT_MS            (10000U)
+#define WIFI_LQ_RSSI_DELTA              (3)     /* dB */
+#define WIFI_LQ_RSSI_AVG_DIV            (4)     /* EWMA weight 1/4 */
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Forget the average and the last published value
+ */
+void wifi_link_quality_reset(void);
+
+/**
+ * @brief Add one sample
+ *
+ * @param sample  Raw reading: state, rssi_raw (rssi is ignored), channel,
+ *                band, security, link_speed_kbps
+ * @param now_ms  Tick in ms
+ * @param out     Out: the value to publish (smoothed), when true
+ * @return true if the sample should be published
+ */
+bool wifi_link_quality_sample(const wifi_link_quality_t *sample, uint32_t now_ms,
+                              wifi_link_quality_t *out);
+
+/**
+ * @brief Last sample, smoothed, published or not
+ */
+void wifi_link_quality_last(wifi_link_quality_t *out);
+
+#endif /* WIFI_LINK_QUALITY_H */
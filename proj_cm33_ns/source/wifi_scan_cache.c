@@ -0,0 +1,382 @@
+/*******************************************************************************
+ * File: wifi_scan_cache.c
+ * Description: Persistent WiFi scan cache for CM33-NS
+ *
+ * APs live in a fixed pool; a bucket array indexed by an FNV-1a hash of
+ * the BSSID heads a chain through the pool, so a result finds its AP in
+ * one or two compares. When the pool is full the AP heard longest ago
+ * (weakest on a tie) makes room.
+ *
+ * Merged SSID entries hold what was last reported to CM55, so RSSI jitter
+ * below WIFI_SCAN_CACHE_RSSI_DELTA does not cause a resend.
+ *
+ * Part of BiiL Course: Embedded C for IoT - Week 7
+ ******************************************************************************/
+
+#include "wifi_scan_cache.h"
+
+#include <string.h>
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+#define CACHE_NONE          (0xFFU)
+
+typedef struct
+{
+    uint8_t             bssid[WIFI_MAC_ADDR_LEN];
+    uint8_t             next;           /* Bucket chain, CACHE_NONE = end */
+    bool                used;
+    uint32_t            last_seen;      /* Scan generation */
+    ipc_wifi_network_t  net;            /* As last heard */
+} cache_ap_t;
+
+typedef struct
+{
+    bool                used;
+    ipc_wifi_network_t  net;            /* As last reported */
+} cache_ssid_t;
+
+/*******************************************************************************
+ * Static Variables
+ ******************************************************************************/
+static cache_ap_t aps[WIFI_SCAN_CACHE_SIZE];
+static uint8_t buckets[WIFI_SCAN_CACHE_BUCKETS];
+static cache_ssid_t ssids[WIFI_SCAN_MAX_NETWORKS];
+
+static uint32_t changed = 0;            /* Bit per ssids[] entry */
+static uint32_t generation = 0;
+static char connected[WIFI_SSID_MAX_LEN] = "";
+static bool cache_ready = false;
+
+/*******************************************************************************
+ * AP Table
+ ******************************************************************************/
+static uint32_t bssid_hash(const uint8_t *bssid)
+{
+    uint32_t h = 2166136261UL;
+
+    for (uint32_t i = 0; i < WIFI_MAC_ADDR_LEN; i++)
+    {
+        h = (h ^ bssid[i]) * 16777619UL;
+    }
+    return h & (WIFI_SCAN_CACHE_BUCKETS - 1U);
+}
+
+static uint8_t ap_find(const uint8_t *bssid)
+{
+    uint8_t i = buckets[bssid_hash(bssid)];
+
+    while (i != CACHE_NONE)
+    {
+        if (memcmp(aps[i].bssid, bssid, WIFI_MAC_ADDR_LEN) == 0)
+        {
+            return i;
+        }
+        i = aps[i].next;
+    }
+    return CACHE_NONE;
+}
+
+static void ap_remove(uint8_t index)
+{
+    uint8_t *link = &buckets[bssid_hash(aps[index].bssid)];
+
+    while (*link != CACHE_NONE)
+    {
+        if (*link == index)
+        {
+            *link = aps[index].next;
+            break;
+        }
+        link = &aps[*link].next;
+    }
+    memset(&aps[index], 0, sizeof(cache_ap_t));
+}
+
+/* Free slot, or the AP heard longest ago (weakest on a tie) to replace */
+static uint8_t ap_alloc(void)
+{
+    uint8_t victim = 0;
+
+    for (uint8_t i = 0; i < WIFI_SCAN_CACHE_SIZE; i++)
+    {
+        if (!aps[i].used)
+        {
+            return i;
+        }
+        if ((aps[i].last_seen < aps[victim].last_seen) ||
+            ((aps[i].last_seen == aps[victim].last_seen) &&
+             (aps[i].net.rssi < aps[victim].net.rssi)))
+        {
+            victim = i;
+        }
+    }
+    return victim;
+}
+
+/*******************************************************************************
+ * Merged SSID List
+ ******************************************************************************/
+static int ssid_find(const char *ssid)
+{
+    for (int i = 0; i < (int)WIFI_SCAN_MAX_NETWORKS; i++)
+    {
+        if (ssids[i].used && (strcmp(ssids[i].net.ssid, ssid) == 0))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* Best AP of an SSID; false if the SSID has none left */
+static bool ssid_merge(const char *ssid, ipc_wifi_network_t *out)
+{
+    uint8_t count = 0;
+
+    for (uint32_t i = 0; i < WIFI_SCAN_CACHE_SIZE; i++)
+    {
+        if (!aps[i].used || (strcmp(aps[i].net.ssid, ssid) != 0))
+        {
+            continue;
+        }
+        if ((count == 0) || (aps[i].net.rssi > out->rssi))
+        {
+            *out = aps[i].net;
+        }
+        count++;
+    }
+
+    if (count == 0)
+    {
+        return false;
+    }
+
+    out->flags = (strcmp(ssid, connected) == 0) ? 0x01 : 0x00;
+    out->ap_count = count;
+    out->reserved = 0;
+    return true;
+}
+
+static bool worth_reporting(const ipc_wifi_network_t *sent, const ipc_wifi_network_t *now)
+{
+    int diff = (int)now->rssi - (int)sent->rssi;
+
+    return (diff >= WIFI_SCAN_CACHE_RSSI_DELTA) ||
+           (diff <= -WIFI_SCAN_CACHE_RSSI_DELTA) ||
+           (now->security != sent->security) ||
+           (now->channel != sent->channel) ||
+           (now->band != sent->band) ||
+           (now->flags != sent->flags) ||
+           (now->ap_count != sent->ap_count);
+}
+
+/* Bring the merged entry of one SSID up to date with the AP table */
+static void ssid_refresh(const char *ssid)
+{
+    ipc_wifi_network_t now;
+    int slot = ssid_find(ssid);
+
+    if (!ssid_merge(ssid, &now))
+    {
+        if (slot >= 0)
+        {
+            /* Reported once more with an empty SSID: entry removed */
+            memset(&ssids[slot], 0, sizeof(cache_ssid_t));
+            changed |= (1UL << slot);
+        }
+        return;
+    }
+
+    if (slot >= 0)
+    {
+        if (worth_reporting(&ssids[slot].net, &now))
+        {
+            ssids[slot].net = now;
+            changed |= (1UL << slot);
+        }
+        return;
+    }
+
+    /* New SSID: free entry, or replace the weakest if this one is stronger */
+    int weakest = -1;
+    for (int i = 0; i < (int)WIFI_SCAN_MAX_NETWORKS; i++)
+    {
+        if (!ssids[i].used)
+        {
+            slot = i;
+            break;
+        }
+        if ((weakest < 0) || (ssids[i].net.rssi < ssids[weakest].net.rssi))
+        {
+            weakest = i;
+        }
+    }
+    if ((slot < 0) && (weakest >= 0) && (now.rssi > ssids[weakest].net.rssi) &&
+        ((ssids[weakest].net.flags & 0x01) == 0))
+    {
+        slot = weakest;
+    }
+    if (slot < 0)
+    {
+        return;
+    }
+
+    ssids[slot].used = true;
+    ssids[slot].net = now;
+    changed |= (1UL << slot);
+}
+
+/*******************************************************************************
+ * Public Functions
+ ******************************************************************************/
+void wifi_scan_cache_begin(const char *connected_ssid)
+{
+    if (!cache_ready)
+    {
+        memset(buckets, CACHE_NONE, sizeof(buckets));
+        cache_ready = true;
+    }
+
+    generation++;
+
+    strncpy(connected, (connected_ssid != NULL) ? connected_ssid : "",
+            WIFI_SSID_MAX_LEN - 1);
+    connected[WIFI_SSID_MAX_LEN - 1] = '\0';
+
+    /* The connected flag may have moved since the last scan */
+    for (int i = 0; i < (int)WIFI_SCAN_MAX_NETWORKS; i++)
+    {
+        if (!ssids[i].used)
+        {
+            continue;
+        }
+        uint8_t flags = (strcmp(ssids[i].net.ssid, connected) == 0) ? 0x01 : 0x00;
+        if (ssids[i].net.flags != flags)
+        {
+            ssids[i].net.flags = flags;
+            changed |= (1UL << i);
+        }
+    }
+}
+
+bool wifi_scan_cache_add(const uint8_t *bssid, const ipc_wifi_network_t *net)
+{
+    char old_ssid[WIFI_SSID_MAX_LEN] = "";
+
+    if (!cache_ready || (bssid == NULL) || (net == NULL) || (net->ssid[0] == '\0'))
+    {
+        return false;
+    }
+
+    uint8_t i = ap_find(bssid);
+    if (i == CACHE_NONE)
+    {
+        i = ap_alloc();
+        if (aps[i].used)
+        {
+            /* Evicted: its SSID may have lost its best AP */
+            memcpy(old_ssid, aps[i].net.ssid, WIFI_SSID_MAX_LEN);
+            ap_remove(i);
+        }
+
+        uint32_t b = bssid_hash(bssid);
+        memcpy(aps[i].bssid, bssid, WIFI_MAC_ADDR_LEN);
+        aps[i].next = buckets[b];
+        aps[i].used = true;
+        buckets[b] = i;
+    }
+    else if (strcmp(aps[i].net.ssid, net->ssid) != 0)
+    {
+        /* AP renamed (e.g. hidden SSID revealed) */
+        memcpy(old_ssid, aps[i].net.ssid, WIFI_SSID_MAX_LEN);
+    }
+
+    aps[i].net = *net;
+    aps[i].last_seen = generation;
+
+    if ((old_ssid[0] != '\0') && (strcmp(old_ssid, net->ssid) != 0))
+    {
+        ssid_refresh(old_ssid);
+    }
+    ssid_refresh(net->ssid);
+
+    return (changed != 0);
+}
+
+void wifi_scan_cache_end(bool completed)
+{
+    if (!cache_ready || !completed)
+    {
+        return;
+    }
+
+    for (uint8_t i = 0; i < WIFI_SCAN_CACHE_SIZE; i++)
+    {
+        if (aps[i].used && ((generation - aps[i].last_seen) >= WIFI_SCAN_CACHE_MAX_AGE))
+        {
+            ap_remove(i);
+        }
+    }
+
+    for (int i = 0; i < (int)WIFI_SCAN_MAX_NETWORKS; i++)
+    {
+        if (ssids[i].used)
+        {
+            char ssid[WIFI_SSID_MAX_LEN];
+            memcpy(ssid, ssids[i].net.ssid, WIFI_SSID_MAX_LEN);
+            ssid_refresh(ssid);
+        }
+    }
+}
+
+uint32_t wifi_scan_cache_take_changes(ipc_wifi_network_t *out)
+{
+    uint32_t mask = changed;
+
+    for (uint32_t i = 0; i < WIFI_SCAN_MAX_NETWORKS; i++)
+    {
+        if (mask & (1UL << i))
+        {
+            out[i] = ssids[i].net;
+        }
+    }
+
+    changed = 0;
+    return mask;
+}
+
+void wifi_scan_cache_mark_all(void)
+{
+    /* Unused entries go out empty, clearing anything stale on CM55 */
+    changed = (1UL << WIFI_SCAN_MAX_NETWORKS) - 1U;
+}
+
+uint32_t wifi_scan_cache_count(void)
+{
+    uint32_t count = 0;
+
+    for (uint32_t i = 0; i < WIFI_SCAN_MAX_NETWORKS; i++)
+    {
+        if (ssids[i].used)
+        {
+            count = i + 1U;
+        }
+    }
+    return count;
+}
+
+uint32_t wifi_scan_cache_ap_count(void)
+{
+    uint32_t count = 0;
+
+    for (uint32_t i = 0; i < WIFI_SCAN_CACHE_SIZE; i++)
+    {
+        if (aps[i].used)
+        {
+            count++;
+        }
+    }
+    return count;
+}
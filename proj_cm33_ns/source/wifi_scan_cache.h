@@ -0,0 +1,87 @@
+/*******************************************************************************
+ * File: wifi_scan_cache.h
+ * Description: Persistent WiFi scan cache for CM33-NS - Header
+ *
+ * Keeps every AP heard in recent scans, keyed by BSSID in a small hash
+ * table, and merges them per SSID into the list shown on CM55: one entry
+ * per SSID with the best RSSI of its APs (and that AP's channel/band).
+ *
+ * The merged list has stable indexes across scans (msg.value of
+ * IPC_CMD_WIFI_SCAN_RESULT), and only entries that changed since they were
+ * last reported are sent: a new SSID, a different channel/security/flags,
+ * or an RSSI step of WIFI_SCAN_CACHE_RSSI_DELTA dB or more. An AP missing
+ * from WIFI_SCAN_CACHE_MAX_AGE completed scans is dropped; an SSID left
+ * without APs is reported once with an empty SSID (entry removed).
+ *
+ * Not thread-safe: wifi_task.c calls it in critical sections, from both
+ * the WCM scan callback and wifi_task.
+ *
+ * Part of BiiL Course: Embedded C for IoT - Week 7
+ ******************************************************************************/
+
+#ifndef WIFI_SCAN_CACHE_H
+#define WIFI_SCAN_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../../shared/wifi_shared.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define WIFI_SCAN_CACHE_SIZE            (32U)   /* APs (BSSIDs) kept */
+#define WIFI_SCAN_CACHE_BUCKETS         (32U)   /* Power of 2 */
+#define WIFI_SCAN_CACHE_MAX_AGE         (3U)    /* Scans an unseen AP is kept */
+#define WIFI_SCAN_CACHE_RSSI_DELTA      (4)     /* dB change worth reporting */
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Start a scan
+ *
+ * @param connected_ssid  SSID to flag as connected, or "" / NULL
+ */
+void wifi_scan_cache_begin(const char *connected_ssid);
+
+/**
+ * @brief Record one scan result
+ *
+ * @param bssid  AP MAC address (WIFI_MAC_ADDR_LEN bytes)
+ * @param net    Result as heard (flags and ap_count are ignored)
+ * @return true if the merged list has changes to send
+ */
+bool wifi_scan_cache_add(const uint8_t *bssid, const ipc_wifi_network_t *net);
+
+/**
+ * @brief End a scan; ages out APs if it completed
+ *
+ * @param completed  false after a timeout (the scan saw only part of the air)
+ */
+void wifi_scan_cache_end(bool completed);
+
+/**
+ * @brief Take the merged entries changed since the last call
+ *
+ * @param out  WIFI_SCAN_MAX_NETWORKS entries, out[i] is filled for each set bit i
+ * @return Bit mask of changed entries
+ */
+uint32_t wifi_scan_cache_take_changes(ipc_wifi_network_t *out);
+
+/**
+ * @brief Mark every entry changed, to resend the whole list
+ */
+void wifi_scan_cache_mark_all(void);
+
+/**
+ * @brief Merged entries in use, as an index bound (highest index + 1)
+ */
+uint32_t wifi_scan_cache_count(void);
+
+/**
+ * @brief APs (BSSIDs) in the cache
+ */
+uint32_t wifi_scan_cache_ap_count(void);
+
+#endif /* WIFI_SCAN_CACHE_H */
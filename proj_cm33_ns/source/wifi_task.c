@@ -5,9 +5,13 @@
  * Implements WiFi infrastructure on CM33-NS core:
  * - SDIO interface initialization for CYW55513 WiFi+BLE combo chip
  * - WiFi Connection Manager (cy_wcm) initialization
- * - WiFi scan with results sent back to CM55 via IPC
+ * - WiFi scan with results streamed to CM55 via IPC as they are found
  * - WiFi connect/disconnect with status via IPC
  * - WiFi status and TCP/IP info queries
+ * - Command queue by priority class (wifi_cmd_queue.c): queries are
+ *   answered during a scan, and a connect/disconnect cancels the scan
+ * - Reconnect after a link drop or warm reset (wifi_link.c), targeted at
+ *   the remembered AP first, with exponential backoff
  *
  * Based on: PSOC_Edge_Wi-Fi_Scan reference project (scan_task.c)
  *
@@ -15,11 +19,22 @@
  ******************************************************************************/
 
 #include "wifi_task.h"
+#include "wifi_scan_cache.h"
+#include "wifi_cmd_queue.h"
+#include "wifi_link.h"
+#include "wifi_link_quality.h"
 #include "cybsp.h"
 #include "cy_wcm.h"
 #include "retarget_io_init.h"
 #include "../../shared/wifi_shared.h"
+#include "../../shared/wifi_link_shared.h"
 #include "../ipc/cm33_ipc_pipe.h"
+#include "../../shared/include/static_mem.h"
+#include "../../shared/include/lat_trace.h"
+#include "../../shared/include/tick_clock.h"
+#include "sntp_client.h"
+#include "whd_wifi_api.h"
+#include "whd_wlioctl.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -44,12 +59,15 @@
  * Static Variables
  ******************************************************************************/
 
-/* FreeRTOS command queue */
-static QueueHandle_t wifi_cmd_queue = NULL;
-
-/* Task handle for scan completion notification */
+/* Task handle for command and scan notifications; set once the command
+ * queue (wifi_cmd_queue.c, used in critical sections) is ready */
 static TaskHandle_t wifi_task_handle = NULL;
 
+/* Commands served, and the count at the last stats print */
+static uint32_t cmd_served = 0;
+static uint32_t cmd_served_printed = 0;
+static uint32_t cmd_stats_tick = 0;
+
 /* SDIO and WCM instances */
 static mtb_hal_sdio_t sdio_instance;
 static cy_stc_sd_host_context_t sdhc_host_context;
@@ -57,15 +75,30 @@ static cy_wcm_config_t wcm_config;
 
 /* Forward declarations */
 static void handle_ntp_sync(void);
+static bool cmd_take(wifi_cmd_class_t max_class, ipc_msg_t *msg, uint32_t *queued_us);
+static void run_wifi_command(const ipc_msg_t *msg, uint32_t queued_us);
 
 /* WiFi state */
 static bool wifi_initialized = false;
 static wifi_state_t wifi_state = WIFI_STATE_DISCONNECTED;
 static char connected_ssid[WIFI_SSID_MAX_LEN] = "";
 
-/* Scan result buffer */
-static ipc_wifi_network_t scan_results[WIFI_SCAN_MAX_RESULTS];
-static volatile uint32_t scan_result_count = 0;
+/* Scan results go to the scan cache (wifi_scan_cache.c), written by the
+ * WCM thread (scan callback) and read by wifi_task in critical sections */
+static volatile bool scan_active = false;   /* Callback may add results */
+
+/* Link events from the WCM thread (event callback), read by wifi_task in
+ * critical sections; times are link_now_ms() */
+static bool link_down_seen = false;
+static bool link_retry_seen = false;        /* WCM started its own retry */
+static uint32_t link_down_ms = 0;
+static uint32_t link_assoc_ms = 0;          /* Last association */
+
+/* wifi_task notification bits */
+#define WIFI_SCAN_EVT_RESULT    (1UL << 0)
+#define WIFI_SCAN_EVT_DONE      (1UL << 1)
+#define WIFI_TASK_EVT_CMD       (1UL << 2)  /* Command queued */
+#define WIFI_TASK_EVT_LINK      (1UL << 3)  /* Link event */
 
 #if (CY_CFG_PWR_SYS_IDLE_MODE == CY_CFG_PWR_MODE_DEEPSLEEP)
 /* SysPm callback for SDHC deep sleep */
@@ -235,6 +268,9 @@ static uint8_t map_channel_to_band(uint16_t channel)
 /*******************************************************************************
  * Scan Callback - Called for each AP found
  * Runs in WCM internal thread context
+ *
+ * The scan cache merges the APs per SSID; when that changes an entry
+ * wifi_task is woken to stream it.
  ******************************************************************************/
 static void wifi_scan_callback(cy_wcm_scan_result_t *result_ptr,
                                 void *user_data,
@@ -244,24 +280,32 @@ static void wifi_scan_callback(cy_wcm_scan_result_t *result_ptr,
 
     if ((result_ptr != NULL) && (status == CY_WCM_SCAN_INCOMPLETE))
     {
-        /* Check SSID is valid and we have room */
+        /* Check SSID is valid */
         uint8_t ssid_len = strlen((const char *)result_ptr->SSID);
-        if ((ssid_len > 0) && (scan_result_count < WIFI_SCAN_MAX_RESULTS))
+        if ((ssid_len == 0) || !scan_active)
         {
-            ipc_wifi_network_t *net = &scan_results[scan_result_count];
-            memset(net, 0, sizeof(ipc_wifi_network_t));
-
-            /* Copy network info */
-            strncpy(net->ssid, (const char *)result_ptr->SSID,
-                    WIFI_SSID_MAX_LEN - 1);
-            net->ssid[WIFI_SSID_MAX_LEN - 1] = '\0';
-            net->rssi = (int8_t)result_ptr->signal_strength;
-            net->security = map_wcm_security(result_ptr->security);
-            net->channel = (uint8_t)result_ptr->channel;
-            net->band = map_channel_to_band(result_ptr->channel);
-            net->flags = 0;
-
-            scan_result_count++;
+            return;
+        }
+
+        /* Build the entry outside the critical section */
+        ipc_wifi_network_t found;
+        memset(&found, 0, sizeof(ipc_wifi_network_t));
+        strncpy(found.ssid, (const char *)result_ptr->SSID,
+                WIFI_SSID_MAX_LEN - 1);
+        found.ssid[WIFI_SSID_MAX_LEN - 1] = '\0';
+        found.rssi = (int8_t)result_ptr->signal_strength;
+        found.security = map_wcm_security(result_ptr->security);
+        found.channel = (uint8_t)result_ptr->channel;
+        found.band = map_channel_to_band(result_ptr->channel);
+        found.flags = 0;
+
+        taskENTER_CRITICAL();
+        bool changed = wifi_scan_cache_add(result_ptr->BSSID, &found);
+        taskEXIT_CRITICAL();
+
+        if (changed && (wifi_task_handle != NULL))
+        {
+            xTaskNotify(wifi_task_handle, WIFI_SCAN_EVT_RESULT, eSetBits);
         }
     }
 
@@ -270,59 +314,75 @@ static void wifi_scan_callback(cy_wcm_scan_result_t *result_ptr,
         /* Notify wifi_task that scan is done */
         if (wifi_task_handle != NULL)
         {
-            xTaskNotifyGive(wifi_task_handle);
+            xTaskNotify(wifi_task_handle, WIFI_SCAN_EVT_DONE, eSetBits);
         }
     }
 }
 
 /*******************************************************************************
- * Send Scan Results via IPC (one per message)
+ * Send New/Updated Scan Results via IPC (one per message)
+ *
+ * msg.value is the entry index: CM55 replaces the entry it already has
+ * under that index, so an updated network never shows twice.
  ******************************************************************************/
-static void send_scan_results_via_ipc(void)
+static void send_dirty_scan_results(void)
 {
-    /* Mark connected network in scan results */
-    if (cy_wcm_is_connected_to_ap() && connected_ssid[0] != '\0')
+    ipc_wifi_network_t batch[WIFI_SCAN_MAX_NETWORKS];
+    uint32_t dirty;
+
+    /* Snapshot the changed entries; the callback keeps adding meanwhile */
+    taskENTER_CRITICAL();
+    dirty = wifi_scan_cache_take_changes(batch);
+    taskEXIT_CRITICAL();
+
+    for (uint32_t i = 0; i < WIFI_SCAN_MAX_NETWORKS; i++)
     {
-        for (uint32_t i = 0; i < scan_result_count; i++)
+        if ((dirty & (1UL << i)) == 0)
         {
-            if (strcmp(scan_results[i].ssid, connected_ssid) == 0)
-            {
-                scan_results[i].flags |= 0x01;  /* Mark as connected */
-                break;
-            }
+            continue;
         }
-    }
 
-    /* Send each network as a separate IPC message */
-    for (uint32_t i = 0; i < scan_result_count; i++)
-    {
         ipc_msg_t msg;
         IPC_MSG_INIT(&msg, IPC_CMD_WIFI_SCAN_RESULT);
         msg.value = i;  /* Network index */
 
         /* Copy network info into IPC data payload */
-        memcpy(msg.data, &scan_results[i], sizeof(ipc_wifi_network_t));
+        memcpy(msg.data, &batch[i], sizeof(ipc_wifi_network_t));
 
         cm33_ipc_send_retry(&msg, 0);
 
         /* Delay between sends to avoid single-buffer overwrite on CM55 */
-        vTaskDelay(pdMS_TO_TICKS(20));
+        vTaskDelay(pdMS_TO_TICKS(WIFI_SCAN_SEND_GAP_MS));
     }
+}
+
+/*******************************************************************************
+ * Send Scan Complete via IPC
+ ******************************************************************************/
+static void send_scan_complete_via_ipc(void)
+{
+    uint32_t count;
+    uint32_t aps;
+
+    taskENTER_CRITICAL();
+    count = wifi_scan_cache_count();
+    aps = wifi_scan_cache_ap_count();
+    taskEXIT_CRITICAL();
 
-    /* Send scan complete with total count */
+    /* Send scan complete with the list size (highest index + 1) */
     ipc_msg_t done_msg;
     IPC_MSG_INIT(&done_msg, IPC_CMD_WIFI_SCAN_COMPLETE);
-    done_msg.value = scan_result_count;
+    done_msg.value = count;
     cm33_ipc_send_retry(&done_msg, 0);
 
-    printf("[CM33-WiFi] Scan complete: %u networks found\r\n",
-           (unsigned int)scan_result_count);
+    printf("[CM33-WiFi] Scan complete: %u networks, %u APs cached\r\n",
+           (unsigned int)count, (unsigned int)aps);
 }
 
 /*******************************************************************************
  * Handle WiFi Scan Command
  ******************************************************************************/
-static void handle_wifi_scan(void)
+static void handle_wifi_scan(bool full)
 {
     if (!wifi_initialized)
     {
@@ -332,14 +392,26 @@ static void handle_wifi_scan(void)
     }
 
     wifi_state = WIFI_STATE_SCANNING;
-    scan_result_count = 0;
-    memset(scan_results, 0, sizeof(scan_results));
+
+    /* Cached networks stay; only changes since the last scan are sent */
+    taskENTER_CRITICAL();
+    wifi_scan_cache_begin(cy_wcm_is_connected_to_ap() ? connected_ssid : "");
+    if (full)
+    {
+        wifi_scan_cache_mark_all();
+    }
+    taskEXIT_CRITICAL();
+
+    /* Drop stale scan bits from an earlier scan (a command bit stays) */
+    (void)xTaskNotifyWait(0, WIFI_SCAN_EVT_RESULT | WIFI_SCAN_EVT_DONE, NULL, 0);
+    scan_active = true;
 
     printf("[CM33-WiFi] Starting WiFi scan...\r\n");
 
     cy_rslt_t result = cy_wcm_start_scan(wifi_scan_callback, NULL, NULL);
     if (CY_RSLT_SUCCESS != result)
     {
+        scan_active = false;
         printf("[CM33-WiFi] Scan start failed: 0x%08X\r\n",
                (unsigned int)result);
         wifi_state = WIFI_STATE_DISCONNECTED;
@@ -347,16 +419,72 @@ static void handle_wifi_scan(void)
         return;
     }
 
-    /* Wait for scan completion (max 10 seconds) */
-    uint32_t notified = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10000));
-    if (notified == 0)
+    /* Stream results while the scan runs (max 10 seconds). The first
+     * result of a batch opens a WIFI_SCAN_COALESCE_MS window so nearby
+     * APs found together go out together. Queries that arrive meanwhile
+     * are answered at once; a connect or disconnect ends the scan. */
+    TickType_t start = xTaskGetTickCount();
+    TickType_t timeout = pdMS_TO_TICKS(WIFI_SCAN_TIMEOUT_MS);
+    bool done = false;
+
+    while (!done)
     {
-        printf("[CM33-WiFi] Scan timeout\r\n");
-        cy_wcm_stop_scan();
+        TickType_t elapsed = xTaskGetTickCount() - start;
+        uint32_t events = 0;
+
+        if ((elapsed >= timeout) ||
+            (xTaskNotifyWait(0, UINT32_MAX, &events, timeout - elapsed) == pdFALSE))
+        {
+            printf("[CM33-WiFi] Scan timeout\r\n");
+            cy_wcm_stop_scan();
+            break;
+        }
+
+        if (events & WIFI_TASK_EVT_CMD)
+        {
+            ipc_msg_t query;
+            uint32_t queued_us;
+
+            while (cmd_take(WIFI_CMD_CLASS_QUERY, &query, &queued_us))
+            {
+                run_wifi_command(&query, queued_us);
+            }
+
+            taskENTER_CRITICAL();
+            bool link_pending = wifi_cmd_queue_pending(WIFI_CMD_CLASS_LINK);
+            if (link_pending)
+            {
+                wifi_cmd_queue_cancelled(IPC_CMD_WIFI_SCAN_START);
+            }
+            taskEXIT_CRITICAL();
+
+            if (link_pending)
+            {
+                printf("[CM33-WiFi] Scan cancelled by connect/disconnect\r\n");
+                cy_wcm_stop_scan();
+                break;
+            }
+        }
+
+        if (events & WIFI_SCAN_EVT_DONE)
+        {
+            done = true;
+        }
+        else if (events & WIFI_SCAN_EVT_RESULT)
+        {
+            vTaskDelay(pdMS_TO_TICKS(WIFI_SCAN_COALESCE_MS));
+        }
+
+        send_dirty_scan_results();
     }
 
-    /* Send results back to CM55 via IPC */
-    send_scan_results_via_ipc();
+    /* Age out APs not heard lately; send what changed last, then the count */
+    scan_active = false;
+    taskENTER_CRITICAL();
+    wifi_scan_cache_end(done);
+    taskEXIT_CRITICAL();
+    send_dirty_scan_results();
+    send_scan_complete_via_ipc();
 
     /* Restore state */
     if (cy_wcm_is_connected_to_ap())
@@ -369,6 +497,134 @@ static void handle_wifi_scan(void)
     }
 }
 
+/*******************************************************************************
+ * Join an AP
+ *
+ * A targeted join goes straight to the remembered BSSID on its band; a
+ * join by SSID has WCM scan every channel for the network first. WCM's
+ * connect API takes no channel, so BSSID + band is as narrow as it gets.
+ ******************************************************************************/
+static cy_wcm_security_t map_security_to_wcm(uint8_t security)
+{
+    switch (security)
+    {
+        case WIFI_SECURITY_OPEN:
+            return CY_WCM_SECURITY_OPEN;
+        case WIFI_SECURITY_WPA2:
+            return CY_WCM_SECURITY_WPA2_AES_PSK;
+        case WIFI_SECURITY_WPA3:
+            return CY_WCM_SECURITY_WPA3_SAE;
+        case WIFI_SECURITY_WPA2_WPA3:
+            return CY_WCM_SECURITY_WPA3_WPA2_PSK;
+        default:
+            return CY_WCM_SECURITY_WPA2_AES_PSK;
+    }
+}
+
+static bool profile_has_bssid(const wifi_link_profile_t *p)
+{
+    for (uint32_t i = 0; i < WIFI_MAC_ADDR_LEN; i++)
+    {
+        if (p->bssid[i] != 0U)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static cy_rslt_t link_join(const wifi_link_profile_t *p, bool targeted,
+                           cy_wcm_ip_address_t *ip_addr)
+{
+    cy_wcm_connect_params_t connect_params;
+    memset(&connect_params, 0, sizeof(connect_params));
+
+    strncpy((char *)connect_params.ap_credentials.SSID,
+            p->ssid, CY_WCM_MAX_SSID_LEN - 1);
+    strncpy((char *)connect_params.ap_credentials.password,
+            p->password, CY_WCM_MAX_PASSPHRASE_LEN - 1);
+    connect_params.ap_credentials.security = map_security_to_wcm(p->security);
+    connect_params.band = CY_WCM_WIFI_BAND_ANY;
+
+    if (targeted)
+    {
+        memcpy(connect_params.BSSID, p->bssid, WIFI_MAC_ADDR_LEN);
+        if (p->band == WIFI_BAND_2_4GHZ)
+        {
+            connect_params.band = CY_WCM_WIFI_BAND_2_4GHZ;
+        }
+        else if (p->band == WIFI_BAND_5GHZ)
+        {
+            connect_params.band = CY_WCM_WIFI_BAND_5GHZ;
+        }
+    }
+
+    return cy_wcm_connect_ap(&connect_params, ip_addr);
+}
+
+/* Reconnect clock (wifi_link.h): tick count in ms, counts through sleep */
+static uint32_t link_now_ms(void)
+{
+    return (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
+}
+
+/* Targeted join if the AP is known, then by SSID */
+static cy_rslt_t link_connect(const wifi_link_profile_t *p, cy_wcm_ip_address_t *ip_addr)
+{
+    if (profile_has_bssid(p))
+    {
+        uint32_t start_ms = link_now_ms();
+        cy_rslt_t result = link_join(p, true, ip_addr);
+        uint32_t join_ms = link_now_ms() - start_ms;
+
+        wifi_link_targeted(result == CY_RSLT_SUCCESS);
+        if (CY_RSLT_SUCCESS == result)
+        {
+            printf("[CM33-WiFi] Joined %02X:%02X:%02X:%02X:%02X:%02X (ch %u) in %lu ms\r\n",
+                   p->bssid[0], p->bssid[1], p->bssid[2], p->bssid[3], p->bssid[4],
+                   p->bssid[5], (unsigned int)p->channel, (unsigned long)join_ms);
+            return result;
+        }
+        printf("[CM33-WiFi] Targeted join failed: 0x%08X after %lu ms, trying by SSID\r\n",
+               (unsigned int)result, (unsigned long)join_ms);
+    }
+
+    return link_join(p, false, ip_addr);
+}
+
+/* Remember the AP just joined, for the next targeted join */
+static void link_remember(wifi_link_profile_t *p)
+{
+    cy_wcm_associated_ap_info_t ap;
+
+    if (CY_RSLT_SUCCESS == cy_wcm_get_associated_ap_info(&ap))
+    {
+        memcpy(p->bssid, ap.BSSID, WIFI_MAC_ADDR_LEN);
+        p->channel = (uint8_t)ap.channel;
+        p->band = map_channel_to_band(ap.channel);
+    }
+    p->auto_connect = true;
+    wifi_link_save(p);
+}
+
+static void send_connected(const char *ssid, const cy_wcm_ip_address_t *ip_addr)
+{
+    ipc_msg_t resp;
+    IPC_MSG_INIT(&resp, IPC_CMD_WIFI_CONNECTED);
+
+    ipc_wifi_status_t status;
+    memset(&status, 0, sizeof(status));
+    status.state = WIFI_STATE_CONNECTED;
+    strncpy(status.ssid, ssid, WIFI_SSID_MAX_LEN - 1);
+    status.ip_addr[0] = (uint8_t)(ip_addr->ip.v4);
+    status.ip_addr[1] = (uint8_t)(ip_addr->ip.v4 >> 8);
+    status.ip_addr[2] = (uint8_t)(ip_addr->ip.v4 >> 16);
+    status.ip_addr[3] = (uint8_t)(ip_addr->ip.v4 >> 24);
+
+    memcpy(resp.data, &status, sizeof(ipc_wifi_status_t));
+    cm33_ipc_send_retry(&resp, 0);
+}
+
 /*******************************************************************************
  * Handle WiFi Connect Command
  ******************************************************************************/
@@ -385,39 +641,26 @@ static void handle_wifi_connect(const ipc_msg_t *cmd_msg)
 
     printf("[CM33-WiFi] Connecting to '%s'...\r\n", conn->ssid);
     wifi_state = WIFI_STATE_CONNECTING;
+    wifi_link_cancel();
 
-    /* Prepare WCM connect parameters */
-    cy_wcm_connect_params_t connect_params;
-    memset(&connect_params, 0, sizeof(connect_params));
+    wifi_link_profile_t profile;
+    wifi_link_profile_t known;
+    memset(&profile, 0, sizeof(profile));
+    strncpy(profile.ssid, conn->ssid, WIFI_SSID_MAX_LEN - 1);
+    strncpy(profile.password, conn->password, WIFI_PASSWORD_MAX_LEN - 1);
+    profile.security = conn->security;
 
-    strncpy((char *)connect_params.ap_credentials.SSID,
-            conn->ssid, CY_WCM_MAX_SSID_LEN - 1);
-    strncpy((char *)connect_params.ap_credentials.password,
-            conn->password, CY_WCM_MAX_PASSPHRASE_LEN - 1);
-
-    /* Map our security enum back to WCM security */
-    switch (conn->security)
+    /* The remembered network again: start with its AP */
+    if (wifi_link_get_profile(&known) && (strcmp(known.ssid, profile.ssid) == 0))
     {
-        case WIFI_SECURITY_OPEN:
-            connect_params.ap_credentials.security = CY_WCM_SECURITY_OPEN;
-            break;
-        case WIFI_SECURITY_WPA2:
-            connect_params.ap_credentials.security = CY_WCM_SECURITY_WPA2_AES_PSK;
-            break;
-        case WIFI_SECURITY_WPA3:
-            connect_params.ap_credentials.security = CY_WCM_SECURITY_WPA3_SAE;
-            break;
-        case WIFI_SECURITY_WPA2_WPA3:
-            connect_params.ap_credentials.security = CY_WCM_SECURITY_WPA3_WPA2_PSK;
-            break;
-        default:
-            connect_params.ap_credentials.security = CY_WCM_SECURITY_WPA2_AES_PSK;
-            break;
+        memcpy(profile.bssid, known.bssid, WIFI_MAC_ADDR_LEN);
+        profile.channel = known.channel;
+        profile.band = known.band;
     }
 
     /* Attempt connection */
     cy_wcm_ip_address_t ip_addr;
-    cy_rslt_t result = cy_wcm_connect_ap(&connect_params, &ip_addr);
+    cy_rslt_t result = link_connect(&profile, &ip_addr);
 
     if (CY_RSLT_SUCCESS == result)
     {
@@ -430,22 +673,10 @@ static void handle_wifi_connect(const ipc_msg_t *cmd_msg)
         wifi_state = WIFI_STATE_CONNECTED;
         strncpy(connected_ssid, conn->ssid, WIFI_SSID_MAX_LEN - 1);
         connected_ssid[WIFI_SSID_MAX_LEN - 1] = '\0';
+        link_remember(&profile);
 
         /* Send connected status with IP */
-        ipc_msg_t resp;
-        IPC_MSG_INIT(&resp, IPC_CMD_WIFI_CONNECTED);
-
-        ipc_wifi_status_t status;
-        memset(&status, 0, sizeof(status));
-        status.state = WIFI_STATE_CONNECTED;
-        strncpy(status.ssid, conn->ssid, WIFI_SSID_MAX_LEN - 1);
-        status.ip_addr[0] = (uint8_t)(ip_addr.ip.v4);
-        status.ip_addr[1] = (uint8_t)(ip_addr.ip.v4 >> 8);
-        status.ip_addr[2] = (uint8_t)(ip_addr.ip.v4 >> 16);
-        status.ip_addr[3] = (uint8_t)(ip_addr.ip.v4 >> 24);
-
-        memcpy(resp.data, &status, sizeof(ipc_wifi_status_t));
-        cm33_ipc_send_retry(&resp, 0);
+        send_connected(conn->ssid, &ip_addr);
 
         /* NTP sync is now requested by CM55 via IPC_CMD_NTP_SYNC
          * after it finishes collecting TCP/IP and hardware info.
@@ -484,6 +715,20 @@ static void handle_wifi_disconnect(void)
     }
 
     printf("[CM33-WiFi] Disconnecting...\r\n");
+
+    /* Stay off the network, also after a warm reset */
+    wifi_link_cancel();
+    wifi_link_set_auto(false);
+
+    if (!cy_wcm_is_connected_to_ap())
+    {
+        /* Link already lost (reconnect stopped) */
+        wifi_state = WIFI_STATE_DISCONNECTED;
+        connected_ssid[0] = '\0';
+        cm33_ipc_send_cmd(IPC_CMD_WIFI_DISCONNECTED, 0);
+        return;
+    }
+
     wifi_state = WIFI_STATE_DISCONNECTING;
 
     cy_rslt_t result = cy_wcm_disconnect_ap();
@@ -600,6 +845,17 @@ static void handle_wifi_get_hardware(void)
         }
 
         strncpy(hw.fw_version, "CYW55513", sizeof(hw.fw_version) - 1);
+
+        /* Link figures from the last link-quality sample (at most 1 s old) */
+        wifi_link_quality_t q;
+        wifi_link_quality_last(&q);
+        if (q.state == WIFI_STATE_CONNECTED)
+        {
+            hw.band = q.band;
+            hw.channel = q.channel;
+            hw.rssi = q.rssi;
+            hw.link_speed = q.link_speed_kbps / 1000U;
+        }
     }
 
     memcpy(resp.data, &hw, sizeof(ipc_wifi_hardware_t));
@@ -609,22 +865,83 @@ static void handle_wifi_get_hardware(void)
 /*******************************************************************************
  * NTP Time Sync (uses lwIP UDP socket)
  *
- * Sends NTP request to time.google.com, parses response, and sends
- * Unix epoch back to CM55 via IPC.
+ * One round queries every server in ntp_servers[]; the protocol, outlier
+ * rejection, drift and poll interval are in sntp_client.c. The result
+ * goes to CM55 as IPC_CMD_NTP_TIME (value = Unix seconds, data =
+ * ipc_ntp_time_t). After the first sync, requested by CM55, wifi_task
+ * repeats the round every sntp_client_poll_s() while connected.
+ *
+ * The local clock is the lat_trace microsecond clock (DWT based).
  ******************************************************************************/
 
 #define NTP_PORT            (123U)
-#define NTP_PACKET_SIZE     (48U)
-#define NTP_EPOCH_OFFSET    (2208988800UL)  /* 1900-01-01 to 1970-01-01 */
-#define NTP_TIMEOUT_SEC     (5)
-#define NTP_SERVER_IP       "216.239.35.0"  /* time.google.com */
+#define NTP_TIMEOUT_MS      (1000U)     /* Per server */
+
+/* time.google.com (two anycast addresses), time.cloudflare.com */
+static const char *const ntp_servers[] =
+{
+    "216.239.35.0",
+    "216.239.35.4",
+    "162.159.200.1",
+};
+#define NTP_SERVER_COUNT    (sizeof(ntp_servers) / sizeof(ntp_servers[0]))
 
 /* Track whether we've synced since last WiFi connect */
 static bool ntp_synced = false;
 static uint32_t ntp_last_sync_tick = 0;
 
-/* Re-sync interval: 30 minutes */
-#define NTP_RESYNC_INTERVAL_MS  (30 * 60 * 1000)
+/* One exchange with one server; false if it gave no usable sample */
+static bool ntp_query(int sock, const char *server_ip, sntp_sample_t *sample)
+{
+    struct sockaddr_in server;
+    memset(&server, 0, sizeof(server));
+    server.sin_family = AF_INET;
+    server.sin_port = lwip_htons(NTP_PORT);
+    server.sin_addr.s_addr = inet_addr(server_ip);
+
+    uint8_t packet[SNTP_PACKET_SIZE];
+    sntp_request_t req;
+    sntp_build_request(packet, tick_clock_now_us64(), &req);
+
+    if (lwip_sendto(sock, packet, SNTP_PACKET_SIZE, 0,
+                    (struct sockaddr *)&server, sizeof(server)) < 0)
+    {
+        printf("[CM33-NTP] %s: send failed\r\n", server_ip);
+        return false;
+    }
+
+    /* Skip late replies to an earlier query until ours or the timeout */
+    for (;;)
+    {
+        struct sockaddr_in from;
+        socklen_t fromlen = sizeof(from);
+        int n = lwip_recvfrom(sock, packet, SNTP_PACKET_SIZE, 0,
+                              (struct sockaddr *)&from, &fromlen);
+        uint64_t t4 = tick_clock_now_us64();
+
+        if (n < 0)
+        {
+            printf("[CM33-NTP] %s: timeout\r\n", server_ip);
+            return false;
+        }
+        if (from.sin_addr.s_addr != server.sin_addr.s_addr)
+        {
+            continue;
+        }
+
+        sntp_result_t result = sntp_parse_reply(packet, n, &req, t4, sample);
+        if (result == SNTP_ERR_ORIGIN)
+        {
+            continue;
+        }
+        if (result != SNTP_OK)
+        {
+            printf("[CM33-NTP] %s: %s\r\n", server_ip, sntp_result_str(result));
+            return false;
+        }
+        return true;
+    }
+}
 
 static void handle_ntp_sync(void)
 {
@@ -634,7 +951,9 @@ static void handle_ntp_sync(void)
         return;
     }
 
-    printf("[CM33-NTP] Syncing time from %s...\r\n", NTP_SERVER_IP);
+    printf("[CM33-NTP] Syncing time from %u servers...\r\n",
+           (unsigned int)NTP_SERVER_COUNT);
+    ntp_last_sync_tick = (uint32_t)xTaskGetTickCount();
 
     /* Create UDP socket */
     int sock = lwip_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
@@ -647,74 +966,292 @@ static void handle_ntp_sync(void)
 
     /* Set receive timeout */
     struct timeval tv;
-    tv.tv_sec = NTP_TIMEOUT_SEC;
-    tv.tv_usec = 0;
+    tv.tv_sec = NTP_TIMEOUT_MS / 1000U;
+    tv.tv_usec = (NTP_TIMEOUT_MS % 1000U) * 1000U;
     lwip_setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
 
-    /* NTP server address */
-    struct sockaddr_in server;
-    memset(&server, 0, sizeof(server));
-    server.sin_family = AF_INET;
-    server.sin_port = lwip_htons(NTP_PORT);
-    server.sin_addr.s_addr = inet_addr(NTP_SERVER_IP);
+    sntp_sample_t samples[NTP_SERVER_COUNT];
+    uint32_t count = 0;
+
+    for (uint32_t i = 0; i < NTP_SERVER_COUNT; i++)
+    {
+        if (ntp_query(sock, ntp_servers[i], &samples[count]))
+        {
+            samples[count].server = (uint8_t)i;
+            printf("[CM33-NTP] %s: stratum %u, delay %lu us\r\n", ntp_servers[i],
+                   (unsigned int)samples[count].stratum,
+                   (unsigned long)samples[count].delay_us);
+            count++;
+        }
+    }
+    lwip_close(sock);
 
-    /* Prepare NTP request packet */
-    uint8_t ntp_packet[NTP_PACKET_SIZE];
-    memset(ntp_packet, 0, NTP_PACKET_SIZE);
-    ntp_packet[0] = 0x1B;  /* LI=0, VN=3 (NTPv3), Mode=3 (client) */
+    taskENTER_CRITICAL();
+    bool used = sntp_client_update(samples, count);
+    taskEXIT_CRITICAL();
 
-    /* Send request */
-    int sent = lwip_sendto(sock, ntp_packet, NTP_PACKET_SIZE, 0,
-                           (struct sockaddr *)&server, sizeof(server));
-    if (sent < 0)
+    if (!used)
     {
-        printf("[CM33-NTP] Send failed\r\n");
-        lwip_close(sock);
-        cm33_ipc_send_cmd(IPC_CMD_NTP_ERROR, 3);
+        printf("[CM33-NTP] No usable reply\r\n");
+        cm33_ipc_send_cmd(IPC_CMD_NTP_ERROR, (count == 0) ? 4 : 5);
         return;
     }
 
-    /* Receive response */
-    struct sockaddr_in from;
-    socklen_t fromlen = sizeof(from);
-    int n = lwip_recvfrom(sock, ntp_packet, NTP_PACKET_SIZE, 0,
-                          (struct sockaddr *)&from, &fromlen);
-    lwip_close(sock);
+    sntp_status_t st;
+    int64_t unix_us = 0;
+    uint32_t cm33_us;
+
+    /* cm33_us is on the lat_trace clock CM55 has the offset to */
+    taskENTER_CRITICAL();
+    (void)sntp_client_now_us(tick_clock_now_us64(), &unix_us);
+    cm33_us = lat_trace_now_us();
+    sntp_client_get_status(&st);
+    taskEXIT_CRITICAL();
+
+    ipc_ntp_time_t t;
+    memset(&t, 0, sizeof(t));
+    t.unix_s = (uint32_t)(unix_us / 1000000);
+    t.unix_us = (uint32_t)(unix_us % 1000000);
+    t.cm33_us = cm33_us;
+    t.drift_ppb = st.drift_ppb;
+    t.delay_us = st.delay_us;
+    t.poll_s = (uint16_t)st.poll_s;
+    t.stratum = st.stratum;
+    t.servers = (uint8_t)count;
+
+    printf("[CM33-NTP] Time synced: epoch=%u.%06u via %s, error %ld us, "
+           "drift %ld ppb, next in %u s\r\n",
+           (unsigned int)t.unix_s, (unsigned int)t.unix_us, ntp_servers[st.server],
+           (long)st.residual_us, (long)st.drift_ppb, (unsigned int)st.poll_s);
 
-    if (n < (int)NTP_PACKET_SIZE)
+    /* Send epoch to CM55 */
+    ipc_msg_t resp;
+    IPC_MSG_INIT(&resp, IPC_CMD_NTP_TIME);
+    resp.value = t.unix_s;
+    memcpy(resp.data, &t, sizeof(ipc_ntp_time_t));
+    cm33_ipc_send_retry(&resp, 0);
+
+    ntp_synced = true;
+}
+
+/* Next round once the poll interval has passed (after a first sync) */
+static void ntp_poll(void)
+{
+    if (!ntp_synced || !cy_wcm_is_connected_to_ap())
     {
-        printf("[CM33-NTP] Receive failed or timeout (got %d bytes)\r\n", n);
-        cm33_ipc_send_cmd(IPC_CMD_NTP_ERROR, 4);
         return;
     }
 
-    /* Extract transmit timestamp from bytes 40-43 (big-endian) */
-    uint32_t ntp_time = ((uint32_t)ntp_packet[40] << 24) |
-                        ((uint32_t)ntp_packet[41] << 16) |
-                        ((uint32_t)ntp_packet[42] << 8)  |
-                        ((uint32_t)ntp_packet[43]);
+    uint32_t elapsed_ms = ((uint32_t)xTaskGetTickCount() - ntp_last_sync_tick) * portTICK_PERIOD_MS;
+    if (elapsed_ms >= sntp_client_poll_s() * 1000U)
+    {
+        handle_ntp_sync();
+    }
+}
 
-    /* Convert NTP epoch (1900) to Unix epoch (1970) */
-    uint32_t unix_epoch = ntp_time - NTP_EPOCH_OFFSET;
+/*******************************************************************************
+ * Link Quality
+ *
+ * Sampled every WIFI_LQ_SAMPLE_MS (and at once when wifi_state changed),
+ * published to CM55 through wifi_link_shared.h when wifi_link_quality.c
+ * finds the change significant. Not sampled while a scan or connect blocks
+ * the task; the next sample after it catches up.
+ ******************************************************************************/
+static uint32_t lq_tick = 0;
+static uint8_t lq_state = 0xFF;             /* wifi_state at the last sample */
 
-    /* Validate: should be after Jan 1, 2020 (1577836800) */
-    if (unix_epoch < 1577836800UL)
+/* TX rate of the link in kbps, 0 if the driver does not say */
+static uint32_t link_rate_kbps(void)
+{
+    whd_interface_t ifp;
+    uint32_t rate = 0;
+
+    if ((CY_RSLT_SUCCESS != cy_wcm_get_whd_interface(CY_WCM_INTERFACE_TYPE_STA, &ifp)) ||
+        (WHD_SUCCESS != whd_wifi_get_ioctl_value(ifp, WLC_GET_RATE, &rate)))
+    {
+        return 0;
+    }
+    return rate * 500U;     /* WLC_GET_RATE is in 500 kbps units */
+}
+
+static void link_quality_poll(void)
+{
+    uint32_t now = (uint32_t)xTaskGetTickCount();
+
+    if ((lq_state == (uint8_t)wifi_state) &&
+        ((now - lq_tick) * portTICK_PERIOD_MS < WIFI_LQ_SAMPLE_MS))
+    {
+        return;
+    }
+    lq_tick = now;
+    lq_state = (uint8_t)wifi_state;
+
+    wifi_link_quality_t sample;
+    memset(&sample, 0, sizeof(sample));
+    sample.state = (uint8_t)wifi_state;
+    sample.band = WIFI_BAND_UNKNOWN;
+    sample.security = WIFI_SECURITY_UNKNOWN;
+
+    cy_wcm_associated_ap_info_t ap;
+    if ((wifi_state == WIFI_STATE_CONNECTED) &&
+        (CY_RSLT_SUCCESS == cy_wcm_get_associated_ap_info(&ap)))
+    {
+        sample.rssi_raw = (int8_t)ap.signal_strength;
+        sample.channel = (uint8_t)ap.channel;
+        sample.band = map_channel_to_band(ap.channel);
+        sample.security = map_wcm_security(ap.security);
+        sample.link_speed_kbps = link_rate_kbps();
+    }
+    else if (wifi_state == WIFI_STATE_CONNECTED)
     {
-        printf("[CM33-NTP] Invalid timestamp: %u\r\n", (unsigned int)unix_epoch);
-        cm33_ipc_send_cmd(IPC_CMD_NTP_ERROR, 5);
+        /* Between the drop and the event: wait for the state to follow */
         return;
     }
 
-    printf("[CM33-NTP] Time synced: epoch=%u\r\n", (unsigned int)unix_epoch);
+    wifi_link_quality_t q;
+    if (wifi_link_quality_sample(&sample, now * portTICK_PERIOD_MS, &q))
+    {
+        wifi_link_shared_update(&q);
+    }
+    else
+    {
+        wifi_link_shared_sampled();
+    }
+}
 
-    /* Send epoch to CM55 */
-    ipc_msg_t resp;
-    IPC_MSG_INIT(&resp, IPC_CMD_NTP_TIME);
-    resp.value = unix_epoch;
-    cm33_ipc_send_retry(&resp, 0);
+/*******************************************************************************
+ * Link Events and Reconnect
+ *
+ * The WCM event callback (WCM thread) only records what happened and wakes
+ * wifi_task; link_poll() then decides. A drop counts only while the
+ * remembered network has auto_connect on and WCM is not connected, so a
+ * requested disconnect or the switch to another AP is not a drop.
+ ******************************************************************************/
+static void wifi_event_callback(cy_wcm_event_t event, cy_wcm_event_data_t *event_data)
+{
+    (void)event_data;
+    uint32_t now_ms = link_now_ms();
 
-    ntp_synced = true;
-    ntp_last_sync_tick = (uint32_t)xTaskGetTickCount();
+    taskENTER_CRITICAL();
+    switch (event)
+    {
+        case CY_WCM_EVENT_DISCONNECTED:
+            link_down_seen = true;
+            link_down_ms = now_ms;
+            break;
+
+        case CY_WCM_EVENT_INITIATED_RETRY:
+            link_retry_seen = true;
+            break;
+
+        case CY_WCM_EVENT_CONNECTED:
+        case CY_WCM_EVENT_RECONNECTED:
+            link_assoc_ms = now_ms;
+            break;
+
+        default:
+            break;
+    }
+    taskEXIT_CRITICAL();
+
+    if (wifi_task_handle != NULL)
+    {
+        xTaskNotify(wifi_task_handle, WIFI_TASK_EVT_LINK, eSetBits);
+    }
+}
+
+/* Back on the remembered network, by our attempt or WCM's own retry */
+static void link_restored(wifi_link_profile_t *p, const cy_wcm_ip_address_t *ip_addr,
+                          uint32_t ip_ms)
+{
+    wifi_link_stats_t st;
+
+    taskENTER_CRITICAL();
+    uint32_t assoc_ms = link_assoc_ms;
+    taskEXIT_CRITICAL();
+
+    wifi_link_reconnected(assoc_ms, ip_ms);
+    wifi_link_get_stats(&st);
+
+    printf("[CM33-WiFi] Reconnected to '%s': associated after %lu ms, IP after %lu ms "
+           "(%lu reconnects, %lu failed tries, worst %lu ms)\r\n",
+           p->ssid, (unsigned long)st.last_assoc_ms, (unsigned long)st.last_ip_ms,
+           (unsigned long)st.reconnects, (unsigned long)st.attempts,
+           (unsigned long)st.max_ip_ms);
+
+    wifi_state = WIFI_STATE_CONNECTED;
+    strncpy(connected_ssid, p->ssid, WIFI_SSID_MAX_LEN - 1);
+    connected_ssid[WIFI_SSID_MAX_LEN - 1] = '\0';
+    link_remember(p);
+    send_connected(p->ssid, ip_addr);
+}
+
+static void link_poll(void)
+{
+    wifi_link_profile_t profile;
+
+    taskENTER_CRITICAL();
+    bool down = link_down_seen;
+    bool wcm_retry = link_retry_seen;
+    uint32_t down_ms = link_down_ms;
+    link_down_seen = false;
+    link_retry_seen = false;
+    taskEXIT_CRITICAL();
+
+    if (!wifi_initialized || !wifi_link_get_profile(&profile))
+    {
+        return;
+    }
+
+    bool connected = cy_wcm_is_connected_to_ap();
+
+    if (down && !connected && profile.auto_connect && !wifi_link_reconnecting())
+    {
+        printf("[CM33-WiFi] Link to '%s' lost, reconnecting\r\n", profile.ssid);
+        wifi_state = WIFI_STATE_DISCONNECTED;
+        connected_ssid[0] = '\0';
+        wifi_link_start(down_ms, true);
+        cm33_ipc_send_cmd(IPC_CMD_WIFI_DISCONNECTED, WIFI_ERR_CONNECTION_LOST);
+    }
+    if (wcm_retry)
+    {
+        wifi_link_wcm_retry(link_now_ms());
+    }
+
+    if (!wifi_link_reconnecting())
+    {
+        return;
+    }
+
+    cy_wcm_ip_address_t ip_addr;
+    memset(&ip_addr, 0, sizeof(ip_addr));
+
+    if (connected)
+    {
+        (void)cy_wcm_get_ip_addr(CY_WCM_INTERFACE_TYPE_STA, &ip_addr);
+        link_restored(&profile, &ip_addr, link_now_ms());
+        return;
+    }
+
+    if (!wifi_link_due(link_now_ms()))
+    {
+        return;
+    }
+
+    wifi_state = WIFI_STATE_CONNECTING;
+    cy_rslt_t result = link_connect(&profile, &ip_addr);
+
+    if (CY_RSLT_SUCCESS == result)
+    {
+        link_restored(&profile, &ip_addr, link_now_ms());
+    }
+    else
+    {
+        wifi_state = WIFI_STATE_DISCONNECTED;
+        uint32_t wait_ms = wifi_link_failed(link_now_ms());
+        printf("[CM33-WiFi] Reconnect failed: 0x%08X, next try in %lu ms\r\n",
+               (unsigned int)result, (unsigned long)wait_ms);
+    }
 }
 
 /*******************************************************************************
@@ -725,7 +1262,7 @@ static void process_wifi_command(const ipc_msg_t *msg)
     switch (msg->cmd)
     {
         case IPC_CMD_WIFI_SCAN_START:
-            handle_wifi_scan();
+            handle_wifi_scan((msg->value & WIFI_SCAN_FLAG_FULL) != 0);
             break;
 
         case IPC_CMD_WIFI_CONNECT:
@@ -760,23 +1297,82 @@ static void process_wifi_command(const ipc_msg_t *msg)
 }
 
 /*******************************************************************************
- * WiFi Task Entry Point
+ * Command Queue
+ *
+ * Each served command records its wait (queued -> started) and run time
+ * (started -> done) on tick_clock, which keeps counting while CM33 sleeps
+ * (a connect blocks wifi_task for seconds).
  ******************************************************************************/
-void wifi_task(void *pvParameters)
+static bool cmd_take(wifi_cmd_class_t max_class, ipc_msg_t *msg, uint32_t *queued_us)
 {
-    (void)pvParameters;
+    taskENTER_CRITICAL();
+    bool ok = wifi_cmd_queue_pop(max_class, msg, queued_us);
+    taskEXIT_CRITICAL();
+    return ok;
+}
 
-    /* Save task handle for scan notification */
-    wifi_task_handle = xTaskGetCurrentTaskHandle();
+static void run_wifi_command(const ipc_msg_t *msg, uint32_t queued_us)
+{
+    uint32_t start_us = tick_clock_now_us();
+    process_wifi_command(msg);
+    uint32_t end_us = tick_clock_now_us();
+
+    taskENTER_CRITICAL();
+    wifi_cmd_queue_record(msg->cmd, start_us - queued_us, end_us - start_us);
+    cmd_served++;
+    taskEXIT_CRITICAL();
+}
 
-    /* Create command queue */
-    wifi_cmd_queue = xQueueCreate(WIFI_CMD_QUEUE_LENGTH, sizeof(ipc_msg_t));
-    if (wifi_cmd_queue == NULL)
+/* Print the per-command figures every WIFI_CMD_STATS_PERIOD_MS, if any ran */
+static void cmd_stats_poll(void)
+{
+    uint32_t now = (uint32_t)xTaskGetTickCount();
+
+    if (((now - cmd_stats_tick) * portTICK_PERIOD_MS < WIFI_CMD_STATS_PERIOD_MS) ||
+        (cmd_served == cmd_served_printed))
     {
-        printf("[CM33-WiFi] FATAL: Failed to create command queue\r\n");
-        vTaskDelete(NULL);
         return;
     }
+    cmd_stats_tick = now;
+    cmd_served_printed = cmd_served;
+
+    printf("[CM33-WiFi] Commands (n, wait avg/max us, run avg/max ms, coalesced, cancelled):\r\n");
+    for (uint32_t i = 0; i < WIFI_CMD_ID_COUNT; i++)
+    {
+        wifi_cmd_stats_t st;
+
+        taskENTER_CRITICAL();
+        wifi_cmd_queue_get_stats((wifi_cmd_id_t)i, &st);
+        taskEXIT_CRITICAL();
+
+        if ((st.count == 0) && (st.coalesced == 0))
+        {
+            continue;
+        }
+
+        uint32_t n = (st.count > 0) ? st.count : 1U;
+        printf("[CM33-WiFi]   %-10s %4lu  %7lu / %7lu  %5lu / %5lu  %3lu  %3lu\r\n",
+               wifi_cmd_queue_name((wifi_cmd_id_t)i), (unsigned long)st.count,
+               (unsigned long)(st.wait_total_us / n), (unsigned long)st.wait_max_us,
+               (unsigned long)(st.run_total_us / n / 1000U),
+               (unsigned long)(st.run_max_us / 1000U),
+               (unsigned long)st.coalesced, (unsigned long)st.cancelled);
+    }
+}
+
+/*******************************************************************************
+ * WiFi Task Entry Point
+ ******************************************************************************/
+void wifi_task(void *pvParameters)
+{
+    (void)pvParameters;
+
+    /* Empty command queue first; the task handle opens it to the IPC task */
+    wifi_cmd_queue_init();
+    wifi_link_quality_reset();
+    wifi_link_shared_init();
+    wifi_task_handle = xTaskGetCurrentTaskHandle();
+    cmd_stats_tick = (uint32_t)xTaskGetTickCount();
 
     printf("[CM33-WiFi] WiFi task started\r\n");
 
@@ -803,16 +1399,46 @@ void wifi_task(void *pvParameters)
     wifi_initialized = true;
     printf("[CM33-WiFi] WiFi Connection Manager initialized\r\n");
 
-    /* Phase 3: Main loop - process WiFi IPC commands */
+    /* Link events drive the reconnect; rejoin the network of the last boot */
+    result = cy_wcm_register_event_callback(wifi_event_callback);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        printf("[CM33-WiFi] Event callback failed: 0x%08X (no auto reconnect)\r\n",
+               (unsigned int)result);
+    }
+
+    wifi_link_profile_t profile;
+    if (wifi_link_init() && wifi_link_get_profile(&profile))
+    {
+        printf("[CM33-WiFi] Rejoining '%s' from the last boot\r\n", profile.ssid);
+        wifi_link_start(link_now_ms(), false);
+    }
+
+    /* Phase 3: Main loop - process WiFi IPC commands, highest class first */
     ipc_msg_t cmd_msg;
+    uint32_t queued_us;
     for (;;)
     {
-        /* Wait for command from IPC handler (1 second timeout) */
-        if (xQueueReceive(wifi_cmd_queue, &cmd_msg, pdMS_TO_TICKS(1000))
-            == pdTRUE)
+        if (cmd_take(WIFI_CMD_CLASS_BACKGROUND, &cmd_msg, &queued_us))
+        {
+            run_wifi_command(&cmd_msg, queued_us);
+        }
+        else
         {
-            process_wifi_command(&cmd_msg);
+            /* Wait for a command or link event (1 second timeout, less if
+             * a reconnect attempt is due sooner) */
+            uint32_t wait_ms = wifi_link_wait_ms(link_now_ms());
+            if (wait_ms > 1000U)
+            {
+                wait_ms = 1000U;
+            }
+            (void)xTaskNotifyWait(0, UINT32_MAX, NULL, pdMS_TO_TICKS(wait_ms));
         }
+
+        link_poll();
+        link_quality_poll();
+        ntp_poll();
+        cmd_stats_poll();
     }
 }
 
@@ -821,18 +1447,41 @@ void wifi_task(void *pvParameters)
  ******************************************************************************/
 bool wifi_task_queue_cmd(const ipc_msg_t *msg)
 {
-    if (wifi_cmd_queue == NULL || msg == NULL)
+    if (wifi_task_handle == NULL || msg == NULL)
     {
         return false;
     }
 
-    if (xQueueSend(wifi_cmd_queue, msg, pdMS_TO_TICKS(100)) == pdTRUE)
+    uint32_t now_us = tick_clock_now_us();
+
+    taskENTER_CRITICAL();
+    wifi_cmd_push_t result = wifi_cmd_queue_push(msg, now_us);
+    taskEXIT_CRITICAL();
+
+    if (result == WIFI_CMD_FULL)
     {
-        return true;
+        printf("[CM33-WiFi] Command queue full\r\n");
+        return false;
+    }
+    if (result == WIFI_CMD_UNKNOWN)
+    {
+        printf("[CM33-WiFi] Not a WiFi task cmd: 0x%02X\r\n", (unsigned int)msg->cmd);
+        return false;
     }
 
-    printf("[CM33-WiFi] Command queue full\r\n");
-    return false;
+    xTaskNotify(wifi_task_handle, WIFI_TASK_EVT_CMD, eSetBits);
+    return true;
+}
+
+/*******************************************************************************
+ * Public API: SNTP Time
+ ******************************************************************************/
+bool wifi_task_get_time_us(int64_t *unix_us)
+{
+    taskENTER_CRITICAL();
+    bool ok = sntp_client_now_us(tick_clock_now_us64(), unix_us);
+    taskEXIT_CRITICAL();
+    return ok;
 }
 
 /* [] END OF FILE */
@@ -21,10 +21,13 @@
  ******************************************************************************/
 #define WIFI_TASK_STACK_SIZE            (4096U)
 #define WIFI_TASK_PRIORITY              (3U)
-#define WIFI_CMD_QUEUE_LENGTH           (8U)
+#define WIFI_CMD_STATS_PERIOD_MS        (60000U)    /* Command latency log */
 
 /* Scan configuration */
 #define WIFI_SCAN_MAX_RESULTS           (16U)
+#define WIFI_SCAN_TIMEOUT_MS            (10000U)
+#define WIFI_SCAN_COALESCE_MS           (150U)  /* Batch results found together */
+#define WIFI_SCAN_SEND_GAP_MS           (20U)   /* Between IPC result messages */
 
 /*******************************************************************************
  * Function Prototypes
@@ -44,11 +47,24 @@ void wifi_task(void *pvParameters);
  * @brief Queue an IPC command for the WiFi task to process
  *
  * Called from cm33_ipc_pipe.c to route WiFi commands (0xD0-0xDF)
- * to the WiFi task for processing.
+ * to the WiFi task for processing. Does not block: status queries go
+ * ahead of connect/disconnect, which go ahead of scan and NTP, and a
+ * command already pending is merged rather than queued twice
+ * (see wifi_cmd_queue.h).
  *
  * @param msg  Pointer to the IPC message
- * @return true if command was queued, false if queue is full
+ * @return true if command was queued or merged, false if queue is full
  */
 bool wifi_task_queue_cmd(const ipc_msg_t *msg);
 
+/**
+ * @brief Current Unix time from SNTP, in microseconds
+ *
+ * Interpolated from the last sync with the estimated clock drift.
+ *
+ * @param unix_us  Out: microseconds since 1970-01-01 UTC
+ * @return false before the first sync
+ */
+bool wifi_task_get_time_us(int64_t *unix_us);
+
 #endif /* WIFI_TASK_H */
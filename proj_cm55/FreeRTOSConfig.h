@@ -68,6 +68,7 @@ extern uint32_t SystemCoreClock;
 #define configUSE_16_BIT_TICKS                  0
 #define configIDLE_SHOULD_YIELD                 1
 #define configUSE_TASK_NOTIFICATIONS            1
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES   2   /* [0] vsync, [1] LVGL wake */
 #define configUSE_MUTEXES                       1
 #define configUSE_RECURSIVE_MUTEXES             1
 #define configUSE_COUNTING_SEMAPHORES           1
@@ -119,6 +120,12 @@ extern uint32_t SystemCoreClock;
     #endif /* RUN_TIME_STATS_PROTOTYPES_ADDED */
 #endif /* configGENERATE_RUN_TIME_STATS */
 
+/* Per-task context switch counting for shared/source/cpu_load.c */
+#ifndef __IASMARM__
+    extern void cpu_load_task_switched_in(uint32_t task_number);
+    #define traceTASK_SWITCHED_IN() cpu_load_task_switched_in(pxCurrentTCB->uxTCBNumber)
+#endif /* __IASMARM__ */
+
 
 /* Co-routine related definitions. */
 #define configUSE_CO_ROUTINES                   0
@@ -0,0 +1,633 @@
+/*******************************************************************************
+ * File: aic_alloc.c
+ * Description: AIC-EEC LVGL Memory Allocator Implementation
+ *
+ * Every block carries an 8-byte header (backend tag + requested size), so
+ * lv_free_core()/lv_realloc_core() know where a pointer came from.
+ *
+ * TLSF after Masmano et al., "TLSF: a New Dynamic Memory Allocator for
+ * Real-Time Systems" (ECRTS 2004): free blocks are kept in lists indexed
+ * by (first level = log2 size, second level = 16 linear subdivisions),
+ * with a bitmap per level, so finding a fitting list is two bit scans.
+ * Pool slots are carved from TLSF pages and never returned to it.
+ *
+ * Part of BiiL Course: Embedded C for IoT
+ ******************************************************************************/
+
+#include "aic_alloc.h"
+#include "lvgl.h"
+#include "cy_syslib.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#if LV_USE_STDLIB_MALLOC == LV_STDLIB_CUSTOM
+
+/* Allocation trace in the format tests/host/aic_alloc_bench replays:
+ * "+ ptr size" alloc, "- ptr" free, "~ ptr size" in-place realloc.
+ * A realloc that moves shows up as an alloc and a free. */
+#if AIC_ALLOC_TRACE
+#define ALLOC_TRACE(fmt, ...)   printf("[ALLOC] " fmt "\r\n", __VA_ARGS__)
+#else
+#define ALLOC_TRACE(fmt, ...)
+#endif
+
+/*******************************************************************************
+ * TLSF Definitions
+ ******************************************************************************/
+
+#define TLSF_ALIGN          8U
+#define TLSF_SL_LOG2        4U
+#define TLSF_SL_COUNT       (1U << TLSF_SL_LOG2)
+#define TLSF_FL_SHIFT       (TLSF_SL_LOG2 + 3U)         /* 3 = log2(TLSF_ALIGN) */
+#define TLSF_SMALL_SIZE     (1U << TLSF_FL_SHIFT)       /* Linear below 128 B */
+#define TLSF_FL_MAX         24U                         /* Blocks < 16 MB */
+#define TLSF_FL_COUNT       (TLSF_FL_MAX - TLSF_FL_SHIFT + 1U)
+
+#define TLSF_FREE_BIT       ((size_t)1U)
+
+typedef struct tlsf_block {
+    struct tlsf_block *prev_phys;   /* Physically previous block (NULL = first) */
+    size_t size;                    /* Payload bytes | TLSF_FREE_BIT */
+    struct tlsf_block *next_free;   /* Free blocks only - overlays the payload */
+    struct tlsf_block *prev_free;
+} tlsf_block_t;
+
+#define TLSF_HDR            (offsetof(tlsf_block_t, next_free))
+#define TLSF_MIN_PAYLOAD    (sizeof(tlsf_block_t) - TLSF_HDR)
+
+/*******************************************************************************
+ * Block Header
+ ******************************************************************************/
+
+#define ALLOC_MAGIC         0xA11C0000UL
+#define ALLOC_MAGIC_MASK    0xFFFF0000UL
+#define ALLOC_KIND_POOL     1U
+#define ALLOC_KIND_TLSF     2U
+#define ALLOC_KIND_HEAP     3U
+
+#define ALLOC_TAG(kind, cls)    (ALLOC_MAGIC | ((uint32_t)(kind) << 8) | (uint32_t)(cls))
+#define ALLOC_TAG_KIND(tag)     (((tag) >> 8) & 0xFFU)
+#define ALLOC_TAG_CLASS(tag)    ((tag) & 0xFFU)
+
+typedef struct {
+    uint32_t tag;
+    uint32_t size;      /* Requested bytes */
+} alloc_hdr_t;
+
+/* Pool slot while free - the link overlays the user area */
+typedef struct pool_slot {
+    alloc_hdr_t hdr;
+    struct pool_slot *next;
+} pool_slot_t;
+
+/*******************************************************************************
+ * Static Variables
+ ******************************************************************************/
+
+static uint8_t *region = NULL;
+static uint32_t region_size = 0;
+static tlsf_block_t *first_block = NULL;
+
+static uint32_t fl_bitmap = 0;
+static uint32_t sl_bitmap[TLSF_FL_COUNT];
+static tlsf_block_t *free_heads[TLSF_FL_COUNT][TLSF_SL_COUNT];
+
+static pool_slot_t *class_free[AIC_ALLOC_CLASS_COUNT];
+static aic_alloc_stats_t stats;
+
+/*******************************************************************************
+ * TLSF Helpers
+ ******************************************************************************/
+
+static inline uint32_t fls_size(size_t x)
+{
+    return (uint32_t)(sizeof(unsigned long) * 8U - 1U) - (uint32_t)__builtin_clzl((unsigned long)x);
+}
+
+static inline size_t blk_size(const tlsf_block_t *b)
+{
+    return b->size & ~TLSF_FREE_BIT;
+}
+
+static inline bool blk_is_free(const tlsf_block_t *b)
+{
+    return (b->size & TLSF_FREE_BIT) != 0U;
+}
+
+static inline void *blk_payload(tlsf_block_t *b)
+{
+    return (uint8_t *)b + TLSF_HDR;
+}
+
+static inline tlsf_block_t *blk_from_payload(void *p)
+{
+    return (tlsf_block_t *)((uint8_t *)p - TLSF_HDR);
+}
+
+static inline tlsf_block_t *blk_next(tlsf_block_t *b)
+{
+    return (tlsf_block_t *)((uint8_t *)blk_payload(b) + blk_size(b));
+}
+
+static void mapping_insert(size_t size, uint32_t *fl, uint32_t *sl)
+{
+    if (size < TLSF_SMALL_SIZE) {
+        *fl = 0;
+        *sl = (uint32_t)(size / (TLSF_SMALL_SIZE / TLSF_SL_COUNT));
+    } else {
+        uint32_t f = fls_size(size);
+        *sl = (uint32_t)(size >> (f - TLSF_SL_LOG2)) ^ TLSF_SL_COUNT;
+        *fl = f - (TLSF_FL_SHIFT - 1U);
+    }
+}
+
+/* Round up to the next list boundary so any block found is large enough */
+static void mapping_search(size_t size, uint32_t *fl, uint32_t *sl)
+{
+    if (size >= TLSF_SMALL_SIZE) {
+        size += ((size_t)1U << (fls_size(size) - TLSF_SL_LOG2)) - 1U;
+    }
+    mapping_insert(size, fl, sl);
+}
+
+static void free_list_insert(tlsf_block_t *b)
+{
+    uint32_t fl, sl;
+    mapping_insert(blk_size(b), &fl, &sl);
+
+    b->prev_free = NULL;
+    b->next_free = free_heads[fl][sl];
+    if (b->next_free != NULL) {
+        b->next_free->prev_free = b;
+    }
+    free_heads[fl][sl] = b;
+
+    fl_bitmap |= (1UL << fl);
+    sl_bitmap[fl] |= (1UL << sl);
+}
+
+static void free_list_remove(tlsf_block_t *b)
+{
+    uint32_t fl, sl;
+    mapping_insert(blk_size(b), &fl, &sl);
+
+    if (b->next_free != NULL) {
+        b->next_free->prev_free = b->prev_free;
+    }
+    if (b->prev_free != NULL) {
+        b->prev_free->next_free = b->next_free;
+    } else {
+        free_heads[fl][sl] = b->next_free;
+        if (b->next_free == NULL) {
+            sl_bitmap[fl] &= ~(1UL << sl);
+            if (sl_bitmap[fl] == 0U) {
+                fl_bitmap &= ~(1UL << fl);
+            }
+        }
+    }
+}
+
+static tlsf_block_t *find_suitable(uint32_t fl, uint32_t sl)
+{
+    uint32_t sl_map = sl_bitmap[fl] & (~0UL << sl);
+
+    if (sl_map == 0U) {
+        uint32_t fl_map = (fl + 1U < 32U) ? (fl_bitmap & (~0UL << (fl + 1U))) : 0U;
+        if (fl_map == 0U) {
+            return NULL;
+        }
+        fl = (uint32_t)__builtin_ctz(fl_map);
+        sl_map = sl_bitmap[fl];
+    }
+
+    return free_heads[fl][(uint32_t)__builtin_ctz(sl_map)];
+}
+
+static void tlsf_init(uint8_t *mem, size_t bytes)
+{
+    uintptr_t start = ((uintptr_t)mem + TLSF_ALIGN - 1U) & ~(uintptr_t)(TLSF_ALIGN - 1U);
+    uintptr_t end = ((uintptr_t)mem + bytes) & ~(uintptr_t)(TLSF_ALIGN - 1U);
+
+    memset(free_heads, 0, sizeof(free_heads));
+    memset(sl_bitmap, 0, sizeof(sl_bitmap));
+    fl_bitmap = 0;
+
+    /* One free block followed by a zero-size used sentinel */
+    first_block = (tlsf_block_t *)start;
+    first_block->prev_phys = NULL;
+    first_block->size = ((end - start) - 2U * TLSF_HDR) | TLSF_FREE_BIT;
+
+    tlsf_block_t *sentinel = blk_next(first_block);
+    sentinel->prev_phys = first_block;
+    sentinel->size = 0;
+
+    free_list_insert(first_block);
+}
+
+static void *tlsf_malloc(size_t size)
+{
+    uint32_t fl, sl;
+
+    size = (size + TLSF_ALIGN - 1U) & ~(size_t)(TLSF_ALIGN - 1U);
+    if (size < TLSF_MIN_PAYLOAD) {
+        size = TLSF_MIN_PAYLOAD;
+    }
+    if (first_block == NULL || size >= ((size_t)1U << (TLSF_FL_MAX - 1U))) {
+        return NULL;
+    }
+
+    mapping_search(size, &fl, &sl);
+    tlsf_block_t *b = find_suitable(fl, sl);
+    if (b == NULL) {
+        return NULL;
+    }
+    free_list_remove(b);
+
+    /* Split off the remainder if it can hold a block of its own */
+    size_t remain = blk_size(b) - size;
+    if (remain >= TLSF_HDR + TLSF_MIN_PAYLOAD) {
+        b->size = size;
+        tlsf_block_t *rest = blk_next(b);
+        rest->prev_phys = b;
+        rest->size = (remain - TLSF_HDR) | TLSF_FREE_BIT;
+        blk_next(rest)->prev_phys = rest;
+        free_list_insert(rest);
+    } else {
+        b->size = blk_size(b);
+    }
+
+    return blk_payload(b);
+}
+
+static void tlsf_free(void *p)
+{
+    tlsf_block_t *b = blk_from_payload(p);
+    b->size = blk_size(b);
+
+    /* Coalesce with free physical neighbours */
+    tlsf_block_t *prev = b->prev_phys;
+    if (prev != NULL && blk_is_free(prev)) {
+        free_list_remove(prev);
+        prev->size = blk_size(prev) + TLSF_HDR + blk_size(b);
+        b = prev;
+    }
+
+    tlsf_block_t *next = blk_next(b);
+    if (blk_is_free(next)) {
+        free_list_remove(next);
+        b->size = blk_size(b) + TLSF_HDR + blk_size(next);
+    }
+
+    blk_next(b)->prev_phys = b;
+    b->size |= TLSF_FREE_BIT;
+    free_list_insert(b);
+}
+
+static size_t tlsf_usable(void *p)
+{
+    return blk_size(blk_from_payload(p));
+}
+
+/*******************************************************************************
+ * Pool Helpers
+ ******************************************************************************/
+
+static inline uint32_t class_index(size_t size)
+{
+    if (size <= 16U) {
+        return 0;
+    }
+    return (32U - (uint32_t)__builtin_clz((uint32_t)size - 1U)) - 4U;
+}
+
+static inline uint32_t class_size(uint32_t cls)
+{
+    return 16U << cls;
+}
+
+/* Carve a page of slots from TLSF into the class free list */
+static bool class_refill(uint32_t cls)
+{
+    uint32_t slot_size = (uint32_t)sizeof(alloc_hdr_t) + class_size(cls);
+    uint8_t *page = tlsf_malloc((size_t)slot_size * AIC_ALLOC_PAGE_SLOTS);
+
+    if (page == NULL) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < AIC_ALLOC_PAGE_SLOTS; i++) {
+        pool_slot_t *slot = (pool_slot_t *)(page + i * slot_size);
+        slot->next = class_free[cls];
+        class_free[cls] = slot;
+    }
+    stats.classes[cls].slots += AIC_ALLOC_PAGE_SLOTS;
+    return true;
+}
+
+/*******************************************************************************
+ * Statistics Helpers
+ ******************************************************************************/
+
+static void stats_on_alloc(uint32_t size)
+{
+    stats.used_bytes += size;
+    stats.live_count++;
+    stats.alloc_count++;
+    if (stats.used_bytes > stats.peak_bytes) {
+        stats.peak_bytes = stats.used_bytes;
+    }
+}
+
+/*******************************************************************************
+ * LVGL Custom Memory Core (LV_STDLIB_CUSTOM)
+ ******************************************************************************/
+
+void lv_mem_init(void)
+{
+    memset(&stats, 0, sizeof(stats));
+    memset(class_free, 0, sizeof(class_free));
+
+    for (uint32_t i = 0; i < AIC_ALLOC_CLASS_COUNT; i++) {
+        stats.classes[i].size = class_size(i);
+    }
+
+    /* One contiguous region from the C heap, owned by LVGL from here on */
+    region = malloc(AIC_ALLOC_REGION_SIZE);
+    if (region == NULL) {
+        printf("[ALLOC] Region of %u B not available - using C heap only\r\n",
+               (unsigned int)AIC_ALLOC_REGION_SIZE);
+        return;
+    }
+    region_size = AIC_ALLOC_REGION_SIZE;
+    stats.region_size = region_size;
+
+    tlsf_init(region, region_size);
+}
+
+void lv_mem_deinit(void)
+{
+    free(region);
+    region = NULL;
+    region_size = 0;
+    first_block = NULL;
+}
+
+lv_mem_pool_t lv_mem_add_pool(void *mem, size_t bytes)
+{
+    /* Single region only */
+    (void)mem;
+    (void)bytes;
+    return NULL;
+}
+
+void lv_mem_remove_pool(lv_mem_pool_t pool)
+{
+    (void)pool;
+}
+
+void *lv_malloc_core(size_t size)
+{
+    alloc_hdr_t *hdr = NULL;
+    uint32_t state;
+
+    if (size <= AIC_ALLOC_CLASS_MAX) {
+        uint32_t cls = class_index(size);
+
+        state = Cy_SysLib_EnterCriticalSection();
+        if (class_free[cls] != NULL || class_refill(cls)) {
+            pool_slot_t *slot = class_free[cls];
+            class_free[cls] = slot->next;
+            hdr = &slot->hdr;
+            hdr->tag = ALLOC_TAG(ALLOC_KIND_POOL, cls);
+
+            aic_alloc_class_stats_t *cs = &stats.classes[cls];
+            if (++cs->in_use > cs->peak) {
+                cs->peak = cs->in_use;
+            }
+        }
+        Cy_SysLib_ExitCriticalSection(state);
+    }
+
+    if (hdr == NULL && size <= AIC_ALLOC_TLSF_MAX) {
+        state = Cy_SysLib_EnterCriticalSection();
+        hdr = tlsf_malloc(sizeof(alloc_hdr_t) + size);
+        if (hdr != NULL) {
+            hdr->tag = ALLOC_TAG(ALLOC_KIND_TLSF, 0);
+        }
+        Cy_SysLib_ExitCriticalSection(state);
+    }
+
+    if (hdr == NULL) {
+        hdr = malloc(sizeof(alloc_hdr_t) + size);
+        if (hdr == NULL) {
+            return NULL;
+        }
+        hdr->tag = ALLOC_TAG(ALLOC_KIND_HEAP, 0);
+
+        state = Cy_SysLib_EnterCriticalSection();
+        stats.heap_live++;
+        stats.heap_bytes += (uint32_t)size;
+        stats.heap_fallbacks++;
+        Cy_SysLib_ExitCriticalSection(state);
+    }
+
+    hdr->size = (uint32_t)size;
+
+    state = Cy_SysLib_EnterCriticalSection();
+    stats_on_alloc((uint32_t)size);
+    Cy_SysLib_ExitCriticalSection(state);
+
+    ALLOC_TRACE("+ %p %u", (void *)(hdr + 1), (unsigned int)size);
+    return hdr + 1;
+}
+
+void lv_free_core(void *p)
+{
+    if (p == NULL) {
+        return;
+    }
+
+    alloc_hdr_t *hdr = (alloc_hdr_t *)p - 1;
+    uint32_t tag = hdr->tag;
+
+    LV_ASSERT_MSG((tag & ALLOC_MAGIC_MASK) == ALLOC_MAGIC, "lv_free: bad block");
+    ALLOC_TRACE("- %p", p);
+
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+
+    stats.used_bytes -= hdr->size;
+    stats.live_count--;
+
+    switch (ALLOC_TAG_KIND(tag)) {
+        case ALLOC_KIND_POOL: {
+            uint32_t cls = ALLOC_TAG_CLASS(tag);
+            pool_slot_t *slot = (pool_slot_t *)hdr;
+            slot->next = class_free[cls];
+            class_free[cls] = slot;
+            stats.classes[cls].in_use--;
+            break;
+        }
+        case ALLOC_KIND_TLSF:
+            tlsf_free(hdr);
+            break;
+        default:
+            stats.heap_live--;
+            stats.heap_bytes -= hdr->size;
+            break;
+    }
+
+    Cy_SysLib_ExitCriticalSection(state);
+
+    if (ALLOC_TAG_KIND(tag) == ALLOC_KIND_HEAP) {
+        free(hdr);
+    }
+}
+
+void *lv_realloc_core(void *p, size_t new_size)
+{
+    if (p == NULL) {
+        return lv_malloc_core(new_size);
+    }
+
+    alloc_hdr_t *hdr = (alloc_hdr_t *)p - 1;
+    size_t usable;
+
+    switch (ALLOC_TAG_KIND(hdr->tag)) {
+        case ALLOC_KIND_POOL:
+            usable = class_size(ALLOC_TAG_CLASS(hdr->tag));
+            break;
+        case ALLOC_KIND_TLSF:
+            usable = tlsf_usable(hdr) - sizeof(alloc_hdr_t);
+            break;
+        default:
+            usable = 0;     /* Always move C heap blocks (size unknown) */
+            break;
+    }
+
+    /* Grow or shrink in place when the block already fits */
+    if (new_size <= usable && new_size >= usable / 2U) {
+        uint32_t state = Cy_SysLib_EnterCriticalSection();
+        stats.used_bytes = stats.used_bytes - hdr->size + (uint32_t)new_size;
+        if (stats.used_bytes > stats.peak_bytes) {
+            stats.peak_bytes = stats.used_bytes;
+        }
+        hdr->size = (uint32_t)new_size;
+        Cy_SysLib_ExitCriticalSection(state);
+        ALLOC_TRACE("~ %p %u", p, (unsigned int)new_size);
+        return p;
+    }
+
+    void *np = lv_malloc_core(new_size);
+    if (np == NULL) {
+        return NULL;
+    }
+    memcpy(np, p, (hdr->size < new_size) ? hdr->size : new_size);
+    lv_free_core(p);
+    return np;
+}
+
+void lv_mem_monitor_core(lv_mem_monitor_t *mon_p)
+{
+    aic_alloc_stats_t st;
+    uint32_t pool_free = 0;
+
+    aic_alloc_get_stats(&st);
+    for (uint32_t i = 0; i < AIC_ALLOC_CLASS_COUNT; i++) {
+        pool_free += (st.classes[i].slots - st.classes[i].in_use) * st.classes[i].size;
+    }
+
+    mon_p->total_size = st.region_size;
+    mon_p->free_size = st.tlsf_free + pool_free;
+    mon_p->free_biggest_size = st.tlsf_largest;
+    mon_p->used_cnt = st.live_count;
+    mon_p->max_used = st.peak_bytes;
+    mon_p->used_pct = (st.region_size > 0U) ?
+                      (uint8_t)(100U - (mon_p->free_size * 100U) / st.region_size) : 0U;
+    mon_p->frag_pct = st.frag_pct;
+}
+
+lv_result_t lv_mem_test_core(void)
+{
+    lv_result_t res = LV_RESULT_OK;
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+
+    /* Physical chain must be consistent up to the sentinel */
+    for (tlsf_block_t *b = first_block; b != NULL && blk_size(b) != 0U; b = blk_next(b)) {
+        if (blk_next(b)->prev_phys != b ||
+            (blk_is_free(b) && b->prev_phys != NULL && blk_is_free(b->prev_phys))) {
+            res = LV_RESULT_INVALID;
+            break;
+        }
+    }
+
+    Cy_SysLib_ExitCriticalSection(state);
+    return res;
+}
+
+/*******************************************************************************
+ * Statistics API
+ ******************************************************************************/
+
+void aic_alloc_get_stats(aic_alloc_stats_t *out)
+{
+    uint32_t free_total = 0;
+    uint32_t largest = 0;
+
+    if (out == NULL) {
+        return;
+    }
+
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+
+    for (tlsf_block_t *b = first_block; b != NULL && blk_size(b) != 0U; b = blk_next(b)) {
+        if (blk_is_free(b)) {
+            free_total += (uint32_t)blk_size(b);
+            if (blk_size(b) > largest) {
+                largest = (uint32_t)blk_size(b);
+            }
+        }
+    }
+
+    *out = stats;
+    Cy_SysLib_ExitCriticalSection(state);
+
+    out->tlsf_free = free_total;
+    out->tlsf_largest = largest;
+    out->frag_pct = (free_total > 0U) ? (uint8_t)(100U - (largest * 100U) / free_total) : 0U;
+}
+
+void aic_alloc_print(void)
+{
+    aic_alloc_stats_t st;
+    aic_alloc_get_stats(&st);
+
+    printf("[ALLOC] LVGL: %lu B live (%lu blocks), peak %lu B, region %lu B\r\n",
+           (unsigned long)st.used_bytes, (unsigned long)st.live_count,
+           (unsigned long)st.peak_bytes, (unsigned long)st.region_size);
+    printf("  TLSF free %lu B, largest %lu B, frag %u%%\r\n",
+           (unsigned long)st.tlsf_free, (unsigned long)st.tlsf_largest, st.frag_pct);
+    for (uint32_t i = 0; i < AIC_ALLOC_CLASS_COUNT; i++) {
+        printf("  pool %3lu B: %lu/%lu in use, peak %lu\r\n",
+               (unsigned long)st.classes[i].size, (unsigned long)st.classes[i].in_use,
+               (unsigned long)st.classes[i].slots, (unsigned long)st.classes[i].peak);
+    }
+    printf("  C heap: %lu live (%lu B), %lu total\r\n", (unsigned long)st.heap_live,
+           (unsigned long)st.heap_bytes, (unsigned long)st.heap_fallbacks);
+}
+
+#else
+
+void aic_alloc_get_stats(aic_alloc_stats_t *out)
+{
+    if (out != NULL) {
+        memset(out, 0, sizeof(aic_alloc_stats_t));
+    }
+}
+
+void aic_alloc_print(void)
+{
+    printf("[ALLOC] Not in use (LV_USE_STDLIB_MALLOC != LV_STDLIB_CUSTOM)\r\n");
+}
+
+#endif /* LV_USE_STDLIB_MALLOC == LV_STDLIB_CUSTOM */
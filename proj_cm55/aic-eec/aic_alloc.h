@@ -0,0 +1,103 @@
+/*******************************************************************************
+ * File: aic_alloc.h
+ * Description: AIC-EEC LVGL Memory Allocator (LV_STDLIB_CUSTOM backend)
+ *
+ * LVGL allocations are served from one region reserved at lv_mem_init():
+ *   - Size-class pools (16..256 bytes): O(1) free-list pop/push, for the
+ *     object, style and event churn of widget create/delete
+ *   - TLSF (two-level segregated fit): O(1) alloc/free with coalescing,
+ *     for blocks up to AIC_ALLOC_TLSF_MAX
+ *   - C heap: larger blocks (draw layers, image buffers) and anything the
+ *     region cannot hold, as with LV_STDLIB_CLIB
+ *
+ * Enabled by LV_USE_STDLIB_MALLOC = LV_STDLIB_CUSTOM in lv_conf.h; lv_init()
+ * calls lv_mem_init(). LVGL-task only, like the rest of LVGL.
+ *
+ * Part of BiiL Course: Embedded C for IoT
+ ******************************************************************************/
+
+#ifndef AIC_ALLOC_H
+#define AIC_ALLOC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * Configuration
+ ******************************************************************************/
+
+#ifndef AIC_ALLOC_REGION_SIZE
+#define AIC_ALLOC_REGION_SIZE   (128U * 1024U)  /* Pools + TLSF region */
+#endif
+
+#ifndef AIC_ALLOC_TLSF_MAX
+#define AIC_ALLOC_TLSF_MAX      (16U * 1024U)   /* Larger requests go to the C heap */
+#endif
+
+#ifndef AIC_ALLOC_PAGE_SLOTS
+#define AIC_ALLOC_PAGE_SLOTS    16U             /* Slots added per pool refill */
+#endif
+
+#ifndef AIC_ALLOC_TRACE
+#define AIC_ALLOC_TRACE         0               /* 1 = print every call (tests/host replay) */
+#endif
+
+#define AIC_ALLOC_CLASS_COUNT   5U              /* 16, 32, 64, 128, 256 bytes */
+#define AIC_ALLOC_CLASS_MAX     256U
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+
+/**
+ * @brief Per size-class statistics
+ */
+typedef struct {
+    uint32_t size;          /* Class payload size */
+    uint32_t slots;         /* Slots carved so far */
+    uint32_t in_use;
+    uint32_t peak;          /* Highest in_use */
+} aic_alloc_class_stats_t;
+
+/**
+ * @brief Allocator statistics
+ */
+typedef struct {
+    uint32_t region_size;   /* Reserved region (0 if not initialized) */
+    uint32_t used_bytes;    /* Requested bytes live (all backends) */
+    uint32_t peak_bytes;    /* Highest used_bytes */
+    uint32_t live_count;    /* Live allocations */
+    uint32_t alloc_count;   /* Total allocations */
+    uint32_t tlsf_free;     /* Free bytes in the TLSF heap */
+    uint32_t tlsf_largest;  /* Largest free TLSF block */
+    uint8_t  frag_pct;      /* 100 - largest * 100 / free */
+    uint32_t heap_live;     /* Live blocks served by the C heap */
+    uint32_t heap_bytes;    /* Their requested bytes */
+    uint32_t heap_fallbacks;/* Total C heap allocations */
+    aic_alloc_class_stats_t classes[AIC_ALLOC_CLASS_COUNT];
+} aic_alloc_stats_t;
+
+/*******************************************************************************
+ * API Functions
+ ******************************************************************************/
+
+/**
+ * @brief Get allocator statistics (walks the TLSF heap for free figures)
+ */
+void aic_alloc_get_stats(aic_alloc_stats_t *stats);
+
+/**
+ * @brief Print allocator statistics to the console
+ */
+void aic_alloc_print(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AIC_ALLOC_H */
@@ -0,0 +1,156 @@
+/*******************************************************************************
+ * File: aic_bind.c
+ * Description: AIC-EEC Sensor-to-Widget Data Binding Implementation
+ *
+ * One lv_timer polls all registered sources. A source is read at most once
+ * per min_interval_ms, and published only when the reading leaves the
+ * deadband, so bound widgets see no set_value/invalidate on idle ticks.
+ *
+ * Part of BiiL Course: Embedded C for IoT
+ ******************************************************************************/
+
+#include "aic_bind.h"
+#include <stdlib.h>
+
+/*******************************************************************************
+ * Static Variables
+ ******************************************************************************/
+
+static aic_bind_source_t *sources[AIC_BIND_MAX_SOURCES];
+static uint8_t source_count = 0;
+static lv_timer_t *poll_timer = NULL;
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+
+static int source_find(const aic_bind_source_t *src)
+{
+    for (uint8_t i = 0; i < source_count; i++) {
+        if (sources[i] == src) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void source_update(aic_bind_source_t *src, uint32_t now)
+{
+    int32_t value = src->read_cb(src->user_data);
+    int32_t current = lv_subject_get_int(&src->subject);
+
+    src->last_read_ms = now;
+
+    if (abs(value - current) <= src->deadband) {
+        src->suppress_count++;
+        return;
+    }
+
+    src->publish_count++;
+    lv_subject_set_int(&src->subject, value);   /* Notifies bound widgets */
+}
+
+static void poll_timer_cb(lv_timer_t *timer)
+{
+    (void)timer;
+    uint32_t now = lv_tick_get();
+
+    for (uint8_t i = 0; i < source_count; i++) {
+        aic_bind_source_t *src = sources[i];
+        if (lv_tick_diff(now, src->last_read_ms) < src->min_interval_ms) {
+            continue;   /* Rate limited - don't even read the sensor */
+        }
+        source_update(src, now);
+    }
+}
+
+/*******************************************************************************
+ * Source API
+ ******************************************************************************/
+
+bool aic_bind_source_init(aic_bind_source_t *src, aic_bind_read_cb_t read_cb,
+                          void *user_data, int32_t initial,
+                          int32_t deadband, uint32_t min_interval_ms)
+{
+    if (src == NULL || read_cb == NULL) {
+        return false;
+    }
+
+    /* Re-init of a registered source (screen rebuilt): drop the old binding */
+    aic_bind_source_deinit(src);
+    if (source_count >= AIC_BIND_MAX_SOURCES) {
+        return false;
+    }
+
+    lv_subject_init_int(&src->subject, initial);
+    src->read_cb = read_cb;
+    src->user_data = user_data;
+    src->deadband = (deadband < 0) ? 0 : deadband;
+    src->min_interval_ms = min_interval_ms;
+    src->last_read_ms = lv_tick_get();
+    src->publish_count = 0;
+    src->suppress_count = 0;
+
+    sources[source_count++] = src;
+
+    if (poll_timer == NULL) {
+        poll_timer = lv_timer_create(poll_timer_cb, AIC_BIND_POLL_MS, NULL);
+    }
+    return true;
+}
+
+void aic_bind_source_deinit(aic_bind_source_t *src)
+{
+    int i = source_find(src);
+    if (i < 0) {
+        return;
+    }
+
+    sources[i] = sources[--source_count];
+    sources[source_count] = NULL;
+    lv_subject_deinit(&src->subject);
+
+    if (source_count == 0 && poll_timer != NULL) {
+        lv_timer_delete(poll_timer);
+        poll_timer = NULL;
+    }
+}
+
+void aic_bind_source_poll(aic_bind_source_t *src)
+{
+    if (src == NULL || src->read_cb == NULL) {
+        return;
+    }
+    source_update(src, lv_tick_get());
+}
+
+/*******************************************************************************
+ * Widget Binding Helpers
+ ******************************************************************************/
+
+static void bar_value_observer_cb(lv_observer_t *observer, lv_subject_t *subject)
+{
+    lv_obj_t *bar = lv_observer_get_target_obj(observer);
+    lv_anim_enable_t anim = (lv_anim_enable_t)(intptr_t)lv_observer_get_user_data(observer);
+    lv_bar_set_value(bar, lv_subject_get_int(subject), anim);
+}
+
+static void led_percent_observer_cb(lv_observer_t *observer, lv_subject_t *subject)
+{
+    lv_obj_t *led = lv_observer_get_target_obj(observer);
+    int32_t pct = LV_CLAMP(0, lv_subject_get_int(subject), 100);
+    lv_led_set_brightness(led, (uint8_t)((pct * 255) / 100));
+}
+
+lv_observer_t *aic_bind_bar_value(lv_obj_t *bar, lv_subject_t *subject,
+                                  lv_anim_enable_t anim)
+{
+    return lv_subject_add_observer_obj(subject, bar_value_observer_cb, bar,
+                                       (void *)(intptr_t)anim);
+}
+
+lv_observer_t *aic_bind_led_percent(lv_obj_t *led, lv_subject_t *subject)
+{
+    lv_led_on(led);
+    return lv_subject_add_observer_obj(subject, led_percent_observer_cb, led, NULL);
+}
@@ -0,0 +1,124 @@
+/*******************************************************************************
+ * File: aic_bind.h
+ * Description: AIC-EEC Sensor-to-Widget Data Binding
+ *
+ * Sensor sources publish their readings into lv_subject_t values.
+ * A source is read at most once per minimum interval, and a reading is
+ * published only when it moves more than a deadband, so widgets bound to
+ * the subject are redrawn only on meaningful changes.
+ *
+ * Sources are polled by a single shared lv_timer (LVGL thread only).
+ * Widgets bind once with the stock LVGL helpers (lv_label_bind_text,
+ * lv_slider_bind_value, ...) or the aic_bind_* helpers below.
+ *
+ * Part of BiiL Course: Embedded C for IoT
+ ******************************************************************************/
+
+#ifndef AIC_BIND_H
+#define AIC_BIND_H
+
+#include "lvgl.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * Configuration
+ ******************************************************************************/
+
+#ifndef AIC_BIND_MAX_SOURCES
+#define AIC_BIND_MAX_SOURCES    8       /* Max concurrently registered sources */
+#endif
+
+#ifndef AIC_BIND_POLL_MS
+#define AIC_BIND_POLL_MS        20U     /* Shared poll timer period */
+#endif
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+
+/**
+ * @brief Sensor read callback - returns the current raw reading
+ * @param user_data User data given at registration
+ */
+typedef int32_t (*aic_bind_read_cb_t)(void *user_data);
+
+/**
+ * @brief Bound sensor source
+ *
+ * Caller allocates (static storage recommended). The subject can be used
+ * with any lv_subject / lv_*_bind_* API once aic_bind_source_init() returns.
+ */
+typedef struct {
+    lv_subject_t       subject;         /* Published value (int subject) */
+    aic_bind_read_cb_t read_cb;         /* Sensor read function */
+    void              *user_data;       /* Passed to read_cb */
+    int32_t            deadband;        /* Publish only if |new - old| > deadband */
+    uint32_t           min_interval_ms; /* Rate limit between sensor reads */
+    uint32_t           last_read_ms;    /* lv_tick of last read */
+    uint32_t           publish_count;   /* Statistics: values published */
+    uint32_t           suppress_count;  /* Statistics: readings filtered out */
+} aic_bind_source_t;
+
+/*******************************************************************************
+ * Source API
+ ******************************************************************************/
+
+/**
+ * @brief Initialize a source and register it with the shared poll timer
+ *
+ * @param src             Source (caller allocates)
+ * @param read_cb         Sensor read function
+ * @param user_data       Passed to read_cb
+ * @param initial         Initial subject value
+ * @param deadband        Change threshold (0 = any change)
+ * @param min_interval_ms Minimum time between sensor reads (0 = every poll)
+ * @return true on success, false if the source table is full
+ *
+ * Initializing a source that is still registered unregisters it first.
+ */
+bool aic_bind_source_init(aic_bind_source_t *src, aic_bind_read_cb_t read_cb,
+                          void *user_data, int32_t initial,
+                          int32_t deadband, uint32_t min_interval_ms);
+
+/**
+ * @brief Unregister a source and release its subject observers
+ *
+ * Call it when the screen using the source is deleted. Does nothing if
+ * the source is not registered. The shared poll timer is deleted when
+ * the last source is removed.
+ */
+void aic_bind_source_deinit(aic_bind_source_t *src);
+
+/**
+ * @brief Poll one source now, ignoring the rate limit
+ *
+ * The deadband still applies.
+ */
+void aic_bind_source_poll(aic_bind_source_t *src);
+
+/*******************************************************************************
+ * Widget Binding Helpers (not provided by LVGL 9.2)
+ ******************************************************************************/
+
+/**
+ * @brief Bind a bar's value to an int subject
+ * @param anim LV_ANIM_ON / LV_ANIM_OFF (animation only starts on changes)
+ */
+lv_observer_t *aic_bind_bar_value(lv_obj_t *bar, lv_subject_t *subject,
+                                  lv_anim_enable_t anim);
+
+/**
+ * @brief Bind an LED widget's brightness to a 0-100 % int subject
+ */
+lv_observer_t *aic_bind_led_percent(lv_obj_t *led, lv_subject_t *subject);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AIC_BIND_H */
@@ -1,172 +1,326 @@
-/*******************************************************************************
- * File: aic_clock.c
- * Description: NTP Clock Display for LVGL
- *
- * Displays current date/time in the top-right corner of the screen.
- * Time is synced via NTP from CM33-NS and maintained locally using
- * FreeRTOS tick counter between syncs.
- *
- * Part of BiiL Course: Embedded C for IoT - Week 7
- ******************************************************************************/
-
-#include "aic_clock.h"
-#include "FreeRTOS.h"
-#include "task.h"
-#include <stdio.h>
-
-/*******************************************************************************
- * Day/Month Name Tables
- ******************************************************************************/
-
-static const char* const day_names[7]   = {
-    "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"
-};
-static const char* const month_names[12] = {
-    "Jan", "Feb", "Mar", "Apr", "May", "Jun",
-    "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
-};
-static const int days_in_month[12] = {
-    31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31
-};
-
-/*******************************************************************************
- * Epoch to Date/Time Conversion (with UTC+7 applied)
- ******************************************************************************/
-
-static void epoch_to_datetime(uint32_t epoch,
-                              int *year, int *month, int *day,
-                              int *hour, int *min, int *wday)
-{
-    /* Apply Thailand timezone (UTC+7) */
-    epoch += AIC_CLOCK_UTC_OFFSET_SEC;
-
-    /* Time of day */
-    uint32_t total_secs = epoch;
-    *min  = (int)((total_secs / 60) % 60);
-    *hour = (int)((total_secs / 3600) % 24);
-
-    /* Total days since 1970-01-01 */
-    uint32_t total_days = total_secs / 86400;
-
-    /* Day of week: 1970-01-01 = Thursday (4) */
-    *wday = (int)((total_days + 4) % 7);  /* 0=Sun, 4=Thu */
-
-    /* Year */
-    int y = 1970;
-    for (;;) {
-        bool leap = (y % 4 == 0) && ((y % 100 != 0) || (y % 400 == 0));
-        uint32_t ydays = leap ? 366U : 365U;
-        if (total_days < ydays) break;
-        total_days -= ydays;
-        y++;
-    }
-    *year = y;
-
-    /* Month */
-    bool leap = (y % 4 == 0) && ((y % 100 != 0) || (y % 400 == 0));
-    int m = 0;
-    while (m < 12) {
-        int dim = days_in_month[m];
-        if (m == 1 && leap) dim = 29;
-        if (total_days < (uint32_t)dim) break;
-        total_days -= (uint32_t)dim;
-        m++;
-    }
-    *month = m;   /* 0-based */
-    *day = (int)total_days + 1;
-}
-
-/*******************************************************************************
- * Format Time String
- ******************************************************************************/
-
-static void format_time_string(char *buf, size_t buflen, uint32_t epoch)
-{
-    int year, month, day, hour, min, wday;
-    epoch_to_datetime(epoch, &year, &month, &day, &hour, &min, &wday);
-
-    (void)year;  /* Not displayed in compact format */
-    snprintf(buf, buflen, "%s %d %s %02d:%02d",
-             day_names[wday], day, month_names[month], hour, min);
-}
-
-/*******************************************************************************
- * Timer Callback (runs every 60 seconds in LVGL thread)
- ******************************************************************************/
-
-static void clock_timer_cb(lv_timer_t *timer)
-{
-    aic_clock_ctx_t *ctx = (aic_clock_ctx_t *)lv_timer_get_user_data(timer);
-    if (ctx) {
-        aic_clock_update(ctx);
-    }
-}
-
-/*******************************************************************************
- * API Implementation
- ******************************************************************************/
-
-void aic_clock_init(aic_clock_ctx_t* ctx, lv_obj_t* parent)
-{
-    if (!ctx) return;
-
-    /* Default state */
-    ctx->base_epoch   = 0;
-    ctx->base_tick    = 0;
-    ctx->time_synced  = false;
-    ctx->update_timer = NULL;
-
-    /* Use active screen if no parent specified */
-    if (!parent) {
-        parent = lv_screen_active();
-    }
-
-    /* Create time label in top-right corner */
-    ctx->lbl_time = lv_label_create(parent);
-    lv_label_set_text(ctx->lbl_time, "--:--");
-    lv_obj_set_style_text_font(ctx->lbl_time, &lv_font_montserrat_14, 0);
-    lv_obj_set_style_text_color(ctx->lbl_time, lv_color_hex(0x8E8E93), 0);
-    lv_obj_align(ctx->lbl_time, LV_ALIGN_TOP_RIGHT, -10, 6);
-
-    /* Make sure it's on top */
-    lv_obj_move_foreground(ctx->lbl_time);
-
-    /* Don't intercept touches */
-    lv_obj_remove_flag(ctx->lbl_time, LV_OBJ_FLAG_CLICKABLE);
-
-    /* Start 60-second update timer */
-    ctx->update_timer = lv_timer_create(clock_timer_cb,
-                                         AIC_CLOCK_UPDATE_MS, ctx);
-
-    printf("[Clock] Initialized (waiting for NTP sync)\r\n");
-}
-
-void aic_clock_set_time(aic_clock_ctx_t* ctx, uint32_t unix_epoch)
-{
-    if (!ctx) return;
-
-    ctx->base_epoch  = unix_epoch;
-    ctx->base_tick   = (uint32_t)xTaskGetTickCount();
-    ctx->time_synced = true;
-
-    /* Update display immediately */
-    aic_clock_update(ctx);
-
-    printf("[Clock] Time set: epoch=%u\r\n", (unsigned int)unix_epoch);
-}
-
-void aic_clock_update(aic_clock_ctx_t* ctx)
-{
-    if (!ctx || !ctx->lbl_time || !ctx->time_synced) return;
-
-    /* Calculate current epoch from base + elapsed ticks */
-    uint32_t current_tick = (uint32_t)xTaskGetTickCount();
-    uint32_t elapsed_ms   = (current_tick - ctx->base_tick)
-                            * portTICK_PERIOD_MS;
-    uint32_t current_epoch = ctx->base_epoch + (elapsed_ms / 1000);
-
-    /* Format and display */
-    char buf[32];
-    format_time_string(buf, sizeof(buf), current_epoch);
-    lv_label_set_text(ctx->lbl_time, buf);
-}
+/*******************************************************************************
+ * File: aic_clock.c
+ * Description: NTP Clock Display for LVGL
+ *
+ * Displays current date/time in the top-right corner of the screen.
+ * Time is synced via NTP from CM33-NS and maintained locally using
+ * FreeRTOS tick counter between syncs.
+ *
+ * Dates are computed with the days <-> civil date algorithms of Howard
+ * Hinnant (proleptic Gregorian, March-based years): a few divisions, no
+ * loops over years or months.
+ *
+ * Part of BiiL Course: Embedded C for IoT - Week 7
+ ******************************************************************************/
+
+#include "aic_clock.h"
+#include "lat_trace.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ * Day/Month Name Tables
+ ******************************************************************************/
+
+static const char* const day_names[7]   = {
+    "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"
+};
+static const char* const month_names[12] = {
+    "Jan", "Feb", "Mar", "Apr", "May", "Jun",
+    "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+};
+
+/*******************************************************************************
+ * Time Zone Table
+ ******************************************************************************/
+
+#define NO_DST      { 0, 0, 0, 0 }
+
+const aic_clock_zone_t aic_clock_zones[] = {
+    /* name    dst      offset  dst  start (std)               end (dst) */
+    { "ICT",   NULL,    7 * 60,  0,  NO_DST,                   NO_DST },                  /* Thailand */
+    { "UTC",   NULL,    0,       0,  NO_DST,                   NO_DST },
+    { "SGT",   NULL,    8 * 60,  0,  NO_DST,                   NO_DST },                  /* Singapore */
+    { "JST",   NULL,    9 * 60,  0,  NO_DST,                   NO_DST },                  /* Japan */
+    { "IST",   NULL,    5 * 60 + 30, 0, NO_DST,                NO_DST },                  /* India */
+    { "GMT",   "BST",   0,       60, { 3, 5, 0, 1 * 60 },      { 10, 5, 0, 2 * 60 } },    /* UK */
+    { "CET",   "CEST",  1 * 60,  60, { 3, 5, 0, 2 * 60 },      { 10, 5, 0, 3 * 60 } },    /* EU */
+    { "EST",   "EDT",   -5 * 60, 60, { 3, 2, 0, 2 * 60 },      { 11, 1, 0, 2 * 60 } },    /* US East */
+    { "PST",   "PDT",   -8 * 60, 60, { 3, 2, 0, 2 * 60 },      { 11, 1, 0, 2 * 60 } },    /* US West */
+    { "AEST",  "AEDT",  10 * 60, 60, { 10, 1, 0, 2 * 60 },     { 4, 1, 0, 3 * 60 } },     /* Sydney */
+};
+
+const uint32_t aic_clock_zone_count = sizeof(aic_clock_zones) / sizeof(aic_clock_zones[0]);
+
+/*******************************************************************************
+ * Days <-> Civil Date (constant time)
+ ******************************************************************************/
+
+/* Days since 1970-01-01 of a date (month 1-12) */
+static int64_t days_from_civil(int64_t y, int m, int d)
+{
+    y -= (m <= 2);
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t yoe = y - era * 400;                                    /* [0, 399] */
+    int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;   /* [0, 365] */
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;            /* [0, 146096] */
+    return era * 146097 + doe - 719468;
+}
+
+/* Date of a day count since 1970-01-01 */
+static void civil_from_days(int64_t z, int *year, int *month, int *day)
+{
+    z += 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    int64_t doe = z - era * 146097;                                 /* [0, 146096] */
+    int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);          /* [0, 365] */
+    int64_t mp  = (5 * doy + 2) / 153;                              /* [0, 11], March = 0 */
+    int m = (int)(mp < 10 ? mp + 3 : mp - 9);
+
+    *day   = (int)(doy - (153 * mp + 2) / 5 + 1);
+    *month = m;
+    *year  = (int)(yoe + era * 400 + (m <= 2));
+}
+
+static int weekday_from_days(int64_t z)
+{
+    /* 1970-01-01 = Thursday (4) */
+    return (int)(((z + 4) % 7 + 7) % 7);
+}
+
+static int64_t floor_div(int64_t a, int64_t b)
+{
+    int64_t q = a / b;
+    return (q * b > a) ? q - 1 : q;
+}
+
+/* Local midnight (as days) of the week-th wday of a month */
+static int64_t rule_day(int year, const aic_clock_rule_t *rule)
+{
+    int64_t first = days_from_civil(year, rule->month, 1);
+    int offset = (rule->wday - weekday_from_days(first) + 7) % 7;
+    int64_t day = first + offset + 7 * (rule->week - 1);
+
+    if (rule->week >= 5) {
+        /* "Last": step back while past the end of the month */
+        int next_month = (rule->month == 12) ? 1 : rule->month + 1;
+        int64_t next = days_from_civil(year + (rule->month == 12), next_month, 1);
+        while (day >= next) {
+            day -= 7;
+        }
+    }
+    return day;
+}
+
+static bool zone_in_dst(const aic_clock_zone_t *zone, int64_t unix_s)
+{
+    if (zone->dst_min == 0 || zone->dst_start.month == 0) {
+        return false;
+    }
+
+    /* Year of the instant in standard time is close enough for the rules */
+    int year, month, day;
+    civil_from_days(floor_div(unix_s + zone->utc_min * 60, 86400), &year, &month, &day);
+
+    int64_t start = rule_day(year, &zone->dst_start) * 86400 +
+                    zone->dst_start.minute * 60 - zone->utc_min * 60;
+    int64_t end   = rule_day(year, &zone->dst_end) * 86400 +
+                    zone->dst_end.minute * 60 - (zone->utc_min + zone->dst_min) * 60;
+
+    if (start < end) {
+        return (unix_s >= start) && (unix_s < end);   /* Northern hemisphere */
+    }
+    return (unix_s >= start) || (unix_s < end);       /* Southern: spans new year */
+}
+
+void aic_clock_to_local(int64_t unix_s, const aic_clock_zone_t* zone, aic_clock_tm_t* tm)
+{
+    if (!tm) return;
+    if (!zone) zone = &aic_clock_zones[0];
+
+    tm->dst = zone_in_dst(zone, unix_s);
+    int64_t local = unix_s + (int64_t)(zone->utc_min + (tm->dst ? zone->dst_min : 0)) * 60;
+
+    int64_t days = floor_div(local, 86400);
+    int64_t secs = local - days * 86400;
+
+    tm->hour = (int)(secs / 3600);
+    tm->min  = (int)((secs / 60) % 60);
+    tm->sec  = (int)(secs % 60);
+    tm->wday = weekday_from_days(days);
+    civil_from_days(days, &tm->year, &tm->month, &tm->day);
+}
+
+/*******************************************************************************
+ * Format Time String
+ ******************************************************************************/
+
+static void format_time_string(char *buf, size_t buflen, const aic_clock_tm_t *tm,
+                               bool show_seconds)
+{
+    if (show_seconds) {
+        snprintf(buf, buflen, "%s %d %s %02d:%02d:%02d",
+                 day_names[tm->wday], tm->day, month_names[tm->month - 1],
+                 tm->hour, tm->min, tm->sec);
+    } else {
+        snprintf(buf, buflen, "%s %d %s %02d:%02d",
+                 day_names[tm->wday], tm->day, month_names[tm->month - 1],
+                 tm->hour, tm->min);
+    }
+}
+
+/*******************************************************************************
+ * Timer Callback (runs at each displayed change in LVGL thread)
+ ******************************************************************************/
+
+static void clock_timer_cb(lv_timer_t *timer)
+{
+    aic_clock_ctx_t *ctx = (aic_clock_ctx_t *)lv_timer_get_user_data(timer);
+    if (ctx) {
+        aic_clock_update(ctx);
+    }
+}
+
+/*******************************************************************************
+ * API Implementation
+ ******************************************************************************/
+
+void aic_clock_init(aic_clock_ctx_t* ctx, lv_obj_t* parent)
+{
+    if (!ctx) return;
+
+    /* Default state */
+    memset(ctx, 0, sizeof(aic_clock_ctx_t));
+    ctx->show_seconds = AIC_CLOCK_DEFAULT_SECONDS;
+    if (!aic_clock_set_zone(ctx, AIC_CLOCK_DEFAULT_ZONE)) {
+        ctx->zone = &aic_clock_zones[0];
+    }
+
+    /* Use active screen if no parent specified */
+    if (!parent) {
+        parent = lv_screen_active();
+    }
+
+    /* Create time label in top-right corner */
+    ctx->lbl_time = lv_label_create(parent);
+    lv_label_set_text(ctx->lbl_time, "--:--");
+    lv_obj_set_style_text_font(ctx->lbl_time, &lv_font_montserrat_14, 0);
+    lv_obj_set_style_text_color(ctx->lbl_time, lv_color_hex(0x8E8E93), 0);
+    lv_obj_align(ctx->lbl_time, LV_ALIGN_TOP_RIGHT, -10, 6);
+
+    /* Make sure it's on top */
+    lv_obj_move_foreground(ctx->lbl_time);
+
+    /* Don't intercept touches */
+    lv_obj_remove_flag(ctx->lbl_time, LV_OBJ_FLAG_CLICKABLE);
+
+    /* Start update timer; re-armed for the next change once synced */
+    ctx->update_timer = lv_timer_create(clock_timer_cb,
+                                         AIC_CLOCK_UPDATE_MS, ctx);
+
+    printf("[Clock] Initialized (waiting for NTP sync)\r\n");
+}
+
+void aic_clock_set_time(aic_clock_ctx_t* ctx, uint32_t unix_epoch)
+{
+    if (!ctx) return;
+
+    ctx->base_ms     = (int64_t)unix_epoch * 1000;
+    ctx->base_tick   = (uint32_t)xTaskGetTickCount();
+    ctx->time_synced = true;
+
+    /* Update display immediately */
+    aic_clock_update(ctx);
+
+    printf("[Clock] Time set: epoch=%u\r\n", (unsigned int)unix_epoch);
+}
+
+void aic_clock_set_time_ntp(aic_clock_ctx_t* ctx, const ipc_ntp_time_t* t)
+{
+    if (!ctx || !t) return;
+
+    int64_t unix_us = (int64_t)t->unix_s * 1000000 + t->unix_us;
+
+    /* Age of the time since CM33 read it, in CM33 clock terms */
+    int32_t offset_us;
+    uint32_t rtt_us;
+    if (lat_trace_get_offset(&offset_us, &rtt_us)) {
+        uint32_t cm33_now = lat_trace_now_us() + (uint32_t)offset_us;
+        int32_t age_us = (int32_t)(cm33_now - t->cm33_us);
+        if (age_us > 0) {
+            unix_us += age_us;
+        }
+    }
+
+    ctx->base_ms     = unix_us / 1000;
+    ctx->base_tick   = (uint32_t)xTaskGetTickCount();
+    ctx->time_synced = true;
+
+    aic_clock_update(ctx);
+
+    printf("[Clock] Time set: epoch=%u.%06u, CM33 drift %ld ppb\r\n",
+           (unsigned int)t->unix_s, (unsigned int)t->unix_us, (long)t->drift_ppb);
+}
+
+bool aic_clock_set_zone(aic_clock_ctx_t* ctx, const char* name)
+{
+    if (!ctx || !name) return false;
+
+    for (uint32_t i = 0; i < aic_clock_zone_count; i++) {
+        const aic_clock_zone_t* zone = &aic_clock_zones[i];
+        if (strcmp(zone->name, name) == 0 ||
+            (zone->dst_name && strcmp(zone->dst_name, name) == 0)) {
+            ctx->zone = zone;
+            aic_clock_update(ctx);
+            return true;
+        }
+    }
+    return false;
+}
+
+void aic_clock_show_seconds(aic_clock_ctx_t* ctx, bool show)
+{
+    if (!ctx) return;
+
+    ctx->show_seconds = show;
+    aic_clock_update(ctx);
+}
+
+bool aic_clock_now_ms(const aic_clock_ctx_t* ctx, int64_t* unix_ms)
+{
+    if (!ctx || !unix_ms || !ctx->time_synced) return false;
+
+    /* Elapsed since the sync (see aic_clock.h on drift) */
+    uint32_t current_tick = (uint32_t)xTaskGetTickCount();
+    int64_t elapsed_ms = (int64_t)(uint32_t)(current_tick - ctx->base_tick)
+                         * portTICK_PERIOD_MS;
+
+    *unix_ms = ctx->base_ms + elapsed_ms;
+    return true;
+}
+
+void aic_clock_update(aic_clock_ctx_t* ctx)
+{
+    int64_t now_ms;
+    if (!ctx || !ctx->lbl_time || !aic_clock_now_ms(ctx, &now_ms)) return;
+
+    aic_clock_tm_t tm;
+    aic_clock_to_local(floor_div(now_ms, 1000), ctx->zone, &tm);
+
+    /* Format and display */
+    char buf[32];
+    format_time_string(buf, sizeof(buf), &tm, ctx->show_seconds);
+    lv_label_set_text(ctx->lbl_time, buf);
+
+    /* Next update just after the next second / minute boundary
+     * (zone offsets are whole minutes, so UTC boundaries are local ones) */
+    if (ctx->update_timer) {
+        uint32_t unit_ms = ctx->show_seconds ? 1000U : 60000U;
+        uint32_t into_ms = (uint32_t)(now_ms - floor_div(now_ms, unit_ms) * unit_ms);
+        lv_timer_set_period(ctx->update_timer, unit_ms - into_ms + 5U);
+        lv_timer_reset(ctx->update_timer);
+    }
+}
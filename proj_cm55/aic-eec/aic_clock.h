@@ -1,85 +1,165 @@
-/*******************************************************************************
- * File: aic_clock.h
- * Description: NTP Clock Display for LVGL
- *
- * Displays current date/time in the top-right corner of the screen.
- * Time is synced via NTP from CM33-NS and maintained locally using
- * FreeRTOS tick counter for auto-update every 60 seconds.
- *
- * Format: "Thu 12 Feb 23:40" (UTC+7 Thailand)
- *
- * Part of BiiL Course: Embedded C for IoT - Week 7
- ******************************************************************************/
-
-#ifndef AIC_CLOCK_H
-#define AIC_CLOCK_H
-
-#include "lvgl.h"
-#include <stdint.h>
-#include <stdbool.h>
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-/*******************************************************************************
- * Configuration
- ******************************************************************************/
-
-#define AIC_CLOCK_UTC_OFFSET_SEC    (7 * 3600)  /* UTC+7 Thailand */
-#define AIC_CLOCK_UPDATE_MS         (60000U)    /* Update display every 60s */
-
-/*******************************************************************************
- * Clock Context Structure
- ******************************************************************************/
-
-typedef struct {
-    lv_obj_t*   lbl_time;       /* LVGL label showing time */
-    lv_timer_t* update_timer;   /* 60-second update timer */
-    uint32_t    base_epoch;     /* Unix epoch from NTP sync */
-    uint32_t    base_tick;      /* FreeRTOS tick at sync moment */
-    bool        time_synced;    /* true after first NTP sync */
-} aic_clock_ctx_t;
-
-/*******************************************************************************
- * API Functions
- ******************************************************************************/
-
-/**
- * @brief Initialize clock display on given parent
- *
- * Creates a label at the top-right corner showing "--:--" until NTP syncs.
- * Starts a 60-second LVGL timer for auto-update.
- *
- * @param ctx    Pointer to clock context (caller allocates)
- * @param parent LVGL parent object (NULL = active screen)
- */
-void aic_clock_init(aic_clock_ctx_t* ctx, lv_obj_t* parent);
-
-/**
- * @brief Set time from NTP epoch
- *
- * Called when IPC_CMD_NTP_TIME is received from CM33.
- * Stores base_epoch and base_tick for local time calculation.
- * Updates the display immediately.
- *
- * @param ctx        Pointer to clock context
- * @param unix_epoch Unix timestamp (seconds since 1970-01-01 00:00:00 UTC)
- */
-void aic_clock_set_time(aic_clock_ctx_t* ctx, uint32_t unix_epoch);
-
-/**
- * @brief Force-update the clock display
- *
- * Recalculates current time from base_epoch + elapsed ticks.
- * Called automatically by the 60-second timer.
- *
- * @param ctx  Pointer to clock context
- */
-void aic_clock_update(aic_clock_ctx_t* ctx);
-
-#ifdef __cplusplus
-}
-#endif
-
-#endif /* AIC_CLOCK_H */
+/*******************************************************************************
+ * File: aic_clock.h
+ * Description: NTP Clock Display for LVGL
+ *
+ * Displays current date/time in the top-right corner of the screen.
+ * Time is synced via NTP from CM33-NS and interpolated locally from the
+ * FreeRTOS tick counter; the label is refreshed right at each minute (or
+ * second) boundary. The tick is not corrected by the drift SNTP measured:
+ * that is the rate error of CM33's clock, while the CM55 tick is kept by
+ * the LPTimer on CLK_LF in tickless sleep. Its error is bounded by the
+ * resync every SNTP poll interval (at most 1024 s).
+ *
+ * Format: "Thu 12 Feb 23:40" or "Thu 12 Feb 23:40:05", in a time zone
+ * from the aic_clock_zones[] table (default Thailand, UTC+7).
+ *
+ * Part of BiiL Course: Embedded C for IoT - Week 7
+ ******************************************************************************/
+
+#ifndef AIC_CLOCK_H
+#define AIC_CLOCK_H
+
+#include "lvgl.h"
+#include "../../shared/ipc_shared.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * Configuration
+ ******************************************************************************/
+
+#define AIC_CLOCK_DEFAULT_ZONE      "ICT"       /* Thailand, UTC+7 */
+#define AIC_CLOCK_DEFAULT_SECONDS   false       /* Show seconds */
+#define AIC_CLOCK_UPDATE_MS         (60000U)    /* Longest gap between updates */
+
+/*******************************************************************************
+ * Time Zone Table
+ ******************************************************************************/
+
+/**
+ * @brief Daylight saving transition: the week-th wday of month, at minute
+ *        of local time (standard time for the start, daylight for the end)
+ */
+typedef struct {
+    uint8_t  month;             /* 1-12, 0 = no DST */
+    uint8_t  week;              /* 1-4, 5 = last */
+    uint8_t  wday;              /* 0 = Sunday */
+    uint16_t minute;            /* Minutes after local midnight */
+} aic_clock_rule_t;
+
+typedef struct {
+    const char*      name;      /* Standard time abbreviation, lookup key */
+    const char*      dst_name;  /* Daylight time abbreviation, NULL = no DST */
+    int16_t          utc_min;   /* Standard time offset from UTC */
+    int16_t          dst_min;   /* Added during DST */
+    aic_clock_rule_t dst_start;
+    aic_clock_rule_t dst_end;
+} aic_clock_zone_t;
+
+extern const aic_clock_zone_t aic_clock_zones[];
+extern const uint32_t aic_clock_zone_count;
+
+/*******************************************************************************
+ * Clock Context Structure
+ ******************************************************************************/
+
+typedef struct {
+    lv_obj_t*   lbl_time;       /* LVGL label showing time */
+    lv_timer_t* update_timer;   /* Fires at the next displayed change */
+    int64_t     base_ms;        /* Unix time (ms) at base_tick */
+    uint32_t    base_tick;      /* FreeRTOS tick at sync moment */
+    const aic_clock_zone_t* zone;
+    bool        show_seconds;
+    bool        time_synced;    /* true after first NTP sync */
+} aic_clock_ctx_t;
+
+/**
+ * @brief Broken-down local time
+ */
+typedef struct {
+    int year;
+    int month;                  /* 1-12 */
+    int day;                    /* 1-31 */
+    int hour;
+    int min;
+    int sec;
+    int wday;                   /* 0 = Sunday */
+    bool dst;
+} aic_clock_tm_t;
+
+/*******************************************************************************
+ * API Functions
+ ******************************************************************************/
+
+/**
+ * @brief Initialize clock display on given parent
+ *
+ * Creates a label at the top-right corner showing "--:--" until NTP syncs.
+ *
+ * @param ctx    Pointer to clock context (caller allocates)
+ * @param parent LVGL parent object (NULL = active screen)
+ */
+void aic_clock_init(aic_clock_ctx_t* ctx, lv_obj_t* parent);
+
+/**
+ * @brief Set time from NTP epoch
+ *
+ * Called when IPC_CMD_NTP_TIME is received from CM33 (msg.value).
+ * Updates the display immediately.
+ *
+ * @param ctx        Pointer to clock context
+ * @param unix_epoch Unix timestamp (seconds since 1970-01-01 00:00:00 UTC)
+ */
+void aic_clock_set_time(aic_clock_ctx_t* ctx, uint32_t unix_epoch);
+
+/**
+ * @brief Set time from the full NTP result (IPC_CMD_NTP_TIME msg.data)
+ *
+ * Keeps the microseconds, and takes out the IPC delay using
+ * the cross-core clock offset of lat_trace when it has one.
+ *
+ * @param ctx  Pointer to clock context
+ * @param t    NTP time from CM33
+ */
+void aic_clock_set_time_ntp(aic_clock_ctx_t* ctx, const ipc_ntp_time_t* t);
+
+/**
+ * @brief Select the time zone by name ("ICT", "UTC", "CET", ...)
+ * @return false if the name is not in aic_clock_zones[]
+ */
+bool aic_clock_set_zone(aic_clock_ctx_t* ctx, const char* name);
+
+/**
+ * @brief Show or hide seconds
+ */
+void aic_clock_show_seconds(aic_clock_ctx_t* ctx, bool show);
+
+/**
+ * @brief Current Unix time in milliseconds
+ * @return false before the first sync
+ */
+bool aic_clock_now_ms(const aic_clock_ctx_t* ctx, int64_t* unix_ms);
+
+/**
+ * @brief Convert Unix time to local time in a zone (constant time)
+ */
+void aic_clock_to_local(int64_t unix_s, const aic_clock_zone_t* zone, aic_clock_tm_t* tm);
+
+/**
+ * @brief Force-update the clock display
+ *
+ * Called automatically by the update timer.
+ *
+ * @param ctx  Pointer to clock context
+ */
+void aic_clock_update(aic_clock_ctx_t* ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AIC_CLOCK_H */
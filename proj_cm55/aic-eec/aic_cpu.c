@@ -0,0 +1,114 @@
+/*******************************************************************************
+ * File: aic_cpu.c
+ * Description: AIC-EEC CPU Load Overlay Implementation
+ *
+ * Part of BiiL Course: Embedded C for IoT
+ ******************************************************************************/
+
+#include "aic_cpu.h"
+#include "cpu_load.h"
+#include <stdio.h>
+
+/*******************************************************************************
+ * Static Variables
+ ******************************************************************************/
+
+#define AIC_CPU_TEXT_MAX    256
+
+static lv_obj_t *overlay = NULL;
+static lv_timer_t *refresh_timer = NULL;
+static aic_cpu_request_cb_t request_remote = NULL;
+static char text[AIC_CPU_TEXT_MAX];
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+
+static size_t append_line(size_t len, const char *core, uint16_t load_x10)
+{
+    if (len < AIC_CPU_TEXT_MAX) {
+        int n = snprintf(&text[len], AIC_CPU_TEXT_MAX - len, "%s%s %u.%u%%",
+                         (len > 0U) ? "\n" : "", core, load_x10 / 10U, load_x10 % 10U);
+        len = (n > 0) ? LV_MIN(len + (size_t)n, AIC_CPU_TEXT_MAX) : len;
+    }
+    return len;
+}
+
+static size_t append_task(size_t len, const char *name, uint16_t load_x10)
+{
+    if (len < AIC_CPU_TEXT_MAX) {
+        int n = snprintf(&text[len], AIC_CPU_TEXT_MAX - len, "\n  %-.8s %u.%u%%",
+                         (name != NULL) ? name : "?", load_x10 / 10U, load_x10 % 10U);
+        len = (n > 0) ? LV_MIN(len + (size_t)n, AIC_CPU_TEXT_MAX) : len;
+    }
+    return len;
+}
+
+static void refresh_timer_cb(lv_timer_t *timer)
+{
+    (void)timer;
+    cpu_load_task_t tasks[AIC_CPU_TASK_ROWS];
+    ipc_cpu_report_t remote;
+    size_t len = 0;
+
+    uint32_t listed = cpu_load_get_tasks(tasks, AIC_CPU_TASK_ROWS, NULL);
+    len = append_line(len, "CM55", cpu_load_get_total_x10());
+    for (uint32_t i = 0; i < listed; i++) {
+        len = append_task(len, tasks[i].name, tasks[i].load_x10);
+    }
+
+    if (cpu_load_get_remote(&remote)) {
+        char name[IPC_MEM_TASK_NAME_LEN + 1];
+
+        len = append_line(len, "CM33", remote.total_x10);
+        for (uint32_t i = 0; i < remote.task_listed && i < AIC_CPU_TASK_ROWS; i++) {
+            lv_memcpy(name, remote.tasks[i].name, IPC_MEM_TASK_NAME_LEN);
+            name[IPC_MEM_TASK_NAME_LEN] = '\0';
+            len = append_task(len, name, remote.tasks[i].load_x10);
+        }
+    }
+
+    lv_label_set_text_static(overlay, text);
+
+    if (request_remote != NULL) {
+        request_remote();
+    }
+}
+
+/*******************************************************************************
+ * Public Functions
+ ******************************************************************************/
+
+lv_obj_t *aic_cpu_overlay_show(aic_cpu_request_cb_t request_cb)
+{
+    request_remote = request_cb;
+
+    if (overlay != NULL) {
+        return overlay;
+    }
+
+    /* Same look as the LVGL sysmon performance monitor */
+    overlay = lv_label_create(lv_layer_top());
+    lv_obj_set_style_bg_opa(overlay, LV_OPA_50, 0);
+    lv_obj_set_style_bg_color(overlay, lv_color_black(), 0);
+    lv_obj_set_style_text_color(overlay, lv_color_white(), 0);
+    lv_obj_set_style_text_font(overlay, &lv_font_montserrat_12, 0);
+    lv_obj_set_style_pad_all(overlay, 4, 0);
+    lv_obj_align(overlay, LV_ALIGN_BOTTOM_RIGHT, 0, 0);
+    lv_label_set_text_static(overlay, "CPU ...");
+
+    refresh_timer = lv_timer_create(refresh_timer_cb, AIC_CPU_REFRESH_MS, NULL);
+    return overlay;
+}
+
+void aic_cpu_overlay_hide(void)
+{
+    if (refresh_timer != NULL) {
+        lv_timer_delete(refresh_timer);
+        refresh_timer = NULL;
+    }
+    if (overlay != NULL) {
+        lv_obj_delete(overlay);
+        overlay = NULL;
+    }
+}
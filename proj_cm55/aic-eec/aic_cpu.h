@@ -0,0 +1,68 @@
+/*******************************************************************************
+ * File: aic_cpu.h
+ * Description: AIC-EEC CPU Load Overlay
+ *
+ * Small sysmon-style overlay on lv_layer_top() showing the load of both
+ * cores and their busiest tasks, from shared/include/cpu_load.h. CM33
+ * figures come from the last IPC_CMD_CPU_REPORT.
+ *
+ * Must be used from the LVGL task only.
+ *
+ * Part of BiiL Course: Embedded C for IoT
+ ******************************************************************************/
+
+#ifndef AIC_CPU_H
+#define AIC_CPU_H
+
+#include "lvgl.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * Configuration
+ ******************************************************************************/
+
+#ifndef AIC_CPU_REFRESH_MS
+#define AIC_CPU_REFRESH_MS      1000U   /* Overlay update period */
+#endif
+
+#ifndef AIC_CPU_TASK_ROWS
+#define AIC_CPU_TASK_ROWS       3       /* Busiest tasks shown per core */
+#endif
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+
+/**
+ * @brief Called on each refresh to ask CM33 for a fresh load report
+ *
+ * Typically: cm55_ipc_send_cmd(IPC_CMD_CPU_REQ, 0).
+ */
+typedef void (*aic_cpu_request_cb_t)(void);
+
+/*******************************************************************************
+ * API Functions
+ ******************************************************************************/
+
+/**
+ * @brief Show the overlay (bottom-right of the top layer)
+ * @param request_cb Remote report request (NULL = CM55 only)
+ * @return Overlay label
+ */
+lv_obj_t *aic_cpu_overlay_show(aic_cpu_request_cb_t request_cb);
+
+/**
+ * @brief Remove the overlay
+ */
+void aic_cpu_overlay_hide(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AIC_CPU_H */
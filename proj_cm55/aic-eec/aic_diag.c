@@ -0,0 +1,238 @@
+/*******************************************************************************
+ * File: aic_diag.c
+ * Description: AIC-EEC Diagnostics Screen Implementation
+ *
+ * Part of BiiL Course: Embedded C for IoT
+ ******************************************************************************/
+
+#include "aic_diag.h"
+#include "aic_screen.h"
+#include "aic_latency.h"
+#include <stdio.h>
+
+/*******************************************************************************
+ * Static Variables
+ ******************************************************************************/
+
+#define AIC_DIAG_TEXT_MAX       384
+
+static int home_id = AIC_SCREEN_INVALID;
+static int diag_id = AIC_SCREEN_INVALID;
+static lv_obj_t *screens_label = NULL;
+static lv_obj_t *mem_panel = NULL;
+static aic_mem_request_cb_t mem_request = NULL;
+static aic_cpu_request_cb_t cpu_request = NULL;
+static bool cpu_overlay_on = false;      /* Overlays outlive the screen */
+static bool latency_overlay_on = false;
+static char text[AIC_DIAG_TEXT_MAX];
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+
+static void refresh_screens(void)
+{
+    aic_screen_stats_t s;
+    size_t len = 0;
+    int n;
+
+    text[0] = '\0';
+    for (int id = 0; id < aic_screen_count() && len < AIC_DIAG_TEXT_MAX; id++) {
+        (void)aic_screen_get_stats(id, &s);
+        n = snprintf(&text[len], AIC_DIAG_TEXT_MAX - len,
+                     "%s%-12s %-6s builds %lu  build %lu ms  switch %lu ms  objs %lu",
+                     (len > 0U) ? "\n" : "", aic_screen_get_name(id),
+                     s.built ? "cached" : "-", (unsigned long)s.build_count,
+                     (unsigned long)s.build_time_ms, (unsigned long)s.last_switch_ms,
+                     (unsigned long)s.obj_count);
+        len = (n > 0) ? LV_MIN(len + (size_t)n, AIC_DIAG_TEXT_MAX) : len;
+    }
+
+    lv_label_set_text_static(screens_label, text);
+}
+
+static void show_home(void)
+{
+    (void)aic_screen_show(home_id, LV_SCR_LOAD_ANIM_MOVE_BOTTOM, AIC_DIAG_ANIM_MS);
+}
+
+static void home_gesture_cb(lv_event_t *e)
+{
+    (void)e;
+    lv_indev_t *indev = lv_indev_active();
+
+    if (lv_indev_get_gesture_dir(indev) == LV_DIR_TOP) {
+        lv_indev_wait_release(indev);
+        aic_diag_show();
+    }
+}
+
+static void diag_gesture_cb(lv_event_t *e)
+{
+    (void)e;
+    lv_indev_t *indev = lv_indev_active();
+
+    if (lv_indev_get_gesture_dir(indev) == LV_DIR_BOTTOM) {
+        lv_indev_wait_release(indev);
+        show_home();
+    }
+}
+
+static void back_btn_cb(lv_event_t *e)
+{
+    (void)e;
+    show_home();
+}
+
+static void diag_loaded_cb(lv_event_t *e)
+{
+    (void)e;
+    refresh_screens();
+    aic_mem_panel_refresh(mem_panel);
+}
+
+/* Evicted by aic_screen - rebuilt on the next visit */
+static void diag_delete_cb(lv_event_t *e)
+{
+    (void)e;
+    screens_label = NULL;
+    mem_panel = NULL;
+}
+
+static lv_obj_t *section_label(lv_obj_t *parent, const char *text)
+{
+    lv_obj_t *label = lv_label_create(parent);
+    lv_label_set_text(label, text);
+    lv_obj_set_style_text_font(label, &lv_font_montserrat_14, 0);
+    lv_obj_set_style_text_color(label, lv_color_hex(0x808080), 0);
+    return label;
+}
+
+static void cpu_switch_cb(lv_event_t *e)
+{
+    cpu_overlay_on = lv_obj_has_state(lv_event_get_target_obj(e), LV_STATE_CHECKED);
+    if (cpu_overlay_on) {
+        (void)aic_cpu_overlay_show(cpu_request);
+    } else {
+        aic_cpu_overlay_hide();
+    }
+}
+
+static void latency_switch_cb(lv_event_t *e)
+{
+    latency_overlay_on = lv_obj_has_state(lv_event_get_target_obj(e), LV_STATE_CHECKED);
+    if (latency_overlay_on) {
+        (void)aic_latency_overlay_show();
+    } else {
+        aic_latency_overlay_hide();
+    }
+}
+
+static void overlay_switch(lv_obj_t *parent, const char *text, bool on, lv_event_cb_t cb)
+{
+    lv_obj_t *sw = lv_switch_create(parent);
+    if (on) {
+        lv_obj_add_state(sw, LV_STATE_CHECKED);
+    }
+    lv_obj_add_event_cb(sw, cb, LV_EVENT_VALUE_CHANGED, NULL);
+
+    lv_obj_t *label = lv_label_create(parent);
+    lv_label_set_text(label, text);
+    lv_obj_set_style_text_color(label, lv_color_white(), 0);
+}
+
+static void build_diag(lv_obj_t *screen, void *user_data)
+{
+    (void)user_data;
+
+    lv_obj_set_style_bg_color(screen, lv_color_hex(0x121212), 0);
+    lv_obj_set_style_pad_all(screen, 12, 0);
+    lv_obj_set_style_pad_row(screen, 8, 0);
+    lv_obj_set_flex_flow(screen, LV_FLEX_FLOW_COLUMN);
+    lv_obj_remove_flag(screen, LV_OBJ_FLAG_SCROLLABLE);    /* Vertical swipes navigate */
+
+    /* Header: title + Back */
+    lv_obj_t *header = lv_obj_create(screen);
+    lv_obj_remove_style_all(header);
+    lv_obj_set_size(header, LV_PCT(100), LV_SIZE_CONTENT);
+    lv_obj_set_flex_flow(header, LV_FLEX_FLOW_ROW);
+    lv_obj_set_flex_align(header, LV_FLEX_ALIGN_SPACE_BETWEEN, LV_FLEX_ALIGN_CENTER,
+                          LV_FLEX_ALIGN_CENTER);
+
+    lv_obj_t *title = lv_label_create(header);
+    lv_label_set_text(title, "Diagnostics");
+    lv_obj_set_style_text_font(title, &lv_font_montserrat_24, 0);
+    lv_obj_set_style_text_color(title, lv_color_white(), 0);
+
+    lv_obj_t *back = lv_button_create(header);
+    lv_obj_t *back_label = lv_label_create(back);
+    lv_label_set_text(back_label, LV_SYMBOL_LEFT " Back");
+    lv_obj_add_event_cb(back, back_btn_cb, LV_EVENT_CLICKED, NULL);
+
+    /* Screen manager statistics, refreshed on every visit */
+    section_label(screen, "Screens");
+    screens_label = lv_label_create(screen);
+    lv_obj_set_style_text_font(screens_label, &lv_font_montserrat_14, 0);
+    lv_obj_set_style_text_color(screens_label, lv_color_hex(0xE0E0E0), 0);
+
+    /* Overlays on the top layer, shown over the example too */
+    section_label(screen, "Overlays");
+    lv_obj_t *overlays = lv_obj_create(screen);
+    lv_obj_remove_style_all(overlays);
+    lv_obj_set_size(overlays, LV_PCT(100), LV_SIZE_CONTENT);
+    lv_obj_set_flex_flow(overlays, LV_FLEX_FLOW_ROW);
+    lv_obj_set_flex_align(overlays, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER,
+                          LV_FLEX_ALIGN_CENTER);
+    lv_obj_set_style_pad_column(overlays, 12, 0);
+    overlay_switch(overlays, "CPU load", cpu_overlay_on, cpu_switch_cb);
+    overlay_switch(overlays, "IMU latency", latency_overlay_on, latency_switch_cb);
+
+    /* Memory of both cores; refreshes itself while this screen is shown */
+    section_label(screen, "Memory");
+    mem_panel = aic_mem_panel_create(screen, mem_request);
+
+    lv_obj_add_event_cb(screen, diag_gesture_cb, LV_EVENT_GESTURE, NULL);
+    lv_obj_add_event_cb(screen, diag_loaded_cb, LV_EVENT_SCREEN_LOADED, NULL);
+    lv_obj_add_event_cb(screen, diag_delete_cb, LV_EVENT_DELETE, NULL);
+}
+
+/*******************************************************************************
+ * Public Functions
+ ******************************************************************************/
+
+int aic_diag_init(int home)
+{
+    lv_obj_t *home_obj = aic_screen_get_obj(home);
+    if (home_obj == NULL) {
+        return AIC_SCREEN_INVALID;
+    }
+
+    if (diag_id == AIC_SCREEN_INVALID) {
+        diag_id = aic_screen_register("diagnostics", build_diag, NULL);
+        if (diag_id == AIC_SCREEN_INVALID) {
+            return AIC_SCREEN_INVALID;
+        }
+    }
+
+    home_id = home;
+    lv_obj_add_event_cb(home_obj, home_gesture_cb, LV_EVENT_GESTURE, NULL);
+
+    /* Built once the user is idle - never ahead of the first frame */
+    aic_screen_prefetch(diag_id);
+    return diag_id;
+}
+
+void aic_diag_set_mem_request(aic_mem_request_cb_t request_cb)
+{
+    mem_request = request_cb;
+}
+
+void aic_diag_set_cpu_request(aic_cpu_request_cb_t request_cb)
+{
+    cpu_request = request_cb;
+}
+
+void aic_diag_show(void)
+{
+    (void)aic_screen_show(diag_id, LV_SCR_LOAD_ANIM_MOVE_TOP, AIC_DIAG_ANIM_MS);
+}
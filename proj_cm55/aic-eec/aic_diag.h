@@ -0,0 +1,73 @@
+/*******************************************************************************
+ * File: aic_diag.h
+ * Description: AIC-EEC Diagnostics Screen
+ *
+ * A second screen next to the running example, managed by aic_screen:
+ * registered at start-up, pre-built while the user is idle, opened with
+ * a swipe up on the example screen and left with a swipe down or Back.
+ * Shows the aic_screen build and switch statistics and the memory panel
+ * (aic_mem.h) of both cores, and turns the CPU load (aic_cpu.h) and
+ * sensor-to-pixel latency (aic_latency.h) overlays on and off.
+ *
+ * Must be used from the LVGL task only.
+ *
+ * Part of BiiL Course: Embedded C for IoT
+ ******************************************************************************/
+
+#ifndef AIC_DIAG_H
+#define AIC_DIAG_H
+
+#include "lvgl.h"
+#include "aic_mem.h"
+#include "aic_cpu.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * Configuration
+ ******************************************************************************/
+
+#ifndef AIC_DIAG_ANIM_MS
+#define AIC_DIAG_ANIM_MS        200U    /* Screen slide time */
+#endif
+
+/*******************************************************************************
+ * API Functions
+ ******************************************************************************/
+
+/**
+ * @brief Register the diagnostics screen and hook the swipe on the home screen
+ * @param home_id aic_screen id of the screen to return to (already shown)
+ * @return Diagnostics screen id, or AIC_SCREEN_INVALID
+ */
+int aic_diag_init(int home_id);
+
+/**
+ * @brief Set the CM33 memory report request of the memory panel
+ *
+ * Call before aic_diag_init(); the panel is created with the screen.
+ * Typically: cm55_ipc_send_cmd(IPC_CMD_MEM_REQ, 0).
+ */
+void aic_diag_set_mem_request(aic_mem_request_cb_t request_cb);
+
+/**
+ * @brief Set the CM33 load report request of the CPU overlay
+ *
+ * Typically: cm55_ipc_send_cmd(IPC_CMD_CPU_REQ, 0).
+ */
+void aic_diag_set_cpu_request(aic_cpu_request_cb_t request_cb);
+
+/**
+ * @brief Open the diagnostics screen
+ */
+void aic_diag_show(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AIC_DIAG_H */
@@ -8,6 +8,9 @@
  ******************************************************************************/
 
 #include "aic_event.h"
+#include "aic_work.h"
+#include "static_mem.h"
+#include "../lv_port_disp.h"
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
@@ -37,9 +40,15 @@ static bool event_initialized = false;
 static subscriber_t subscribers[AIC_EVENT_MAX][AIC_EVENT_MAX_SUBSCRIBERS];
 static uint8_t subscriber_counts[AIC_EVENT_MAX];
 
+STATIC_QUEUE_DEFINE(event, AIC_EVENT_QUEUE_SIZE, sizeof(event_entry_t));
+STATIC_MUTEX_DEFINE(event);
+
 static QueueHandle_t event_queue = NULL;
-static TaskHandle_t event_task_handle = NULL;
 static SemaphoreHandle_t event_mutex = NULL;
+static bool event_on_executor = false;
+
+static void event_work_fn(void *arg);
+static aic_work_t event_work = AIC_WORK_INIT("event", event_work_fn, AIC_WORK_PRIO_NORMAL);
 
 /*******************************************************************************
  * Helper Functions
@@ -64,22 +73,21 @@ static void deliver_event(aic_event_t event, const aic_event_data_t *data)
     }
 
     xSemaphoreGive(event_mutex);
+
+    /* Subscribers update UI state; let LVGL render it now */
+    if (subscriber_counts[event] > 0) {
+        lv_port_disp_wake();
+    }
 }
 
 /*******************************************************************************
- * Event Task
+ * Event Work (runs on the aic_work executor)
  ******************************************************************************/
 
-static void event_task(void *param)
+static void event_work_fn(void *arg)
 {
-    (void)param;
-    event_entry_t entry;
-
-    while (1) {
-        if (xQueueReceive(event_queue, &entry, portMAX_DELAY) == pdTRUE) {
-            deliver_event(entry.event, entry.has_data ? &entry.data : NULL);
-        }
-    }
+    (void)arg;
+    aic_event_process();
 }
 
 /*******************************************************************************
@@ -97,20 +105,20 @@ bool aic_event_init(void)
     memset(subscriber_counts, 0, sizeof(subscriber_counts));
 
     /* Create queue */
-    event_queue = xQueueCreate(AIC_EVENT_QUEUE_SIZE, sizeof(event_entry_t));
+    event_queue = STATIC_QUEUE_CREATE(event, "aic_event", sizeof(event_entry_t));
     if (event_queue == NULL) {
         return false;
     }
 
     /* Create mutex */
-    event_mutex = xSemaphoreCreateMutex();
+    event_mutex = STATIC_MUTEX_CREATE(event, "aic_event");
     if (event_mutex == NULL) {
         vQueueDelete(event_queue);
         event_queue = NULL;
         return false;
     }
 
-    /* Create task */
+    /* Delivery runs on the shared work executor */
     aic_event_create_task();
 
     event_initialized = true;
@@ -282,6 +290,10 @@ bool aic_event_publish(aic_event_t event, const aic_event_data_t *data)
         result = xQueueSend(event_queue, &entry, 0);
     }
 
+    if (result == pdTRUE && event_on_executor) {
+        aic_work_schedule(&event_work);
+    }
+
     return (result == pdTRUE);
 }
 
@@ -312,26 +324,19 @@ uint32_t aic_event_queue_count(void)
 
 void aic_event_create_task(void)
 {
-    if (event_task_handle != NULL) {
+    if (event_on_executor || !aic_work_init()) {
         return;
     }
 
-    xTaskCreate(
-        event_task,
-        "AIC_EVT",
-        AIC_EVENT_TASK_STACK,
-        NULL,
-        AIC_EVENT_TASK_PRIORITY,
-        &event_task_handle
-    );
+    event_on_executor = true;
+    if (event_queue != NULL && uxQueueMessagesWaiting(event_queue) > 0) {
+        aic_work_schedule(&event_work);
+    }
 }
 
 void aic_event_delete_task(void)
 {
-    if (event_task_handle != NULL) {
-        vTaskDelete(event_task_handle);
-        event_task_handle = NULL;
-    }
+    event_on_executor = false;
 }
 
 void aic_event_process(void)
@@ -141,8 +141,6 @@ typedef void (*aic_event_cb_t)(aic_event_t event, const aic_event_data_t *data,
 
 #define AIC_EVENT_MAX_SUBSCRIBERS   (8U)    /**< Max subscribers per event */
 #define AIC_EVENT_QUEUE_SIZE        (16U)   /**< Event queue size */
-#define AIC_EVENT_TASK_STACK        (256U)  /**< Event task stack size */
-#define AIC_EVENT_TASK_PRIORITY     (3U)    /**< Event task priority */
 
 /*******************************************************************************
  * Function Prototypes
@@ -275,16 +273,16 @@ static inline bool aic_event_publish_temp(int16_t temp_centi)
 }
 
 /*******************************************************************************
- * FreeRTOS Task (Internal)
+ * Background Delivery (Internal)
  ******************************************************************************/
 
 /**
- * @brief Create event processing task
+ * @brief Deliver queued events on the aic_work executor (normal priority)
  */
 void aic_event_create_task(void);
 
 /**
- * @brief Delete event processing task
+ * @brief Stop background delivery (use aic_event_process() instead)
  */
 void aic_event_delete_task(void);
 
@@ -0,0 +1,106 @@
+/*******************************************************************************
+ * File: aic_latency.c
+ * Description: AIC-EEC Sensor-to-Pixel Latency Overlay Implementation
+ *
+ * Part of BiiL Course: Embedded C for IoT
+ ******************************************************************************/
+
+#include "aic_latency.h"
+#include "lat_trace.h"
+#include <stdio.h>
+
+/*******************************************************************************
+ * Static Variables
+ ******************************************************************************/
+
+#define AIC_LATENCY_TEXT_MAX    320
+
+static lv_obj_t *overlay = NULL;
+static lv_timer_t *refresh_timer = NULL;
+static char text[AIC_LATENCY_TEXT_MAX];
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+
+static size_t append(size_t len, int n)
+{
+    return (n > 0) ? LV_MIN(len + (size_t)n, AIC_LATENCY_TEXT_MAX) : len;
+}
+
+static void refresh_timer_cb(lv_timer_t *timer)
+{
+    (void)timer;
+    lat_trace_stats_t s;
+    uint32_t samples, dropped, rtt_us;
+    int32_t offset_us;
+    size_t len = 0;
+
+    lat_trace_get_counts(&samples, &dropped);
+    len = append(len, snprintf(text, AIC_LATENCY_TEXT_MAX, "IMU->pixel %lu (drop %lu)",
+                               (unsigned long)samples, (unsigned long)dropped));
+
+    if (lat_trace_get_offset(&offset_us, &rtt_us)) {
+        len = append(len, snprintf(&text[len], AIC_LATENCY_TEXT_MAX - len,
+                                   "\n  sync +-%luus", (unsigned long)(rtt_us / 2U)));
+    } else {
+        len = append(len, snprintf(&text[len], AIC_LATENCY_TEXT_MAX - len,
+                                   "\n  sync pending"));
+    }
+
+    /* avg / max in 0.1 ms */
+    for (uint32_t i = 0; i < LAT_STAGE_COUNT && len < AIC_LATENCY_TEXT_MAX; i++) {
+        (void)lat_trace_get_stage((lat_trace_stage_t)i, &s);
+        uint32_t avg = (s.count > 0U) ? (uint32_t)(s.total_us / s.count) / 100U : 0U;
+        uint32_t max = s.max_us / 100U;
+
+        len = append(len, snprintf(&text[len], AIC_LATENCY_TEXT_MAX - len,
+                                   "\n  %-7s %lu.%lu / %lu.%lu ms",
+                                   lat_trace_stage_name((lat_trace_stage_t)i),
+                                   (unsigned long)(avg / 10U), (unsigned long)(avg % 10U),
+                                   (unsigned long)(max / 10U), (unsigned long)(max % 10U)));
+    }
+
+    lv_label_set_text_static(overlay, text);
+}
+
+/*******************************************************************************
+ * Public Functions
+ ******************************************************************************/
+
+lv_obj_t *aic_latency_overlay_show(void)
+{
+    if (overlay != NULL) {
+        return overlay;
+    }
+
+    /* Same look as the CPU load overlay (aic_cpu.c) */
+    overlay = lv_label_create(lv_layer_top());
+    lv_obj_set_style_bg_opa(overlay, LV_OPA_50, 0);
+    lv_obj_set_style_bg_color(overlay, lv_color_black(), 0);
+    lv_obj_set_style_text_color(overlay, lv_color_white(), 0);
+    lv_obj_set_style_text_font(overlay, &lv_font_montserrat_12, 0);
+    lv_obj_set_style_pad_all(overlay, 4, 0);
+    lv_obj_align(overlay, LV_ALIGN_BOTTOM_LEFT, 0, 0);
+    lv_label_set_text_static(overlay, "IMU->pixel ...");
+
+    refresh_timer = lv_timer_create(refresh_timer_cb, AIC_LATENCY_REFRESH_MS, NULL);
+
+    /* Clock syncs and CM33 reports only while the overlay is up */
+    (void)lat_trace_enable(true);
+    return overlay;
+}
+
+void aic_latency_overlay_hide(void)
+{
+    (void)lat_trace_enable(false);
+
+    if (refresh_timer != NULL) {
+        lv_timer_delete(refresh_timer);
+        refresh_timer = NULL;
+    }
+    if (overlay != NULL) {
+        lv_obj_delete(overlay);
+        overlay = NULL;
+    }
+}
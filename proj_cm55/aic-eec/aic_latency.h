@@ -0,0 +1,59 @@
+/*******************************************************************************
+ * File: aic_latency.h
+ * Description: AIC-EEC Sensor-to-Pixel Latency Overlay
+ *
+ * Small overlay on lv_layer_top() with the per-stage latency of IMU
+ * samples from the CM33 read to the frame on screen, from
+ * shared/include/lat_trace.h (avg / max per stage, samples, drops).
+ *
+ * The widget stage is marked where the IMU value is handed to a widget
+ * (tilt getters, aic_imu_read_all(), aic_imu_get_orientation()), so other
+ * redraws, including this overlay's, do not count as the update.
+ *
+ * The tracer's clock syncs and reports to CM33 run only while the overlay
+ * is shown (lat_trace_enable()).
+ *
+ * Must be used from the LVGL task only.
+ *
+ * Part of BiiL Course: Embedded C for IoT
+ ******************************************************************************/
+
+#ifndef AIC_LATENCY_H
+#define AIC_LATENCY_H
+
+#include "lvgl.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * Configuration
+ ******************************************************************************/
+
+#ifndef AIC_LATENCY_REFRESH_MS
+#define AIC_LATENCY_REFRESH_MS  1000U   /* Overlay update period */
+#endif
+
+/*******************************************************************************
+ * API Functions
+ ******************************************************************************/
+
+/**
+ * @brief Show the overlay (bottom-left of the top layer)
+ * @return Overlay label
+ */
+lv_obj_t *aic_latency_overlay_show(void);
+
+/**
+ * @brief Remove the overlay
+ */
+void aic_latency_overlay_hide(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AIC_LATENCY_H */
@@ -8,6 +8,8 @@
  ******************************************************************************/
 
 #include "aic_log.h"
+#include "aic_work.h"
+#include "static_mem.h"
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
@@ -33,12 +35,18 @@ static bool log_initialized = false;
 static aic_log_level_t current_level = AIC_LOG_INFO;
 static uint8_t output_targets = AIC_LOG_TARGET_PRINTF;
 
+STATIC_QUEUE_DEFINE(log, AIC_LOG_QUEUE_SIZE, sizeof(log_entry_t));
+STATIC_MUTEX_DEFINE(log);
+
 static QueueHandle_t log_queue = NULL;
-static TaskHandle_t log_task_handle = NULL;
+static bool log_on_executor = false;
 static SemaphoreHandle_t log_mutex = NULL;
 
 static uint32_t dropped_count = 0;
 
+static void log_work_fn(void *arg);
+static aic_work_t log_work = AIC_WORK_INIT("log", log_work_fn, AIC_WORK_PRIO_LOW);
+
 /* Level prefixes */
 static const char *level_prefixes[] = {
     "",         /* NONE */
@@ -122,20 +130,33 @@ static void output_message(const log_entry_t *entry)
 #endif
 }
 
+static void enqueue_message(const log_entry_t *entry)
+{
+    /* Try to queue (don't block) */
+    BaseType_t result;
+    if (xPortIsInsideInterrupt()) {
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+        result = xQueueSendFromISR(log_queue, entry, &xHigherPriorityTaskWoken);
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    } else {
+        result = xQueueSend(log_queue, entry, 0);
+    }
+
+    if (result != pdTRUE) {
+        dropped_count++;
+    } else if (log_on_executor) {
+        aic_work_schedule(&log_work);
+    }
+}
+
 /*******************************************************************************
- * Log Task
+ * Log Work (runs on the aic_work executor)
  ******************************************************************************/
 
-static void log_task(void *param)
+static void log_work_fn(void *arg)
 {
-    (void)param;
-    log_entry_t entry;
-
-    while (1) {
-        if (xQueueReceive(log_queue, &entry, portMAX_DELAY) == pdTRUE) {
-            output_message(&entry);
-        }
-    }
+    (void)arg;
+    aic_log_process();
 }
 
 /*******************************************************************************
@@ -149,20 +170,20 @@ bool aic_log_init(void)
     }
 
     /* Create queue */
-    log_queue = xQueueCreate(AIC_LOG_QUEUE_SIZE, sizeof(log_entry_t));
+    log_queue = STATIC_QUEUE_CREATE(log, "aic_log", sizeof(log_entry_t));
     if (log_queue == NULL) {
         return false;
     }
 
     /* Create mutex */
-    log_mutex = xSemaphoreCreateMutex();
+    log_mutex = STATIC_MUTEX_CREATE(log, "aic_log");
     if (log_mutex == NULL) {
         vQueueDelete(log_queue);
         log_queue = NULL;
         return false;
     }
 
-    /* Create task */
+    /* Output runs on the shared work executor */
     aic_log_create_task();
 
     log_initialized = true;
@@ -248,19 +269,7 @@ void aic_log(aic_log_level_t level, const char *fmt, ...)
     vsnprintf(entry.message, AIC_LOG_MSG_MAX_LEN, fmt, args);
     va_end(args);
 
-    /* Try to queue (don't block) */
-    BaseType_t result;
-    if (xPortIsInsideInterrupt()) {
-        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-        result = xQueueSendFromISR(log_queue, &entry, &xHigherPriorityTaskWoken);
-        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
-    } else {
-        result = xQueueSend(log_queue, &entry, 0);
-    }
-
-    if (result != pdTRUE) {
-        dropped_count++;
-    }
+    enqueue_message(&entry);
 }
 
 void aic_log_tag(aic_log_level_t level, const char *tag, const char *fmt, ...)
@@ -293,19 +302,7 @@ void aic_log_tag(aic_log_level_t level, const char *tag, const char *fmt, ...)
     vsnprintf(entry.message + tag_len, AIC_LOG_MSG_MAX_LEN - tag_len, fmt, args);
     va_end(args);
 
-    /* Try to queue (don't block) */
-    BaseType_t result;
-    if (xPortIsInsideInterrupt()) {
-        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-        result = xQueueSendFromISR(log_queue, &entry, &xHigherPriorityTaskWoken);
-        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
-    } else {
-        result = xQueueSend(log_queue, &entry, 0);
-    }
-
-    if (result != pdTRUE) {
-        dropped_count++;
-    }
+    enqueue_message(&entry);
 }
 
 void aic_log_flush(void)
@@ -314,6 +311,12 @@ void aic_log_flush(void)
         return;
     }
 
+    /* On the executor itself nothing else would drain the queue */
+    if (aic_work_in_executor() || !log_on_executor) {
+        aic_log_process();
+        return;
+    }
+
     /* Wait until queue is empty */
     while (uxQueueMessagesWaiting(log_queue) > 0) {
         vTaskDelay(pdMS_TO_TICKS(1));
@@ -338,26 +341,19 @@ uint32_t aic_log_dropped_count(void)
 
 void aic_log_create_task(void)
 {
-    if (log_task_handle != NULL) {
+    if (log_on_executor || !aic_work_init()) {
         return;
     }
 
-    xTaskCreate(
-        log_task,
-        "AIC_LOG",
-        AIC_LOG_TASK_STACK,
-        NULL,
-        AIC_LOG_TASK_PRIORITY,
-        &log_task_handle
-    );
+    log_on_executor = true;
+    if (log_queue != NULL && uxQueueMessagesWaiting(log_queue) > 0) {
+        aic_work_schedule(&log_work);
+    }
 }
 
 void aic_log_delete_task(void)
 {
-    if (log_task_handle != NULL) {
-        vTaskDelete(log_task_handle);
-        log_task_handle = NULL;
-    }
+    log_on_executor = false;
 }
 
 void aic_log_process(void)
@@ -37,8 +37,6 @@ typedef enum {
 
 #define AIC_LOG_QUEUE_SIZE      (16U)       /**< Number of messages in queue */
 #define AIC_LOG_MSG_MAX_LEN     (128U)      /**< Max message length */
-#define AIC_LOG_TASK_STACK      (256U)      /**< Log task stack size (words) */
-#define AIC_LOG_TASK_PRIORITY   (2U)        /**< Log task priority */
 
 /*******************************************************************************
  * Log Output Targets
@@ -182,18 +180,18 @@ void aic_log_set_lvgl_label(lv_obj_t *label, uint8_t max_lines);
 #endif /* LV_LVGL_H_INCLUDE_SIMPLE */
 
 /*******************************************************************************
- * FreeRTOS Task (Internal)
+ * Background Output (Internal)
  ******************************************************************************/
 
 /**
- * @brief Create log output task
+ * @brief Run log output on the aic_work executor (low priority)
  *
- * Called automatically by aic_log_init() if FreeRTOS is available.
+ * Called automatically by aic_log_init().
  */
 void aic_log_create_task(void);
 
 /**
- * @brief Delete log output task
+ * @brief Stop background output (use aic_log_process() instead)
  */
 void aic_log_delete_task(void);
 
@@ -0,0 +1,186 @@
+/*******************************************************************************
+ * File: aic_mem.c
+ * Description: AIC-EEC Memory Usage Panel Implementation
+ *
+ * A single label refreshed by an lv_timer; all figures come from
+ * mem_stats (local core) and mem_stats_get_remote() (CM33 over IPC).
+ *
+ * Part of BiiL Course: Embedded C for IoT
+ ******************************************************************************/
+
+#include "aic_mem.h"
+#include "aic_alloc.h"
+#include "mem_stats.h"
+#include <stdio.h>
+#include <stdarg.h>
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+#define AIC_MEM_TEXT_MAX    768
+
+typedef struct {
+    lv_obj_t *label;
+    lv_timer_t *timer;
+    aic_mem_request_cb_t request_cb;
+    char text[AIC_MEM_TEXT_MAX];
+} mem_panel_ctx_t;
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+
+/* Append to the panel text, never past its end */
+static size_t text_append(char *buf, size_t len, const char *fmt, ...)
+{
+    va_list args;
+    int n;
+
+    if (len >= AIC_MEM_TEXT_MAX) {
+        return len;
+    }
+
+    va_start(args, fmt);
+    n = vsnprintf(buf + len, AIC_MEM_TEXT_MAX - len, fmt, args);
+    va_end(args);
+
+    if (n < 0) {
+        return len;
+    }
+    len += (size_t)n;
+    return (len < AIC_MEM_TEXT_MAX) ? len : AIC_MEM_TEXT_MAX;
+}
+
+static void build_text(mem_panel_ctx_t *ctx)
+{
+    mem_stats_heap_t heap;
+    mem_stats_region_t region;
+    mem_stats_task_t tasks[AIC_MEM_TASK_ROWS];
+    ipc_mem_report_t remote;
+    uint32_t total = 0;
+    size_t len = 0;
+    char *buf = ctx->text;
+
+    /* CM55 */
+    mem_stats_get_heap(&heap);
+    len = text_append(buf, len, "CM55 heap  %lu / %lu KB  peak %lu KB  frag %u%%\n",
+                      (unsigned long)(heap.used / 1024U), (unsigned long)(heap.total / 1024U),
+                      (unsigned long)(heap.peak / 1024U), heap.frag_pct);
+
+    aic_alloc_stats_t lv;
+    aic_alloc_get_stats(&lv);
+    if (lv.region_size > 0U) {
+        len = text_append(buf, len, "  lvgl  %lu / %lu KB  peak %lu KB  frag %u%%  heap %lu\n",
+                          (unsigned long)(lv.used_bytes / 1024U),
+                          (unsigned long)(lv.region_size / 1024U),
+                          (unsigned long)(lv.peak_bytes / 1024U), lv.frag_pct,
+                          (unsigned long)lv.heap_live);
+    }
+
+    for (uint32_t i = 0; mem_stats_get_region(i, &region); i++) {
+        if (region.painted) {
+            len = text_append(buf, len, "  %s  %lu / %lu KB high-water\n", region.name,
+                              (unsigned long)(region.high_water / 1024U),
+                              (unsigned long)(region.slot_size / 1024U));
+        } else {
+            len = text_append(buf, len, "  %s  %lu KB\n", region.name,
+                              (unsigned long)(region.size / 1024U));
+        }
+    }
+
+    uint32_t listed = mem_stats_get_tasks(tasks, AIC_MEM_TASK_ROWS, &total);
+    len = text_append(buf, len, "  stack free (%lu tasks):", (unsigned long)total);
+    for (uint32_t i = 0; i < listed; i++) {
+        len = text_append(buf, len, " %s %lu", tasks[i].name,
+                          (unsigned long)tasks[i].stack_free);
+    }
+
+    /* CM33 (last IPC report) */
+    if (!mem_stats_get_remote(&remote)) {
+        len = text_append(buf, len, "\n\nCM33  (no report yet)");
+    } else {
+        len = text_append(buf, len, "\n\nCM33 heap  %lu / %lu KB  peak %lu KB  frag %u%%\n",
+                          (unsigned long)(remote.heap_used / 1024U),
+                          (unsigned long)(remote.heap_total / 1024U),
+                          (unsigned long)(remote.heap_peak / 1024U), remote.frag_pct);
+        len = text_append(buf, len, "  stack free (%u tasks):", remote.task_count);
+        for (uint32_t i = 0; i < remote.task_listed && i < AIC_MEM_TASK_ROWS; i++) {
+            len = text_append(buf, len, " %.8s %lu", remote.tasks[i].name,
+                              (unsigned long)remote.tasks[i].stack_free);
+        }
+    }
+}
+
+static void refresh_timer_cb(lv_timer_t *timer)
+{
+    lv_obj_t *panel = (lv_obj_t *)lv_timer_get_user_data(timer);
+
+    /* Panel on a cached, hidden screen: no redraw, no IPC request */
+    if (lv_obj_get_screen(panel) != lv_screen_active()) {
+        return;
+    }
+    aic_mem_panel_refresh(panel);
+}
+
+static void panel_delete_cb(lv_event_t *e)
+{
+    mem_panel_ctx_t *ctx = (mem_panel_ctx_t *)lv_event_get_user_data(e);
+    lv_timer_delete(ctx->timer);
+    lv_free(ctx);
+}
+
+/*******************************************************************************
+ * Public Functions
+ ******************************************************************************/
+
+lv_obj_t *aic_mem_panel_create(lv_obj_t *parent, aic_mem_request_cb_t request_cb)
+{
+    if (parent == NULL) {
+        parent = lv_screen_active();
+    }
+
+    mem_panel_ctx_t *ctx = lv_malloc(sizeof(mem_panel_ctx_t));
+    if (ctx == NULL) {
+        return NULL;
+    }
+    ctx->request_cb = request_cb;
+    ctx->text[0] = '\0';
+
+    lv_obj_t *panel = lv_obj_create(parent);
+    lv_obj_set_size(panel, LV_PCT(90), LV_SIZE_CONTENT);
+    lv_obj_set_style_bg_color(panel, lv_color_hex(0x1E1E1E), 0);
+    lv_obj_set_style_border_width(panel, 0, 0);
+    lv_obj_set_user_data(panel, ctx);
+
+    ctx->label = lv_label_create(panel);
+    lv_obj_set_width(ctx->label, LV_PCT(100));
+    lv_obj_set_style_text_font(ctx->label, &lv_font_montserrat_14, 0);
+    lv_obj_set_style_text_color(ctx->label, lv_color_hex(0xE0E0E0), 0);
+
+    ctx->timer = lv_timer_create(refresh_timer_cb, AIC_MEM_REFRESH_MS, panel);
+    lv_obj_add_event_cb(panel, panel_delete_cb, LV_EVENT_DELETE, ctx);
+
+    aic_mem_panel_refresh(panel);
+    return panel;
+}
+
+void aic_mem_panel_refresh(lv_obj_t *panel)
+{
+    if (panel == NULL) {
+        return;
+    }
+
+    mem_panel_ctx_t *ctx = (mem_panel_ctx_t *)lv_obj_get_user_data(panel);
+    if (ctx == NULL) {
+        return;
+    }
+
+    build_text(ctx);
+    lv_label_set_text(ctx->label, ctx->text);
+
+    /* Ask for a new CM33 report; shown on the next refresh */
+    if (ctx->request_cb != NULL) {
+        ctx->request_cb();
+    }
+}
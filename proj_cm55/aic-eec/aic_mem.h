@@ -0,0 +1,73 @@
+/*******************************************************************************
+ * File: aic_mem.h
+ * Description: AIC-EEC Memory Usage Panel
+ *
+ * On-screen view of shared/include/mem_stats.h: CM55 heap, VG-Lite and
+ * frame buffer regions, task stacks closest to overflow, and the last
+ * CM33 report received over IPC (IPC_CMD_MEM_REPORT).
+ *
+ * Must be used from the LVGL task only.
+ *
+ * Part of BiiL Course: Embedded C for IoT
+ ******************************************************************************/
+
+#ifndef AIC_MEM_H
+#define AIC_MEM_H
+
+#include "lvgl.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * Configuration
+ ******************************************************************************/
+
+#ifndef AIC_MEM_REFRESH_MS
+#define AIC_MEM_REFRESH_MS      1000U   /* Panel update period */
+#endif
+
+#ifndef AIC_MEM_TASK_ROWS
+#define AIC_MEM_TASK_ROWS       4       /* Lowest-stack tasks shown per core */
+#endif
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+
+/**
+ * @brief Called on each refresh to ask CM33 for a fresh report
+ *
+ * Typically: cm55_ipc_send_cmd(IPC_CMD_MEM_REQ, 0). The reply is stored by
+ * the IPC receive path and shown on the next refresh.
+ */
+typedef void (*aic_mem_request_cb_t)(void);
+
+/*******************************************************************************
+ * API Functions
+ ******************************************************************************/
+
+/**
+ * @brief Create the memory panel
+ * @param parent     Parent object (NULL = active screen)
+ * @param request_cb Remote report request (NULL = CM55 figures only)
+ * @return Panel object (delete it to stop the refresh timer)
+ *
+ * The timer only refreshes (and requests) while the panel's screen is
+ * the active one.
+ */
+lv_obj_t *aic_mem_panel_create(lv_obj_t *parent, aic_mem_request_cb_t request_cb);
+
+/**
+ * @brief Refresh the panel now
+ */
+void aic_mem_panel_refresh(lv_obj_t *panel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AIC_MEM_H */
@@ -0,0 +1,246 @@
+/*******************************************************************************
+ * File: aic_screen.c
+ * Description: AIC-EEC Lazy Screen Manager Implementation
+ *
+ * Screens are built on first use, kept alive in an LRU cache bounded by
+ * screen count and object count, and optionally pre-built while the user
+ * is idle (lv_display_get_inactive_time).
+ *
+ * Part of BiiL Course: Embedded C for IoT
+ ******************************************************************************/
+
+#include "aic_screen.h"
+#include <stdio.h>
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+typedef struct {
+    const char *name;
+    aic_screen_build_cb_t build_cb;
+    void *user_data;
+    lv_obj_t *obj;              /* NULL until built */
+    uint32_t last_used;         /* LRU stamp */
+    bool prefetch_pending;
+    aic_screen_stats_t stats;
+} screen_entry_t;
+
+/*******************************************************************************
+ * Static Variables
+ ******************************************************************************/
+
+static screen_entry_t screens[AIC_SCREEN_MAX];
+static uint8_t screen_count = 0;
+static uint32_t use_counter = 0;
+static lv_timer_t *prefetch_timer = NULL;
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+
+static screen_entry_t *get_entry(int id)
+{
+    if (id < 0 || id >= (int)screen_count) {
+        return NULL;
+    }
+    return &screens[id];
+}
+
+static uint32_t count_objs(lv_obj_t *obj)
+{
+    uint32_t count = 1;
+    uint32_t child_cnt = lv_obj_get_child_count(obj);
+
+    for (uint32_t i = 0; i < child_cnt; i++) {
+        count += count_objs(lv_obj_get_child(obj, (int32_t)i));
+    }
+    return count;
+}
+
+/* Screen deleted from outside the manager - forget the pointer */
+static void screen_delete_cb(lv_event_t *e)
+{
+    screen_entry_t *entry = (screen_entry_t *)lv_event_get_user_data(e);
+    entry->obj = NULL;
+    entry->stats.built = false;
+    entry->stats.obj_count = 0;
+}
+
+static void build_screen(screen_entry_t *entry)
+{
+    uint32_t t0 = lv_tick_get();
+
+    entry->obj = lv_obj_create(NULL);
+    lv_obj_add_event_cb(entry->obj, screen_delete_cb, LV_EVENT_DELETE, entry);
+    entry->build_cb(entry->obj, entry->user_data);
+
+    entry->stats.build_time_ms = lv_tick_elaps(t0);
+    entry->stats.build_count++;
+    entry->stats.obj_count = count_objs(entry->obj);
+    entry->stats.built = true;
+    entry->prefetch_pending = false;
+
+    printf("[SCREEN] Built '%s': %lu objs in %lu ms\r\n", entry->name,
+           (unsigned long)entry->stats.obj_count,
+           (unsigned long)entry->stats.build_time_ms);
+}
+
+static void evict_entry(screen_entry_t *entry)
+{
+    if (entry->obj != NULL) {
+        lv_obj_delete(entry->obj);  /* screen_delete_cb clears entry->obj */
+    }
+}
+
+/* Evict least recently used screens until the cache fits the budget.
+ * The screen being shown and the currently active screen are never evicted. */
+static void enforce_budget(const screen_entry_t *keep)
+{
+    lv_obj_t *active = lv_screen_active();
+
+    for (;;) {
+        uint32_t cached = 0;
+        uint32_t objs = 0;
+        screen_entry_t *lru = NULL;
+
+        for (uint8_t i = 0; i < screen_count; i++) {
+            screen_entry_t *entry = &screens[i];
+            if (entry->obj == NULL) {
+                continue;
+            }
+            entry->stats.obj_count = count_objs(entry->obj);
+            cached++;
+            objs += entry->stats.obj_count;
+
+            if (entry != keep && entry->obj != active &&
+                (lru == NULL || entry->last_used < lru->last_used)) {
+                lru = entry;
+            }
+        }
+
+        if ((cached <= AIC_SCREEN_MAX_CACHED && objs <= AIC_SCREEN_OBJ_BUDGET) ||
+            lru == NULL) {
+            break;
+        }
+        evict_entry(lru);
+    }
+}
+
+static void prefetch_timer_cb(lv_timer_t *timer)
+{
+    if (lv_display_get_inactive_time(NULL) < AIC_SCREEN_PREFETCH_IDLE_MS) {
+        return;     /* User is interacting - don't steal render time */
+    }
+
+    /* Build one pending screen per tick */
+    for (uint8_t i = 0; i < screen_count; i++) {
+        screen_entry_t *entry = &screens[i];
+        if (entry->prefetch_pending) {
+            if (entry->obj == NULL) {
+                build_screen(entry);
+                enforce_budget(entry);
+            }
+            entry->prefetch_pending = false;
+            return;
+        }
+    }
+
+    lv_timer_pause(timer);  /* Nothing left to prefetch */
+}
+
+/*******************************************************************************
+ * Public Functions
+ ******************************************************************************/
+
+int aic_screen_register(const char *name, aic_screen_build_cb_t build_cb, void *user_data)
+{
+    if (build_cb == NULL || screen_count >= AIC_SCREEN_MAX) {
+        return AIC_SCREEN_INVALID;
+    }
+
+    screen_entry_t *entry = &screens[screen_count];
+    lv_memzero(entry, sizeof(screen_entry_t));
+    entry->name = (name != NULL) ? name : "?";
+    entry->build_cb = build_cb;
+    entry->user_data = user_data;
+
+    return (int)screen_count++;
+}
+
+bool aic_screen_show(int id, lv_screen_load_anim_t anim, uint32_t time)
+{
+    screen_entry_t *entry = get_entry(id);
+    if (entry == NULL) {
+        return false;
+    }
+
+    uint32_t t0 = lv_tick_get();
+
+    if (entry->obj == NULL) {
+        build_screen(entry);
+    }
+    entry->last_used = ++use_counter;
+    entry->prefetch_pending = false;
+
+    enforce_budget(entry);
+
+    /* auto_del = false: the old screen stays cached */
+    lv_screen_load_anim(entry->obj, anim, time, 0, false);
+
+    entry->stats.last_switch_ms = lv_tick_elaps(t0);
+    return true;
+}
+
+void aic_screen_prefetch(int id)
+{
+    screen_entry_t *entry = get_entry(id);
+    if (entry == NULL || entry->obj != NULL) {
+        return;
+    }
+
+    entry->prefetch_pending = true;
+
+    if (prefetch_timer == NULL) {
+        prefetch_timer = lv_timer_create(prefetch_timer_cb, 100, NULL);
+    } else {
+        lv_timer_resume(prefetch_timer);
+    }
+}
+
+void aic_screen_evict(int id)
+{
+    screen_entry_t *entry = get_entry(id);
+    if (entry == NULL || entry->obj == NULL || entry->obj == lv_screen_active()) {
+        return;
+    }
+    evict_entry(entry);
+}
+
+lv_obj_t *aic_screen_get_obj(int id)
+{
+    screen_entry_t *entry = get_entry(id);
+    return (entry != NULL) ? entry->obj : NULL;
+}
+
+bool aic_screen_get_stats(int id, aic_screen_stats_t *stats)
+{
+    screen_entry_t *entry = get_entry(id);
+    if (entry == NULL || stats == NULL) {
+        return false;
+    }
+
+    *stats = entry->stats;
+    return true;
+}
+
+int aic_screen_count(void)
+{
+    return (int)screen_count;
+}
+
+const char *aic_screen_get_name(int id)
+{
+    screen_entry_t *entry = get_entry(id);
+    return (entry != NULL) ? entry->name : NULL;
+}
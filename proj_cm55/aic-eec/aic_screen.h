@@ -0,0 +1,127 @@
+/*******************************************************************************
+ * File: aic_screen.h
+ * Description: AIC-EEC Lazy Screen Manager
+ *
+ * Screens are registered with a build callback and constructed on first
+ * use. Recently used screens stay alive (hidden, not deleted) within an
+ * object budget, so switching back is just lv_screen_load(). Screens can
+ * be queued for pre-building while the user is idle.
+ *
+ * Must be used from the LVGL task only.
+ *
+ * Part of BiiL Course: Embedded C for IoT
+ ******************************************************************************/
+
+#ifndef AIC_SCREEN_H
+#define AIC_SCREEN_H
+
+#include "lvgl.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * Configuration
+ ******************************************************************************/
+
+#ifndef AIC_SCREEN_MAX
+#define AIC_SCREEN_MAX              8       /* Max registered screens */
+#endif
+
+#ifndef AIC_SCREEN_MAX_CACHED
+#define AIC_SCREEN_MAX_CACHED       3       /* Max screens kept alive */
+#endif
+
+#ifndef AIC_SCREEN_OBJ_BUDGET
+#define AIC_SCREEN_OBJ_BUDGET       600U    /* Max LVGL objects over cached screens */
+#endif
+
+#ifndef AIC_SCREEN_PREFETCH_IDLE_MS
+#define AIC_SCREEN_PREFETCH_IDLE_MS 500U    /* User inactivity before prefetch */
+#endif
+
+#define AIC_SCREEN_INVALID          (-1)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+
+/**
+ * @brief Screen build callback - create the screen content on @p screen
+ * @param screen    Fresh screen object (lv_obj_create(NULL))
+ * @param user_data User data given at registration
+ */
+typedef void (*aic_screen_build_cb_t)(lv_obj_t *screen, void *user_data);
+
+/**
+ * @brief Per-screen statistics
+ */
+typedef struct {
+    uint32_t build_count;       /* Times constructed (1 = never evicted) */
+    uint32_t build_time_ms;     /* Duration of last build */
+    uint32_t last_switch_ms;    /* Duration of last aic_screen_show() */
+    uint32_t obj_count;         /* Objects in the screen tree (if built) */
+    bool     built;
+} aic_screen_stats_t;
+
+/*******************************************************************************
+ * API Functions
+ ******************************************************************************/
+
+/**
+ * @brief Register a screen (not built until first shown or prefetched)
+ * @return Screen id, or AIC_SCREEN_INVALID if the table is full
+ */
+int aic_screen_register(const char *name, aic_screen_build_cb_t build_cb, void *user_data);
+
+/**
+ * @brief Show a screen, building it first if needed
+ *
+ * The previously active screen is kept alive for fast switching back.
+ * Least recently used screens are deleted when the cache exceeds
+ * AIC_SCREEN_MAX_CACHED or AIC_SCREEN_OBJ_BUDGET.
+ *
+ * @param id    Screen id
+ * @param anim  Load animation (LV_SCR_LOAD_ANIM_NONE for instant)
+ * @param time  Animation time in ms
+ */
+bool aic_screen_show(int id, lv_screen_load_anim_t anim, uint32_t time);
+
+/**
+ * @brief Queue a screen to be built during user idle time
+ */
+void aic_screen_prefetch(int id);
+
+/**
+ * @brief Delete a cached screen (it will be rebuilt on next show)
+ */
+void aic_screen_evict(int id);
+
+/**
+ * @brief Get the screen object (NULL if not built)
+ */
+lv_obj_t *aic_screen_get_obj(int id);
+
+/**
+ * @brief Get statistics for a screen
+ */
+bool aic_screen_get_stats(int id, aic_screen_stats_t *stats);
+
+/**
+ * @brief Number of registered screens (ids are 0 .. count-1)
+ */
+int aic_screen_count(void);
+
+/**
+ * @brief Get the name given at registration (NULL for an invalid id)
+ */
+const char *aic_screen_get_name(int id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AIC_SCREEN_H */
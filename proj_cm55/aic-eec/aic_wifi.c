@@ -6,6 +6,8 @@
  ******************************************************************************/
 
 #include "aic_wifi.h"
+#include "cybsp.h"
+#include "../../shared/wifi_link_shared.h"
 #include <string.h>
 #include <stdio.h>
 
@@ -27,6 +29,7 @@ static void scan_btn_click_cb(lv_event_t* e);
 static void connect_btn_click_cb(lv_event_t* e);
 static void password_kb_cb(lv_event_t* e);
 static void update_connect_button(aic_wifi_ctx_t* ctx);
+static void link_timer_cb(lv_timer_t* timer);
 
 /*******************************************************************************
  * Initialization Functions
@@ -66,6 +69,9 @@ aic_wifi_ctx_t* aic_wifi_init(lv_obj_t* parent)
     /* Create details panel */
     create_details_panel(ctx, ctx->main_screen);
 
+    /* Link quality comes from shared memory, written by CM33 on change */
+    ctx->link_timer = lv_timer_create(link_timer_cb, AIC_WIFI_LINK_POLL_MS, ctx);
+
     return ctx;
 }
 
@@ -73,6 +79,19 @@ void aic_wifi_deinit(aic_wifi_ctx_t* ctx)
 {
     if (!ctx) return;
 
+    if (ctx->scan_refresh_timer) {
+        lv_timer_delete(ctx->scan_refresh_timer);
+    }
+
+    if (ctx->link_timer) {
+        lv_timer_delete(ctx->link_timer);
+    }
+
+    if (ctx->password_overlay) {
+        lv_obj_delete(ctx->password_overlay);
+        ctx->password_overlay = NULL;
+    }
+
     if (ctx->main_screen) {
         lv_obj_delete(ctx->main_screen);
     }
@@ -437,7 +456,7 @@ static void password_kb_cb(lv_event_t* e)
         }
     }
 
-    /* Hide dialog (async delete to avoid crash inside callback) */
+    /* Hide dialog; it is kept for the next connect */
     aic_wifi_hide_password_dialog(ctx);
 }
 
@@ -573,6 +592,71 @@ void aic_wifi_update_networks(aic_wifi_ctx_t* ctx, const ipc_wifi_scan_t* scan_d
     }
 }
 
+/* Show scan_stream without its removed (empty) entries */
+static void scan_stream_show(aic_wifi_ctx_t* ctx)
+{
+    ipc_wifi_scan_t list;
+    memset(&list, 0, sizeof(ipc_wifi_scan_t));
+    list.connected_idx = -1;
+
+    for (uint8_t i = 0; i < ctx->scan_stream.count && i < WIFI_SCAN_MAX_NETWORKS; i++) {
+        const ipc_wifi_network_t* net = &ctx->scan_stream.networks[i];
+        if (net->ssid[0] == '\0') continue;
+        if (net->flags & 0x01) {
+            list.connected_idx = (int8_t)list.count;
+        }
+        list.networks[list.count++] = *net;
+    }
+
+    aic_wifi_update_networks(ctx, &list);
+}
+
+static void scan_refresh_timer_cb(lv_timer_t* timer)
+{
+    aic_wifi_ctx_t* ctx = (aic_wifi_ctx_t*)lv_timer_get_user_data(timer);
+
+    ctx->scan_refresh_timer = NULL;     /* One-shot, deleted by LVGL */
+    scan_stream_show(ctx);
+    if (ctx->state == WIFI_STATE_SCANNING) {
+        char status[64];
+        snprintf(status, sizeof(status), "Scanning... %d found", ctx->scan_data.count);
+        lv_label_set_text(ctx->status_bar, status);
+    }
+}
+
+void aic_wifi_add_scan_result(aic_wifi_ctx_t* ctx, uint32_t index,
+                              const ipc_wifi_network_t* network)
+{
+    if (!ctx || !network || index >= WIFI_SCAN_MAX_NETWORKS) return;
+
+    memcpy(&ctx->scan_stream.networks[index], network, sizeof(ipc_wifi_network_t));
+    if (index >= ctx->scan_stream.count) {
+        ctx->scan_stream.count = (uint8_t)(index + 1);
+    }
+
+    /* Coalesce a burst of results into one redraw */
+    if (!ctx->scan_refresh_timer) {
+        ctx->scan_refresh_timer = lv_timer_create(scan_refresh_timer_cb,
+                                                  AIC_WIFI_SCAN_REFRESH_MS, ctx);
+        lv_timer_set_repeat_count(ctx->scan_refresh_timer, 1);
+    }
+}
+
+void aic_wifi_scan_complete(aic_wifi_ctx_t* ctx, uint32_t count)
+{
+    if (!ctx) return;
+
+    if (ctx->scan_refresh_timer) {
+        lv_timer_delete(ctx->scan_refresh_timer);
+        ctx->scan_refresh_timer = NULL;
+    }
+
+    if (count < ctx->scan_stream.count) {
+        ctx->scan_stream.count = (uint8_t)count;
+    }
+    scan_stream_show(ctx);
+}
+
 void aic_wifi_update_tcpip(aic_wifi_ctx_t* ctx, const ipc_wifi_tcpip_t* tcpip)
 {
     if (!ctx || !tcpip) return;
@@ -633,6 +717,55 @@ void aic_wifi_update_hardware(aic_wifi_ctx_t* ctx, const ipc_wifi_hardware_t* hw
     lv_label_set_text(ctx->lbl_band, wifi_band_to_str(hw_info->band));
 }
 
+/*******************************************************************************
+ * Link Quality (wifi_link_shared.h)
+ ******************************************************************************/
+
+static void link_timer_cb(lv_timer_t* timer)
+{
+    aic_wifi_ctx_t* ctx = (aic_wifi_ctx_t*)lv_timer_get_user_data(timer);
+    wifi_link_quality_t q;
+    uint32_t count;
+
+    if (!wifi_link_shared_read(&q, &count) || count == ctx->link_count) {
+        return;
+    }
+    ctx->link_count = count;
+    ctx->link = q;
+
+    /* rssi is 0 when not connected: show no bars */
+    if (ctx->link_icon) {
+        aic_wifi_update_signal_icon(ctx->link_icon,
+                                    q.state == WIFI_STATE_CONNECTED ? q.rssi : -127);
+    }
+
+    /* Labels follow only while connected; aic_wifi_set_state() clears them */
+    if (q.state != WIFI_STATE_CONNECTED || ctx->state != WIFI_STATE_CONNECTED) {
+        return;
+    }
+
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%d dBm", q.rssi);
+    lv_label_set_text(ctx->lbl_rssi, buf);
+
+    snprintf(buf, sizeof(buf), "%d", q.channel);
+    lv_label_set_text(ctx->lbl_channel, buf);
+
+    lv_label_set_text(ctx->lbl_band, wifi_band_to_str(q.band));
+}
+
+void aic_wifi_set_link_icon(aic_wifi_ctx_t* ctx, lv_obj_t* icon)
+{
+    if (!ctx) return;
+
+    ctx->link_icon = icon;
+    if (icon) {
+        /* Show the last value now, not at the next change */
+        aic_wifi_update_signal_icon(icon, ctx->link.state == WIFI_STATE_CONNECTED
+                                          ? ctx->link.rssi : -127);
+    }
+}
+
 void aic_wifi_set_state(aic_wifi_ctx_t* ctx, wifi_state_t state)
 {
     if (!ctx) return;
@@ -672,6 +805,9 @@ void aic_wifi_set_state(aic_wifi_ctx_t* ctx, wifi_state_t state)
             for (uint8_t k = 0; k < ctx->scan_data.count; k++) {
                 ctx->scan_data.networks[k].flags &= (uint8_t)~0x01;
             }
+            for (uint8_t k = 0; k < ctx->scan_stream.count; k++) {
+                ctx->scan_stream.networks[k].flags &= (uint8_t)~0x01;
+            }
             /* Clear selection and hide connect button */
             ctx->selected_index = -1;
             ctx->selected_ssid[0] = '\0';
@@ -927,8 +1063,20 @@ void aic_wifi_show_password_dialog(aic_wifi_ctx_t* ctx, const char* ssid)
     if (!ctx) return;
     ctx->dialog_open = true;
 
-    /* Create overlay */
-    lv_obj_t* overlay = lv_obj_create(lv_screen_active());
+    /* Dialog is built once and reused - the keyboard is expensive to create */
+    if (ctx->password_overlay) {
+        lv_label_set_text_fmt(ctx->password_title, "Connect to \"%s\"", ssid);
+        lv_textarea_set_text(ctx->password_ta, "");
+        lv_obj_remove_flag(ctx->password_overlay, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_move_foreground(ctx->password_overlay);
+        return;
+    }
+
+    /* Create overlay on the manager's own container so it lives and dies
+     * with ctx, whichever screen is active. Floating keeps it out of the
+     * container's row layout. */
+    lv_obj_t* overlay = lv_obj_create(ctx->main_screen);
+    lv_obj_add_flag(overlay, LV_OBJ_FLAG_FLOATING);
     lv_obj_set_size(overlay, AIC_WIFI_SCREEN_WIDTH, AIC_WIFI_SCREEN_HEIGHT);
     lv_obj_set_style_bg_color(overlay, lv_color_black(), 0);
     lv_obj_set_style_bg_opa(overlay, LV_OPA_50, 0);
@@ -947,6 +1095,7 @@ void aic_wifi_show_password_dialog(aic_wifi_ctx_t* ctx, const char* ssid)
 
     /* Title */
     lv_obj_t* title = lv_label_create(dialog);
+    ctx->password_title = title;
     lv_label_set_text_fmt(title, "Connect to \"%s\"", ssid);
     lv_obj_set_style_text_font(title, &lv_font_montserrat_24, 0);
     lv_obj_set_style_text_color(title, AIC_WIFI_COLOR_TEXT, 0);
@@ -975,20 +1124,17 @@ void aic_wifi_show_password_dialog(aic_wifi_ctx_t* ctx, const char* ssid)
     lv_obj_add_event_cb(ctx->password_kb, password_kb_cb, LV_EVENT_CANCEL, ctx);
 
     /* Store overlay reference for hiding */
-    lv_obj_set_user_data(ctx->password_ta, overlay);
+    ctx->password_overlay = overlay;
 }
 
 void aic_wifi_hide_password_dialog(aic_wifi_ctx_t* ctx)
 {
-    if (!ctx || !ctx->password_ta) return;
-
-    lv_obj_t* overlay = (lv_obj_t*)lv_obj_get_user_data(ctx->password_ta);
-    if (overlay) {
-        lv_obj_delete_async(overlay);
-    }
+    if (!ctx || !ctx->password_overlay) return;
 
-    ctx->password_ta = NULL;
-    ctx->password_kb = NULL;
+    /* Hide instead of delete so the next show is instant.
+     * Clear the text so the password doesn't linger in memory. */
+    lv_textarea_set_text(ctx->password_ta, "");
+    lv_obj_add_flag(ctx->password_overlay, LV_OBJ_FLAG_HIDDEN);
     ctx->dialog_open = false;
 }
 
@@ -28,6 +28,12 @@ extern "C" {
 #define AIC_WIFI_SCREEN_WIDTH   800
 #define AIC_WIFI_SCREEN_HEIGHT  480
 
+/* Streamed scan results are redrawn at most this often */
+#define AIC_WIFI_SCAN_REFRESH_MS    100
+
+/* Link quality from CM33 (wifi_link_shared.h) is checked this often */
+#define AIC_WIFI_LINK_POLL_MS       250
+
 /*******************************************************************************
  * Color Palette (macOS-style dark theme)
  ******************************************************************************/
@@ -76,6 +82,8 @@ typedef struct {
     lv_obj_t* scan_btn;             /* Scan button */
     lv_obj_t* password_kb;          /* Password keyboard (hidden by default) */
     lv_obj_t* password_ta;          /* Password text area */
+    lv_obj_t* password_overlay;     /* Cached password dialog (built on first use) */
+    lv_obj_t* password_title;       /* Dialog title ("Connect to ...") */
     lv_obj_t* connecting_spinner;   /* Connection spinner */
 
     /* Detail labels */
@@ -95,6 +103,12 @@ typedef struct {
     int selected_index;
     wifi_state_t state;
     ipc_wifi_scan_t scan_data;
+    ipc_wifi_scan_t scan_stream;    /* Scan list as kept on CM33, by its index */
+    lv_timer_t* scan_refresh_timer; /* Pending redraw of scan_stream */
+    lv_timer_t* link_timer;         /* Polls wifi_link_shared.h */
+    lv_obj_t* link_icon;            /* Signal icon kept current (optional) */
+    uint32_t link_count;            /* update_count last shown */
+    wifi_link_quality_t link;       /* Link quality last shown */
     ipc_wifi_tcpip_t tcpip_info;
     ipc_wifi_hardware_t hw_info;
     char selected_ssid[WIFI_SSID_MAX_LEN];
@@ -163,6 +177,27 @@ void aic_wifi_set_disconnect_cb(aic_wifi_ctx_t* ctx, aic_wifi_disconnect_cb_t cb
  */
 void aic_wifi_update_networks(aic_wifi_ctx_t* ctx, const ipc_wifi_scan_t* scan_data);
 
+/**
+ * @brief Add or replace one streamed scan result (IPC_CMD_WIFI_SCAN_RESULT)
+ *
+ * CM33 sends each network as soon as it is found and again when it
+ * changes; an empty SSID removes the entry. Entries persist across
+ * scans. The list is redrawn at most once per AIC_WIFI_SCAN_REFRESH_MS.
+ *
+ * @param ctx WiFi context
+ * @param index Entry index (msg.value)
+ * @param network Network info (msg.data)
+ */
+void aic_wifi_add_scan_result(aic_wifi_ctx_t* ctx, uint32_t index,
+                              const ipc_wifi_network_t* network);
+
+/**
+ * @brief Finish a streamed scan (IPC_CMD_WIFI_SCAN_COMPLETE)
+ * @param ctx WiFi context
+ * @param count Total networks (msg.value)
+ */
+void aic_wifi_scan_complete(aic_wifi_ctx_t* ctx, uint32_t count);
+
 /**
  * @brief Update TCP/IP info display
  * @param ctx WiFi context
@@ -211,6 +246,16 @@ lv_obj_t* aic_wifi_create_signal_icon(lv_obj_t* parent, int8_t rssi);
  */
 void aic_wifi_update_signal_icon(lv_obj_t* icon, int8_t rssi);
 
+/**
+ * @brief Keep a signal icon current from the link quality CM33 publishes
+ *
+ * Redrawn only when CM33 publishes a significant change (no IPC query).
+ *
+ * @param ctx WiFi context
+ * @param icon Icon from aic_wifi_create_signal_icon() (NULL to stop)
+ */
+void aic_wifi_set_link_icon(aic_wifi_ctx_t* ctx, lv_obj_t* icon);
+
 /**
  * @brief Create a network list item
  * @param parent Parent list object
@@ -0,0 +1,256 @@
+/*******************************************************************************
+ * File: aic_work.c
+ * Description: AIC-EEC Deferred Work Executor Implementation
+ *
+ * Part of BiiL Course: Embedded C for IoT
+ ******************************************************************************/
+
+#include "aic_work.h"
+#include "static_mem.h"
+#include "cy_pdl.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+
+typedef struct {
+    aic_work_t *work;
+    void *arg;
+    uint32_t submit_cycles;
+    bool scheduled;             /* From aic_work_schedule() */
+} work_item_t;
+
+/*******************************************************************************
+ * Static Variables
+ ******************************************************************************/
+
+static uint8_t work_storage[AIC_WORK_PRIO_COUNT][AIC_WORK_QUEUE_SIZE * sizeof(work_item_t)];
+static StaticQueue_t work_queue_cb[AIC_WORK_PRIO_COUNT];
+STATIC_TASK_DEFINE(work, AIC_WORK_TASK_STACK);
+
+static QueueHandle_t work_queues[AIC_WORK_PRIO_COUNT];
+static TaskHandle_t work_task_handle = NULL;
+
+static const char *const queue_names[AIC_WORK_PRIO_COUNT] = {
+    "work_high", "work_norm", "work_low"
+};
+
+/* Descriptors that have run at least once (for aic_work_print) */
+static aic_work_t *work_list = NULL;
+
+static uint32_t cycles_per_us = 1;
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+
+static inline uint32_t cycles_now(void)
+{
+    return DWT->CYCCNT;
+}
+
+static void register_work(aic_work_t *work)
+{
+    for (aic_work_t *w = work_list; w != NULL; w = w->next) {
+        if (w == work) {
+            return;
+        }
+    }
+    work->next = work_list;
+    work_list = work;
+}
+
+static bool queue_item(aic_work_t *work, void *arg, bool scheduled)
+{
+    work_item_t item = {
+        .work = work,
+        .arg = arg,
+        .submit_cycles = cycles_now(),
+        .scheduled = scheduled
+    };
+    BaseType_t result;
+
+    if (work_task_handle == NULL || work->prio >= AIC_WORK_PRIO_COUNT) {
+        return false;
+    }
+
+    if (xPortIsInsideInterrupt()) {
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+        result = xQueueSendFromISR(work_queues[work->prio], &item, &xHigherPriorityTaskWoken);
+        if (result == pdTRUE) {
+            vTaskNotifyGiveFromISR(work_task_handle, &xHigherPriorityTaskWoken);
+        }
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    } else {
+        result = xQueueSend(work_queues[work->prio], &item, 0);
+        if (result == pdTRUE) {
+            xTaskNotifyGive(work_task_handle);
+        }
+    }
+
+    if (result != pdTRUE) {
+        work->stats.dropped++;
+        return false;
+    }
+    return true;
+}
+
+static bool take_next(work_item_t *item)
+{
+    /* Strict priority: re-check from the top after every item */
+    for (uint32_t prio = 0; prio < AIC_WORK_PRIO_COUNT; prio++) {
+        if (xQueueReceive(work_queues[prio], item, 0) == pdTRUE) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void run_item(const work_item_t *item)
+{
+    aic_work_t *work = item->work;
+    uint32_t start = cycles_now();
+    uint32_t latency_us = (start - item->submit_cycles) / cycles_per_us;
+
+    if (item->scheduled) {
+        work->pending = false;
+    }
+
+    work->fn(item->arg);
+
+    uint32_t run_us = (cycles_now() - start) / cycles_per_us;
+
+    register_work(work);
+    work->stats.runs++;
+    work->stats.latency_total_us += latency_us;
+    work->stats.run_total_us += run_us;
+    if (latency_us > work->stats.latency_max_us) {
+        work->stats.latency_max_us = latency_us;
+    }
+    if (run_us > work->stats.run_max_us) {
+        work->stats.run_max_us = run_us;
+    }
+}
+
+/*******************************************************************************
+ * Executor Task
+ ******************************************************************************/
+
+static void work_task(void *param)
+{
+    (void)param;
+    work_item_t item;
+
+    while (1) {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        while (take_next(&item)) {
+            run_item(&item);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Public Functions
+ ******************************************************************************/
+
+bool aic_work_init(void)
+{
+    if (work_task_handle != NULL) {
+        return true;
+    }
+
+    /* Cycle counter for latency / run time */
+#if defined(DCB)
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+#else
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+#endif
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    cycles_per_us = (SystemCoreClock >= 1000000U) ? (SystemCoreClock / 1000000U) : 1U;
+
+    for (uint32_t prio = 0; prio < AIC_WORK_PRIO_COUNT; prio++) {
+        work_queues[prio] = static_mem_queue_create(queue_names[prio], AIC_WORK_QUEUE_SIZE,
+                                                    sizeof(work_item_t), work_storage[prio],
+                                                    &work_queue_cb[prio]);
+        if (work_queues[prio] == NULL) {
+            return false;
+        }
+    }
+
+    work_task_handle = STATIC_TASK_CREATE(work, work_task, "AIC_WORK", NULL,
+                                          AIC_WORK_TASK_PRIORITY);
+    return (work_task_handle != NULL);
+}
+
+bool aic_work_submit(aic_work_t *work, void *arg)
+{
+    if (work == NULL || work->fn == NULL) {
+        return false;
+    }
+    return queue_item(work, arg, false);
+}
+
+bool aic_work_schedule(aic_work_t *work)
+{
+    if (work == NULL || work->fn == NULL) {
+        return false;
+    }
+
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+    bool already = work->pending;
+    work->pending = true;
+    Cy_SysLib_ExitCriticalSection(state);
+
+    if (already) {
+        return true;
+    }
+
+    if (!queue_item(work, NULL, true)) {
+        work->pending = false;
+        return false;
+    }
+    return true;
+}
+
+bool aic_work_in_executor(void)
+{
+    return (work_task_handle != NULL) && !xPortIsInsideInterrupt() &&
+           (xTaskGetCurrentTaskHandle() == work_task_handle);
+}
+
+void aic_work_get_stats(const aic_work_t *work, aic_work_stats_t *stats)
+{
+    if (work == NULL || stats == NULL) {
+        return;
+    }
+
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+    memcpy(stats, &work->stats, sizeof(aic_work_stats_t));
+    Cy_SysLib_ExitCriticalSection(state);
+}
+
+void aic_work_print(void)
+{
+    static const char *const prio_names[AIC_WORK_PRIO_COUNT] = { "high", "norm", "low" };
+    aic_work_stats_t s;
+
+    printf("[WORK] %-10s %-4s %8s %6s %9s %9s %9s %9s\r\n", "name", "prio",
+           "runs", "drop", "lat avg", "lat max", "run avg", "run max");
+
+    for (aic_work_t *w = work_list; w != NULL; w = w->next) {
+        aic_work_get_stats(w, &s);
+        uint32_t runs = (s.runs > 0U) ? s.runs : 1U;
+
+        printf("[WORK] %-10s %-4s %8lu %6lu %7luus %7luus %7luus %7luus\r\n",
+               (w->name != NULL) ? w->name : "?", prio_names[w->prio],
+               (unsigned long)s.runs, (unsigned long)s.dropped,
+               (unsigned long)(s.latency_total_us / runs), (unsigned long)s.latency_max_us,
+               (unsigned long)(s.run_total_us / runs), (unsigned long)s.run_max_us);
+    }
+}
@@ -0,0 +1,133 @@
+/*******************************************************************************
+ * File: aic_work.h
+ * Description: AIC-EEC Deferred Work Executor
+ *
+ * One FreeRTOS task runs deferred work for the aic-eec modules and the IPC
+ * receive path, instead of each module owning a task and a stack. Work
+ * items are function + argument pairs queued at one of three priority
+ * levels; the executor always runs the highest non-empty level first, in
+ * FIFO order within a level.
+ *
+ * Every work descriptor keeps its own latency (submit -> start) and run
+ * time figures, see aic_work_print().
+ *
+ * Work functions must not block for long: everything queued behind them
+ * waits. They may be submitted from tasks and ISRs.
+ *
+ * Part of BiiL Course: Embedded C for IoT
+ ******************************************************************************/
+
+#ifndef AIC_WORK_H
+#define AIC_WORK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * Configuration
+ ******************************************************************************/
+
+#define AIC_WORK_TASK_STACK     (512U)      /**< Executor stack size (words) */
+#define AIC_WORK_TASK_PRIORITY  (3U)        /**< Executor task priority */
+#define AIC_WORK_QUEUE_SIZE     (16U)       /**< Items per priority level */
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+
+/**
+ * @brief Priority levels (scheduling policy is strict priority)
+ */
+typedef enum {
+    AIC_WORK_PRIO_HIGH = 0,     /**< IPC receive, latency sensitive */
+    AIC_WORK_PRIO_NORMAL,       /**< Event delivery */
+    AIC_WORK_PRIO_LOW,          /**< Logging, housekeeping */
+    AIC_WORK_PRIO_COUNT
+} aic_work_prio_t;
+
+/**
+ * @brief Work function
+ */
+typedef void (*aic_work_fn_t)(void *arg);
+
+/**
+ * @brief Per-descriptor statistics (times in microseconds)
+ */
+typedef struct {
+    uint32_t runs;
+    uint32_t dropped;           /**< Submissions lost to a full queue */
+    uint32_t latency_max_us;
+    uint32_t latency_total_us;
+    uint32_t run_max_us;
+    uint32_t run_total_us;
+} aic_work_stats_t;
+
+/**
+ * @brief Work descriptor - define one static instance per kind of work
+ */
+typedef struct aic_work {
+    const char *name;
+    aic_work_fn_t fn;
+    aic_work_prio_t prio;
+    volatile bool pending;      /**< Queued by aic_work_schedule() */
+    aic_work_stats_t stats;
+    struct aic_work *next;      /**< Registered list (internal) */
+} aic_work_t;
+
+#define AIC_WORK_INIT(_name, _fn, _prio) \
+    { .name = (_name), .fn = (_fn), .prio = (_prio) }
+
+/*******************************************************************************
+ * API Functions
+ ******************************************************************************/
+
+/**
+ * @brief Create the executor task and its queues (idempotent)
+ * @return true on success
+ */
+bool aic_work_init(void);
+
+/**
+ * @brief Queue one run of work->fn(arg)
+ *
+ * Every call queues an item, so each argument is delivered.
+ *
+ * @return false if the level queue is full or the executor is not running
+ */
+bool aic_work_submit(aic_work_t *work, void *arg);
+
+/**
+ * @brief Queue a run of work->fn(NULL) unless one is already pending
+ *
+ * For "drain my queue" style work: repeated calls before the work runs
+ * cost nothing. The pending flag is cleared just before fn runs, so a call
+ * made while fn runs queues one more run.
+ *
+ * @return false if the item could not be queued
+ */
+bool aic_work_schedule(aic_work_t *work);
+
+/**
+ * @brief true when called from a work function
+ */
+bool aic_work_in_executor(void);
+
+/**
+ * @brief Copy the statistics of a work descriptor
+ */
+void aic_work_get_stats(const aic_work_t *work, aic_work_stats_t *stats);
+
+/**
+ * @brief Print statistics of all work descriptors run so far
+ */
+void aic_work_print(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AIC_WORK_H */
@@ -35,6 +35,7 @@
 
 /* IMU shared memory for CM33-CM55 IPC (BMI270 data from CM33) */
 #include "../../shared/imu_shared.h"
+#include "lat_trace.h"      /* Sensor-to-pixel latency trace points */
 #define HW_IMU_AVAILABLE 1  /* IMU data available via shared memory from CM33 */
 
 /*******************************************************************************
@@ -327,6 +328,10 @@ bool aic_imu_read_accel(float *ax, float *ay, float *az)
     /* Try to read from shared memory (CM33 BMI270 data) */
     if (IMU_SHARED_IS_VALID()) {
         if (imu_shared_read_accel(&raw_ax, &raw_ay, &raw_az)) {
+            uint32_t trace_id, read_us, publish_us;
+            if (imu_shared_read_trace(&trace_id, &read_us, &publish_us)) {
+                lat_trace_begin(trace_id, read_us, publish_us);
+            }
             raw_ax -= accel_offset[AIC_AXIS_X];
             raw_ay -= accel_offset[AIC_AXIS_Y];
             raw_az -= accel_offset[AIC_AXIS_Z];
@@ -434,6 +439,9 @@ bool aic_imu_read_all(aic_imu_data_t *data)
     data->gyro_raw_y = (int32_t)(data->gyro_y * GYRO_SCALE_250DPS);
     data->gyro_raw_z = (int32_t)(data->gyro_z * GYRO_SCALE_250DPS);
 
+    /* Values handed to the dashboard widgets: latency trace point */
+    lat_trace_mark(LAT_STAGE_WIDGET);
+
     return accel_ok && gyro_ok;
 }
 
@@ -445,6 +453,9 @@ aic_orientation_t aic_imu_get_orientation(void)
         return AIC_ORIENT_UNKNOWN;
     }
 
+    /* Shown by the orientation widget: latency trace point */
+    lat_trace_mark(LAT_STAGE_WIDGET);
+
     /* Determine orientation based on gravity vector */
     if (az > ORIENT_THRESHOLD) {
         return AIC_ORIENT_FLAT_UP;
@@ -37,6 +37,7 @@
 
 #include "tilt.h"
 #include "sensors.h"
+#include "lat_trace.h"
 #include <math.h>
 #include <stdio.h>
 
@@ -195,26 +196,33 @@ bool aic_tilt_update(float ax, float ay, float az,
     tilt_state.roll = normalize_angle(tilt_state.roll);
     tilt_state.pitch = clamp_f(tilt_state.pitch, -90.0f, 90.0f);
 
+    lat_trace_mark(LAT_STAGE_FILTER);
     return true;
 }
 
+/* The getters hand the filtered angles to the widgets: latency trace
+ * point for the widget update (ignored if nothing is in flight) */
+
 bool aic_tilt_get_state(aic_tilt_state_t *state)
 {
     if (state == NULL) {
         return false;
     }
 
+    lat_trace_mark(LAT_STAGE_WIDGET);
     *state = tilt_state;
     return tilt_state.initialized;
 }
 
 float aic_tilt_get_roll(void)
 {
+    lat_trace_mark(LAT_STAGE_WIDGET);
     return tilt_state.roll;
 }
 
 float aic_tilt_get_pitch(void)
 {
+    lat_trace_mark(LAT_STAGE_WIDGET);
     return tilt_state.pitch;
 }
 
@@ -222,6 +230,7 @@ uint8_t aic_tilt_get_roll_percent(void)
 {
     /* Map -90..+90 degrees to 0..100% */
     /* -90 = 0%, 0 = 50%, +90 = 100% */
+    lat_trace_mark(LAT_STAGE_WIDGET);
     float clamped = clamp_f(tilt_state.roll, -90.0f, 90.0f);
     float percent = (clamped + 90.0f) / 180.0f * 100.0f;
     return (uint8_t)clamp_f(percent, 0.0f, 100.0f);
@@ -231,6 +240,7 @@ uint8_t aic_tilt_get_pitch_percent(void)
 {
     /* Map -90..+90 degrees to 0..100% */
     /* -90 = 0%, 0 = 50%, +90 = 100% */
+    lat_trace_mark(LAT_STAGE_WIDGET);
     float clamped = clamp_f(tilt_state.pitch, -90.0f, 90.0f);
     float percent = (clamped + 90.0f) / 180.0f * 100.0f;
     return (uint8_t)clamp_f(percent, 0.0f, 100.0f);
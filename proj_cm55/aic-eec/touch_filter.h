@@ -0,0 +1,174 @@
+/*******************************************************************************
+ * File Name:   touch_filter.h
+ *
+ * Description: Touch coordinate filter (1 Euro filter) with short-horizon
+ *              linear prediction. Removes drag jitter at low speed while
+ *              keeping lag small at high speed, then extrapolates the
+ *              position by the measured touch-to-display latency.
+ *
+ *              1 Euro filter: Casiez, Roussel, Vogel - CHI 2012.
+ *                cutoff = min_cutoff + beta * |filtered velocity|
+ *
+ * Target:      PSoC Edge E84 Evaluation Kit
+ *
+ * Usage:
+ *   // Create filter instance
+ *   touch_filter_t tf;
+ *   touch_filter_init(&tf, &cfg);
+ *
+ *   // On every sample while pressed (timestamps in ms)
+ *   touch_filter_update(&tf, raw_x, raw_y, now_ms, &out_x, &out_y);
+ *
+ *   // On release
+ *   touch_filter_reset(&tf);
+ *
+ ******************************************************************************/
+
+#ifndef TOUCH_FILTER_H
+#define TOUCH_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+/*******************************************************************************
+ * Data Types
+ ******************************************************************************/
+
+/**
+ * @brief Filter tuning (per display / touch controller)
+ */
+typedef struct {
+    float min_cutoff;       /* Hz - lower = less jitter at rest, more lag */
+    float beta;             /* Speed coefficient - higher = less lag when fast */
+    float d_cutoff;         /* Hz - velocity low-pass cutoff */
+    float predict_ms;       /* Prediction horizon (0 = off) */
+    float max_predict_px;   /* Clamp on predicted offset */
+} touch_filter_cfg_t;
+
+/**
+ * @brief One filtered axis (position + velocity state)
+ */
+typedef struct {
+    float x;                /* Filtered position */
+    float dx;               /* Filtered velocity (px/s) */
+} touch_filter_axis_t;
+
+/**
+ * @brief 2-axis touch filter
+ */
+typedef struct {
+    touch_filter_cfg_t  cfg;
+    touch_filter_axis_t ax;
+    touch_filter_axis_t ay;
+    uint32_t            last_ms;
+    bool                initialized;    /* false until first sample after reset */
+} touch_filter_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Smoothing factor for an exponential low-pass at given cutoff
+ */
+static inline float touch_filter_alpha(float cutoff_hz, float dt_s)
+{
+    float tau = 1.0f / (2.0f * 3.14159265f * cutoff_hz);
+    return 1.0f / (1.0f + tau / dt_s);
+}
+
+/**
+ * @brief Initialize filter with tuning parameters
+ *
+ * @param tf    Pointer to filter structure
+ * @param cfg   Tuning parameters (copied)
+ */
+static inline void touch_filter_init(touch_filter_t *tf, const touch_filter_cfg_t *cfg)
+{
+    if (tf == NULL || cfg == NULL) return;
+
+    memset(tf, 0, sizeof(touch_filter_t));
+    tf->cfg = *cfg;
+}
+
+/**
+ * @brief Reset filter state (call on touch release)
+ *
+ * @param tf    Pointer to filter structure
+ */
+static inline void touch_filter_reset(touch_filter_t *tf)
+{
+    if (tf == NULL) return;
+
+    tf->initialized = false;
+}
+
+/**
+ * @brief Filter one axis
+ */
+static inline float touch_filter_axis_update(touch_filter_axis_t *a,
+                                             const touch_filter_cfg_t *cfg,
+                                             float raw, float dt_s)
+{
+    /* Velocity estimate, low-passed at d_cutoff */
+    float raw_dx = (raw - a->x) / dt_s;
+    float a_d = touch_filter_alpha(cfg->d_cutoff, dt_s);
+    a->dx = a->dx + a_d * (raw_dx - a->dx);
+
+    /* Adaptive cutoff: faster motion -> higher cutoff -> less lag */
+    float cutoff = cfg->min_cutoff + cfg->beta * fabsf(a->dx);
+    float a_x = touch_filter_alpha(cutoff, dt_s);
+    a->x = a->x + a_x * (raw - a->x);
+
+    /* Short-horizon linear prediction */
+    float offset = a->dx * (cfg->predict_ms / 1000.0f);
+    if (offset >  cfg->max_predict_px) offset =  cfg->max_predict_px;
+    if (offset < -cfg->max_predict_px) offset = -cfg->max_predict_px;
+
+    return a->x + offset;
+}
+
+/**
+ * @brief Update filter with a new raw sample
+ *
+ * The first sample after init/reset passes through unchanged so a new
+ * press lands exactly where the finger is.
+ *
+ * @param tf        Pointer to filter structure
+ * @param raw_x     Raw X coordinate
+ * @param raw_y     Raw Y coordinate
+ * @param now_ms    Sample timestamp in ms
+ * @param out_x     Filtered (and predicted) X
+ * @param out_y     Filtered (and predicted) Y
+ */
+static inline void touch_filter_update(touch_filter_t *tf,
+                                       int32_t raw_x, int32_t raw_y,
+                                       uint32_t now_ms,
+                                       int32_t *out_x, int32_t *out_y)
+{
+    if (tf == NULL || out_x == NULL || out_y == NULL) return;
+
+    if (!tf->initialized) {
+        tf->ax.x = (float)raw_x;
+        tf->ay.x = (float)raw_y;
+        tf->ax.dx = 0.0f;
+        tf->ay.dx = 0.0f;
+        tf->last_ms = now_ms;
+        tf->initialized = true;
+        *out_x = raw_x;
+        *out_y = raw_y;
+        return;
+    }
+
+    uint32_t dt_ms = now_ms - tf->last_ms;
+    if (dt_ms == 0) dt_ms = 1;
+    tf->last_ms = now_ms;
+
+    float dt_s = (float)dt_ms / 1000.0f;
+    *out_x = (int32_t)lroundf(touch_filter_axis_update(&tf->ax, &tf->cfg, (float)raw_x, dt_s));
+    *out_y = (int32_t)lroundf(touch_filter_axis_update(&tf->ay, &tf->cfg, (float)raw_y, dt_s));
+}
+
+#endif /* TOUCH_FILTER_H */
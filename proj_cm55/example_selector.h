@@ -14,6 +14,8 @@
 #define EXAMPLE_SELECTOR_H
 
 #include "lvgl.h"
+#include "aic-eec/aic_screen.h"
+#include "aic-eec/aic_diag.h"
 
 /*******************************************************************************
  * CONFIGURATION - Change these values to select different examples
@@ -282,6 +284,32 @@ static inline void run_selected_example(void)
 #endif
 }
 
+/*******************************************************************************
+ * Start the selected example on a screen managed by aic_screen
+ *
+ * The example is built on its own screen, which stays alive while the
+ * diagnostics screen (aic_diag.h, swipe up) is open. The diagnostics
+ * screen itself is only built once the user is idle after the first frame.
+ ******************************************************************************/
+static inline void example_screen_build(lv_obj_t *screen, void *user_data)
+{
+    (void)user_data;
+
+    /* Examples build on lv_screen_active() */
+    lv_screen_load(screen);
+    run_selected_example();
+}
+
+static inline void start_selected_example(void)
+{
+    lv_obj_t *boot_screen = lv_screen_active();
+    int example_id = aic_screen_register("example", example_screen_build, NULL);
+
+    (void)aic_screen_show(example_id, LV_SCR_LOAD_ANIM_NONE, 0);
+    lv_obj_delete(boot_screen);     /* Default display screen, now unused */
+    (void)aic_diag_init(example_id);
+}
+
 /*******************************************************************************
  * Helper function to print current selection
  ******************************************************************************/
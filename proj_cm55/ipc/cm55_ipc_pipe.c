@@ -10,6 +10,12 @@
 
 #include "cm55_ipc_pipe.h"
 #include "../../shared/include/ipc_communication.h"
+#include "../../shared/include/mem_stats.h"
+#include "../../shared/include/cpu_load.h"
+#include "../../shared/include/lat_trace.h"
+#include "../../shared/include/static_mem.h"
+#include "../lv_port_disp.h"
+#include "../aic-eec/aic_work.h"
 #include "cy_ipc_pipe.h"
 #include "FreeRTOS.h"
 #include "task.h"
@@ -22,9 +28,6 @@
  * Configuration
  ******************************************************************************/
 
-#define CM55_IPC_TASK_STACK_SIZE    (configMINIMAL_STACK_SIZE * 2)
-#define CM55_IPC_TASK_PRIORITY      (3)
-#define CM55_IPC_PROCESS_DELAY_MS   (10)
 
 /*******************************************************************************
  * Static Variables
@@ -37,6 +40,7 @@ CY_SECTION_SHAREDMEM static ipc_msg_t cm55_tx_msg;
 static volatile bool msg_received = false;
 static ipc_msg_t rx_buffer;
 static SemaphoreHandle_t rx_mutex = NULL;
+STATIC_MUTEX_DEFINE(rx);
 
 /* Initialization state */
 static bool ipc_initialized = false;
@@ -50,8 +54,10 @@ static uint32_t tx_count = 0;
 static uint32_t rx_count = 0;
 static uint32_t error_count = 0;
 
-/* FreeRTOS task handle */
-static TaskHandle_t ipc_task_handle = NULL;
+/* Receive work on the shared executor (replaces the IPC_RX polling task) */
+static void cm55_ipc_rx_work_fn(void *arg);
+static aic_work_t ipc_rx_work = AIC_WORK_INIT("ipc_rx", cm55_ipc_rx_work_fn, AIC_WORK_PRIO_HIGH);
+static volatile bool rx_on_executor = false;
 
 /*******************************************************************************
  * IPC Callback (called from ISR context)
@@ -63,8 +69,20 @@ static void cm55_ipc_callback(uint32_t *msgData)
 
     /* Copy to buffer (ISR-safe) */
     memcpy(&rx_buffer, msg, sizeof(ipc_msg_t));
+    lat_trace_stamp_rx(&rx_buffer);     /* Clock sync receive time */
     msg_received = true;
     rx_count++;
+
+    if (rx_on_executor) {
+        aic_work_schedule(&ipc_rx_work);
+    }
+}
+
+/* Latency tracer syncs and reports: single attempt, a lost sync is retried
+ * by the next one and a retry delay would only inflate its round trip */
+static bool lat_trace_send(const ipc_msg_t *msg)
+{
+    return (cm55_ipc_send(msg) == CY_IPC_PIPE_SUCCESS);
 }
 
 /*******************************************************************************
@@ -80,7 +98,7 @@ cy_en_ipc_pipe_status_t cm55_ipc_init(void)
     }
 
     /* Create mutex for thread-safe access */
-    rx_mutex = xSemaphoreCreateMutex();
+    rx_mutex = STATIC_MUTEX_CREATE(rx, "ipc_rx");
     if (rx_mutex == NULL) {
         printf("[CM55 IPC] Failed to create mutex\n");
         return CY_IPC_PIPE_ERROR_NO_INTR;
@@ -98,6 +116,7 @@ cy_en_ipc_pipe_status_t cm55_ipc_init(void)
 
     if (status == CY_IPC_PIPE_SUCCESS) {
         ipc_initialized = true;
+        lat_trace_init(lat_trace_send);     /* Runs while the latency overlay is on */
         printf("[CM55 IPC] Initialized successfully\n");
     } else {
         printf("[CM55 IPC] Init failed: %d\n", status);
@@ -240,6 +259,9 @@ void cm55_ipc_process(void)
         /* Call registered callback first */
         if (rx_callback != NULL) {
             rx_callback(&msg, rx_callback_user_data);
+
+            /* The callback may have changed UI state; render it now */
+            lv_port_disp_wake();
         }
 
         /* Handle built-in commands */
@@ -254,6 +276,46 @@ void cm55_ipc_process(void)
                 }
                 break;
 
+            case IPC_CMD_MEM_REQ:
+                /* Dump this core's memory figures to the requester */
+                {
+                    ipc_msg_t report;
+                    IPC_MSG_INIT(&report, IPC_CMD_MEM_REPORT);
+                    report.value = msg.value;
+                    mem_stats_fill_report((ipc_mem_report_t *)report.data);
+                    cm55_ipc_send_retry(&report, 0);
+                }
+                break;
+
+            case IPC_CMD_CPU_REQ:
+                /* Send this core's per-task CPU load */
+                {
+                    ipc_msg_t report;
+                    IPC_MSG_INIT(&report, IPC_CMD_CPU_REPORT);
+                    cpu_load_fill_report((ipc_cpu_report_t *)report.data);
+                    cm55_ipc_send_retry(&report, 0);
+                }
+                break;
+
+            case IPC_CMD_CPU_REPORT:
+                /* Keep the other core's load for the overlay (polled - not printed) */
+                cpu_load_set_remote((const ipc_cpu_report_t *)msg.data);
+                break;
+
+            case IPC_CMD_MEM_REPORT:
+                /* Keep the other core's figures for the memory panel
+                 * (polled - printed only for a dump request) */
+                mem_stats_set_remote((const ipc_mem_report_t *)msg.data);
+                if (msg.value == IPC_MEM_PRINT) {
+                    mem_stats_print_report("CM33", (const ipc_mem_report_t *)msg.data);
+                }
+                break;
+
+            case IPC_CMD_LAT_SYNC_REPLY:
+                /* Latency tracer clock offset */
+                lat_trace_sync_done(&msg);
+                break;
+
             case IPC_CMD_LOG:
                 /* Print log from CM33 */
                 printf("[CM33] %s", msg.data);
@@ -382,48 +444,40 @@ cy_en_ipc_pipe_status_t cm55_ipc_request_button(uint8_t button_id)
 }
 
 /*******************************************************************************
- * FreeRTOS Task
+ * Receive Work (runs on the aic_work executor)
  ******************************************************************************/
 
-static void cm55_ipc_task(void *param)
+static void cm55_ipc_rx_work_fn(void *arg)
 {
-    (void)param;
-
-    printf("[CM55 IPC] Task started\n");
-
-    while (1) {
-        cm55_ipc_process();
-        vTaskDelay(pdMS_TO_TICKS(CM55_IPC_PROCESS_DELAY_MS));
-    }
+    (void)arg;
+    cm55_ipc_process();
 }
 
 void cm55_ipc_create_task(void)
 {
-    if (ipc_task_handle != NULL) {
-        return;  /* Task already created */
+    if (rx_on_executor) {
+        return;  /* Already attached */
     }
 
-    BaseType_t result = xTaskCreate(
-        cm55_ipc_task,
-        "IPC_RX",
-        CM55_IPC_TASK_STACK_SIZE,
-        NULL,
-        CM55_IPC_TASK_PRIORITY,
-        &ipc_task_handle
-    );
+    if (!aic_work_init()) {
+        printf("[CM55 IPC] Failed to start work executor\n");
+        return;
+    }
+
+    rx_on_executor = true;
+    printf("[CM55 IPC] Receive on work executor\n");
 
-    if (result != pdPASS) {
-        printf("[CM55 IPC] Failed to create task\n");
-        ipc_task_handle = NULL;
+    /* A message may have arrived before attaching */
+    if (msg_received) {
+        aic_work_schedule(&ipc_rx_work);
     }
 }
 
 void cm55_ipc_delete_task(void)
 {
-    if (ipc_task_handle != NULL) {
-        vTaskDelete(ipc_task_handle);
-        ipc_task_handle = NULL;
-        printf("[CM55 IPC] Task deleted\n");
+    if (rx_on_executor) {
+        rx_on_executor = false;
+        printf("[CM55 IPC] Receive detached\n");
     }
 }
 
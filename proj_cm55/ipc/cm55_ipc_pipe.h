@@ -199,19 +199,19 @@ cy_en_ipc_pipe_status_t cm55_ipc_set_led_brightness(uint8_t led_id, uint8_t brig
 cy_en_ipc_pipe_status_t cm55_ipc_request_button(uint8_t button_id);
 
 /*******************************************************************************
- * FreeRTOS Task
+ * Background Receive
  ******************************************************************************/
 
 /**
- * @brief Create IPC receive task (FreeRTOS)
+ * @brief Start background IPC receive processing
  *
- * Creates a FreeRTOS task that continuously processes IPC messages.
- * The task runs at priority 3 and uses configMINIMAL_STACK_SIZE * 2.
+ * Each received message schedules cm55_ipc_process() as high priority work
+ * on the shared aic_work executor (no dedicated task, no polling).
  */
 void cm55_ipc_create_task(void);
 
 /**
- * @brief Delete IPC task
+ * @brief Stop background receive (call cm55_ipc_process() instead)
  */
 void cm55_ipc_delete_task(void);
 
@@ -44,6 +44,9 @@
 #include <stdbool.h>
 #include <string.h>
 #include "cy_graphics.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "lat_trace.h"
 
 
 #if LV_COLOR_DEPTH == 16
@@ -66,6 +69,9 @@ void *frame_buffer2 = &disp_buf2;
 
 cy_stc_gfx_context_t gfx_context;
 
+/* LVGL (gfx) task, created in main.c */
+extern TaskHandle_t rtos_cm55_gfx_task_handle;
+
 
 /*******************************************************************************
 * Function Name: disp_flush
@@ -90,11 +96,15 @@ static void LV_ATTRIBUTE_FAST_MEM disp_flush(lv_display_t *disp_drv,
 {
     CY_UNUSED_PARAMETER(area);
 
+    lat_trace_mark(LAT_STAGE_FLUSH);
+
     Cy_GFXSS_Set_FrameBuffer((GFXSS_Type*) GFXSS, (uint32_t*) color_p,
             &gfx_context);
 
     if (ulTaskNotifyTake(pdTRUE, portMAX_DELAY))
     {
+        lat_trace_mark(LAT_STAGE_VSYNC);
+
         /* Inform the graphics library that you are ready with the flushing */
         lv_display_flush_ready(disp_drv);
     }
@@ -159,4 +169,69 @@ void lv_port_disp_init(void)
 }
 
 
+/*******************************************************************************
+* Function Name: lv_port_disp_wait
+********************************************************************************
+* Summary:
+*  Blocks the LVGL task until lv_port_disp_wake() is called or the next LVGL
+*  timer is due. With no LVGL timer ready it blocks until woken, which leaves
+*  the idle task free to enter tickless sleep. Wakes that arrive while LVGL
+*  is running are kept and end the next wait at once.
+*
+* Parameters:
+*  timeout_ms: Value returned by lv_timer_handler().
+*
+* Return:
+*  bool: true if woken, false on timeout
+*
+*******************************************************************************/
+bool lv_port_disp_wait(uint32_t timeout_ms)
+{
+    TickType_t ticks = (LV_NO_TIMER_READY == timeout_ms) ?
+                       portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+
+    return (0U != ulTaskNotifyTakeIndexed(LV_PORT_WAKE_NOTIFY_INDEX, pdTRUE,
+                                          ticks));
+}
+
+
+/*******************************************************************************
+* Function Name: lv_port_disp_wake
+********************************************************************************
+* Summary:
+*  Wakes the LVGL task so pending input or invalidated UI state is handled
+*  without waiting for the next LVGL timer. Safe from tasks and ISRs; cheap
+*  to call repeatedly since wakes are coalesced.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void lv_port_disp_wake(void)
+{
+    if (NULL == rtos_cm55_gfx_task_handle)
+    {
+        return;
+    }
+
+    if (xPortIsInsideInterrupt())
+    {
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+        vTaskNotifyGiveIndexedFromISR(rtos_cm55_gfx_task_handle,
+                                      LV_PORT_WAKE_NOTIFY_INDEX,
+                                      &xHigherPriorityTaskWoken);
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    }
+    else if (xTaskGetCurrentTaskHandle() != rtos_cm55_gfx_task_handle)
+    {
+        (void)xTaskNotifyGiveIndexed(rtos_cm55_gfx_task_handle,
+                                     LV_PORT_WAKE_NOTIFY_INDEX);
+    }
+}
+
+
 /* [] END OF FILE */
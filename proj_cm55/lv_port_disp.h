@@ -69,6 +69,10 @@ extern "C" {
 #define ACTUAL_DISP_VER_RES                          (600U)
 #define ACTUAL_DISP_HOR_RES                          (1024U)
 #endif
+
+/* Task notification index used to wake the LVGL task. Index 0 is taken by
+ * the vsync wait in disp_flush(). */
+#define LV_PORT_WAKE_NOTIFY_INDEX                    (1U)
 extern cy_stc_gfx_context_t gfx_context;
 extern void *frame_buffer1;
 extern void *frame_buffer2;
@@ -79,6 +83,13 @@ extern void *frame_buffer2;
 /* Initialize low level display driver */
 void lv_port_disp_init(void);
 
+/* Block the LVGL task until woken or timeout_ms (from lv_timer_handler())
+ * elapses. Returns true if woken. */
+bool lv_port_disp_wait(uint32_t timeout_ms);
+
+/* Wake the LVGL task after changing UI state from another task or an ISR */
+void lv_port_disp_wake(void);
+
 
 #ifdef __cplusplus
 } /* extern "C" */
@@ -41,7 +41,6 @@
 *******************************************************************************/
 #include "lv_port_disp.h"
 #include "lv_port_indev.h"
-#include "lv_indev_private.h"
 #include "cy_utils.h"
 #if defined(MTB_CTP_GT911)
 #include "mtb_ctp_gt911.h"
@@ -52,6 +51,12 @@
 #endif
 #include "cybsp.h"
 #include "display_i2c_config.h"
+#include "aic-eec/touch_filter.h"
+#include "static_mem.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
 
 
 /*******************************************************************************
@@ -65,25 +70,110 @@
 #endif
 
 /* Touch polling interval (ms). Lower = smoother slider/drag, higher = less I2C load.
- * 20ms (50Hz) gives good responsiveness. Original was 100ms which felt laggy. */
+ * 20ms (50Hz) gives good responsiveness. Original was 100ms which felt laggy.
+ * With an IRQ line this is only the tracking rate while a finger is down. */
 #define INDEV_READ_PERIOD_MS       20U
 
+/* Touch reader task. Runs the I2C reads outside the LVGL loop and pushes
+ * samples into a queue that LVGL drains in LV_INDEV_MODE_EVENT. */
+#define TOUCH_TASK_STACK_SIZE      (configMINIMAL_STACK_SIZE * 2)
+#define TOUCH_TASK_PRIORITY        (configMAX_PRIORITIES - 2)
+#define TOUCH_QUEUE_LENGTH         (8U)
+
+/* Touch filter (1 Euro + linear prediction), tuned per display/controller.
+ * PREDICT_MS approximates the touch-to-display latency: one tracking period
+ * plus about one frame. Set TOUCH_FILTER_ENABLED to 0 to pass raw points. */
+#define TOUCH_FILTER_ENABLED       (1U)
+#if defined(MTB_CTP_FT5406)
+/* 4.3" 800x480: noisy controller, small panel */
+#define TOUCH_FILTER_MIN_CUTOFF    (1.0f)
+#define TOUCH_FILTER_BETA          (0.010f)
+#define TOUCH_FILTER_PREDICT_MS    (30.0f)
+#elif defined(MTB_CTP_GT911)
+/* 7" 1024x600 Waveshare */
+#define TOUCH_FILTER_MIN_CUTOFF    (1.5f)
+#define TOUCH_FILTER_BETA          (0.007f)
+#define TOUCH_FILTER_PREDICT_MS    (30.0f)
+#else
+/* 10.1" EK79007AD3 + ILI2511: IRQ-driven, lower latency */
+#define TOUCH_FILTER_MIN_CUTOFF    (1.5f)
+#define TOUCH_FILTER_BETA          (0.007f)
+#define TOUCH_FILTER_PREDICT_MS    (20.0f)
+#endif
+#define TOUCH_FILTER_D_CUTOFF      (1.0f)
+#define TOUCH_FILTER_MAX_PREDICT   (24.0f)  /* px */
+
+/* Controllers whose interrupt line is wired to the MCU. Without one the
+ * reader falls back to polling (FT5406/GT911 on the RPi DSI connector only
+ * expose I2C). */
+#if defined(MTB_CTP_ILI2511)
+#define TOUCH_IRQ_ENABLED          (1U)
+#define TOUCH_IRQ_PRIORITY         (3UL)
+#else
+#define TOUCH_IRQ_ENABLED          (0U)
+#endif
+
 /*******************************************************************************
 * Touch Disable Flag (for CAPSENSE I2C bus sharing)
 * When disabled, touchpad_read() skips I2C reads to free the bus for CAPSENSE
 *******************************************************************************/
-static bool touch_disabled = false;
+static volatile bool touch_disabled = false;
+
+/* Touch sample passed from the reader task to LVGL */
+typedef struct
+{
+    int32_t  x;
+    int32_t  y;
+    bool     pressed;
+    uint32_t timestamp;     /* FreeRTOS tick when the sample was read */
+} touch_sample_t;
+
+STATIC_TASK_DEFINE(touch, TOUCH_TASK_STACK_SIZE);
+STATIC_QUEUE_DEFINE(touch, TOUCH_QUEUE_LENGTH, sizeof(touch_sample_t));
+STATIC_MUTEX_DEFINE(touch_bus);
+
+static QueueHandle_t touch_queue = NULL;
+static SemaphoreHandle_t touch_bus_mutex = NULL;
+static TaskHandle_t touch_task_handle = NULL;
+
+#if (TOUCH_FILTER_ENABLED == 1U)
+static const touch_filter_cfg_t touch_filter_cfg =
+{
+    .min_cutoff     = TOUCH_FILTER_MIN_CUTOFF,
+    .beta           = TOUCH_FILTER_BETA,
+    .d_cutoff       = TOUCH_FILTER_D_CUTOFF,
+    .predict_ms     = TOUCH_FILTER_PREDICT_MS,
+    .max_predict_px = TOUCH_FILTER_MAX_PREDICT,
+};
+#endif
 
 #if defined(MTB_CTP_FT5406)
 /*******************************************************************************
 * I2C Error Recovery
-* If FT5406 I2C reads fail consecutively, reinitialize I2C bus + touch controller
+* If FT5406 I2C reads fail consecutively, reinitialize I2C bus + touch controller.
+* Recovery runs as a state machine in the touch reader task, one step per
+* tracking period, releasing the bus between steps. Input reports "released"
+* until the controller is back.
 *******************************************************************************/
 #define TOUCH_I2C_ERROR_THRESHOLD  5U
+#define TOUCH_RECOVERY_SETTLE_MS   10U
+
+typedef enum
+{
+    TOUCH_RECOVERY_IDLE = 0,
+    TOUCH_RECOVERY_BUS_RESET,       /* Disable/enable the SCB */
+    TOUCH_RECOVERY_SETTLE,          /* Let the bus settle */
+    TOUCH_RECOVERY_CTP_INIT,        /* Re-initialize the controller */
+} touch_recovery_state_t;
+
 static uint32_t touch_i2c_error_count = 0;
-static uint32_t touch_recovery_count  = 0;
+static volatile touch_recovery_state_t touch_recovery_state = TOUCH_RECOVERY_IDLE;
+static TickType_t touch_recovery_start_tick = 0;
+static TickType_t touch_recovery_step_tick  = 0;
 #endif
 
+static lv_port_indev_recovery_stats_t touch_recovery_stats;
+
 /*******************************************************************************
 * Global Variables
 *******************************************************************************/
@@ -112,6 +202,15 @@ mtb_ctp_ft5406_config_t ctp_ft5406_cfg =
 };
 #endif /* MTB_CTP_FT5406 */
 
+#if (TOUCH_IRQ_ENABLED == 1U)
+/* Touch controller IRQ Config */
+cy_stc_sysint_t touch_irq_cfg =
+{
+    .intrSrc      = ioss_interrupts_gpio_17_IRQn,
+    .intrPriority = TOUCH_IRQ_PRIORITY,
+};
+#endif
+
 
 /*******************************************************************************
 * Function Name: touchpad_init
@@ -147,46 +246,59 @@ static void touchpad_init(void)
 }
 
 
+#if (TOUCH_IRQ_ENABLED == 1U)
 /*******************************************************************************
-* Function Name: touchpad_read
+* Function Name: touch_irq_handler
 ********************************************************************************
 * Summary:
-*  Touchpad read function called by the LVGL library.
-*  Here you will find example implementation of input devices supported by
-*  LVGL:
-*   - Touchpad
-*   - Mouse (with cursor support)
-*   - Keypad (supports GUI usage only with key)
-*   - Encoder (supports GUI usage only with: left, right, push)
-*   - Button (external buttons to press points on the screen)
+*  Touch controller interrupt handler. Flags the touch event for the driver and
+*  wakes the touch reader task.
 *
-*   The `..._read()` function are only examples.
-*   You should shape them according to your hardware.
+* Parameters:
+*  void
 *
+* Return:
+*  void
+*
+*******************************************************************************/
+static void touch_irq_handler(void)
+{
+    BaseType_t higher_priority_task_woken = pdFALSE;
+
+    Cy_GPIO_ClearInterrupt(CTP_IRQ_PORT, CTP_IRQ_PIN);
+    NVIC_ClearPendingIRQ(touch_irq_cfg.intrSrc);
+
+    ctp_ili2511_cfg.touch_event = true;
+
+    if (NULL != touch_task_handle)
+    {
+        vTaskNotifyGiveFromISR(touch_task_handle, &higher_priority_task_woken);
+    }
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+}
+#endif /* TOUCH_IRQ_ENABLED */
+
+
+/*******************************************************************************
+* Function Name: touchpad_read_hw
+********************************************************************************
+* Summary:
+*  Reads a single touch point from the touch controller over I2C.
 *
 * Parameters:
-*  *indev_drv: Pointer to the input driver structure to be registered by LVGL.
-*  *data: Pointer to the data buffer holding touch coordinates.
+*  *x: Pointer to store the X coordinate (display orientation).
+*  *y: Pointer to store the Y coordinate (display orientation).
 *
 * Return:
-*  void
+*  bool: true if a finger is on the panel
 *
 *******************************************************************************/
-LV_ATTRIBUTE_FAST_MEM void touchpad_read(lv_indev_t *indev_drv,
-                                         lv_indev_data_t *data)
+static bool touchpad_read_hw(int32_t *x, int32_t *y)
 {
     static int touch_x = 0;
     static int touch_y = 0;
     cy_rslt_t result   = CY_RSLT_SUCCESS;
-
-    data->state = LV_INDEV_STATE_REL;
-
-    /* Skip I2C touch reads when disabled (CAPSENSE needs exclusive bus access) */
-    if (touch_disabled) {
-        data->point.x = 0;
-        data->point.y = 0;
-        return;
-    }
+    bool pressed       = false;
 
 #if defined(MTB_CTP_GT911)
     result = mtb_gt911_get_single_touch(DISPLAY_I2C_CONTROLLER_HW,
@@ -196,14 +308,14 @@ LV_ATTRIBUTE_FAST_MEM void touchpad_read(lv_indev_t *indev_drv,
 
     if (CY_RSLT_SUCCESS == result)
     {
-        data->state = LV_INDEV_STATE_PR;
+        pressed = true;
     }
 #elif defined(MTB_CTP_ILI2511)
     result = mtb_ctp_ili2511_get_single_touch(&touch_x, &touch_y);
 
     if (CY_RSLT_SUCCESS == result)
     {
-        data->state = LV_INDEV_STATE_PR;
+        pressed = true;
     }
 #elif defined(MTB_CTP_FT5406)
     mtb_ctp_touch_event_t touch_event;
@@ -218,7 +330,7 @@ LV_ATTRIBUTE_FAST_MEM void touchpad_read(lv_indev_t *indev_drv,
         if ((MTB_CTP_TOUCH_DOWN == touch_event) ||
             (MTB_CTP_TOUCH_CONTACT == touch_event))
         {
-            data->state = LV_INDEV_STATE_PR;
+            pressed = true;
         }
     }
     else
@@ -227,16 +339,13 @@ LV_ATTRIBUTE_FAST_MEM void touchpad_read(lv_indev_t *indev_drv,
 
         if (touch_i2c_error_count >= TOUCH_I2C_ERROR_THRESHOLD)
         {
-            touch_recovery_count++;
-            printf("[TOUCH] I2C recovery #%u (%u errors)\r\n",
-                   (unsigned int)touch_recovery_count,
+            /* Hand over to the background recovery state machine */
+            printf("[TOUCH] I2C recovery #%u started (%u errors)\r\n",
+                   (unsigned int)(touch_recovery_stats.recovery_count + 1U),
                    (unsigned int)touch_i2c_error_count);
 
-            Cy_SCB_I2C_Disable(DISPLAY_I2C_CONTROLLER_HW,
-                               &disp_touch_i2c_controller_context);
-            Cy_SCB_I2C_Enable(DISPLAY_I2C_CONTROLLER_HW);
-            mtb_ctp_ft5406_init(&ctp_ft5406_cfg);
-
+            touch_recovery_start_tick = xTaskGetTickCount();
+            touch_recovery_state = TOUCH_RECOVERY_BUS_RESET;
             touch_i2c_error_count = 0;
         }
     }
@@ -245,14 +354,264 @@ LV_ATTRIBUTE_FAST_MEM void touchpad_read(lv_indev_t *indev_drv,
 
 #if defined(MTB_CTP_FT5406)
     /* Set the last pressed coordinates */
-    data->point.x = ACTUAL_DISP_HOR_RES - touch_x;
-    data->point.y = ACTUAL_DISP_VER_RES - touch_y;
+    *x = ACTUAL_DISP_HOR_RES - touch_x;
+    *y = ACTUAL_DISP_VER_RES - touch_y;
 #elif defined(MTB_CTP_ILI2511) || defined(MTB_CTP_GT911)
     /* Set the last pressed coordinates */
-    data->point.x = touch_x;
-    data->point.y = touch_y;
+    *x = touch_x;
+    *y = touch_y;
 #endif
 
+    return pressed;
+}
+
+
+#if defined(MTB_CTP_FT5406)
+/*******************************************************************************
+* Function Name: touch_recovery_step
+********************************************************************************
+* Summary:
+*  Runs one step of the FT5406 recovery state machine. Each step is short so
+*  neither the reader task nor other I2C bus users stall for the whole
+*  re-initialization. Must be called with the touch bus mutex held.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  bool: true while recovery is in progress (skip the touch read)
+*
+*******************************************************************************/
+static bool touch_recovery_step(void)
+{
+    TickType_t now = xTaskGetTickCount();
+    uint32_t duration_ms;
+
+    switch (touch_recovery_state)
+    {
+        case TOUCH_RECOVERY_BUS_RESET:
+            Cy_SCB_I2C_Disable(DISPLAY_I2C_CONTROLLER_HW,
+                               &disp_touch_i2c_controller_context);
+            Cy_SCB_I2C_Enable(DISPLAY_I2C_CONTROLLER_HW);
+            touch_recovery_step_tick = now;
+            touch_recovery_state = TOUCH_RECOVERY_SETTLE;
+            break;
+
+        case TOUCH_RECOVERY_SETTLE:
+            if ((now - touch_recovery_step_tick) >=
+                pdMS_TO_TICKS(TOUCH_RECOVERY_SETTLE_MS))
+            {
+                touch_recovery_state = TOUCH_RECOVERY_CTP_INIT;
+            }
+            break;
+
+        case TOUCH_RECOVERY_CTP_INIT:
+            if (CY_RSLT_SUCCESS == (cy_rslt_t)mtb_ctp_ft5406_init(&ctp_ft5406_cfg))
+            {
+                duration_ms = (uint32_t)pdTICKS_TO_MS(now - touch_recovery_start_tick);
+
+                touch_recovery_stats.recovery_count++;
+                touch_recovery_stats.last_duration_ms = duration_ms;
+                touch_recovery_stats.total_duration_ms += duration_ms;
+                if (duration_ms > touch_recovery_stats.max_duration_ms)
+                {
+                    touch_recovery_stats.max_duration_ms = duration_ms;
+                }
+                touch_recovery_stats.last_recovery_ms = (uint32_t)pdTICKS_TO_MS(now);
+
+                printf("[TOUCH] I2C recovery #%u done in %u ms\r\n",
+                       (unsigned int)touch_recovery_stats.recovery_count,
+                       (unsigned int)duration_ms);
+
+                touch_recovery_state = TOUCH_RECOVERY_IDLE;
+            }
+            else
+            {
+                /* Controller not answering yet - reset the bus again */
+                touch_recovery_stats.failed_attempts++;
+                touch_recovery_state = TOUCH_RECOVERY_BUS_RESET;
+            }
+            break;
+
+        case TOUCH_RECOVERY_IDLE:
+        default:
+            return false;
+    }
+
+    return true;
+}
+#endif /* MTB_CTP_FT5406 */
+
+
+/*******************************************************************************
+* Function Name: touch_queue_push
+********************************************************************************
+* Summary:
+*  Pushes a sample to the LVGL touch queue and wakes the LVGL task. When the
+*  queue is full the oldest sample is dropped so the newest position always
+*  reaches LVGL.
+*
+* Parameters:
+*  *sample: Pointer to the touch sample.
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void touch_queue_push(const touch_sample_t *sample)
+{
+    touch_sample_t dropped;
+
+    if (pdTRUE != xQueueSend(touch_queue, sample, 0))
+    {
+        (void)xQueueReceive(touch_queue, &dropped, 0);
+        (void)xQueueSend(touch_queue, sample, 0);
+    }
+
+    lv_port_disp_wake();
+}
+
+
+/*******************************************************************************
+* Function Name: touch_task
+********************************************************************************
+* Summary:
+*  Touch reader task. With an IRQ line it sleeps until the controller signals
+*  a touch, then tracks the finger at INDEV_READ_PERIOD_MS until release, so
+*  the idle I2C traffic is zero. Without an IRQ line it polls. While a
+*  finger is down a sample is queued every period, moved or not, so LVGL
+*  keeps reading and its long-press and repeat timers run; otherwise only
+*  the release edge is queued.
+*
+* Parameters:
+*  void *arg: Not used.
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void touch_task(void *arg)
+{
+    CY_UNUSED_PARAMETER(arg);
+
+    touch_sample_t last = { 0, 0, false, 0 };
+    touch_sample_t sample;
+#if (TOUCH_FILTER_ENABLED == 1U)
+    touch_filter_t filter;
+
+    touch_filter_init(&filter, &touch_filter_cfg);
+#endif
+
+    for (;;)
+    {
+#if (TOUCH_IRQ_ENABLED == 1U)
+        if (!last.pressed)
+        {
+            /* Idle: block until the controller raises its interrupt */
+            (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+        else
+        {
+            vTaskDelay(pdMS_TO_TICKS(INDEV_READ_PERIOD_MS));
+        }
+#else
+        vTaskDelay(pdMS_TO_TICKS(INDEV_READ_PERIOD_MS));
+#endif
+
+        /* Skip I2C touch reads when disabled (CAPSENSE needs exclusive bus access) */
+        if (touch_disabled)
+        {
+            if (last.pressed)
+            {
+                last.pressed = false;
+                last.timestamp = xTaskGetTickCount();
+                touch_queue_push(&last);
+            }
+            continue;
+        }
+
+        xSemaphoreTake(touch_bus_mutex, portMAX_DELAY);
+#if defined(MTB_CTP_FT5406)
+        if (touch_recovery_step())
+        {
+            xSemaphoreGive(touch_bus_mutex);
+
+            /* Report "released" while the controller is recovering */
+            if (last.pressed)
+            {
+                last.pressed = false;
+                last.timestamp = xTaskGetTickCount();
+                touch_queue_push(&last);
+#if (TOUCH_FILTER_ENABLED == 1U)
+                touch_filter_reset(&filter);
+#endif
+            }
+            continue;
+        }
+#endif
+        sample.pressed = touchpad_read_hw(&sample.x, &sample.y);
+        xSemaphoreGive(touch_bus_mutex);
+        sample.timestamp = xTaskGetTickCount();
+
+        if (!sample.pressed)
+        {
+            /* Release is reported at the last pressed position */
+            sample.x = last.x;
+            sample.y = last.y;
+#if (TOUCH_FILTER_ENABLED == 1U)
+            touch_filter_reset(&filter);
+#endif
+        }
+#if (TOUCH_FILTER_ENABLED == 1U)
+        else
+        {
+            touch_filter_update(&filter, sample.x, sample.y,
+                                (uint32_t)pdTICKS_TO_MS(sample.timestamp),
+                                &sample.x, &sample.y);
+            sample.x = LV_CLAMP(0, sample.x, (int32_t)ACTUAL_DISP_HOR_RES - 1);
+            sample.y = LV_CLAMP(0, sample.y, (int32_t)ACTUAL_DISP_VER_RES - 1);
+        }
+#endif
+
+        /* A held finger is queued too: event-mode LVGL only sees reads */
+        if (sample.pressed || last.pressed)
+        {
+            touch_queue_push(&sample);
+            last = sample;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: touchpad_read
+********************************************************************************
+* Summary:
+*  Touchpad read function called by the LVGL library (LV_INDEV_MODE_EVENT).
+*  Drains one queued sample per call and asks LVGL to keep reading while
+*  more samples are waiting, so no press/release edge is lost.
+*
+* Parameters:
+*  *indev_drv: Pointer to the input driver structure to be registered by LVGL.
+*  *data: Pointer to the data buffer holding touch coordinates.
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+LV_ATTRIBUTE_FAST_MEM void touchpad_read(lv_indev_t *indev_drv,
+                                         lv_indev_data_t *data)
+{
+    static touch_sample_t current = { 0, 0, false, 0 };
+
+    CY_UNUSED_PARAMETER(indev_drv);
+
+    (void)xQueueReceive(touch_queue, &current, 0);
+
+    data->point.x = current.x;
+    data->point.y = current.y;
+    data->state = current.pressed ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+    data->continue_reading = (uxQueueMessagesWaiting(touch_queue) > 0U);
 }
 
 
@@ -274,15 +633,58 @@ void lv_port_indev_init(void)
     /* Initialize your touchpad if you have. */
     touchpad_init();
 
-    /* Register a touchpad input device */
-    lv_indev_t * indev = lv_indev_create();
-    lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
-    lv_indev_set_read_cb(indev, touchpad_read);
-    lv_timer_pause(indev->read_timer);
-    lv_timer_reset(indev->read_timer);
-    lv_timer_set_period(indev->read_timer, INDEV_READ_PERIOD_MS);
-    lv_timer_resume(indev->read_timer);
+    touch_queue = STATIC_QUEUE_CREATE(touch, "touch", sizeof(touch_sample_t));
+    touch_bus_mutex = STATIC_MUTEX_CREATE(touch_bus, "touch_bus");
+    if ((NULL == touch_queue) || (NULL == touch_bus_mutex))
+    {
+        CY_ASSERT(0);
+    }
+
+    /* Register a touchpad input device. Event mode: no read timer, LVGL
+     * reads only when lv_port_indev_process() finds queued samples. */
+    indev_touchpad = lv_indev_create();
+    lv_indev_set_type(indev_touchpad, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_read_cb(indev_touchpad, touchpad_read);
+    lv_indev_set_mode(indev_touchpad, LV_INDEV_MODE_EVENT);
+
+    touch_task_handle = STATIC_TASK_CREATE(touch, touch_task, "Touch task",
+                                           NULL, TOUCH_TASK_PRIORITY);
+    if (NULL == touch_task_handle)
+    {
+        CY_ASSERT(0);
+    }
 
+#if (TOUCH_IRQ_ENABLED == 1U)
+    /* Take over the controller IRQ so it wakes the reader task */
+    Cy_GPIO_SetInterruptEdge(CTP_IRQ_PORT, CTP_IRQ_PIN, CY_GPIO_INTR_FALLING);
+    Cy_GPIO_SetInterruptMask(CTP_IRQ_PORT, CTP_IRQ_PIN, 1U);
+    Cy_GPIO_ClearInterrupt(CTP_IRQ_PORT, CTP_IRQ_PIN);
+    Cy_SysInt_Init(&touch_irq_cfg, touch_irq_handler);
+    NVIC_EnableIRQ(touch_irq_cfg.intrSrc);
+#endif
+}
+
+
+/*******************************************************************************
+* Function Name: lv_port_indev_process
+********************************************************************************
+* Summary:
+*  Feeds queued touch samples to LVGL. Must be called from the LVGL task
+*  before lv_timer_handler(). Costs one queue check when idle.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void lv_port_indev_process(void)
+{
+    if ((NULL != touch_queue) && (uxQueueMessagesWaiting(touch_queue) > 0U))
+    {
+        lv_indev_read(indev_touchpad);
+    }
 }
 
 
@@ -303,6 +705,13 @@ void lv_port_indev_init(void)
 void lv_port_indev_disable_touch(void)
 {
     touch_disabled = true;
+
+    /* Wait for an in-flight touch read to release the bus */
+    if (NULL != touch_bus_mutex)
+    {
+        xSemaphoreTake(touch_bus_mutex, portMAX_DELAY);
+        xSemaphoreGive(touch_bus_mutex);
+    }
     printf("[TOUCH] Display touch DISABLED (I2C bus released for CAPSENSE)\r\n");
 }
 
@@ -327,4 +736,29 @@ void lv_port_indev_enable_touch(void)
 }
 
 
+/*******************************************************************************
+* Function Name: lv_port_indev_get_recovery_stats
+********************************************************************************
+* Summary:
+*  Returns touch controller recovery metrics (count, duration, failures).
+*  All zero for controllers without background recovery.
+*
+* Parameters:
+*  *stats: Pointer to the structure to fill.
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void lv_port_indev_get_recovery_stats(lv_port_indev_recovery_stats_t *stats)
+{
+    if (NULL != stats)
+    {
+        taskENTER_CRITICAL();
+        *stats = touch_recovery_stats;
+        taskEXIT_CRITICAL();
+    }
+}
+
+
 /* [] END OF FILE */
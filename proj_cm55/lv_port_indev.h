@@ -52,6 +52,21 @@ extern "C" {
 #include "cy_scb_i2c.h"
 
 
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Touch controller background recovery metrics */
+typedef struct
+{
+    uint32_t recovery_count;        /* Successful recoveries */
+    uint32_t failed_attempts;       /* Re-init attempts that failed */
+    uint32_t last_duration_ms;      /* Error threshold hit -> controller back */
+    uint32_t max_duration_ms;
+    uint32_t total_duration_ms;
+    uint32_t last_recovery_ms;      /* Uptime of the last recovery */
+} lv_port_indev_recovery_stats_t;
+
+
 /*******************************************************************************
 * Variables
 *******************************************************************************/
@@ -63,10 +78,16 @@ extern cy_stc_scb_i2c_context_t disp_touch_i2c_controller_context;
 *******************************************************************************/
 void lv_port_indev_init(void);
 
+/* Feed queued touch samples to LVGL (call from the LVGL task) */
+void lv_port_indev_process(void);
+
 /* Touch disable/enable for I2C bus sharing with CAPSENSE */
 void lv_port_indev_disable_touch(void);
 void lv_port_indev_enable_touch(void);
 
+/* Touch controller recovery metrics */
+void lv_port_indev_get_recovery_stats(lv_port_indev_recovery_stats_t *stats);
+
 
 #ifdef __cplusplus
 } /* extern "C" */
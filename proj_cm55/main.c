@@ -63,6 +63,12 @@
 #include "lv_port_indev.h"
 #include "demos/lv_demos.h"
 #include "display_i2c_config.h"
+#include "boot_profile.h"
+#include "mem_stats.h"
+#include "cpu_load.h"
+#include "static_mem.h"
+#include "periodic.h"
+#include "uart_buf.h"
 
 /*******************************************************************************
  * Course Example Selector
@@ -93,6 +99,10 @@
 
 #define GFX_TASK_PRIORITY                   (configMAX_PRIORITIES - 1)
 
+/* One pass of the LVGL loop (input + timers + render + vsync) should fit in
+ * two refresh periods; longer passes are counted as deadline misses. */
+#define GFX_LOOP_DEADLINE_MS                (2U * LV_DEF_REFR_PERIOD)
+
 #define APP_BUFFER_COUNT                    (2U)
 /* 64 KB */
 #define DEFAULT_GPU_CMD_BUFFER_SIZE         ((64U) * (1024U))
@@ -105,6 +115,10 @@
                                              ((GPU_TESSELLATION_BUFFER_SIZE) * \
                                               (APP_BUFFER_COUNT)))
 
+/* Display panel power-up time after the I2C/DSI interface is up. LVGL init
+ * and the UI build run inside this window instead of sleeping through it. */
+#define PANEL_POWER_UP_MS                   (500U)
+
 #define GPU_MEM_BASE                        (0x0U)
 #define I2C_CONTROLLER_IRQ_PRIORITY         (2UL)
 #define VG_PARAMS_POS                       (0UL)
@@ -135,6 +149,9 @@ volatile void *vglite_heap_base = &contiguous_mem;
 
 TaskHandle_t rtos_cm55_gfx_task_handle = NULL;
 
+/* Graphics task stack and TCB (static, no heap) */
+STATIC_TASK_DEFINE(gfx, GFX_TASK_STACK_SIZE);
+
 /* DC IRQ Config */
 cy_stc_sysint_t dc_irq_cfg =
 {
@@ -430,6 +447,74 @@ static void disp_touch_i2c_controller_interrupt(void)
 }
 
 
+/*******************************************************************************
+* Function Name: panel_wait_ready
+********************************************************************************
+* Summary:
+*  Waits until the display panel power-up time has elapsed since
+*  power_tick. Only the remaining time is slept, so work done since then
+*  (vglite/LVGL init, UI build) overlaps with the panel power-up.
+*
+* Parameters:
+*  TickType_t power_tick: Tick at which the panel interface was brought up
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void panel_wait_ready(TickType_t power_tick)
+{
+    TickType_t elapsed = xTaskGetTickCount() - power_tick;
+
+    if (elapsed < pdMS_TO_TICKS(PANEL_POWER_UP_MS))
+    {
+        vTaskDelay(pdMS_TO_TICKS(PANEL_POWER_UP_MS) - elapsed);
+    }
+}
+
+
+#if IPC_ENABLED
+/*******************************************************************************
+* Function Name: diag_mem_request
+********************************************************************************
+* Summary:
+*  Memory panel request callback of the diagnostics screen: asks CM33 for
+*  its memory report, shown on the panel's next refresh.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void diag_mem_request(void)
+{
+    (void)cm55_ipc_send_cmd(IPC_CMD_MEM_REQ, IPC_MEM_POLL);
+}
+
+
+/*******************************************************************************
+* Function Name: diag_cpu_request
+********************************************************************************
+* Summary:
+*  CPU overlay request callback of the diagnostics screen: asks CM33 for
+*  its load report, shown on the overlay's next refresh.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void diag_cpu_request(void)
+{
+    (void)cm55_ipc_send_cmd(IPC_CMD_CPU_REQ, 0U);
+}
+#endif
+
+
 /*******************************************************************************
 * Function Name: cm55_gfx_task
 ********************************************************************************
@@ -440,11 +525,11 @@ static void disp_touch_i2c_controller_interrupt(void)
 *       - Configure the DC, GPU interrupts.
 *       - Initialize I2C interface to be used for touch as well as 7, 4.3-inch 
 *         display drivers.
-*       - Initializes the display panel selected through Makefile component and
-*         vglite driver.
-*       - Allocates vglite memory.
-*       - Configures LVGL, low level display and touch driver.
-*       - Finally invokes the UI application.
+*       - Allocates vglite memory and initializes the vglite driver.
+*       - Configures LVGL and the low level display driver, then builds the
+*         UI application while the display panel powers up.
+*       - Initializes the display panel selected through Makefile component
+*         once its power-up time has elapsed, then the touch driver.
 *
 * Parameters:
 *  void *arg: Pointer to the argument passed to the task (not used)
@@ -458,6 +543,8 @@ static void cm55_gfx_task(void *arg)
     CY_UNUSED_PARAMETER(arg);
 
     uint32_t time_till_next = 0;
+    bool first_frame_done = false;
+    static periodic_task_t gfx_timing;
 
     cy_en_sysint_status_t sysint_status = CY_SYSINT_SUCCESS;
     cy_en_gfx_status_t gfx_status = CY_GFX_SUCCESS;
@@ -548,68 +635,12 @@ static void cm55_gfx_task(void *arg)
 
         /* Enable the I2C */
         Cy_SCB_I2C_Enable(DISPLAY_I2C_CONTROLLER_HW);
+        boot_profile_mark("gfx_i2c_init");
 
-        vTaskDelay(pdMS_TO_TICKS(500));
-
-#if defined(MTB_DISPLAY_WS7P0DSI_RPI)
-        /* Initialize the RPI display */
-        status = mtb_disp_ws7p0dsi_panel_init(DISPLAY_I2C_CONTROLLER_HW,
-                                              &disp_touch_i2c_controller_context);
-
-        if (CY_RSLT_SUCCESS != status)
-        {
-            printf("Waveshare 7-Inch R-Pi display init failed with status = %u\r\n", (unsigned int) status);
-            CY_ASSERT(0);
-        }
-
-#elif defined(MTB_DISPLAY_EK79007AD3)
-        /* Initialize the WF101JTYAHMNB0 display driver. */
-        mipi_status = mtb_display_ek79007ad3_init(GFXSS_GFXSS_MIPIDSI,
-                                                  &ek79007ad3_pin_cfg);
-
-        if (CY_MIPIDSI_SUCCESS != mipi_status)
-        {
-            printf("WF101JTYAHMNB0 10-inch display init failed with status = %d\r\n", mipi_status);
-            CY_ASSERT(0);
-        }
-
-#elif defined(MTB_DISPLAY_W4P3INCH_RPI)
-
-        i2c_result = Cy_SCB_I2C_Init(DISPLAY_I2C_CONTROLLER_HW,
-                                     &DISPLAY_I2C_CONTROLLER_config,
-                                     &disp_touch_i2c_controller_context);
-
-        if (CY_SCB_I2C_SUCCESS != i2c_result)
-        {
-            printf("I2C controller initialization failed !!\n");
-            CY_ASSERT(0);
-        }
-
-        /* Initialize the I2C interrupt */
-        sysint_status = Cy_SysInt_Init(&disp_touch_i2c_controller_irq_cfg,
-                                       &disp_touch_i2c_controller_interrupt);
+        /* Panel power-up window starts here. Everything below up to
+         * panel_wait_ready() does not touch the panel. */
+        TickType_t panel_power_tick = xTaskGetTickCount();
 
-        if (CY_SYSINT_SUCCESS != sysint_status)
-        {
-            printf("I2C controller interrupt initialization failed\r\n");
-            CY_ASSERT(0);
-        }
-
-        /* Enable the I2C interrupts. */
-        NVIC_EnableIRQ(disp_touch_i2c_controller_irq_cfg.intrSrc);
-
-        /* Enable the I2C */
-        Cy_SCB_I2C_Enable(DISPLAY_I2C_CONTROLLER_HW);
-
-         /* Initialize the Waveshare 4.3-Inch display */
-        i2c_result = mtb_disp_waveshare_4p3_init(DISPLAY_I2C_CONTROLLER_HW,
-                                             &disp_touch_i2c_controller_context);
-        if (CY_SCB_I2C_SUCCESS != i2c_result)
-        {
-            printf("Waveshare 4.3-Inch display init failed with status = %u\r\n", (unsigned int) i2c_result);
-            CY_ASSERT(0);
-        }
-#endif
         /* Allocate memory for VGLite from the vglite_heap_base */
         vg_module_parameters_t vg_params;
         vg_params.register_mem_base = (uint32_t)GFXSS_GFXSS_GPU_GCNANO;
@@ -617,6 +648,17 @@ static void cm55_gfx_task(void *arg)
         vg_params.contiguous_mem_base[VG_PARAMS_POS] = vglite_heap_base;
         vg_params.contiguous_mem_size[VG_PARAMS_POS] = VGLITE_HEAP_SIZE;
 
+        /* Account VG-Lite command and tessellation buffers (painted for
+         * high-water marks) and the frame buffers before first use */
+        mem_stats_region_add("vg_cmd", contiguous_mem,
+                             DEFAULT_GPU_CMD_BUFFER_SIZE, APP_BUFFER_COUNT, true);
+        mem_stats_region_add("vg_tess",
+                             &contiguous_mem[DEFAULT_GPU_CMD_BUFFER_SIZE * APP_BUFFER_COUNT],
+                             GPU_TESSELLATION_BUFFER_SIZE, APP_BUFFER_COUNT, true);
+        mem_stats_region_add("framebuf", frame_buffer1,
+                             MY_DISP_HOR_RES * MY_DISP_VER_RES * (LV_COLOR_DEPTH / 8),
+                             2U, false);
+
         /* Initialize VGlite memory. */
         vg_lite_init_mem(&vg_params);
 
@@ -628,18 +670,95 @@ static void cm55_gfx_task(void *arg)
 
         if (VG_LITE_SUCCESS == vglite_status)
         {
+            boot_profile_mark("vglite_init");
+
             /* Initialize LVGL library */
             lv_init();
             lv_port_disp_init();
-            lv_port_indev_init();
+            boot_profile_mark("lvgl_init");
 
             /* Print which example is running */
             print_example_info();
 
-            /* Run the selected example
+#if IPC_ENABLED
+            /* Diagnostics screen (swipe up) shows CM33 memory and load too */
+            aic_diag_set_mem_request(diag_mem_request);
+            aic_diag_set_cpu_request(diag_cpu_request);
+#endif
+
+            /* Run the selected example on its managed screen
              * Change SELECTED_PART and SELECTED_EXAMPLE in example_selector.h
              */
-            run_selected_example();
+            start_selected_example();
+            boot_profile_mark("ui_build");
+
+            /* Panel must have powered up before it is initialized */
+            panel_wait_ready(panel_power_tick);
+            boot_profile_mark("panel_ready");
+
+#if defined(MTB_DISPLAY_WS7P0DSI_RPI)
+            /* Initialize the RPI display */
+            status = mtb_disp_ws7p0dsi_panel_init(DISPLAY_I2C_CONTROLLER_HW,
+                                                  &disp_touch_i2c_controller_context);
+
+            if (CY_RSLT_SUCCESS != status)
+            {
+                printf("Waveshare 7-Inch R-Pi display init failed with status = %u\r\n", (unsigned int) status);
+                CY_ASSERT(0);
+            }
+
+#elif defined(MTB_DISPLAY_EK79007AD3)
+            /* Initialize the WF101JTYAHMNB0 display driver. */
+            mipi_status = mtb_display_ek79007ad3_init(GFXSS_GFXSS_MIPIDSI,
+                                                      &ek79007ad3_pin_cfg);
+
+            if (CY_MIPIDSI_SUCCESS != mipi_status)
+            {
+                printf("WF101JTYAHMNB0 10-inch display init failed with status = %d\r\n", mipi_status);
+                CY_ASSERT(0);
+            }
+
+#elif defined(MTB_DISPLAY_W4P3INCH_RPI)
+
+            i2c_result = Cy_SCB_I2C_Init(DISPLAY_I2C_CONTROLLER_HW,
+                                         &DISPLAY_I2C_CONTROLLER_config,
+                                         &disp_touch_i2c_controller_context);
+
+            if (CY_SCB_I2C_SUCCESS != i2c_result)
+            {
+                printf("I2C controller initialization failed !!\n");
+                CY_ASSERT(0);
+            }
+
+            /* Initialize the I2C interrupt */
+            sysint_status = Cy_SysInt_Init(&disp_touch_i2c_controller_irq_cfg,
+                                           &disp_touch_i2c_controller_interrupt);
+
+            if (CY_SYSINT_SUCCESS != sysint_status)
+            {
+                printf("I2C controller interrupt initialization failed\r\n");
+                CY_ASSERT(0);
+            }
+
+            /* Enable the I2C interrupts. */
+            NVIC_EnableIRQ(disp_touch_i2c_controller_irq_cfg.intrSrc);
+
+            /* Enable the I2C */
+            Cy_SCB_I2C_Enable(DISPLAY_I2C_CONTROLLER_HW);
+
+             /* Initialize the Waveshare 4.3-Inch display */
+            i2c_result = mtb_disp_waveshare_4p3_init(DISPLAY_I2C_CONTROLLER_HW,
+                                                 &disp_touch_i2c_controller_context);
+            if (CY_SCB_I2C_SUCCESS != i2c_result)
+            {
+                printf("Waveshare 4.3-Inch display init failed with status = %u\r\n", (unsigned int) i2c_result);
+                CY_ASSERT(0);
+            }
+#endif
+            boot_profile_mark("panel_init");
+
+            lv_port_indev_init();
+            boot_profile_mark("indev_init");
         }
         else
         {
@@ -656,13 +775,46 @@ static void cm55_gfx_task(void *arg)
         handle_app_error();
     }
 
+    /* The loop is event driven, so only execution time is tracked */
+    periodic_init(&gfx_timing, "LVGL", 0U, GFX_LOOP_DEADLINE_MS);
+
     for (;;)
     {
+        periodic_begin(&gfx_timing);
+
+        /* Feed touch samples queued by the touch reader task (event mode) */
+        lv_port_indev_process();
+
         /* LVGL's timer handler function, to be called periodically to handle
          * LVGL tasks.
          */
         time_till_next = lv_timer_handler();
-        vTaskDelay(pdMS_TO_TICKS(time_till_next));
+
+        periodic_end(&gfx_timing);
+
+        if (!first_frame_done)
+        {
+            /* First lv_timer_handler() renders and flushes (waits for vsync) */
+            first_frame_done = true;
+            boot_profile_mark("first_frame");
+            boot_profile_report("CM55");
+            static_mem_seal();
+            mem_stats_print("CM55");
+#if IPC_ENABLED
+            /* CM33's figures follow, printed when its reply arrives */
+            (void)cm55_ipc_send_cmd(IPC_CMD_MEM_REQ, IPC_MEM_PRINT);
+#endif
+            static_mem_print("CM55");
+            periodic_print_previous("CM55");
+
+            /* Boot reports are out; from here log bursts are dropped
+             * rather than stalling the LVGL loop */
+            uart_buf_set_policy(UART_BUF_DROP);
+        }
+
+        /* Sleep until the next LVGL timer is due, or earlier when touch,
+         * IPC or the event bus changes UI state (lv_port_disp_wake()) */
+        (void)lv_port_disp_wait(time_till_next);
     }
 }
 
@@ -712,6 +864,8 @@ int main(void)
     cy_rslt_t result       = CY_RSLT_SUCCESS;
     BaseType_t task_return = pdFAIL;
 
+    boot_profile_start();
+
     /* Initialize the device and board peripherals */
     result = cybsp_init();
 
@@ -736,15 +890,17 @@ int main(void)
     /* Initialize IPC communication with CM33-NS */
     if (CY_IPC_PIPE_SUCCESS == cm55_ipc_init())
     {
-        /* Create IPC receive task */
+        /* Process received messages on the shared work executor */
         cm55_ipc_create_task();
     }
+    boot_profile_mark("ipc_init");
 #endif
 
     /* Create the FreeRTOS Task */
-    task_return = xTaskCreate(cm55_gfx_task, GFX_TASK_NAME,
-                              GFX_TASK_STACK_SIZE, NULL,
-                              GFX_TASK_PRIORITY, &rtos_cm55_gfx_task_handle);
+    rtos_cm55_gfx_task_handle = STATIC_TASK_CREATE(gfx, cm55_gfx_task,
+                                                   GFX_TASK_NAME, NULL,
+                                                   GFX_TASK_PRIORITY);
+    task_return = (NULL != rtos_cm55_gfx_task_handle) ? pdPASS : pdFAIL;
 
     /* ANSI ESC sequence for clear screen */
     printf("\x1b[2J\x1b[;H");
@@ -760,7 +916,11 @@ int main(void)
         printf("IPC Communication: ENABLED\r\n\n");
 #endif
 
+        /* Per-task CPU load sampling */
+        cpu_load_init();
+
         /* Start the RTOS Scheduler */
+        boot_profile_mark("scheduler");
         vTaskStartScheduler();
 
         /* Should never get here! */
@@ -133,6 +133,7 @@
 #include "../aic-eec/aic-eec.h"
 #include "../aic-eec/gpio.h"
 #include "../aic-eec/sensors.h"
+#include "../aic-eec/aic_bind.h"
 #include "../lv_port_indev.h"    /* For touch disable/enable (I2C bus sharing) */
 #include <stdio.h>
 
@@ -430,33 +431,39 @@ static lv_obj_t * ex8_bar;
 static lv_obj_t * ex8_raw_label;
 static lv_obj_t * ex8_volt_label;
 static lv_obj_t * ex8_pct_label;
-static lv_timer_t * ex8_timer;
+static aic_bind_source_t ex8_adc_src;
 
 #define ADC_MAX 4095
 #define ADC_VREF_MV 3300
+#define EX8_ADC_DEADBAND 8      /* ~6 mV: ignore ADC noise */
+#define EX8_ADC_MIN_MS   100    /* Same rate as the old 100 ms timer */
 
-static void ex8_timer_cb(lv_timer_t * timer)
+static int32_t ex8_adc_read_cb(void * user_data)
 {
-    (void)timer;
-
-    /* Read REAL ADC value */
-    uint16_t adc_value = aic_adc_read(AIC_ADC_CH0);
+    (void)user_data;
+    return (int32_t)aic_adc_read(AIC_ADC_CH0);
+}
 
-    /* Update slider */
-    lv_slider_set_value(ex8_slider, adc_value, LV_ANIM_ON);
+/* Percent + voltage are derived from the raw subject - runs only on change */
+static void ex8_adc_observer_cb(lv_observer_t * observer, lv_subject_t * subject)
+{
+    (void)observer;
+    int32_t adc_value = lv_subject_get_int(subject);
 
-    /* Update bar */
     int32_t pct = (adc_value * 100) / ADC_MAX;
-    lv_bar_set_value(ex8_bar, pct, LV_ANIM_ON);
-
-    /* Update labels */
-    lv_label_set_text_fmt(ex8_raw_label, "Raw: %d", (int)adc_value);
     lv_label_set_text_fmt(ex8_pct_label, "%d%%", (int)pct);
 
     float voltage = ((float)adc_value / ADC_MAX) * (ADC_VREF_MV / 1000.0f);
     lv_label_set_text_fmt(ex8_volt_label, "Voltage: %.3f V", (double)voltage);
 }
 
+/* Screen deleted: release the source so a rebuild starts clean */
+static void ex8_screen_delete_cb(lv_event_t * e)
+{
+    (void)e;
+    aic_bind_source_deinit(&ex8_adc_src);
+}
+
 void part1_ex8_hw_adc_display(void)
 {
     /* ===== HARDWARE INITIALIZATION ===== */
@@ -507,8 +514,8 @@ void part1_ex8_hw_adc_display(void)
     ex8_bar = lv_bar_create(scr);
     lv_obj_set_size(ex8_bar, 200, 18);
     lv_obj_align(ex8_bar, LV_ALIGN_CENTER, -55, 25);
-    lv_bar_set_range(ex8_bar, 0, 100);
-    lv_bar_set_value(ex8_bar, 50, LV_ANIM_OFF);
+    lv_bar_set_range(ex8_bar, 0, ADC_MAX);     /* Bound to raw subject */
+    lv_bar_set_value(ex8_bar, 2048, LV_ANIM_OFF);
     /* Cyan bar style */
     lv_obj_set_style_bg_color(ex8_bar, lv_color_hex(0x003344), LV_PART_MAIN);
     lv_obj_set_style_bg_color(ex8_bar, lv_color_hex(0x00FFFF), LV_PART_INDICATOR);
@@ -536,8 +543,15 @@ void part1_ex8_hw_adc_display(void)
     /* Footer */
     aic_create_footer(scr);
 
-    /* Timer for auto-update with REAL ADC data */
-    ex8_timer = lv_timer_create(ex8_timer_cb, 100, NULL);
+    /* Bind widgets to the REAL ADC source (redraw only on change) */
+    aic_bind_source_init(&ex8_adc_src, ex8_adc_read_cb, NULL, 2048,
+                         EX8_ADC_DEADBAND, EX8_ADC_MIN_MS);
+    lv_slider_bind_value(ex8_slider, &ex8_adc_src.subject);
+    aic_bind_bar_value(ex8_bar, &ex8_adc_src.subject, LV_ANIM_ON);
+    lv_label_bind_text(ex8_raw_label, &ex8_adc_src.subject, "Raw: %" LV_PRId32);
+    lv_subject_add_observer_obj(&ex8_adc_src.subject, ex8_adc_observer_cb,
+                                ex8_volt_label, NULL);
+    lv_obj_add_event_cb(scr, ex8_screen_delete_cb, LV_EVENT_DELETE, NULL);
 
     printf("[Week3] Ex8: Hardware ADC Display started\r\n");
 }
@@ -568,7 +582,8 @@ typedef struct {
 
 static ex9_gpio_item_t ex9_gpios[EX9_NUM_TOGGLE_LEDS];
 static lv_obj_t * ex9_blue_led;  /* Blue LED controlled by POT */
-static lv_timer_t * ex9_timer;
+static aic_bind_source_t ex9_button_src;
+static aic_bind_source_t ex9_adc_src;
 
 /* Button/ADC UI elements */
 static lv_obj_t * ex9_btn_status_led;
@@ -630,46 +645,46 @@ static void ex9_all_off_cb(lv_event_t * e)
     printf("[HW] All LEDs: OFF\r\n");
 }
 
-/* Timer to update button, ADC, and Blue LED */
-static void ex9_timer_cb(lv_timer_t * timer)
+/* Bound sources: button and POT are only redrawn when they change */
+static int32_t ex9_button_read_cb(void * user_data)
 {
-    (void)timer;
-
-    /* Read REAL button state - USER BTN 2 (SW4) */
-    bool pressed = aic_gpio_button_read(AIC_BTN_USER2);
-    if(ex9_btn_status_led != NULL) {
-        if(pressed) {
-            lv_led_on(ex9_btn_status_led);
-            lv_label_set_text(ex9_btn_status_label, "PRESSED");
-            lv_obj_set_style_text_color(ex9_btn_status_label, lv_color_hex(0x00FF00), 0);
-        } else {
-            lv_led_off(ex9_btn_status_led);
-            lv_label_set_text(ex9_btn_status_label, "Released");
-            lv_obj_set_style_text_color(ex9_btn_status_label, lv_color_hex(0xFF6666), 0);
-        }
-    }
+    (void)user_data;
+    return aic_gpio_button_read(AIC_BTN_USER2) ? 1 : 0;
+}
 
-    /* Read REAL ADC value and control Blue LED */
-    uint8_t percent = aic_adc_read_percent(AIC_ADC_CH0);
+static int32_t ex9_adc_read_cb(void * user_data)
+{
+    (void)user_data;
+    return (int32_t)aic_adc_read_percent(AIC_ADC_CH0);
+}
 
-    /* Update ADC display */
-    if(ex9_adc_label != NULL) {
-        lv_label_set_text_fmt(ex9_adc_label, "%u%%", percent);
-    }
-    if(ex9_adc_bar != NULL) {
-        lv_bar_set_value(ex9_adc_bar, percent, LV_ANIM_ON);
+static void ex9_button_observer_cb(lv_observer_t * observer, lv_subject_t * subject)
+{
+    (void)observer;
+    if(lv_subject_get_int(subject)) {
+        lv_led_on(ex9_btn_status_led);
+        lv_label_set_text(ex9_btn_status_label, "PRESSED");
+        lv_obj_set_style_text_color(ex9_btn_status_label, lv_color_hex(0x00FF00), 0);
+    } else {
+        lv_led_off(ex9_btn_status_led);
+        lv_label_set_text(ex9_btn_status_label, "Released");
+        lv_obj_set_style_text_color(ex9_btn_status_label, lv_color_hex(0xFF6666), 0);
     }
+}
 
-    /* Update Blue LED widget brightness from POT (dimming effect 0-255) */
-    if(ex9_blue_led != NULL) {
-        /* Map 0-100% to LED brightness 0-255 */
-        uint8_t brightness = (uint8_t)((percent * 255) / 100);
-        /* Always turn ON first, then set brightness for proper dimming */
-        lv_led_on(ex9_blue_led);
-        lv_led_set_brightness(ex9_blue_led, brightness);
-    }
-    /* Update REAL Blue LED via PWM */
-    aic_gpio_pwm_set_brightness(AIC_LED_BLUE, percent);
+/* Update REAL Blue LED via PWM when the POT percentage changes */
+static void ex9_pwm_observer_cb(lv_observer_t * observer, lv_subject_t * subject)
+{
+    (void)observer;
+    aic_gpio_pwm_set_brightness(AIC_LED_BLUE, (uint8_t)lv_subject_get_int(subject));
+}
+
+/* Screen deleted: release the sources so a rebuild starts clean */
+static void ex9_screen_delete_cb(lv_event_t * e)
+{
+    (void)e;
+    aic_bind_source_deinit(&ex9_button_src);
+    aic_bind_source_deinit(&ex9_adc_src);
 }
 
 void part1_ex9_hw_gpio_dashboard(void)
@@ -827,8 +842,16 @@ void part1_ex9_hw_gpio_dashboard(void)
     /* Footer */
     aic_create_footer(scr);
 
-    /* Timer to update button, ADC, and Blue LED */
-    ex9_timer = lv_timer_create(ex9_timer_cb, 100, NULL);
+    /* Bind button, ADC, and Blue LED to their sources */
+    aic_bind_source_init(&ex9_button_src, ex9_button_read_cb, NULL, 0, 0, 0);
+    aic_bind_source_init(&ex9_adc_src, ex9_adc_read_cb, NULL, 0, 0, 100);
+    lv_subject_add_observer_obj(&ex9_button_src.subject, ex9_button_observer_cb,
+                                ex9_btn_status_label, NULL);
+    lv_label_bind_text(ex9_adc_label, &ex9_adc_src.subject, "%" LV_PRId32 "%%");
+    aic_bind_bar_value(ex9_adc_bar, &ex9_adc_src.subject, LV_ANIM_ON);
+    aic_bind_led_percent(ex9_blue_led, &ex9_adc_src.subject);
+    lv_subject_add_observer(&ex9_adc_src.subject, ex9_pwm_observer_cb, NULL);
+    lv_obj_add_event_cb(scr, ex9_screen_delete_cb, LV_EVENT_DELETE, NULL);
 
     printf("[Week3] Ex9: Hardware GPIO Dashboard started\r\n");
     printf("  - Red/Green: Toggle ON/OFF\r\n");
@@ -40,6 +40,7 @@
 * Header Files
 *******************************************************************************/
 #include "retarget_io_init.h"
+#include "uart_buf.h"
 
 
 /*******************************************************************************
@@ -142,6 +143,12 @@ void init_retarget_io(void)
         handle_app_error();
     }
 
+    /* Buffer printf output once the scheduler runs (non-blocking writers) */
+    if (!uart_buf_init(CYBSP_DEBUG_UART_HW))
+    {
+        handle_app_error();
+    }
+
 #if (CY_CFG_PWR_SYS_IDLE_MODE == CY_CFG_PWR_MODE_DEEPSLEEP)
     /* UART SysPm callback registration for retarget-io */
     Cy_SysPm_RegisterCallback(&retarget_io_syspm_cb);
@@ -97,6 +97,27 @@ typedef struct __attribute__((packed)) {
     uint8_t     reserved;                    /* Padding */
 } ipc_bt_connect_t;
 
+/*******************************************************************************
+ * BLE Scan Filter Structure (IPC_CMD_BT_SCAN_FILTER data)
+ *
+ * Applies from the next scan; devices failing any enabled rule are not
+ * listed. All zero (with min_rssi = BT_SCAN_FILTER_RSSI_ANY) lists all.
+ ******************************************************************************/
+
+#define BT_SCAN_FILTER_UUID         (0x01U) /* Advertises service uuid */
+#define BT_SCAN_FILTER_COMPANY      (0x02U) /* Manufacturer data from company_id */
+#define BT_SCAN_FILTER_NAMED        (0x04U) /* Has a local name */
+#define BT_SCAN_FILTER_RSSI_ANY     (-128)
+
+typedef struct __attribute__((packed)) {
+    int8_t      min_rssi;                    /* Weaker advertisements are ignored */
+    uint8_t     match;                       /* BT_SCAN_FILTER_* rules enabled */
+    uint16_t    company_id;                  /* Bluetooth SIG company identifier */
+    uint8_t     uuid_len;                    /* 2, 4 or 16 */
+    uint8_t     reserved[3];                 /* Padding */
+    uint8_t     uuid[BT_UUID_MAX_LEN];       /* Service UUID, little endian */
+} ipc_bt_scan_filter_t;
+
 /*******************************************************************************
  * BLE Hardware Info Structure
  ******************************************************************************/
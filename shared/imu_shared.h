@@ -53,25 +53,28 @@
 /*******************************************************************************
  * IMU Shared Data Structure
  *
- * Layout (64 bytes):
+ * Layout (80 bytes):
  *   Offset 0:  magic (4 bytes) - Must be IMU_SHARED_MAGIC
  *   Offset 4:  version (4 bytes)
  *   Offset 8:  valid (4 bytes) - Set true when data is valid
  *   Offset 12: update_count (4 bytes) - Incremented on each update
- *   Offset 16: accel_x (4 bytes, float, m/s^2)
- *   Offset 20: accel_y (4 bytes, float, m/s^2)
- *   Offset 24: accel_z (4 bytes, float, m/s^2)
- *   Offset 28: gyro_x (4 bytes, float, rad/s)
- *   Offset 32: gyro_y (4 bytes, float, rad/s)
- *   Offset 36: gyro_z (4 bytes, float, rad/s)
- *   Offset 40-63: reserved
+ *   Offset 16: write_lock (4 bytes) - Odd while CM33 writes
+ *   Offset 20: accel_x (4 bytes, float, m/s^2)
+ *   Offset 24: accel_y (4 bytes, float, m/s^2)
+ *   Offset 28: accel_z (4 bytes, float, m/s^2)
+ *   Offset 32: gyro_x (4 bytes, float, rad/s)
+ *   Offset 36: gyro_y (4 bytes, float, rad/s)
+ *   Offset 40: gyro_z (4 bytes, float, rad/s)
+ *   Offset 44-55: raw data (6 x int16)
+ *   Offset 56-67: read time, error and WDT counters
+ *   Offset 68-79: latency trace stamps (version 2, see lat_trace.h)
  *
  ******************************************************************************/
 
 typedef struct __attribute__((packed, aligned(4))) {
     /* Header - verification and versioning */
     uint32_t magic;             /* Must be IMU_SHARED_MAGIC */
-    uint32_t version;           /* Structure version (currently 1) */
+    uint32_t version;           /* Structure version (currently 2) */
     uint32_t valid;             /* 1 = data valid, 0 = not yet written */
     uint32_t update_count;      /* Incremented each time CM33 updates */
     uint32_t write_lock;        /* Odd = writing, Even = done (for sync) */
@@ -99,6 +102,11 @@ typedef struct __attribute__((packed, aligned(4))) {
     uint32_t error_count;       /* I2C/sensor error counter */
     uint32_t wdt_reset_count;   /* Watchdog reset counter (incremented on WDT reset) */
 
+    /* Latency trace (CM33 microsecond clock, see lat_trace.h) */
+    uint32_t trace_id;          /* update_count the stamps belong to */
+    uint32_t trace_read_us;     /* I2C read complete */
+    uint32_t trace_publish_us;  /* Published to shared memory */
+
 } imu_shared_t;
 
 /*******************************************************************************
@@ -133,7 +141,7 @@ static inline void imu_shared_init_ex(bool preserve_wdt_count)
     uint32_t saved_wdt_count = imu->wdt_reset_count;
 
     imu->magic = IMU_SHARED_MAGIC;
-    imu->version = 1;
+    imu->version = 2;
     imu->valid = 0;
     imu->update_count = 0;
     imu->write_lock = 0;  /* Even = not writing */
@@ -151,6 +159,9 @@ static inline void imu_shared_init_ex(bool preserve_wdt_count)
     imu->gyro_raw_z = 0;
     imu->last_read_time_ms = 0;
     imu->error_count = 0;
+    imu->trace_id = 0;
+    imu->trace_read_us = 0;
+    imu->trace_publish_us = 0;
 
     /* Preserve or reset WDT counter */
     if (preserve_wdt_count && saved_wdt_count < 1000) {
@@ -217,6 +228,25 @@ static inline void imu_shared_update(float ax, float ay, float az,
     imu->write_lock++;
 }
 
+/**
+ * @brief Stamp the next update for the latency tracer (called by CM33)
+ *
+ * Call right before imu_shared_update(); the stamps belong to the update
+ * that follows (trace_id = update_count + 1).
+ *
+ * @param read_us    I2C read complete (lat_trace_now_us())
+ * @param publish_us Now (lat_trace_now_us())
+ */
+static inline void imu_shared_set_trace(uint32_t read_us, uint32_t publish_us)
+{
+    volatile imu_shared_t *imu = IMU_SHARED_PTR;
+
+    imu->trace_read_us = read_us;
+    imu->trace_publish_us = publish_us;
+    __DSB();
+    imu->trace_id = imu->update_count + 1U;
+}
+
 /**
  * @brief Update IMU raw data (called by CM33 for debugging)
  */
@@ -349,6 +379,46 @@ static inline bool imu_shared_read_gyro(float *gx, float *gy, float *gz)
     return true;
 }
 
+/**
+ * @brief Read the latency trace stamps of the current update (called by CM55)
+ * @param id         Out: update_count of the sample
+ * @param read_us    Out: CM33 I2C read complete
+ * @param publish_us Out: CM33 publish
+ * @return false if the current update carries no stamps or CM33 is writing
+ */
+static inline bool imu_shared_read_trace(uint32_t *id, uint32_t *read_us,
+                                         uint32_t *publish_us)
+{
+    volatile imu_shared_t *imu = IMU_SHARED_PTR;
+
+    __DSB();
+    if (imu->magic != IMU_SHARED_MAGIC || imu->version < 2U) {
+        return false;
+    }
+
+    uint32_t lock1 = imu->write_lock;
+    __DSB();
+    if (lock1 & 1) {
+        return false;
+    }
+
+    uint32_t count = imu->update_count;
+    uint32_t tmp_id = imu->trace_id;
+    uint32_t tmp_read = imu->trace_read_us;
+    uint32_t tmp_publish = imu->trace_publish_us;
+
+    __DSB();
+    if (imu->write_lock != lock1 || tmp_id != count || tmp_id != imu->trace_id) {
+        return false;
+    }
+
+    if (id) *id = tmp_id;
+    if (read_us) *read_us = tmp_read;
+    if (publish_us) *publish_us = tmp_publish;
+
+    return true;
+}
+
 /**
  * @brief Read all IMU data from shared memory (called by CM55)
  * @param ax, ay, az Pointers to store acceleration
@@ -0,0 +1,55 @@
+/*******************************************************************************
+ * File: boot_profile.h
+ * Description: Boot-phase timestamp recorder (CM33 and CM55)
+ *
+ * Records named boot phases with microsecond timestamps taken from the
+ * DWT cycle counter, so it works before the FreeRTOS scheduler starts.
+ * Each core keeps its own table; times are relative to boot_profile_start().
+ *
+ * Usage:
+ *   boot_profile_start();              // first thing in main()
+ *   boot_profile_mark("ipc_init");     // after each phase
+ *   boot_profile_report("CM55");       // e.g. after the first frame
+ ******************************************************************************/
+
+#ifndef BOOT_PROFILE_H
+#define BOOT_PROFILE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ * Configuration
+ ******************************************************************************/
+
+#define BOOT_PROFILE_MAX_MARKS          (16U)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+
+typedef struct {
+    const char *phase;      /* Static string - phase that just completed */
+    uint32_t    time_us;    /* Microseconds since boot_profile_start() */
+} boot_profile_mark_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/** Enable the cycle counter and set time zero */
+void boot_profile_start(void);
+
+/** Record the end of a boot phase (safe from any task, before/after scheduler) */
+void boot_profile_mark(const char *phase);
+
+/** Microseconds since boot_profile_start() */
+uint32_t boot_profile_elapsed_us(void);
+
+/** Get recorded marks; returns number of marks */
+uint32_t boot_profile_get(const boot_profile_mark_t **marks);
+
+/** Print the boot phase table with per-phase durations */
+void boot_profile_report(const char *core_name);
+
+#endif /* BOOT_PROFILE_H */
@@ -0,0 +1,106 @@
+/*******************************************************************************
+ * File: cpu_load.h
+ * Description: Per-task CPU load monitor (CM33 and CM55)
+ *
+ * A FreeRTOS software timer samples uxTaskGetSystemState() every
+ * CPU_LOAD_PERIOD_MS and turns the run-time counter deltas into rolling
+ * per-task CPU percentages. Context switches are counted per task by the
+ * traceTASK_SWITCHED_IN() hook (see FreeRTOSConfig.h).
+ *
+ * Requires configGENERATE_RUN_TIME_STATS = 1 and configUSE_TRACE_FACILITY = 1.
+ *
+ * The figures can be sent to the other core with IPC_CMD_CPU_REQ /
+ * IPC_CMD_CPU_REPORT (payload ipc_cpu_report_t, see ipc_shared.h).
+ *
+ * Usage:
+ *   cpu_load_init();                   // before or after the scheduler starts
+ *   ...
+ *   cpu_load_task_t tasks[8];
+ *   uint32_t n = cpu_load_get_tasks(tasks, 8, NULL);
+ ******************************************************************************/
+
+#ifndef CPU_LOAD_H
+#define CPU_LOAD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../ipc_shared.h"
+
+/*******************************************************************************
+ * Configuration
+ ******************************************************************************/
+
+#define CPU_LOAD_PERIOD_MS              (1000U)
+#define CPU_LOAD_MAX_TASKS              (16U)   /* Must cover all tasks of the core */
+#define CPU_LOAD_SWITCH_SLOTS           (32U)   /* Power of 2, indexed by task number */
+#define CPU_LOAD_SMOOTHING_SHIFT        (2U)    /* Rolling average weight 1/4 */
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+
+/**
+ * @brief Per-task load figures
+ */
+typedef struct {
+    const char *name;
+    uint32_t    task_number;    /* FreeRTOS task number (unique per task) */
+    uint16_t    load_x10;       /* Rolling CPU load in 0.1 % */
+    uint16_t    last_x10;       /* Load in the last period */
+    uint32_t    switches;       /* Switched in during the last period */
+    uint8_t     priority;
+} cpu_load_task_t;
+
+/*******************************************************************************
+ * API Functions
+ ******************************************************************************/
+
+/**
+ * @brief Create and start the sampling timer
+ * @return true on success
+ */
+bool cpu_load_init(void);
+
+/**
+ * @brief Core load (100 % - idle), rolling, in 0.1 %
+ */
+uint16_t cpu_load_get_total_x10(void);
+
+/**
+ * @brief Get per-task figures, highest load first
+ * @param tasks     Output array
+ * @param max_tasks Array length
+ * @param total     Out: tasks tracked (may exceed max_tasks)
+ * @return Entries written
+ */
+uint32_t cpu_load_get_tasks(cpu_load_task_t *tasks, uint32_t max_tasks, uint32_t *total);
+
+/**
+ * @brief Fill an IPC CPU load report for this core
+ */
+void cpu_load_fill_report(ipc_cpu_report_t *report);
+
+/**
+ * @brief Store the report last received from the other core
+ */
+void cpu_load_set_remote(const ipc_cpu_report_t *report);
+
+/**
+ * @brief Get the last report received from the other core
+ * @return false if none received yet
+ */
+bool cpu_load_get_remote(ipc_cpu_report_t *report);
+
+/**
+ * @brief Print per-task load to the console
+ */
+void cpu_load_print(const char *core_name);
+
+/**
+ * @brief traceTASK_SWITCHED_IN() hook - counts a switch for the task
+ *
+ * Called by the kernel from the context switch; do not call directly.
+ */
+void cpu_load_task_switched_in(uint32_t task_number);
+
+#endif /* CPU_LOAD_H */
@@ -0,0 +1,209 @@
+/*******************************************************************************
+ * File: lat_trace.h
+ * Description: End-to-end sensor-to-pixel latency tracer (CM33 and CM55)
+ *
+ * Follows one IMU sample from the BMI270 read on CM33 to the frame that
+ * shows it on CM55, timestamping each stage:
+ *
+ *   CM33: I2C read complete ........ imu_shared_set_trace() read_us
+ *   CM33: shared memory publish .... imu_shared_set_trace() publish_us
+ *   CM55: aic_imu_read_accel() ..... lat_trace_begin()
+ *   CM55: aic_tilt_update() ........ lat_trace_mark(LAT_STAGE_FILTER)
+ *   CM55: value handed to widget ... lat_trace_mark(LAT_STAGE_WIDGET)
+ *         (aic_tilt_get_*(), aic_imu_read_all(), aic_imu_get_orientation(),
+ *          or the example after it sets a widget from aic_imu_read_accel())
+ *   CM55: disp_flush() ............. lat_trace_mark(LAT_STAGE_FLUSH)
+ *   CM55: vsync .................... lat_trace_mark(LAT_STAGE_VSYNC)
+ *
+ * The sample is identified by the update_count of the shared IMU block.
+ * One sample is traced at a time; a newer sample that arrives before the
+ * current one reached the screen replaces it and counts as dropped.
+ *
+ * The cores have no common timebase, so each keeps a microsecond clock
+ * from its own DWT cycle counter and CM55 estimates the offset between
+ * them NTP style, with IPC_CMD_LAT_SYNC / IPC_CMD_LAT_SYNC_REPLY every
+ * LAT_TRACE_SYNC_MS while the tracer is enabled (lat_trace_enable(), the
+ * latency overlay does this). The sync with the shortest round trip of the last
+ * LAT_TRACE_SYNC_WINDOW is kept, its round trip bounds the cross-core
+ * error. Cross-core stages are skipped until the first sync.
+ *
+ * Every LAT_TRACE_REPORT_EVERY syncs CM55 sends the per-stage figures to
+ * CM33 (IPC_CMD_LAT_REPORT, payload ipc_lat_report_t), which prints them
+ * when new samples were traced.
+ *
+ * Usage (CM55):
+ *   lat_trace_init(send_fn);           // after IPC init
+ *   lat_trace_enable(true);            // while the figures are watched
+ *   ...
+ *   lat_trace_stats_t s;
+ *   lat_trace_get_stage(LAT_STAGE_TOTAL, &s);
+ ******************************************************************************/
+
+#ifndef LAT_TRACE_H
+#define LAT_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../ipc_shared.h"
+
+/*******************************************************************************
+ * Configuration
+ ******************************************************************************/
+
+#define LAT_TRACE_SYNC_MS               (1000U)
+#define LAT_TRACE_SYNC_WINDOW           (8U)    /* Syncs a low-RTT sync is kept for */
+#define LAT_TRACE_REPORT_EVERY          (5U)    /* Syncs per report to CM33 */
+#define LAT_TRACE_HIST_BINS             (9U)
+
+/* Upper bounds (us) of the latency histogram bins; the last bin is open */
+#define LAT_TRACE_HIST_LIMITS_US        { 500U, 1000U, 2000U, 5000U, 10000U, \
+                                          20000U, 50000U, 100000U }
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+
+/**
+ * @brief Stages; each is timed from the previous stage the sample passed
+ */
+typedef enum {
+    LAT_STAGE_PUBLISH = 0,      /* CM33 read -> shared memory publish */
+    LAT_STAGE_READ,             /* Publish -> CM55 read (cross-core) */
+    LAT_STAGE_FILTER,           /* Read -> tilt filter (optional) */
+    LAT_STAGE_WIDGET,           /* Read/filter -> widget invalidated */
+    LAT_STAGE_FLUSH,            /* Widget -> frame rendered, flush */
+    LAT_STAGE_VSYNC,            /* Flush -> frame on screen */
+    LAT_STAGE_TOTAL,            /* CM33 read -> frame on screen (cross-core) */
+    LAT_STAGE_COUNT
+} lat_trace_stage_t;
+
+/**
+ * @brief Latency distribution of one stage
+ */
+typedef struct {
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t total_us;
+    uint32_t hist[LAT_TRACE_HIST_BINS];
+} lat_trace_stats_t;
+
+/**
+ * @brief Sends an IPC message to the other core (true on success)
+ */
+typedef bool (*lat_trace_send_fn_t)(const ipc_msg_t *msg);
+
+/*******************************************************************************
+ * API Functions
+ ******************************************************************************/
+
+/**
+ * @brief Microseconds from this core's cycle counter (ISR-safe)
+ *
+ * Must be called at least once per cycle counter wrap (~10 s at 400 MHz);
+ * the sync timer and the IMU loop do.
+ */
+uint32_t lat_trace_now_us(void);
+
+/**
+ * @brief The same clock, without the 32-bit wrap (~71 min)
+ *
+ * Stops while the core sleeps in tickless idle: use tick_clock for spans
+ * that include idle time.
+ */
+uint64_t lat_trace_now_us64(void);
+
+/**
+ * @brief Create the sync / report timer, stopped (CM55)
+ * @param send Used for syncs and reports
+ * @return true on success
+ */
+bool lat_trace_init(lat_trace_send_fn_t send);
+
+/**
+ * @brief Start or stop the syncs and reports (CM55)
+ *
+ * Starting drops the last offset: the cycle counters stop in sleep at
+ * different times, so it is stale. Cross-core stages resume after the
+ * first sync.
+ * @return false if the timer command failed
+ */
+bool lat_trace_enable(bool on);
+
+/**
+ * @brief A new IMU sample was read on CM55
+ * @param id         update_count of the sample
+ * @param read_us    CM33 clock at I2C read complete
+ * @param publish_us CM33 clock at publish
+ *
+ * Repeated calls with the same id are ignored.
+ */
+void lat_trace_begin(uint32_t id, uint32_t read_us, uint32_t publish_us);
+
+/**
+ * @brief The traced sample reached a stage (CM55)
+ *
+ * Ignored with no sample in flight or out of order. LAT_STAGE_FLUSH needs
+ * LAT_STAGE_WIDGET, LAT_STAGE_VSYNC needs LAT_STAGE_FLUSH.
+ */
+void lat_trace_mark(lat_trace_stage_t stage);
+
+/**
+ * @brief Stamp an incoming IPC_CMD_LAT_SYNC / _REPLY (from the IPC ISR)
+ */
+void lat_trace_stamp_rx(ipc_msg_t *msg);
+
+/**
+ * @brief Answer IPC_CMD_LAT_SYNC (CM33), fills reply_tx_us
+ * @param request Stamped request
+ * @param reply   Out: IPC_CMD_LAT_SYNC_REPLY to send at once
+ */
+void lat_trace_sync_reply(const ipc_msg_t *request, ipc_msg_t *reply);
+
+/**
+ * @brief Handle IPC_CMD_LAT_SYNC_REPLY (CM55)
+ */
+void lat_trace_sync_done(const ipc_msg_t *reply);
+
+/**
+ * @brief Copy the distribution of one stage
+ */
+bool lat_trace_get_stage(lat_trace_stage_t stage, lat_trace_stats_t *stats);
+
+/**
+ * @brief Samples traced to the screen / replaced before reaching it
+ */
+void lat_trace_get_counts(uint32_t *samples, uint32_t *dropped);
+
+/**
+ * @brief Current clock offset (CM33 - CM55) and its sync round trip
+ * @return false before the first sync
+ */
+bool lat_trace_get_offset(int32_t *offset_us, uint32_t *rtt_us);
+
+/**
+ * @brief Clear all distributions and counts
+ */
+void lat_trace_reset(void);
+
+/**
+ * @brief Fill an IPC latency report
+ */
+void lat_trace_fill_report(ipc_lat_report_t *report);
+
+/**
+ * @brief Print the distributions of this core to the console
+ */
+void lat_trace_print(const char *core_name);
+
+/**
+ * @brief Print a report received from the other core
+ */
+void lat_trace_print_report(const char *core_name, const ipc_lat_report_t *report);
+
+/**
+ * @brief Short stage name ("publish", "read", ...)
+ */
+const char *lat_trace_stage_name(lat_trace_stage_t stage);
+
+#endif /* LAT_TRACE_H */
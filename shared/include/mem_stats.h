@@ -0,0 +1,148 @@
+/*******************************************************************************
+ * File: mem_stats.h
+ * Description: Runtime memory accounting (CM33 and CM55)
+ *
+ * One query API for the memory pools of a core:
+ *   - C heap (FreeRTOS heap_3 and LVGL CLIB both allocate from malloc):
+ *     size, in use, peak and fragmentation
+ *   - Registered static regions (VG-Lite command/tessellation buffers,
+ *     frame buffers): size and, if painted, high-water mark
+ *   - Per-task stack high-water marks
+ *
+ * The same figures can be sent to the other core with IPC_CMD_MEM_REQ /
+ * IPC_CMD_MEM_REPORT (payload ipc_mem_report_t, see ipc_shared.h). The
+ * requester keeps them (mem_stats_set_remote()) and prints them only for
+ * a request with value IPC_MEM_PRINT; the memory panel polls with
+ * IPC_MEM_POLL.
+ *
+ * Usage:
+ *   mem_stats_region_add("vg_cmd", cmd_base, CMD_SIZE, 2, true);
+ *   ...
+ *   mem_stats_heap_t heap;
+ *   mem_stats_get_heap(&heap);
+ *   mem_stats_print("CM55");
+ ******************************************************************************/
+
+#ifndef MEM_STATS_H
+#define MEM_STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../ipc_shared.h"
+
+/*******************************************************************************
+ * Configuration
+ ******************************************************************************/
+
+#define MEM_STATS_MAX_REGIONS           (6U)
+#define MEM_STATS_MAX_TASKS             (16U)   /* Must cover all tasks of the core */
+#define MEM_STATS_PAINT_WORD            (0xA5C3A5C3UL)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+
+/**
+ * @brief C heap figures (from the C library allocator)
+ */
+typedef struct {
+    uint32_t total;         /* Heap size from the linker (0 if unknown) */
+    uint32_t arena;         /* Bytes the allocator has taken from the heap */
+    uint32_t used;          /* Bytes allocated now */
+    uint32_t peak;          /* Highest 'used' seen (sampled on each query) */
+    uint32_t arena_free;    /* Free bytes held inside the arena (holes) */
+    uint8_t  frag_pct;      /* arena_free / arena in percent */
+} mem_stats_heap_t;
+
+/**
+ * @brief Static region figures
+ */
+typedef struct {
+    const char *name;
+    uint32_t    size;       /* Total bytes (slot_size * slot_count) */
+    uint32_t    slot_size;
+    uint8_t     slot_count;
+    uint32_t    high_water; /* Largest bytes used in any slot (= slot_size if not painted) */
+    bool        painted;
+} mem_stats_region_t;
+
+/**
+ * @brief Per-task stack figures
+ */
+typedef struct {
+    const char *name;
+    uint32_t    stack_free; /* Minimum free stack ever (bytes) */
+    uint8_t     priority;
+} mem_stats_task_t;
+
+/*******************************************************************************
+ * API Functions
+ ******************************************************************************/
+
+/**
+ * @brief Get C heap figures (also updates the sampled peak)
+ */
+void mem_stats_get_heap(mem_stats_heap_t *heap);
+
+/**
+ * @brief Register a static memory region
+ *
+ * A region is split into slot_count equal slots (e.g. the VG-Lite double
+ * buffered command buffers). With paint = true the region is filled with
+ * MEM_STATS_PAINT_WORD now, and its high-water mark is found later by
+ * scanning each slot back from its end for the first overwritten word.
+ * Paint only before the owner starts using the memory.
+ *
+ * @return true on success, false if the table is full
+ */
+bool mem_stats_region_add(const char *name, void *base, uint32_t slot_size,
+                          uint8_t slot_count, bool paint);
+
+/**
+ * @brief Get a registered region (high-water mark is rescanned)
+ * @param index 0 .. mem_stats_region_count() - 1
+ */
+bool mem_stats_get_region(uint32_t index, mem_stats_region_t *region);
+
+/**
+ * @brief Number of registered regions
+ */
+uint32_t mem_stats_region_count(void);
+
+/**
+ * @brief Get per-task stack figures, lowest free stack first
+ * @param tasks     Output array
+ * @param max_tasks Array length
+ * @param total     Out: number of tasks on the core (may exceed max_tasks)
+ * @return Entries written
+ */
+uint32_t mem_stats_get_tasks(mem_stats_task_t *tasks, uint32_t max_tasks,
+                             uint32_t *total);
+
+/**
+ * @brief Fill an IPC memory report for this core
+ */
+void mem_stats_fill_report(ipc_mem_report_t *report);
+
+/**
+ * @brief Store the report last received from the other core
+ */
+void mem_stats_set_remote(const ipc_mem_report_t *report);
+
+/**
+ * @brief Get the last report received from the other core
+ * @return false if none received yet
+ */
+bool mem_stats_get_remote(ipc_mem_report_t *report);
+
+/**
+ * @brief Print heap, regions and task stacks to the console
+ */
+void mem_stats_print(const char *core_name);
+
+/**
+ * @brief Print an IPC memory report (e.g. one received from the other core)
+ */
+void mem_stats_print_report(const char *core_name, const ipc_mem_report_t *report);
+
+#endif /* MEM_STATS_H */
@@ -0,0 +1,147 @@
+/*******************************************************************************
+ * File: periodic.h
+ * Description: Periodic task timing - jitter, execution time, deadline misses
+ *              (CM33 and CM55)
+ *
+ * Replaces the vTaskDelay() at the end of a periodic loop with
+ * periodic_wait(), which sleeps with vTaskDelayUntil() semantics (no drift)
+ * and records per task:
+ *   - release jitter: actual start-to-start period minus nominal, histogram
+ *   - execution time: wake to the next periodic_wait()
+ *   - deadline misses: execution longer than the deadline
+ *   - overruns: the next release was already due, so no sleep happened
+ *
+ * Loops that are not strictly periodic (the LVGL loop) can use
+ * periodic_begin() / periodic_end() to record execution time and misses.
+ *
+ * The statistics live in a .noinit record that survives a warm reset: after
+ * a watchdog or fault reset, periodic_print_previous() shows the figures of
+ * the boot that died.
+ *
+ * Usage:
+ *   static periodic_task_t imu_timing;
+ *   periodic_init(&imu_timing, "IMU", 100, 0);
+ *   for (;;) {
+ *       periodic_wait(&imu_timing);
+ *       imu_read_and_update();
+ *   }
+ ******************************************************************************/
+
+#ifndef PERIODIC_H
+#define PERIODIC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "FreeRTOS.h"
+
+/*******************************************************************************
+ * Configuration
+ ******************************************************************************/
+
+#define PERIODIC_MAX_TASKS              (8U)
+#define PERIODIC_NAME_LEN               (12U)
+#define PERIODIC_HIST_BINS              (8U)
+
+/* Upper bounds (us) of the jitter histogram bins; the last bin is open */
+#define PERIODIC_HIST_LIMITS_US         { 50U, 100U, 250U, 500U, 1000U, 2000U, 5000U }
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+
+/**
+ * @brief Timing statistics of one periodic task (stored in .noinit)
+ */
+typedef struct {
+    char     name[PERIODIC_NAME_LEN];
+    uint32_t period_us;         /* Nominal period (0 = not periodic) */
+    uint32_t deadline_us;
+    uint32_t releases;          /* Completed cycles */
+    uint32_t misses;            /* Execution > deadline */
+    uint32_t overruns;          /* Next release already due at wait */
+    uint32_t exec_last_us;
+    uint32_t exec_max_us;
+    uint64_t exec_total_us;
+    int32_t  jitter_min_us;     /* Actual - nominal period */
+    int32_t  jitter_max_us;
+    uint32_t jitter_hist[PERIODIC_HIST_BINS];   /* |jitter| histogram */
+} periodic_stats_t;
+
+/**
+ * @brief Periodic task handle (owned by the task)
+ */
+typedef struct {
+    periodic_stats_t *stats;    /* Slot in the .noinit record */
+    TickType_t period_ticks;
+    TickType_t last_wake;
+    uint32_t   release_cycles;  /* Cycle count at the current release */
+    uint32_t   release_us;      /* tick_clock_now_us() at the current release */
+    bool       started;
+} periodic_task_t;
+
+/*******************************************************************************
+ * API Functions
+ ******************************************************************************/
+
+/**
+ * @brief Register a task for timing
+ * @param pt          Handle
+ * @param name        Short name (copied)
+ * @param period_ms   Nominal period (0 = aperiodic, begin/end only)
+ * @param deadline_ms Deadline from release (0 = period)
+ * @return false if PERIODIC_MAX_TASKS are registered
+ */
+bool periodic_init(periodic_task_t *pt, const char *name, uint32_t period_ms,
+                   uint32_t deadline_ms);
+
+/**
+ * @brief End the current cycle and sleep until the next release
+ *
+ * The first call only sets the release time.
+ */
+void periodic_wait(periodic_task_t *pt);
+
+/**
+ * @brief Change the period of a running task
+ *
+ * No-op if the period is unchanged. Otherwise the next periodic_wait()
+ * starts the schedule afresh, so the change is not counted as jitter or an
+ * overrun. The statistics report the current period.
+ * @param pt          Handle
+ * @param period_ms   New period (> 0)
+ */
+void periodic_set_period(periodic_task_t *pt, uint32_t period_ms);
+
+/**
+ * @brief Mark the start of an execution (aperiodic use)
+ */
+void periodic_begin(periodic_task_t *pt);
+
+/**
+ * @brief Mark the end of an execution (aperiodic use)
+ */
+void periodic_end(periodic_task_t *pt);
+
+/**
+ * @brief Copy the statistics of the task at index
+ * @param index 0 .. periodic_count() - 1
+ * @param previous true for the record of the previous boot
+ */
+bool periodic_get(uint32_t index, bool previous, periodic_stats_t *stats);
+
+/**
+ * @brief Number of registered tasks (or tasks in the previous boot's record)
+ */
+uint32_t periodic_count(bool previous);
+
+/**
+ * @brief Print the statistics of this boot to the console
+ */
+void periodic_print(const char *core_name);
+
+/**
+ * @brief Print the statistics saved by the previous boot, if any
+ */
+void periodic_print_previous(const char *core_name);
+
+#endif /* PERIODIC_H */
@@ -0,0 +1,149 @@
+/*******************************************************************************
+ * File: static_mem.h
+ * Description: Static kernel objects and memory map report (CM33 and CM55)
+ *
+ * Long-lived tasks, queues, mutexes and timers are created from storage
+ * sized at compile time (configSUPPORT_STATIC_ALLOCATION), so they never
+ * touch the heap. Each object created through this module is recorded, and
+ * static_mem_print() lists them with their sizes plus any heap growth since
+ * static_mem_seal() marked the end of boot.
+ *
+ * Usage:
+ *   STATIC_TASK_DEFINE(imu, IMU_TASK_STACK_SIZE);
+ *   STATIC_QUEUE_DEFINE(cmd, 8, sizeof(ipc_msg_t));
+ *   ...
+ *   STATIC_TASK_CREATE(imu, imu_task, "IMU Task", NULL, IMU_TASK_PRIORITY);
+ *   cmd_queue = STATIC_QUEUE_CREATE(cmd, "cmd");
+ *   ...
+ *   static_mem_seal();             // end of boot
+ *   static_mem_print("CM33");
+ ******************************************************************************/
+
+#ifndef STATIC_MEM_H
+#define STATIC_MEM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "timers.h"
+
+/*******************************************************************************
+ * Configuration
+ ******************************************************************************/
+
+#define STATIC_MEM_MAX_OBJECTS          (24U)
+
+/*******************************************************************************
+ * Storage Helpers
+ ******************************************************************************/
+
+#define STATIC_TASK_DEFINE(var, stack_words)                                \
+    static StackType_t var##_stack[(stack_words)];                          \
+    static StaticTask_t var##_tcb
+
+#define STATIC_QUEUE_DEFINE(var, length, item_size)                         \
+    static uint8_t var##_queue_buf[(length) * (item_size)];                 \
+    static StaticQueue_t var##_queue_obj
+
+#define STATIC_MUTEX_DEFINE(var)                                            \
+    static StaticSemaphore_t var##_mutex_obj
+
+#define STATIC_TIMER_DEFINE(var)                                            \
+    static StaticTimer_t var##_timer_obj
+
+#define STATIC_TASK_CREATE(var, fn, name, param, prio)                      \
+    static_mem_task_create((fn), (name),                                    \
+                           (uint32_t)(sizeof(var##_stack) / sizeof(StackType_t)), \
+                           (param), (prio), var##_stack, &var##_tcb)
+
+#define STATIC_QUEUE_CREATE(var, name, item_size)                           \
+    static_mem_queue_create((name),                                         \
+                            (uint32_t)(sizeof(var##_queue_buf) / (item_size)), \
+                            (item_size), var##_queue_buf, &var##_queue_obj)
+
+#define STATIC_MUTEX_CREATE(var, name)                                      \
+    static_mem_mutex_create((name), &var##_mutex_obj)
+
+#define STATIC_TIMER_CREATE(var, name, period, reload, id, cb)              \
+    static_mem_timer_create((name), (period), (reload), (id), (cb), &var##_timer_obj)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+
+typedef enum {
+    STATIC_MEM_TASK = 0,
+    STATIC_MEM_QUEUE,
+    STATIC_MEM_MUTEX,
+    STATIC_MEM_TIMER,
+    STATIC_MEM_KIND_COUNT
+} static_mem_kind_t;
+
+/**
+ * @brief One recorded object
+ */
+typedef struct {
+    const char       *name;
+    const void       *object;   /* Control block (identifies the object) */
+    uint32_t          bytes;    /* Control block + stack or queue storage */
+    static_mem_kind_t kind;
+} static_mem_object_t;
+
+/*******************************************************************************
+ * API Functions
+ ******************************************************************************/
+
+/**
+ * @brief xTaskCreateStatic() and record it
+ * @return Task handle, NULL on failure
+ */
+TaskHandle_t static_mem_task_create(TaskFunction_t fn, const char *name,
+                                    uint32_t stack_words, void *param,
+                                    UBaseType_t priority, StackType_t *stack,
+                                    StaticTask_t *tcb);
+
+/**
+ * @brief xQueueCreateStatic() and record it
+ */
+QueueHandle_t static_mem_queue_create(const char *name, uint32_t length,
+                                      uint32_t item_size, uint8_t *storage,
+                                      StaticQueue_t *queue);
+
+/**
+ * @brief xSemaphoreCreateMutexStatic() and record it
+ */
+SemaphoreHandle_t static_mem_mutex_create(const char *name, StaticSemaphore_t *mutex);
+
+/**
+ * @brief xTimerCreateStatic() and record it
+ */
+TimerHandle_t static_mem_timer_create(const char *name, TickType_t period,
+                                      bool auto_reload, void *timer_id,
+                                      TimerCallbackFunction_t callback,
+                                      StaticTimer_t *timer);
+
+/**
+ * @brief Get a recorded object
+ * @param index 0 .. static_mem_count() - 1
+ */
+bool static_mem_get(uint32_t index, static_mem_object_t *object);
+
+/**
+ * @brief Number of recorded objects
+ */
+uint32_t static_mem_count(void);
+
+/**
+ * @brief Mark the end of boot: heap use from here on is reported as growth
+ */
+void static_mem_seal(void);
+
+/**
+ * @brief Print the memory map of static kernel objects to the console
+ */
+void static_mem_print(const char *core_name);
+
+#endif /* STATIC_MEM_H */
@@ -0,0 +1,42 @@
+/*******************************************************************************
+ * File: tick_clock.h
+ * Description: Microsecond clock that keeps counting in tickless sleep
+ *              (CM33 and CM55)
+ *
+ * The DWT cycle counter behind lat_trace_now_us64() stops while the core
+ * sleeps in tickless idle, so it only measures spans the core stays awake
+ * for. This clock is the FreeRTOS tick count, which the tickless idle
+ * code steps by the time slept, plus the SysTick count for the part of
+ * the current tick. Use it for anything measured across idle time: time
+ * of day, timeouts, periods.
+ *
+ * The result is monotonic and 64-bit (the tick count wrap is extended),
+ * as long as it is read at least once per tick count wrap (49 days at
+ * 1 kHz). Callable from tasks and ISRs.
+ *
+ * Usage:
+ *   uint64_t t0 = tick_clock_now_us64();
+ *   ...
+ *   uint32_t elapsed_us = (uint32_t)(tick_clock_now_us64() - t0);
+ ******************************************************************************/
+
+#ifndef TICK_CLOCK_H
+#define TICK_CLOCK_H
+
+#include <stdint.h>
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+
+/**
+ * @brief Microseconds since the scheduler started
+ */
+uint64_t tick_clock_now_us64(void);
+
+/**
+ * @brief Low 32 bits of tick_clock_now_us64() (wraps after 71 minutes)
+ */
+uint32_t tick_clock_now_us(void);
+
+#endif /* TICK_CLOCK_H */
@@ -0,0 +1,118 @@
+/*******************************************************************************
+ * File: uart_buf.h
+ * Description: Ring-buffered, non-blocking debug UART output (CM33 and CM55)
+ *
+ * printf() normally goes through retarget-io, which spins in the calling
+ * task until every byte is in the UART FIFO: a log burst at 115200 baud
+ * delays the IMU and IPC tasks by milliseconds. With this module _write()
+ * (wrapped with -Wl,--wrap=_write, see the Makefiles) only copies the text
+ * into a ring buffer; a low-priority task moves it into the TX FIFO as it
+ * drains, converting LF to CRLF like retarget-io.
+ *
+ * When the ring is full, UART_BUF_DROP discards the write (counted) and
+ * UART_BUF_BLOCK makes the writer sleep until it fits. ISRs always drop.
+ * A write is queued in pieces of at most UART_BUF_SIZE: one that fits in
+ * a piece is queued whole or not at all, a longer one can be cut after
+ * any piece. Before the scheduler runs, output is written synchronously, so
+ * boot messages and their order are unchanged. Both mains keep
+ * UART_BUF_BLOCK for the boot reports and switch to UART_BUF_DROP after.
+ *
+ * Usage:
+ *   init_retarget_io();
+ *   uart_buf_init(CYBSP_DEBUG_UART_HW);   // done in init_retarget_io()
+ *   ...
+ *   uart_buf_set_policy(UART_BUF_DROP);   // end of boot
+ *   ...
+ *   uart_buf_flush();                     // before a reset / in a fault
+ ******************************************************************************/
+
+#ifndef UART_BUF_H
+#define UART_BUF_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_pdl.h"
+
+/*******************************************************************************
+ * Configuration
+ ******************************************************************************/
+
+#ifndef UART_BUF_SIZE
+#define UART_BUF_SIZE                   (2048U) /* Power of 2 */
+#endif
+
+#ifndef UART_BUF_DEFAULT_POLICY
+#define UART_BUF_DEFAULT_POLICY         UART_BUF_BLOCK
+#endif
+
+#define UART_BUF_TASK_STACK             (256U)  /* Words */
+#define UART_BUF_TASK_PRIORITY          (1U)    /* Just above idle */
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+
+/**
+ * @brief What a write does when the ring is full
+ */
+typedef enum {
+    UART_BUF_DROP = 0,          /* Discard what does not fit, count it */
+    UART_BUF_BLOCK              /* Sleep until it fits (tasks only) */
+} uart_buf_policy_t;
+
+/**
+ * @brief Counters
+ */
+typedef struct {
+    uint32_t bytes_written;     /* Accepted into the ring */
+    uint32_t bytes_sent;        /* Moved to the TX FIFO */
+    uint32_t bytes_dropped;
+    uint32_t writes_dropped;
+    uint32_t writes_blocked;    /* Writers that had to wait (UART_BUF_BLOCK) */
+    uint32_t high_water;        /* Most bytes ever queued */
+} uart_buf_stats_t;
+
+/*******************************************************************************
+ * API Functions
+ ******************************************************************************/
+
+/**
+ * @brief Start buffering and the drain task
+ * @param base Debug UART SCB, already initialized and enabled
+ * @return true on success
+ */
+bool uart_buf_init(CySCB_Type *base);
+
+/**
+ * @brief Select the overflow policy
+ */
+void uart_buf_set_policy(uart_buf_policy_t policy);
+
+/**
+ * @brief Queue bytes for output (what _write() calls)
+ *
+ * Dropped bytes are counted in the stats, not reported: an error return
+ * would mark stdout failed in newlib.
+ * @return len, also when bytes were dropped; 0 if data is NULL, len <= 0
+ *         or uart_buf_init() has not run
+ */
+int uart_buf_write(const char *data, int len);
+
+/**
+ * @brief Write everything queued synchronously
+ *
+ * Spins on the UART; safe with interrupts disabled (fault handlers).
+ */
+void uart_buf_flush(void);
+
+/**
+ * @brief Copy the counters
+ */
+void uart_buf_get_stats(uart_buf_stats_t *stats);
+
+/**
+ * @brief Print the counters to the console
+ */
+void uart_buf_print(const char *core_name);
+
+#endif /* UART_BUF_H */
@@ -40,6 +40,13 @@ typedef enum {
     IPC_CMD_PONG        = 0x43,
     IPC_CMD_ACK         = 0x44,
     IPC_CMD_NACK        = 0x45,
+    IPC_CMD_MEM_REQ     = 0x46,     /* Either core: request memory report (value: IPC_MEM_*) */
+    IPC_CMD_MEM_REPORT  = 0x47,     /* Reply: ipc_mem_report_t in data */
+    IPC_CMD_CPU_REQ     = 0x48,     /* Either core: request CPU load report */
+    IPC_CMD_CPU_REPORT  = 0x49,     /* Reply: ipc_cpu_report_t in data */
+    IPC_CMD_LAT_SYNC    = 0x4A,     /* CM55→CM33: trace clock sync, ipc_lat_sync_t */
+    IPC_CMD_LAT_SYNC_REPLY = 0x4B,  /* CM33→CM55: sync reply, ipc_lat_sync_t */
+    IPC_CMD_LAT_REPORT  = 0x4C,     /* CM55→CM33: ipc_lat_report_t in data */
 
     /* Control Commands (0x80-0x8F) */
     IPC_CMD_INIT        = 0x81,
@@ -104,10 +111,11 @@ typedef enum {
     IPC_CMD_BT_CONNECTED        = 0xE8,
     IPC_CMD_BT_DISCONNECTED     = 0xE9,
     IPC_CMD_BT_ERROR            = 0xEA,
+    IPC_CMD_BT_SCAN_FILTER      = 0xEB,   /* CM55→CM33: data=ipc_bt_scan_filter_t */
 
     /* NTP/Time Commands (0xF0-0xF3) */
     IPC_CMD_NTP_SYNC            = 0xF0,   /* CM55→CM33: Request NTP time sync */
-    IPC_CMD_NTP_TIME            = 0xF1,   /* CM33→CM55: Time result (value=epoch) */
+    IPC_CMD_NTP_TIME            = 0xF1,   /* CM33→CM55: Time result (value=epoch, data=ipc_ntp_time_t) */
     IPC_CMD_NTP_ERROR           = 0xF2,   /* CM33→CM55: Sync failed */
 
 } ipc_cmd_t;
@@ -171,6 +179,97 @@ typedef struct __attribute__((packed)) {
     uint32_t timestamp;
 } ipc_button_data_t;
 
+/*******************************************************************************
+ * Memory Report (for IPC) - see shared/include/mem_stats.h
+ ******************************************************************************/
+
+#define IPC_MEM_MAX_TASKS       (8U)
+#define IPC_MEM_TASK_NAME_LEN   (8U)
+
+/* IPC_CMD_MEM_REQ value, echoed in the IPC_CMD_MEM_REPORT value */
+#define IPC_MEM_POLL            (0U)    /* Panel refresh: keep, don't print */
+#define IPC_MEM_PRINT           (1U)    /* Dump: the requester prints the reply */
+
+typedef struct __attribute__((packed)) {
+    char     name[IPC_MEM_TASK_NAME_LEN];   /* Truncated, not NUL-terminated if full */
+    uint32_t stack_free;                    /* Minimum free stack ever (bytes) */
+} ipc_mem_task_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t heap_total;        /* C heap size (0 if unknown) */
+    uint32_t heap_used;         /* Bytes allocated now */
+    uint32_t heap_peak;         /* Highest heap_used seen */
+    uint32_t heap_arena;        /* Bytes taken from the heap by the allocator */
+    uint8_t  frag_pct;          /* Free-but-reserved share of the arena */
+    uint8_t  task_count;        /* Tasks on the core */
+    uint8_t  task_listed;       /* Entries in tasks[] (lowest stack_free first) */
+    uint8_t  reserved;
+    ipc_mem_task_t tasks[IPC_MEM_MAX_TASKS];
+} ipc_mem_report_t;
+
+/*******************************************************************************
+ * CPU Load Report (for IPC) - see shared/include/cpu_load.h
+ ******************************************************************************/
+
+#define IPC_CPU_MAX_TASKS       (10U)
+
+typedef struct __attribute__((packed)) {
+    char     name[IPC_MEM_TASK_NAME_LEN];   /* Truncated, not NUL-terminated if full */
+    uint16_t load_x10;                      /* Rolling CPU load in 0.1 % */
+    uint16_t switches;                      /* Context switches per second */
+} ipc_cpu_task_t;
+
+typedef struct __attribute__((packed)) {
+    uint16_t total_x10;         /* Core load (100 % - idle) in 0.1 % */
+    uint8_t  task_count;        /* Tasks on the core */
+    uint8_t  task_listed;       /* Entries in tasks[] (highest load first) */
+    ipc_cpu_task_t tasks[IPC_CPU_MAX_TASKS];
+} ipc_cpu_report_t;
+
+/*******************************************************************************
+ * Sensor-to-Pixel Latency (for IPC) - see shared/include/lat_trace.h
+ ******************************************************************************/
+
+#define IPC_LAT_STAGE_COUNT     (7U)
+
+/* Trace clock sync: NTP style four timestamps, each in its core's clock */
+typedef struct __attribute__((packed)) {
+    uint32_t request_tx_us;     /* CM55: request sent */
+    uint32_t request_rx_us;     /* CM33: request received (ISR) */
+    uint32_t reply_tx_us;       /* CM33: reply sent */
+    uint32_t reply_rx_us;       /* CM55: reply received (ISR) */
+} ipc_lat_sync_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t min_us;
+    uint32_t avg_us;
+    uint32_t max_us;
+} ipc_lat_stage_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t samples;           /* Samples traced through to vsync */
+    uint32_t dropped;           /* Superseded before reaching the screen */
+    int32_t  clock_offset_us;   /* CM33 clock - CM55 clock */
+    uint16_t sync_rtt_us;       /* Round trip of the sync in use */
+    uint16_t reserved;
+    ipc_lat_stage_t stages[IPC_LAT_STAGE_COUNT];    /* lat_trace_stage_t order */
+} ipc_lat_report_t;
+
+/*******************************************************************************
+ * NTP Time (for IPC) - see proj_cm33_ns/source/sntp_client.h
+ ******************************************************************************/
+
+typedef struct __attribute__((packed)) {
+    uint32_t unix_s;            /* Unix time at cm33_us */
+    uint32_t unix_us;           /* Microseconds within unix_s */
+    uint32_t cm33_us;           /* CM33 lat_trace clock the time is valid at */
+    int32_t  drift_ppb;         /* CM33 clock rate error estimate */
+    uint32_t delay_us;          /* Server round trip of the sample used */
+    uint16_t poll_s;            /* Next sync in */
+    uint8_t  stratum;
+    uint8_t  servers;           /* Servers that answered */
+} ipc_ntp_time_t;
+
 /*******************************************************************************
  * Helper Macros
  ******************************************************************************/
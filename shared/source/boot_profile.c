@@ -0,0 +1,80 @@
+/*******************************************************************************
+ * File: boot_profile.c
+ * Description: Boot-phase timestamp recorder (CM33 and CM55)
+ *
+ * Uses the DWT cycle counter (wraps after ~10 s at 400 MHz, well beyond
+ * boot time) and SystemCoreClock for the conversion to microseconds.
+ ******************************************************************************/
+
+#include "boot_profile.h"
+#include "cy_pdl.h"
+#include <stdio.h>
+
+/*******************************************************************************
+ * Static Variables
+ ******************************************************************************/
+
+static boot_profile_mark_t boot_marks[BOOT_PROFILE_MAX_MARKS];
+static volatile uint32_t boot_mark_count = 0;
+static uint32_t boot_start_cycles = 0;
+
+/*******************************************************************************
+ * Public Functions
+ ******************************************************************************/
+
+void boot_profile_start(void)
+{
+#if defined(DCB)
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+#else
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+#endif
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    boot_start_cycles = DWT->CYCCNT;
+    boot_mark_count = 0;
+}
+
+uint32_t boot_profile_elapsed_us(void)
+{
+    uint32_t cycles = DWT->CYCCNT - boot_start_cycles;
+    uint32_t cycles_per_us = SystemCoreClock / 1000000UL;
+
+    return (cycles_per_us > 0U) ? (cycles / cycles_per_us) : 0U;
+}
+
+void boot_profile_mark(const char *phase)
+{
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+
+    if (boot_mark_count < BOOT_PROFILE_MAX_MARKS) {
+        boot_marks[boot_mark_count].phase = phase;
+        boot_marks[boot_mark_count].time_us = boot_profile_elapsed_us();
+        boot_mark_count++;
+    }
+
+    Cy_SysLib_ExitCriticalSection(state);
+}
+
+uint32_t boot_profile_get(const boot_profile_mark_t **marks)
+{
+    if (marks != NULL) {
+        *marks = boot_marks;
+    }
+    return boot_mark_count;
+}
+
+void boot_profile_report(const char *core_name)
+{
+    uint32_t prev_us = 0;
+
+    printf("[%s] Boot profile (ms):\r\n", core_name);
+    for (uint32_t i = 0; i < boot_mark_count; i++) {
+        uint32_t t = boot_marks[i].time_us;
+        printf("  %-14s at %5lu.%01lu  (+%lu.%01lu)\r\n", boot_marks[i].phase,
+               (unsigned long)(t / 1000U), (unsigned long)((t % 1000U) / 100U),
+               (unsigned long)((t - prev_us) / 1000U),
+               (unsigned long)(((t - prev_us) % 1000U) / 100U));
+        prev_us = t;
+    }
+}
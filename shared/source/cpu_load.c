@@ -0,0 +1,270 @@
+/*******************************************************************************
+ * File: cpu_load.c
+ * Description: Per-task CPU load monitor (CM33 and CM55)
+ *
+ * Load is the share of the summed run-time counter deltas of all tasks in
+ * one period, so it does not depend on the run-time timer frequency.
+ * Tasks are matched between samples by their FreeRTOS task number.
+ ******************************************************************************/
+
+#include "cpu_load.h"
+#include "static_mem.h"
+#include "cy_pdl.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifndef configIDLE_TASK_NAME
+#define configIDLE_TASK_NAME    "IDLE"
+#endif
+
+/*******************************************************************************
+ * Static Variables
+ ******************************************************************************/
+
+typedef struct {
+    cpu_load_task_t info;
+    uint32_t        last_runtime;
+    bool            seen;
+} load_record_t;
+
+static load_record_t records[CPU_LOAD_MAX_TASKS];
+static uint32_t record_count = 0;
+static uint16_t total_x10 = 0;
+
+/* Written from the context switch, read and cleared by the sampler */
+static volatile uint32_t switch_counts[CPU_LOAD_SWITCH_SLOTS];
+
+static TaskStatus_t task_status[CPU_LOAD_MAX_TASKS];
+static TimerHandle_t sample_timer = NULL;
+STATIC_TIMER_DEFINE(sample);
+
+static ipc_cpu_report_t remote_report;
+static bool remote_valid = false;
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+
+static load_record_t *find_record(uint32_t task_number)
+{
+    for (uint32_t i = 0; i < record_count; i++) {
+        if (records[i].info.task_number == task_number) {
+            return &records[i];
+        }
+    }
+    return NULL;
+}
+
+static uint16_t smooth(uint16_t avg, uint16_t sample)
+{
+    int32_t diff = (int32_t)sample - (int32_t)avg;
+    return (uint16_t)((int32_t)avg + diff / (int32_t)(1U << CPU_LOAD_SMOOTHING_SHIFT));
+}
+
+static void sample_timer_cb(TimerHandle_t timer)
+{
+    (void)timer;
+
+    uint32_t count = (uint32_t)uxTaskGetSystemState(task_status, CPU_LOAD_MAX_TASKS, NULL);
+    uint32_t period_total = 0;
+    uint32_t deltas[CPU_LOAD_MAX_TASKS];
+
+    if (count == 0U) {
+        return;     /* More tasks than CPU_LOAD_MAX_TASKS */
+    }
+
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+
+    for (uint32_t i = 0; i < record_count; i++) {
+        records[i].seen = false;
+    }
+
+    /* Run-time deltas since the last sample (new tasks start from zero) */
+    for (uint32_t i = 0; i < count; i++) {
+        const TaskStatus_t *ts = &task_status[i];
+        load_record_t *rec = find_record((uint32_t)ts->xTaskNumber);
+
+        if (rec == NULL && record_count < CPU_LOAD_MAX_TASKS) {
+            rec = &records[record_count++];
+            memset(rec, 0, sizeof(load_record_t));
+            rec->info.task_number = (uint32_t)ts->xTaskNumber;
+            rec->last_runtime = (uint32_t)ts->ulRunTimeCounter;
+        }
+        if (rec == NULL) {
+            deltas[i] = 0;
+            continue;
+        }
+
+        deltas[i] = (uint32_t)ts->ulRunTimeCounter - rec->last_runtime;
+        rec->last_runtime = (uint32_t)ts->ulRunTimeCounter;
+        rec->info.name = ts->pcTaskName;
+        rec->info.priority = (uint8_t)ts->uxCurrentPriority;
+        rec->seen = true;
+        period_total += deltas[i];
+    }
+
+    for (uint32_t i = 0; i < count && period_total > 0U; i++) {
+        load_record_t *rec = find_record((uint32_t)task_status[i].xTaskNumber);
+        if (rec == NULL) {
+            continue;
+        }
+
+        uint16_t inst = (uint16_t)(((uint64_t)deltas[i] * 1000U) / period_total);
+        rec->info.last_x10 = inst;
+        rec->info.load_x10 = smooth(rec->info.load_x10, inst);
+
+        uint32_t slot = rec->info.task_number & (CPU_LOAD_SWITCH_SLOTS - 1U);
+        rec->info.switches = (switch_counts[slot] * 1000U) / CPU_LOAD_PERIOD_MS;
+        switch_counts[slot] = 0;
+
+        if (strcmp(task_status[i].pcTaskName, configIDLE_TASK_NAME) == 0) {
+            total_x10 = smooth(total_x10, (uint16_t)(1000U - inst));
+        }
+    }
+
+    /* Forget deleted tasks */
+    for (uint32_t i = 0; i < record_count; ) {
+        if (!records[i].seen) {
+            records[i] = records[--record_count];
+        } else {
+            i++;
+        }
+    }
+
+    Cy_SysLib_ExitCriticalSection(state);
+}
+
+/*******************************************************************************
+ * Public Functions
+ ******************************************************************************/
+
+bool cpu_load_init(void)
+{
+    if (sample_timer != NULL) {
+        return true;
+    }
+
+    sample_timer = STATIC_TIMER_CREATE(sample, "CPU Load", pdMS_TO_TICKS(CPU_LOAD_PERIOD_MS),
+                                       true, NULL, sample_timer_cb);
+    if (sample_timer == NULL) {
+        return false;
+    }
+    return (xTimerStart(sample_timer, 0) == pdPASS);
+}
+
+void cpu_load_task_switched_in(uint32_t task_number)
+{
+    switch_counts[task_number & (CPU_LOAD_SWITCH_SLOTS - 1U)]++;
+}
+
+uint16_t cpu_load_get_total_x10(void)
+{
+    return total_x10;
+}
+
+uint32_t cpu_load_get_tasks(cpu_load_task_t *tasks, uint32_t max_tasks, uint32_t *total)
+{
+    uint32_t listed = 0;
+
+    if (tasks == NULL) {
+        max_tasks = 0;
+    }
+
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+
+    if (total != NULL) {
+        *total = record_count;
+    }
+
+    /* Insertion sort, highest load first; drop the rest */
+    for (uint32_t i = 0; i < record_count; i++) {
+        const cpu_load_task_t *t = &records[i].info;
+        uint32_t pos = listed;
+
+        while (pos > 0U && tasks[pos - 1U].load_x10 < t->load_x10) {
+            if (pos < max_tasks) {
+                tasks[pos] = tasks[pos - 1U];
+            }
+            pos--;
+        }
+        if (pos < max_tasks) {
+            tasks[pos] = *t;
+            if (listed < max_tasks) {
+                listed++;
+            }
+        }
+    }
+
+    Cy_SysLib_ExitCriticalSection(state);
+    return listed;
+}
+
+void cpu_load_fill_report(ipc_cpu_report_t *report)
+{
+    cpu_load_task_t tasks[IPC_CPU_MAX_TASKS];
+    uint32_t total = 0;
+
+    if (report == NULL) {
+        return;
+    }
+
+    memset(report, 0, sizeof(ipc_cpu_report_t));
+
+    uint32_t listed = cpu_load_get_tasks(tasks, IPC_CPU_MAX_TASKS, &total);
+    report->total_x10 = cpu_load_get_total_x10();
+    report->task_count = (uint8_t)total;
+    report->task_listed = (uint8_t)listed;
+
+    for (uint32_t i = 0; i < listed; i++) {
+        if (tasks[i].name != NULL) {
+            strncpy(report->tasks[i].name, tasks[i].name, IPC_MEM_TASK_NAME_LEN);
+        }
+        report->tasks[i].load_x10 = tasks[i].load_x10;
+        report->tasks[i].switches = (tasks[i].switches > 0xFFFFU) ?
+                                    0xFFFFU : (uint16_t)tasks[i].switches;
+    }
+}
+
+void cpu_load_set_remote(const ipc_cpu_report_t *report)
+{
+    if (report == NULL) {
+        return;
+    }
+
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+    memcpy(&remote_report, report, sizeof(ipc_cpu_report_t));
+    remote_valid = true;
+    Cy_SysLib_ExitCriticalSection(state);
+}
+
+bool cpu_load_get_remote(ipc_cpu_report_t *report)
+{
+    if (report == NULL || !remote_valid) {
+        return false;
+    }
+
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+    memcpy(report, &remote_report, sizeof(ipc_cpu_report_t));
+    Cy_SysLib_ExitCriticalSection(state);
+    return true;
+}
+
+void cpu_load_print(const char *core_name)
+{
+    cpu_load_task_t tasks[CPU_LOAD_MAX_TASKS];
+    uint32_t total = 0;
+    uint32_t listed = cpu_load_get_tasks(tasks, CPU_LOAD_MAX_TASKS, &total);
+    uint16_t load = cpu_load_get_total_x10();
+
+    printf("[%s] CPU load %u.%u%% (%lu tasks)\r\n", core_name,
+           load / 10U, load % 10U, (unsigned long)total);
+    for (uint32_t i = 0; i < listed; i++) {
+        printf("  %-16s %3u.%u%%  %5lu sw/s  prio %u\r\n",
+               (tasks[i].name != NULL) ? tasks[i].name : "?",
+               tasks[i].load_x10 / 10U, tasks[i].load_x10 % 10U,
+               (unsigned long)tasks[i].switches, tasks[i].priority);
+    }
+}
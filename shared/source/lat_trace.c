@@ -0,0 +1,434 @@
+/*******************************************************************************
+ * File: lat_trace.c
+ * Description: End-to-end sensor-to-pixel latency tracer (CM33 and CM55)
+ *
+ * The microsecond clock extends the 32-bit DWT cycle counter (enabled by
+ * boot_profile_start()) to 64 bits, so it stays monotonic across counter
+ * wraps as long as it is read once per wrap.
+ *
+ * Clock offset (CM33 - CM55) from the four sync timestamps t0..t3:
+ *   offset = ((t1 - t0) + (t2 - t3)) / 2
+ *   rtt    = (t3 - t0) - (t2 - t1)
+ * The error of the offset is at most rtt / 2.
+ ******************************************************************************/
+
+#include "lat_trace.h"
+#include "static_mem.h"
+#include "cy_pdl.h"
+#include "FreeRTOS.h"
+#include "timers.h"
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ * Static Variables
+ ******************************************************************************/
+
+/* Clock */
+static uint32_t clock_last_cycles = 0;
+static uint64_t clock_cycles = 0;
+static uint32_t clock_cycles_per_us = 0;
+
+/* Distributions */
+static lat_trace_stats_t stages[LAT_STAGE_COUNT];
+static uint32_t samples = 0;
+static uint32_t dropped = 0;
+
+static const uint32_t hist_limits_us[LAT_TRACE_HIST_BINS - 1U] = LAT_TRACE_HIST_LIMITS_US;
+
+/* Sample in flight (CM55 clock) */
+static bool     flight_active = false;
+static uint32_t flight_origin_us = 0;       /* CM33 read, CM55 clock */
+static bool     flight_has_origin = false;
+static int32_t  flight_stage = -1;          /* Last stage marked */
+static uint32_t flight_stage_us = 0;
+static uint32_t last_begun_id = 0;
+
+/* Clock sync (CM55) */
+static bool     sync_valid = false;
+static int32_t  sync_offset_us = 0;
+static uint32_t sync_rtt_us = 0;
+static uint32_t sync_age = 0;
+static uint32_t sync_pending_t0 = 0;
+static bool     sync_pending = false;
+static uint32_t sync_ticks = 0;
+
+static lat_trace_send_fn_t send_msg = NULL;
+static TimerHandle_t sync_timer = NULL;
+STATIC_TIMER_DEFINE(sync);
+
+static const char *const stage_names[LAT_STAGE_COUNT] = {
+    "publish", "read", "filter", "widget", "flush", "vsync", "total"
+};
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+
+static void record(lat_trace_stage_t stage, int32_t latency_us)
+{
+    lat_trace_stats_t *s = &stages[stage];
+    /* A negative cross-core figure is within the sync error - count as 0 */
+    uint32_t us = (latency_us > 0) ? (uint32_t)latency_us : 0U;
+    uint32_t bin = 0;
+
+    while (bin < (LAT_TRACE_HIST_BINS - 1U) && us >= hist_limits_us[bin]) {
+        bin++;
+    }
+    s->hist[bin]++;
+
+    if (s->count == 0U || us < s->min_us) {
+        s->min_us = us;
+    }
+    if (us > s->max_us) {
+        s->max_us = us;
+    }
+    s->total_us += us;
+    s->count++;
+}
+
+static bool stage_allowed(lat_trace_stage_t stage)
+{
+    switch (stage) {
+        case LAT_STAGE_FILTER:
+            return (flight_stage == (int32_t)LAT_STAGE_READ);
+        case LAT_STAGE_WIDGET:
+            return (flight_stage == (int32_t)LAT_STAGE_READ ||
+                    flight_stage == (int32_t)LAT_STAGE_FILTER);
+        case LAT_STAGE_FLUSH:
+            return (flight_stage == (int32_t)LAT_STAGE_WIDGET);
+        case LAT_STAGE_VSYNC:
+            return (flight_stage == (int32_t)LAT_STAGE_FLUSH);
+        default:
+            return false;
+    }
+}
+
+static void sync_timer_cb(TimerHandle_t timer)
+{
+    (void)timer;
+    ipc_msg_t msg;
+
+    if (send_msg == NULL) {
+        return;
+    }
+
+    /* Report first, so the sync below is not delayed behind it */
+    if (++sync_ticks >= LAT_TRACE_REPORT_EVERY) {
+        sync_ticks = 0;
+        IPC_MSG_INIT(&msg, IPC_CMD_LAT_REPORT);
+        lat_trace_fill_report((ipc_lat_report_t *)msg.data);
+        (void)send_msg(&msg);
+    }
+
+    IPC_MSG_INIT(&msg, IPC_CMD_LAT_SYNC);
+    ipc_lat_sync_t *sync = (ipc_lat_sync_t *)msg.data;
+
+    sync_pending_t0 = lat_trace_now_us();
+    sync->request_tx_us = sync_pending_t0;
+    sync_pending = send_msg(&msg);
+}
+
+/*******************************************************************************
+ * Public Functions
+ ******************************************************************************/
+
+uint32_t lat_trace_now_us(void)
+{
+    return (uint32_t)lat_trace_now_us64();
+}
+
+uint64_t lat_trace_now_us64(void)
+{
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+
+    if (clock_cycles_per_us == 0U) {
+        clock_cycles_per_us = (SystemCoreClock >= 1000000U) ? (SystemCoreClock / 1000000U) : 1U;
+        clock_last_cycles = DWT->CYCCNT;
+    }
+
+    uint32_t now = DWT->CYCCNT;
+    clock_cycles += (uint32_t)(now - clock_last_cycles);
+    clock_last_cycles = now;
+    uint64_t cycles = clock_cycles;
+
+    Cy_SysLib_ExitCriticalSection(state);
+    return cycles / clock_cycles_per_us;
+}
+
+bool lat_trace_init(lat_trace_send_fn_t send)
+{
+    send_msg = send;
+
+    if (sync_timer != NULL) {
+        return true;
+    }
+
+    (void)lat_trace_now_us();
+    sync_timer = STATIC_TIMER_CREATE(sync, "Lat Sync", pdMS_TO_TICKS(LAT_TRACE_SYNC_MS),
+                                     true, NULL, sync_timer_cb);
+    return (sync_timer != NULL);
+}
+
+bool lat_trace_enable(bool on)
+{
+    if (sync_timer == NULL) {
+        return false;
+    }
+
+    if (!on) {
+        sync_pending = false;
+        return (xTimerStop(sync_timer, 0) == pdPASS);
+    }
+
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+    sync_valid = false;
+    sync_pending = false;
+    sync_ticks = 0;
+    Cy_SysLib_ExitCriticalSection(state);
+    return (xTimerStart(sync_timer, 0) == pdPASS);
+}
+
+void lat_trace_begin(uint32_t id, uint32_t read_us, uint32_t publish_us)
+{
+    uint32_t now = lat_trace_now_us();
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+
+    if (id == 0U || id == last_begun_id) {
+        Cy_SysLib_ExitCriticalSection(state);
+        return;
+    }
+    last_begun_id = id;
+
+    if (flight_active) {
+        dropped++;
+    }
+
+    record(LAT_STAGE_PUBLISH, (int32_t)(publish_us - read_us));
+
+    flight_has_origin = sync_valid;
+    if (sync_valid) {
+        uint32_t publish_local = publish_us - (uint32_t)sync_offset_us;
+        flight_origin_us = read_us - (uint32_t)sync_offset_us;
+        record(LAT_STAGE_READ, (int32_t)(now - publish_local));
+    }
+
+    flight_active = true;
+    flight_stage = (int32_t)LAT_STAGE_READ;
+    flight_stage_us = now;
+
+    Cy_SysLib_ExitCriticalSection(state);
+}
+
+void lat_trace_mark(lat_trace_stage_t stage)
+{
+    if (!flight_active) {
+        return;
+    }
+
+    uint32_t now = lat_trace_now_us();
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+
+    if (flight_active && stage_allowed(stage)) {
+        record(stage, (int32_t)(now - flight_stage_us));
+        flight_stage = (int32_t)stage;
+        flight_stage_us = now;
+
+        if (stage == LAT_STAGE_VSYNC) {
+            if (flight_has_origin) {
+                record(LAT_STAGE_TOTAL, (int32_t)(now - flight_origin_us));
+            }
+            samples++;
+            flight_active = false;
+        }
+    }
+
+    Cy_SysLib_ExitCriticalSection(state);
+}
+
+void lat_trace_stamp_rx(ipc_msg_t *msg)
+{
+    if (msg == NULL) {
+        return;
+    }
+
+    ipc_lat_sync_t *sync = (ipc_lat_sync_t *)msg->data;
+
+    if (msg->cmd == IPC_CMD_LAT_SYNC) {
+        sync->request_rx_us = lat_trace_now_us();
+    } else if (msg->cmd == IPC_CMD_LAT_SYNC_REPLY) {
+        sync->reply_rx_us = lat_trace_now_us();
+    }
+}
+
+void lat_trace_sync_reply(const ipc_msg_t *request, ipc_msg_t *reply)
+{
+    if (request == NULL || reply == NULL) {
+        return;
+    }
+
+    IPC_MSG_INIT(reply, IPC_CMD_LAT_SYNC_REPLY);
+    memcpy(reply->data, request->data, sizeof(ipc_lat_sync_t));
+    ((ipc_lat_sync_t *)reply->data)->reply_tx_us = lat_trace_now_us();
+}
+
+void lat_trace_sync_done(const ipc_msg_t *reply)
+{
+    if (reply == NULL) {
+        return;
+    }
+
+    const ipc_lat_sync_t *sync = (const ipc_lat_sync_t *)reply->data;
+
+    /* Only the reply to the last request; late ones have a stale t0 */
+    if (!sync_pending || sync->request_tx_us != sync_pending_t0) {
+        return;
+    }
+    sync_pending = false;
+
+    int32_t out = (int32_t)(sync->request_rx_us - sync->request_tx_us);
+    int32_t back = (int32_t)(sync->reply_tx_us - sync->reply_rx_us);
+    int32_t total = (int32_t)(sync->reply_rx_us - sync->request_tx_us);
+    int32_t remote = (int32_t)(sync->reply_tx_us - sync->request_rx_us);
+
+    if (total < 0 || remote < 0 || remote > total) {
+        return;
+    }
+
+    uint32_t rtt = (uint32_t)(total - remote);
+    int32_t offset = (int32_t)(((int64_t)out + (int64_t)back) / 2);
+
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+
+    sync_age++;
+    if (!sync_valid || rtt <= sync_rtt_us || sync_age >= LAT_TRACE_SYNC_WINDOW) {
+        sync_offset_us = offset;
+        sync_rtt_us = rtt;
+        sync_age = 0;
+        sync_valid = true;
+    }
+
+    Cy_SysLib_ExitCriticalSection(state);
+}
+
+bool lat_trace_get_stage(lat_trace_stage_t stage, lat_trace_stats_t *stats)
+{
+    if (stage >= LAT_STAGE_COUNT || stats == NULL) {
+        return false;
+    }
+
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+    memcpy(stats, &stages[stage], sizeof(lat_trace_stats_t));
+    Cy_SysLib_ExitCriticalSection(state);
+    return true;
+}
+
+void lat_trace_get_counts(uint32_t *samples_out, uint32_t *dropped_out)
+{
+    if (samples_out != NULL) {
+        *samples_out = samples;
+    }
+    if (dropped_out != NULL) {
+        *dropped_out = dropped;
+    }
+}
+
+bool lat_trace_get_offset(int32_t *offset_us, uint32_t *rtt_us)
+{
+    if (!sync_valid) {
+        return false;
+    }
+    if (offset_us != NULL) {
+        *offset_us = sync_offset_us;
+    }
+    if (rtt_us != NULL) {
+        *rtt_us = sync_rtt_us;
+    }
+    return true;
+}
+
+void lat_trace_reset(void)
+{
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+    memset(stages, 0, sizeof(stages));
+    samples = 0;
+    dropped = 0;
+    flight_active = false;
+    Cy_SysLib_ExitCriticalSection(state);
+}
+
+void lat_trace_fill_report(ipc_lat_report_t *report)
+{
+    lat_trace_stats_t s;
+
+    if (report == NULL) {
+        return;
+    }
+
+    memset(report, 0, sizeof(ipc_lat_report_t));
+    report->samples = samples;
+    report->dropped = dropped;
+
+    if (sync_valid) {
+        report->clock_offset_us = sync_offset_us;
+        report->sync_rtt_us = (sync_rtt_us > 0xFFFFU) ? 0xFFFFU : (uint16_t)sync_rtt_us;
+    }
+
+    for (uint32_t i = 0; i < LAT_STAGE_COUNT && i < IPC_LAT_STAGE_COUNT; i++) {
+        (void)lat_trace_get_stage((lat_trace_stage_t)i, &s);
+        report->stages[i].min_us = s.min_us;
+        report->stages[i].avg_us = (s.count > 0U) ? (uint32_t)(s.total_us / s.count) : 0U;
+        report->stages[i].max_us = s.max_us;
+    }
+}
+
+void lat_trace_print(const char *core_name)
+{
+    lat_trace_stats_t s;
+
+    printf("[%s] Sensor-to-pixel latency: %lu samples, %lu dropped\r\n", core_name,
+           (unsigned long)samples, (unsigned long)dropped);
+    if (sync_valid) {
+        printf("  clock offset %ldus (rtt %luus)\r\n", (long)sync_offset_us,
+               (unsigned long)sync_rtt_us);
+    } else {
+        printf("  clock offset not synced - cross-core stages skipped\r\n");
+    }
+
+    printf("  %-8s %7s %8s %8s %8s   <.5 <1 <2 <5 <10 <20 <50 <100 >=100ms\r\n",
+           "stage", "count", "min", "avg", "max");
+    for (uint32_t i = 0; i < LAT_STAGE_COUNT; i++) {
+        (void)lat_trace_get_stage((lat_trace_stage_t)i, &s);
+        printf("  %-8s %7lu %6luus %6luus %6luus  ", stage_names[i],
+               (unsigned long)s.count, (unsigned long)s.min_us,
+               (unsigned long)((s.count > 0U) ? (s.total_us / s.count) : 0U),
+               (unsigned long)s.max_us);
+        for (uint32_t b = 0; b < LAT_TRACE_HIST_BINS; b++) {
+            printf(" %lu", (unsigned long)s.hist[b]);
+        }
+        printf("\r\n");
+    }
+}
+
+void lat_trace_print_report(const char *core_name, const ipc_lat_report_t *report)
+{
+    if (report == NULL) {
+        return;
+    }
+
+    printf("[%s] Sensor-to-pixel latency: %lu samples, %lu dropped, "
+           "offset %ldus (rtt %uus)\r\n", core_name,
+           (unsigned long)report->samples, (unsigned long)report->dropped,
+           (long)report->clock_offset_us, report->sync_rtt_us);
+    for (uint32_t i = 0; i < IPC_LAT_STAGE_COUNT && i < LAT_STAGE_COUNT; i++) {
+        printf("  %-8s min %6luus  avg %6luus  max %6luus\r\n", stage_names[i],
+               (unsigned long)report->stages[i].min_us,
+               (unsigned long)report->stages[i].avg_us,
+               (unsigned long)report->stages[i].max_us);
+    }
+}
+
+const char *lat_trace_stage_name(lat_trace_stage_t stage)
+{
+    return (stage < LAT_STAGE_COUNT) ? stage_names[stage] : "?";
+}
@@ -0,0 +1,329 @@
+/*******************************************************************************
+ * File: mem_stats.c
+ * Description: Runtime memory accounting (CM33 and CM55)
+ *
+ * Heap figures come from the C library's mallinfo(); heap_3 makes FreeRTOS
+ * allocate through malloc() too, so one heap covers the kernel objects,
+ * the application and (with LV_STDLIB_CLIB) LVGL. Task stacks come from
+ * uxTaskGetSystemState() (configUSE_TRACE_FACILITY = 1).
+ ******************************************************************************/
+
+#include "mem_stats.h"
+#include "cy_pdl.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <malloc.h>
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ * Static Variables
+ ******************************************************************************/
+
+typedef struct {
+    const char *name;
+    uint32_t   *base;
+    uint32_t    slot_size;
+    uint8_t     slot_count;
+    bool        painted;
+} region_entry_t;
+
+static region_entry_t regions[MEM_STATS_MAX_REGIONS];
+static uint32_t region_count = 0;
+
+static uint32_t heap_peak = 0;
+
+static TaskStatus_t task_status[MEM_STATS_MAX_TASKS];
+
+static ipc_mem_report_t remote_report;
+static bool remote_valid = false;
+
+#if defined(__GNUC__) && !defined(__ARMCC_VERSION)
+/* Heap bounds from the linker script */
+extern uint8_t __HeapBase;
+extern uint8_t __HeapLimit;
+#endif
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+
+static void region_sync_cache(const region_entry_t *entry)
+{
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+    /* Clean too: the owner may have CPU-written lines still in the cache */
+    SCB_CleanInvalidateDCache_by_Addr(entry->base,
+                                      (int32_t)(entry->slot_size * entry->slot_count));
+#else
+    (void)entry;
+#endif
+}
+
+/* Bytes used in one slot: scan back from the end for the first word
+ * that no longer holds the paint pattern */
+static uint32_t slot_high_water(const uint32_t *slot, uint32_t slot_size)
+{
+    uint32_t words = slot_size / sizeof(uint32_t);
+
+    while (words > 0U && slot[words - 1U] == MEM_STATS_PAINT_WORD) {
+        words--;
+    }
+    return words * sizeof(uint32_t);
+}
+
+/*******************************************************************************
+ * Heap
+ ******************************************************************************/
+
+void mem_stats_get_heap(mem_stats_heap_t *heap)
+{
+    if (heap == NULL) {
+        return;
+    }
+
+    memset(heap, 0, sizeof(mem_stats_heap_t));
+
+#if defined(__GNUC__) && !defined(__ARMCC_VERSION)
+    struct mallinfo mi = mallinfo();
+
+    heap->total = (uint32_t)(&__HeapLimit - &__HeapBase);
+    heap->arena = (uint32_t)mi.arena;
+    heap->used = (uint32_t)mi.uordblks;
+    heap->arena_free = (uint32_t)mi.fordblks;
+
+    /* Full newlib tracks the true maximum; newlib-nano leaves it 0 */
+    if ((uint32_t)mi.usmblks > heap_peak) {
+        heap_peak = (uint32_t)mi.usmblks;
+    }
+#endif
+
+    if (heap->used > heap_peak) {
+        heap_peak = heap->used;
+    }
+    heap->peak = heap_peak;
+
+    if (heap->arena > 0U) {
+        heap->frag_pct = (uint8_t)((heap->arena_free * 100U) / heap->arena);
+    }
+}
+
+/*******************************************************************************
+ * Regions
+ ******************************************************************************/
+
+bool mem_stats_region_add(const char *name, void *base, uint32_t slot_size,
+                          uint8_t slot_count, bool paint)
+{
+    if (base == NULL || slot_count == 0U || region_count >= MEM_STATS_MAX_REGIONS) {
+        return false;
+    }
+
+    region_entry_t *entry = &regions[region_count];
+    entry->name = name;
+    entry->base = (uint32_t *)base;
+    entry->slot_size = slot_size & ~(sizeof(uint32_t) - 1U);
+    entry->slot_count = slot_count;
+    entry->painted = paint;
+
+    if (paint) {
+        uint32_t words = (entry->slot_size * slot_count) / sizeof(uint32_t);
+        for (uint32_t i = 0; i < words; i++) {
+            entry->base[i] = MEM_STATS_PAINT_WORD;
+        }
+        region_sync_cache(entry);
+    }
+
+    region_count++;
+    return true;
+}
+
+uint32_t mem_stats_region_count(void)
+{
+    return region_count;
+}
+
+bool mem_stats_get_region(uint32_t index, mem_stats_region_t *region)
+{
+    if (index >= region_count || region == NULL) {
+        return false;
+    }
+
+    const region_entry_t *entry = &regions[index];
+
+    region->name = entry->name;
+    region->slot_size = entry->slot_size;
+    region->slot_count = entry->slot_count;
+    region->size = entry->slot_size * entry->slot_count;
+    region->painted = entry->painted;
+    region->high_water = entry->slot_size;
+
+    if (entry->painted) {
+        region_sync_cache(entry);
+        region->high_water = 0;
+        for (uint8_t s = 0; s < entry->slot_count; s++) {
+            const uint32_t *slot = entry->base + (s * entry->slot_size) / sizeof(uint32_t);
+            uint32_t used = slot_high_water(slot, entry->slot_size);
+            if (used > region->high_water) {
+                region->high_water = used;
+            }
+        }
+    }
+    return true;
+}
+
+/*******************************************************************************
+ * Task Stacks
+ ******************************************************************************/
+
+uint32_t mem_stats_get_tasks(mem_stats_task_t *tasks, uint32_t max_tasks,
+                             uint32_t *total)
+{
+    uint32_t count;
+    uint32_t listed = 0;
+
+    /* task_status[] is shared between callers - keep other tasks out */
+    vTaskSuspendAll();
+
+    count = (uint32_t)uxTaskGetNumberOfTasks();
+    if (total != NULL) {
+        *total = count;
+    }
+
+    /* Returns 0 if the array is too small for all tasks */
+    count = (uint32_t)uxTaskGetSystemState(task_status, MEM_STATS_MAX_TASKS, NULL);
+
+    for (uint32_t i = 0; i < count && tasks != NULL; i++) {
+        mem_stats_task_t t = {
+            .name = task_status[i].pcTaskName,
+            .stack_free = (uint32_t)task_status[i].usStackHighWaterMark * sizeof(StackType_t),
+            .priority = (uint8_t)task_status[i].uxCurrentPriority,
+        };
+
+        /* Insertion sort, lowest free stack first; drop the rest */
+        uint32_t pos = listed;
+        while (pos > 0U && tasks[pos - 1U].stack_free > t.stack_free) {
+            if (pos < max_tasks) {
+                tasks[pos] = tasks[pos - 1U];
+            }
+            pos--;
+        }
+        if (pos < max_tasks) {
+            tasks[pos] = t;
+            if (listed < max_tasks) {
+                listed++;
+            }
+        }
+    }
+
+    (void)xTaskResumeAll();
+
+    return listed;
+}
+
+/*******************************************************************************
+ * IPC Report
+ ******************************************************************************/
+
+void mem_stats_fill_report(ipc_mem_report_t *report)
+{
+    mem_stats_heap_t heap;
+    mem_stats_task_t tasks[IPC_MEM_MAX_TASKS];
+    uint32_t total = 0;
+
+    if (report == NULL) {
+        return;
+    }
+
+    memset(report, 0, sizeof(ipc_mem_report_t));
+
+    mem_stats_get_heap(&heap);
+    report->heap_total = heap.total;
+    report->heap_used = heap.used;
+    report->heap_peak = heap.peak;
+    report->heap_arena = heap.arena;
+    report->frag_pct = heap.frag_pct;
+
+    uint32_t listed = mem_stats_get_tasks(tasks, IPC_MEM_MAX_TASKS, &total);
+    report->task_count = (uint8_t)total;
+    report->task_listed = (uint8_t)listed;
+
+    for (uint32_t i = 0; i < listed; i++) {
+        strncpy(report->tasks[i].name, tasks[i].name, IPC_MEM_TASK_NAME_LEN);
+        report->tasks[i].stack_free = tasks[i].stack_free;
+    }
+}
+
+void mem_stats_set_remote(const ipc_mem_report_t *report)
+{
+    if (report == NULL) {
+        return;
+    }
+
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+    memcpy(&remote_report, report, sizeof(ipc_mem_report_t));
+    remote_valid = true;
+    Cy_SysLib_ExitCriticalSection(state);
+}
+
+bool mem_stats_get_remote(ipc_mem_report_t *report)
+{
+    if (report == NULL || !remote_valid) {
+        return false;
+    }
+
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+    memcpy(report, &remote_report, sizeof(ipc_mem_report_t));
+    Cy_SysLib_ExitCriticalSection(state);
+    return true;
+}
+
+/*******************************************************************************
+ * Console Output
+ ******************************************************************************/
+
+void mem_stats_print(const char *core_name)
+{
+    mem_stats_heap_t heap;
+    mem_stats_region_t region;
+    mem_stats_task_t tasks[MEM_STATS_MAX_TASKS];
+    uint32_t total = 0;
+
+    mem_stats_get_heap(&heap);
+    printf("[%s] Heap: %lu/%lu B used, peak %lu, arena %lu, frag %u%%\r\n",
+           core_name, (unsigned long)heap.used, (unsigned long)heap.total,
+           (unsigned long)heap.peak, (unsigned long)heap.arena, heap.frag_pct);
+
+    for (uint32_t i = 0; mem_stats_get_region(i, &region); i++) {
+        if (region.painted) {
+            printf("  %-10s %7lu B  (%u x %lu, high-water %lu)\r\n", region.name,
+                   (unsigned long)region.size, region.slot_count,
+                   (unsigned long)region.slot_size, (unsigned long)region.high_water);
+        } else {
+            printf("  %-10s %7lu B\r\n", region.name, (unsigned long)region.size);
+        }
+    }
+
+    uint32_t listed = mem_stats_get_tasks(tasks, MEM_STATS_MAX_TASKS, &total);
+    printf("  Stack free (min) - %lu tasks:\r\n", (unsigned long)total);
+    for (uint32_t i = 0; i < listed; i++) {
+        printf("    %-16s %6lu B\r\n", tasks[i].name, (unsigned long)tasks[i].stack_free);
+    }
+}
+
+void mem_stats_print_report(const char *core_name, const ipc_mem_report_t *report)
+{
+    if (report == NULL) {
+        return;
+    }
+
+    printf("[%s] Heap: %lu/%lu B used, peak %lu, arena %lu, frag %u%%\r\n",
+           core_name, (unsigned long)report->heap_used, (unsigned long)report->heap_total,
+           (unsigned long)report->heap_peak, (unsigned long)report->heap_arena,
+           report->frag_pct);
+
+    printf("  Stack free (min) - %u tasks:\r\n", report->task_count);
+    for (uint32_t i = 0; i < report->task_listed && i < IPC_MEM_MAX_TASKS; i++) {
+        printf("    %-8.8s %6lu B\r\n", report->tasks[i].name,
+               (unsigned long)report->tasks[i].stack_free);
+    }
+}
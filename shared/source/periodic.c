@@ -0,0 +1,267 @@
+/*******************************************************************************
+ * File: periodic.c
+ * Description: Periodic task timing - jitter, execution time, deadline misses
+ *              (CM33 and CM55)
+ *
+ * Execution times come from the DWT cycle counter (enabled by
+ * boot_profile_start()); it wraps after ~10 s at 400 MHz, well above any
+ * task period here. The counter stops while the core sleeps in tickless
+ * idle, which is where a periodic task spends its wait, so release times
+ * come from tick_clock instead.
+ *
+ * The statistics are written in place into a .noinit record. The first
+ * periodic_init() after reset moves a valid record left by the previous
+ * boot aside before starting a fresh one.
+ ******************************************************************************/
+
+#include "periodic.h"
+#include "tick_clock.h"
+#include "cy_pdl.h"
+#include "task.h"
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ * Static Variables
+ ******************************************************************************/
+
+#define PERIODIC_RECORD_MAGIC   (0x50455244UL)  /* "PERD" */
+
+typedef struct {
+    uint32_t magic;
+    uint32_t count;
+    periodic_stats_t tasks[PERIODIC_MAX_TASKS];
+} periodic_record_t;
+
+/* Survives warm resets (watchdog, fault, software reset) */
+CY_NOINIT static periodic_record_t record;
+
+static periodic_record_t previous;
+static bool previous_valid = false;
+static bool record_ready = false;
+
+static const uint32_t hist_limits_us[PERIODIC_HIST_BINS - 1U] = PERIODIC_HIST_LIMITS_US;
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+
+static inline uint32_t cycles_to_us(uint32_t cycles)
+{
+    uint32_t per_us = SystemCoreClock / 1000000U;
+    return cycles / ((per_us > 0U) ? per_us : 1U);
+}
+
+static void record_prepare(void)
+{
+    if (record_ready) {
+        return;
+    }
+
+    if (record.magic == PERIODIC_RECORD_MAGIC && record.count <= PERIODIC_MAX_TASKS) {
+        memcpy(&previous, &record, sizeof(periodic_record_t));
+        previous_valid = true;
+    }
+
+    memset(&record, 0, sizeof(periodic_record_t));
+    record.magic = PERIODIC_RECORD_MAGIC;
+    record_ready = true;
+}
+
+static void record_exec(periodic_stats_t *s, uint32_t exec_us)
+{
+    s->exec_last_us = exec_us;
+    s->exec_total_us += exec_us;
+    if (exec_us > s->exec_max_us) {
+        s->exec_max_us = exec_us;
+    }
+    if (s->deadline_us > 0U && exec_us > s->deadline_us) {
+        s->misses++;
+    }
+}
+
+static void record_jitter(periodic_stats_t *s, int32_t jitter_us)
+{
+    uint32_t mag = (jitter_us < 0) ? (uint32_t)(-jitter_us) : (uint32_t)jitter_us;
+    uint32_t bin = 0;
+
+    while (bin < (PERIODIC_HIST_BINS - 1U) && mag >= hist_limits_us[bin]) {
+        bin++;
+    }
+    s->jitter_hist[bin]++;
+
+    if (s->releases == 0U || jitter_us < s->jitter_min_us) {
+        s->jitter_min_us = jitter_us;
+    }
+    if (s->releases == 0U || jitter_us > s->jitter_max_us) {
+        s->jitter_max_us = jitter_us;
+    }
+}
+
+static void print_record(const char *core_name, const char *title,
+                         const periodic_record_t *rec)
+{
+    printf("[%s] Periodic tasks (%s):\r\n", core_name, title);
+    printf("  %-12s %7s %8s %6s %6s %8s %8s %8s %8s\r\n", "name", "period",
+           "cycles", "miss", "ovrun", "exec avg", "exec max", "jit min", "jit max");
+
+    for (uint32_t i = 0; i < rec->count; i++) {
+        const periodic_stats_t *s = &rec->tasks[i];
+        uint32_t cycles = (s->releases > 0U) ? s->releases : 1U;
+
+        printf("  %-12.*s %5luus %8lu %6lu %6lu %6luus %6luus %6ldus %6ldus\r\n",
+               (int)PERIODIC_NAME_LEN, s->name, (unsigned long)s->period_us,
+               (unsigned long)s->releases, (unsigned long)s->misses,
+               (unsigned long)s->overruns,
+               (unsigned long)(s->exec_total_us / cycles), (unsigned long)s->exec_max_us,
+               (long)s->jitter_min_us, (long)s->jitter_max_us);
+
+        if (s->period_us > 0U) {
+            printf("    |jitter| <50us %lu, <100 %lu, <250 %lu, <500 %lu, <1ms %lu, "
+                   "<2ms %lu, <5ms %lu, >=5ms %lu\r\n",
+                   (unsigned long)s->jitter_hist[0], (unsigned long)s->jitter_hist[1],
+                   (unsigned long)s->jitter_hist[2], (unsigned long)s->jitter_hist[3],
+                   (unsigned long)s->jitter_hist[4], (unsigned long)s->jitter_hist[5],
+                   (unsigned long)s->jitter_hist[6], (unsigned long)s->jitter_hist[7]);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Public Functions
+ ******************************************************************************/
+
+bool periodic_init(periodic_task_t *pt, const char *name, uint32_t period_ms,
+                   uint32_t deadline_ms)
+{
+    if (pt == NULL) {
+        return false;
+    }
+
+    memset(pt, 0, sizeof(periodic_task_t));
+
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+
+    record_prepare();
+    if (record.count < PERIODIC_MAX_TASKS) {
+        pt->stats = &record.tasks[record.count++];
+    }
+
+    Cy_SysLib_ExitCriticalSection(state);
+
+    if (pt->stats == NULL) {
+        return false;
+    }
+
+    strncpy(pt->stats->name, (name != NULL) ? name : "?", PERIODIC_NAME_LEN);
+    pt->stats->period_us = period_ms * 1000U;
+    pt->stats->deadline_us = ((deadline_ms > 0U) ? deadline_ms : period_ms) * 1000U;
+    pt->period_ticks = pdMS_TO_TICKS(period_ms);
+    return true;
+}
+
+void periodic_wait(periodic_task_t *pt)
+{
+    if (pt == NULL || pt->stats == NULL || pt->period_ticks == 0U) {
+        return;
+    }
+
+    periodic_stats_t *s = pt->stats;
+
+    if (!pt->started) {
+        pt->started = true;
+        pt->last_wake = xTaskGetTickCount();
+        vTaskDelayUntil(&pt->last_wake, pt->period_ticks);
+        pt->release_us = tick_clock_now_us();
+        pt->release_cycles = DWT->CYCCNT;
+        return;
+    }
+
+    record_exec(s, cycles_to_us(DWT->CYCCNT - pt->release_cycles));
+
+    if (xTaskDelayUntil(&pt->last_wake, pt->period_ticks) == pdFALSE) {
+        s->overruns++;
+    }
+
+    uint32_t now_us = tick_clock_now_us();
+    int32_t jitter_us = (int32_t)(now_us - pt->release_us) - (int32_t)s->period_us;
+
+    record_jitter(s, jitter_us);
+    pt->release_us = now_us;
+    pt->release_cycles = DWT->CYCCNT;
+    s->releases++;
+}
+
+void periodic_set_period(periodic_task_t *pt, uint32_t period_ms)
+{
+    if (pt == NULL || pt->stats == NULL || period_ms == 0U ||
+        pt->stats->period_us == period_ms * 1000U) {
+        return;
+    }
+
+    bool same_deadline = (pt->stats->deadline_us == pt->stats->period_us);
+
+    pt->stats->period_us = period_ms * 1000U;
+    if (same_deadline) {
+        pt->stats->deadline_us = pt->stats->period_us;
+    }
+    pt->period_ticks = pdMS_TO_TICKS(period_ms);
+    pt->started = false;
+}
+
+void periodic_begin(periodic_task_t *pt)
+{
+    if (pt != NULL) {
+        pt->release_cycles = DWT->CYCCNT;
+        pt->started = true;
+    }
+}
+
+void periodic_end(periodic_task_t *pt)
+{
+    if (pt == NULL || pt->stats == NULL || !pt->started) {
+        return;
+    }
+
+    record_exec(pt->stats, cycles_to_us(DWT->CYCCNT - pt->release_cycles));
+    pt->stats->releases++;
+    pt->started = false;
+}
+
+bool periodic_get(uint32_t index, bool previous_boot, periodic_stats_t *stats)
+{
+    const periodic_record_t *rec = previous_boot ? &previous : &record;
+
+    if (stats == NULL || (previous_boot && !previous_valid) || index >= rec->count) {
+        return false;
+    }
+
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+    memcpy(stats, &rec->tasks[index], sizeof(periodic_stats_t));
+    Cy_SysLib_ExitCriticalSection(state);
+    return true;
+}
+
+uint32_t periodic_count(bool previous_boot)
+{
+    if (previous_boot) {
+        return previous_valid ? previous.count : 0U;
+    }
+    return record_ready ? record.count : 0U;
+}
+
+void periodic_print(const char *core_name)
+{
+    if (record_ready) {
+        print_record(core_name, "this boot", &record);
+    }
+}
+
+void periodic_print_previous(const char *core_name)
+{
+    if (previous_valid) {
+        print_record(core_name, "previous boot", &previous);
+    } else {
+        printf("[%s] Periodic tasks: no record from previous boot\r\n", core_name);
+    }
+}
@@ -0,0 +1,166 @@
+/*******************************************************************************
+ * File: static_mem.c
+ * Description: Static kernel objects and memory map report (CM33 and CM55)
+ *
+ * Objects are identified by their control block, so deleting and recreating
+ * one in the same storage (e.g. a module deinit/init) updates its entry
+ * instead of adding a new one.
+ ******************************************************************************/
+
+#include "static_mem.h"
+#include "mem_stats.h"
+#include "cy_pdl.h"
+#include <stdio.h>
+
+/*******************************************************************************
+ * Static Variables
+ ******************************************************************************/
+
+static static_mem_object_t objects[STATIC_MEM_MAX_OBJECTS];
+static uint32_t object_count = 0;
+
+static bool sealed = false;
+static uint32_t sealed_heap_used = 0;
+
+static const char *const kind_names[STATIC_MEM_KIND_COUNT] = {
+    "task", "queue", "mutex", "timer"
+};
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+
+static void record(const char *name, const void *object, uint32_t bytes,
+                   static_mem_kind_t kind)
+{
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+    static_mem_object_t *entry = NULL;
+
+    for (uint32_t i = 0; i < object_count; i++) {
+        if (objects[i].object == object) {
+            entry = &objects[i];
+            break;
+        }
+    }
+    if (entry == NULL && object_count < STATIC_MEM_MAX_OBJECTS) {
+        entry = &objects[object_count++];
+    }
+    if (entry != NULL) {
+        entry->name = name;
+        entry->object = object;
+        entry->bytes = bytes;
+        entry->kind = kind;
+    }
+
+    Cy_SysLib_ExitCriticalSection(state);
+}
+
+/*******************************************************************************
+ * Public Functions
+ ******************************************************************************/
+
+TaskHandle_t static_mem_task_create(TaskFunction_t fn, const char *name,
+                                    uint32_t stack_words, void *param,
+                                    UBaseType_t priority, StackType_t *stack,
+                                    StaticTask_t *tcb)
+{
+    TaskHandle_t handle = xTaskCreateStatic(fn, name, stack_words, param,
+                                            priority, stack, tcb);
+    if (handle != NULL) {
+        record(name, tcb, (stack_words * sizeof(StackType_t)) + sizeof(StaticTask_t),
+               STATIC_MEM_TASK);
+    }
+    return handle;
+}
+
+QueueHandle_t static_mem_queue_create(const char *name, uint32_t length,
+                                      uint32_t item_size, uint8_t *storage,
+                                      StaticQueue_t *queue)
+{
+    QueueHandle_t handle = xQueueCreateStatic(length, item_size, storage, queue);
+    if (handle != NULL) {
+        record(name, queue, (length * item_size) + sizeof(StaticQueue_t),
+               STATIC_MEM_QUEUE);
+    }
+    return handle;
+}
+
+SemaphoreHandle_t static_mem_mutex_create(const char *name, StaticSemaphore_t *mutex)
+{
+    SemaphoreHandle_t handle = xSemaphoreCreateMutexStatic(mutex);
+    if (handle != NULL) {
+        record(name, mutex, sizeof(StaticSemaphore_t), STATIC_MEM_MUTEX);
+    }
+    return handle;
+}
+
+TimerHandle_t static_mem_timer_create(const char *name, TickType_t period,
+                                      bool auto_reload, void *timer_id,
+                                      TimerCallbackFunction_t callback,
+                                      StaticTimer_t *timer)
+{
+    TimerHandle_t handle = xTimerCreateStatic(name, period,
+                                              auto_reload ? pdTRUE : pdFALSE,
+                                              timer_id, callback, timer);
+    if (handle != NULL) {
+        record(name, timer, sizeof(StaticTimer_t), STATIC_MEM_TIMER);
+    }
+    return handle;
+}
+
+bool static_mem_get(uint32_t index, static_mem_object_t *object)
+{
+    if (object == NULL || index >= object_count) {
+        return false;
+    }
+
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+    *object = objects[index];
+    Cy_SysLib_ExitCriticalSection(state);
+    return true;
+}
+
+uint32_t static_mem_count(void)
+{
+    return object_count;
+}
+
+void static_mem_seal(void)
+{
+    mem_stats_heap_t heap;
+
+    mem_stats_get_heap(&heap);
+    sealed_heap_used = heap.used;
+    sealed = true;
+}
+
+void static_mem_print(const char *core_name)
+{
+    uint32_t totals[STATIC_MEM_KIND_COUNT] = { 0 };
+    uint32_t total = 0;
+    static_mem_object_t obj;
+
+    printf("[%s] Static kernel objects (%lu):\r\n", core_name,
+           (unsigned long)object_count);
+
+    for (uint32_t i = 0; static_mem_get(i, &obj); i++) {
+        printf("  %-5s %-16s %6lu B  @%p\r\n", kind_names[obj.kind],
+               (obj.name != NULL) ? obj.name : "?",
+               (unsigned long)obj.bytes, obj.object);
+        totals[obj.kind] += obj.bytes;
+        total += obj.bytes;
+    }
+
+    printf("  total %lu B (tasks %lu, queues %lu, mutexes %lu, timers %lu)\r\n",
+           (unsigned long)total, (unsigned long)totals[STATIC_MEM_TASK],
+           (unsigned long)totals[STATIC_MEM_QUEUE], (unsigned long)totals[STATIC_MEM_MUTEX],
+           (unsigned long)totals[STATIC_MEM_TIMER]);
+
+    if (sealed) {
+        mem_stats_heap_t heap;
+        mem_stats_get_heap(&heap);
+        printf("  heap since boot: %ld B (sealed at %lu B)\r\n",
+               (long)heap.used - (long)sealed_heap_used,
+               (unsigned long)sealed_heap_used);
+    }
+}
@@ -0,0 +1,70 @@
+/*******************************************************************************
+ * File: tick_clock.c
+ * Description: Microsecond clock that keeps counting in tickless sleep
+ *              (CM33 and CM55)
+ *
+ * SysTick counts down from LOAD to 0 once per tick and is reloaded by the
+ * port after a tickless sleep, so LOAD - VAL is the time into the current
+ * tick. A wrap whose interrupt is still pending (PENDSTSET) has not been
+ * added to the tick count yet and is added here.
+ ******************************************************************************/
+
+#include "tick_clock.h"
+#include "cy_pdl.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define TICK_CLOCK_TICK_US      (1000000ULL / configTICK_RATE_HZ)
+
+/*******************************************************************************
+ * Static Variables
+ ******************************************************************************/
+
+static TickType_t last_ticks = 0;
+static uint32_t tick_wraps = 0;
+static uint64_t last_us = 0;
+
+/*******************************************************************************
+ * Public Functions
+ ******************************************************************************/
+
+uint64_t tick_clock_now_us64(void)
+{
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+
+    TickType_t ticks = xTaskGetTickCountFromISR();
+    uint32_t load = SysTick->LOAD;
+    uint32_t val = SysTick->VAL;
+    uint64_t sub_us = 0U;
+
+    if ((SysTick->CTRL & SysTick_CTRL_ENABLE_Msk) != 0U && load != 0U) {
+        if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0U) {
+            /* Wrapped, tick not counted yet: VAL is read after the wrap */
+            val = SysTick->VAL;
+            sub_us = TICK_CLOCK_TICK_US;
+        }
+        sub_us += ((uint64_t)(load - val) * TICK_CLOCK_TICK_US) / ((uint64_t)load + 1U);
+    }
+
+    if (ticks < last_ticks) {
+        tick_wraps++;
+    }
+    last_ticks = ticks;
+
+    uint64_t total_ticks = ((uint64_t)tick_wraps << 32) | (uint64_t)ticks;
+    uint64_t now_us = total_ticks * TICK_CLOCK_TICK_US + sub_us;
+
+    /* The sub-tick part can run ahead of a tick stepped after sleep */
+    if (now_us < last_us) {
+        now_us = last_us;
+    }
+    last_us = now_us;
+
+    Cy_SysLib_ExitCriticalSection(state);
+    return now_us;
+}
+
+uint32_t tick_clock_now_us(void)
+{
+    return (uint32_t)tick_clock_now_us64();
+}
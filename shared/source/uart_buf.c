@@ -0,0 +1,256 @@
+/*******************************************************************************
+ * File: uart_buf.c
+ * Description: Ring-buffered, non-blocking debug UART output (CM33 and CM55)
+ *
+ * The ring is shared by every writer and the drain task; all access is in
+ * short critical sections (a memcpy on write, at most one TX FIFO worth of
+ * register writes on drain).
+ *
+ * The drain task polls the FIFO instead of using the SCB TX interrupt:
+ * both cores print through the same SCB, and its interrupt mask is one
+ * register, so neither core can own the TX interrupt.
+ ******************************************************************************/
+
+#include "uart_buf.h"
+#include "static_mem.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ * Static Variables
+ ******************************************************************************/
+
+#define UART_BUF_MASK   (UART_BUF_SIZE - 1U)
+
+static char ring[UART_BUF_SIZE];
+static volatile uint32_t ring_head = 0;     /* Next write (free running) */
+static volatile uint32_t ring_tail = 0;     /* Next send (free running) */
+static bool cr_sent = false;                /* CR of the LF at the tail is out */
+
+static CySCB_Type *uart_base = NULL;
+static uart_buf_policy_t policy = UART_BUF_DEFAULT_POLICY;
+static uart_buf_stats_t stats;
+
+static TaskHandle_t drain_task_handle = NULL;
+STATIC_TASK_DEFINE(uart_drain, UART_BUF_TASK_STACK);
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+
+/* Call inside a critical section */
+static bool ring_put(const char *data, uint32_t len)
+{
+    uint32_t used = ring_head - ring_tail;
+    if (len > (UART_BUF_SIZE - used)) {
+        return false;
+    }
+
+    uint32_t pos = ring_head & UART_BUF_MASK;
+    uint32_t first = UART_BUF_SIZE - pos;
+    if (first > len) {
+        first = len;
+    }
+    memcpy(&ring[pos], data, first);
+    memcpy(ring, &data[first], len - first);
+
+    ring_head += len;
+    stats.bytes_written += len;
+    if ((used + len) > stats.high_water) {
+        stats.high_water = used + len;
+    }
+    return true;
+}
+
+/* Move bytes into the TX FIFO until it is full; true if bytes remain */
+static bool drain_fifo(void)
+{
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+
+    while (ring_tail != ring_head) {
+        char c = ring[ring_tail & UART_BUF_MASK];
+
+#if defined(CY_RETARGET_IO_CONVERT_LF_TO_CRLF)
+        if (c == '\n' && !cr_sent) {
+            if (Cy_SCB_UART_Put(uart_base, (uint32_t)'\r') == 0U) {
+                break;
+            }
+            cr_sent = true;
+        }
+#endif
+        if (Cy_SCB_UART_Put(uart_base, (uint32_t)(uint8_t)c) == 0U) {
+            break;
+        }
+        cr_sent = false;
+        ring_tail++;
+        stats.bytes_sent++;
+    }
+
+    bool remaining = (ring_tail != ring_head);
+    Cy_SysLib_ExitCriticalSection(state);
+    return remaining;
+}
+
+static void wake_drain(void)
+{
+    if (xPortIsInsideInterrupt()) {
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+        vTaskNotifyGiveFromISR(drain_task_handle, &xHigherPriorityTaskWoken);
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    } else {
+        xTaskNotifyGive(drain_task_handle);
+    }
+}
+
+/*******************************************************************************
+ * Drain Task
+ ******************************************************************************/
+
+static void uart_drain_task(void *param)
+{
+    (void)param;
+
+    while (1) {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        /* A full FIFO takes ~5 ms to drain at 115200 baud */
+        while (drain_fifo()) {
+            vTaskDelay(1);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Public Functions
+ ******************************************************************************/
+
+bool uart_buf_init(CySCB_Type *base)
+{
+    if (drain_task_handle != NULL) {
+        return true;
+    }
+    if (base == NULL) {
+        return false;
+    }
+
+    uart_base = base;
+    drain_task_handle = STATIC_TASK_CREATE(uart_drain, uart_drain_task, "UART TX", NULL,
+                                           UART_BUF_TASK_PRIORITY);
+    return (drain_task_handle != NULL);
+}
+
+void uart_buf_set_policy(uart_buf_policy_t new_policy)
+{
+    policy = new_policy;
+}
+
+int uart_buf_write(const char *data, int len)
+{
+    if (data == NULL || len <= 0 || drain_task_handle == NULL) {
+        return 0;
+    }
+
+    bool in_isr = xPortIsInsideInterrupt();
+    bool waited = false;
+    uint32_t done = 0;
+
+    while (done < (uint32_t)len) {
+        uint32_t chunk = (uint32_t)len - done;
+        if (chunk > UART_BUF_SIZE) {
+            chunk = UART_BUF_SIZE;
+        }
+
+        uint32_t state = Cy_SysLib_EnterCriticalSection();
+        bool queued = ring_put(&data[done], chunk);
+        Cy_SysLib_ExitCriticalSection(state);
+
+        if (queued) {
+            done += chunk;
+            continue;
+        }
+
+        if (policy == UART_BUF_DROP || in_isr ||
+            xTaskGetSchedulerState() != taskSCHEDULER_RUNNING) {
+            state = Cy_SysLib_EnterCriticalSection();
+            stats.bytes_dropped += (uint32_t)len - done;
+            stats.writes_dropped++;
+            Cy_SysLib_ExitCriticalSection(state);
+            break;
+        }
+
+        if (!waited) {
+            waited = true;
+            stats.writes_blocked++;
+        }
+        wake_drain();
+        vTaskDelay(1);
+    }
+
+    if (done > 0U) {
+        wake_drain();
+    }
+
+    /* Dropped output is counted, not reported: an error would mark stdout
+     * failed in newlib */
+    return len;
+}
+
+void uart_buf_flush(void)
+{
+    if (uart_base == NULL) {
+        return;
+    }
+
+    while (drain_fifo()) {
+        /* Spin until the FIFO takes the rest */
+    }
+    while (!Cy_SCB_UART_IsTxComplete(uart_base)) {
+    }
+}
+
+void uart_buf_get_stats(uart_buf_stats_t *out)
+{
+    if (out == NULL) {
+        return;
+    }
+
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+    memcpy(out, &stats, sizeof(uart_buf_stats_t));
+    Cy_SysLib_ExitCriticalSection(state);
+}
+
+void uart_buf_print(const char *core_name)
+{
+    uart_buf_stats_t s;
+    uart_buf_get_stats(&s);
+
+    printf("[%s] UART out: %lu queued, %lu sent, %lu dropped in %lu writes, "
+           "%lu blocked, peak %lu/%u bytes (%s)\r\n", core_name,
+           (unsigned long)s.bytes_written, (unsigned long)s.bytes_sent,
+           (unsigned long)s.bytes_dropped, (unsigned long)s.writes_dropped,
+           (unsigned long)s.writes_blocked, (unsigned long)s.high_water,
+           (unsigned)UART_BUF_SIZE, (policy == UART_BUF_BLOCK) ? "block" : "drop");
+}
+
+/*******************************************************************************
+ * _write() Wrapper (GCC, linked with -Wl,--wrap=_write)
+ ******************************************************************************/
+
+#if defined(__GNUC__) && !defined(__ARMCC_VERSION)
+
+int __real__write(int fd, const char *ptr, int len);
+
+int __wrap__write(int fd, const char *ptr, int len)
+{
+    /* Until the scheduler runs (boot banners), keep retarget-io's
+     * synchronous output so nothing is lost or reordered */
+    if ((fd == 1 || fd == 2) && drain_task_handle != NULL &&
+        xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+        return uart_buf_write(ptr, len);
+    }
+    return __real__write(fd, ptr, len);
+}
+
+#endif
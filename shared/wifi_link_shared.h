@@ -0,0 +1,169 @@
+/*******************************************************************************
+ * File Name:   wifi_link_shared.h
+ *
+ * Description: Shared memory block for WiFi link quality between CM33 and CM55
+ *
+ *              CM33 (wifi_task) samples the link once a second, smooths the
+ *              RSSI and writes this block only when something changed enough
+ *              to matter (see wifi_link_quality.h), plus a heartbeat.
+ *              CM55 checks update_count from an LVGL timer and redraws the
+ *              signal icon when it moved: no IPC round trip per update.
+ *
+ * Memory Map:
+ *   - m33_m55_shared region: 0x261C0000, size 256KB
+ *   - CAPSENSE data: offset 0x00 (64 bytes)
+ *   - IMU data: offset 0x40 (80 bytes)
+ *   - WiFi link data: offset 0x100 (48 bytes)
+ *
+ * Usage:
+ *   CM33 (writer):
+ *     wifi_link_shared_init();
+ *     wifi_link_shared_update(&quality);
+ *
+ *   CM55 (reader):
+ *     wifi_link_quality_t q;
+ *     uint32_t count;
+ *     if (wifi_link_shared_read(&q, &count) && count != last_count) { ... }
+ *
+ * Part of BiiL Course: Embedded C for IoT - Week 7
+ ******************************************************************************/
+
+#ifndef WIFI_LINK_SHARED_H
+#define WIFI_LINK_SHARED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "wifi_shared.h"
+
+/*******************************************************************************
+ * Shared Memory Configuration
+ ******************************************************************************/
+
+/* Shared memory base address (from linker script) */
+#define SHARED_MEM_BASE_ADDR        (0x261C0000UL)
+
+/* WiFi link data offset in shared memory (after IMU, 64-byte aligned) */
+#define WIFI_LINK_SHARED_OFFSET     (0x00000100UL)
+
+/* Magic number to verify valid data (0x11AC600D = "LINK GOOD") */
+#define WIFI_LINK_SHARED_MAGIC      (0x11AC600DUL)
+
+/*******************************************************************************
+ * WiFi Link Shared Data Structure
+ *
+ * Layout (48 bytes):
+ *   Offset 0:  magic (4 bytes) - Must be WIFI_LINK_SHARED_MAGIC
+ *   Offset 4:  version (4 bytes)
+ *   Offset 8:  valid (4 bytes) - Set true when data is valid
+ *   Offset 12: update_count (4 bytes) - Incremented on each update
+ *   Offset 16: write_lock (4 bytes) - Odd = writing, Even = done
+ *   Offset 20: quality (16 bytes, wifi_link_quality_t)
+ *   Offset 36: samples (4 bytes) - Link samples taken, published or not
+ *   Offset 40-47: reserved
+ *
+ ******************************************************************************/
+
+typedef struct __attribute__((packed, aligned(4))) {
+    uint32_t magic;             /* Must be WIFI_LINK_SHARED_MAGIC */
+    uint32_t version;           /* Structure version (currently 1) */
+    uint32_t valid;             /* 1 = data valid, 0 = not yet written */
+    uint32_t update_count;      /* Incremented each time CM33 updates */
+    uint32_t write_lock;        /* Odd = writing, Even = done (for sync) */
+    wifi_link_quality_t quality;
+    uint32_t samples;           /* Samples taken (vs update_count: coalescing) */
+    uint8_t  reserved[8];       /* Padding to 48 bytes total */
+} wifi_link_shared_t;
+
+/*******************************************************************************
+ * Pointer to shared WiFi link data
+ ******************************************************************************/
+
+#define WIFI_LINK_SHARED_PTR  ((volatile wifi_link_shared_t *)(SHARED_MEM_BASE_ADDR + WIFI_LINK_SHARED_OFFSET))
+
+/*******************************************************************************
+ * CM33 Functions
+ ******************************************************************************/
+
+/**
+ * @brief Initialize shared link structure (called by CM33 at startup)
+ */
+static inline void wifi_link_shared_init(void)
+{
+    volatile wifi_link_shared_t *link = WIFI_LINK_SHARED_PTR;
+
+    link->valid = 0;
+    link->update_count = 0;
+    link->write_lock = 0;   /* Even = not writing */
+    link->samples = 0;
+    memset((void *)&link->quality, 0, sizeof(wifi_link_quality_t));
+    link->version = 1;
+    __DSB();
+    link->magic = WIFI_LINK_SHARED_MAGIC;
+}
+
+/**
+ * @brief Count a link sample that was not published (called by CM33)
+ */
+static inline void wifi_link_shared_sampled(void)
+{
+    WIFI_LINK_SHARED_PTR->samples++;
+}
+
+/**
+ * @brief Publish new link quality (called by CM33)
+ *
+ * Uses write_lock like imu_shared_update(): odd while writing.
+ */
+static inline void wifi_link_shared_update(const wifi_link_quality_t *q)
+{
+    volatile wifi_link_shared_t *link = WIFI_LINK_SHARED_PTR;
+
+    link->write_lock++;
+    __DSB();
+
+    memcpy((void *)&link->quality, q, sizeof(wifi_link_quality_t));
+    link->samples++;
+    link->update_count++;
+    link->valid = 1;
+
+    __DSB();
+    link->write_lock++;
+}
+
+/*******************************************************************************
+ * CM55 Functions
+ ******************************************************************************/
+
+/**
+ * @brief Read the current link quality (called by CM55)
+ *
+ * @param q      Out
+ * @param count  Out: update_count, to tell a new update from the last one
+ * @return false if no data yet or CM33 was writing (keep the previous value)
+ */
+static inline bool wifi_link_shared_read(wifi_link_quality_t *q, uint32_t *count)
+{
+    volatile wifi_link_shared_t *link = WIFI_LINK_SHARED_PTR;
+
+    __DSB();
+
+    if (link->magic != WIFI_LINK_SHARED_MAGIC || link->valid == 0) {
+        return false;
+    }
+
+    uint32_t lock1 = link->write_lock;
+    __DSB();
+    if (lock1 & 1) {
+        return false;
+    }
+
+    memcpy(q, (const void *)&link->quality, sizeof(wifi_link_quality_t));
+    *count = link->update_count;
+
+    __DSB();
+    uint32_t lock2 = link->write_lock;
+    return lock1 == lock2;
+}
+
+#endif /* WIFI_LINK_SHARED_H */
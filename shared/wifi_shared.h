@@ -65,6 +65,13 @@ typedef enum {
     WIFI_STATE_ERROR            = 5
 } wifi_state_t;
 
+/*
+ * IPC_CMD_WIFI_DISCONNECTED: msg.value = WIFI_ERR_NONE after a disconnect
+ * request, WIFI_ERR_CONNECTION_LOST when the link dropped. CM33 then
+ * reconnects by itself and sends IPC_CMD_WIFI_CONNECTED once it is back;
+ * after a warm reset it rejoins the last network the same way.
+ */
+
 /* WiFi IPC Commands (0xD0-0xDF) are defined in ipc_shared.h */
 
 /*******************************************************************************
@@ -78,9 +85,20 @@ typedef struct __attribute__((packed)) {
     uint8_t     channel;                     /* WiFi channel (1-14 for 2.4GHz) */
     uint8_t     band;                        /* Frequency band (wifi_band_t) */
     uint8_t     flags;                       /* Bit flags: bit0=connected, bit1=saved */
-    uint8_t     reserved[2];                 /* Padding for alignment */
+    uint8_t     ap_count;                    /* APs (BSSIDs) merged into this entry */
+    uint8_t     reserved;                    /* Padding for alignment */
 } ipc_wifi_network_t;
 
+/*
+ * IPC_CMD_WIFI_SCAN_RESULT carries one entry of the list kept on CM33, with
+ * msg.value its index; indexes are stable across scans. A scan only sends
+ * entries that changed since the last one, and an entry with an empty SSID
+ * was removed. IPC_CMD_WIFI_SCAN_COMPLETE: msg.value = highest index + 1.
+ * IPC_CMD_WIFI_SCAN_START with msg.value = WIFI_SCAN_FLAG_FULL resends
+ * every entry (e.g. after the CM55 list was lost).
+ */
+#define WIFI_SCAN_FLAG_FULL     (1U << 0)
+
 /*******************************************************************************
  * WiFi Scan Result Structure
  ******************************************************************************/
@@ -147,6 +165,22 @@ typedef struct __attribute__((packed)) {
     uint32_t    uptime;                     /* Connection uptime in seconds */
 } ipc_wifi_status_t;
 
+/*******************************************************************************
+ * WiFi Link Quality Structure (published by CM33, see wifi_link_shared.h)
+ ******************************************************************************/
+
+typedef struct __attribute__((packed, aligned(4))) {
+    uint8_t     state;                      /* wifi_state_t */
+    int8_t      rssi;                       /* Smoothed RSSI, dBm (0 if not connected) */
+    int8_t      rssi_raw;                   /* Last reading, dBm */
+    uint8_t     channel;                    /* Current channel */
+    uint8_t     band;                       /* wifi_band_t */
+    uint8_t     security;                   /* wifi_security_t */
+    uint8_t     reserved[2];                /* Padding */
+    uint32_t    link_speed_kbps;            /* TX rate, 0 if unknown */
+    uint32_t    time_ms;                    /* CM33 tick of this sample */
+} wifi_link_quality_t;
+
 /*******************************************************************************
  * WiFi Error Codes
  ******************************************************************************/
@@ -0,0 +1,506 @@
+/*******************************************************************************
+ * File: aic_alloc_bench.c
+ * Description: Host allocation-trace benchmark for proj_cm55/aic-eec/aic_alloc.c
+ *
+ * Replays an LVGL allocation trace through the pool/TLSF memory core and
+ * through the C library allocator, and reports time per call, peak use,
+ * TLSF fragmentation and C heap fallbacks.
+ *
+ * Trace source:
+ *   aic_alloc_bench             synthetic trace modelled on the examples
+ *                               (long-lived home screen, WiFi list
+ *                               rebuilds, password dialog open/close,
+ *                               screen switches with draw layers)
+ *   aic_alloc_bench FILE        trace captured on the board with
+ *                               AIC_ALLOC_TRACE = 1 ("[ALLOC] + ptr size",
+ *                               "[ALLOC] - ptr", "[ALLOC] ~ ptr size")
+ *
+ * Checks: block contents survive until freed (no overlap), the TLSF chain
+ * stays consistent, and after everything is freed nothing is live and the
+ * TLSF heap has coalesced back into one block.
+ *
+ * Timings are host figures: use them to compare the two allocators, not
+ * as Cortex-M55 cycle counts.
+ *
+ * Part of BiiL Course: Embedded C for IoT
+ ******************************************************************************/
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "aic_alloc.h"
+#include "lvgl.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TIMING_RUNS         20U
+#define MAP_BITS            18U
+#define MAP_SIZE            (1UL << MAP_BITS)
+#define MAP_EMPTY           0U
+#define MAP_TOMBSTONE       1U
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef enum {
+    OP_ALLOC,
+    OP_FREE,
+    OP_REALLOC,
+    OP_MARK         /* Phase boundary - size indexes phase_names */
+} op_kind_t;
+
+typedef struct {
+    uint8_t kind;
+    uint32_t id;
+    uint32_t size;
+} op_t;
+
+typedef struct {
+    op_t *ops;
+    size_t count;
+    size_t cap;
+    uint32_t ids;           /* Block ids handed out */
+    uint32_t big_allocs;    /* Requests above AIC_ALLOC_TLSF_MAX */
+} trace_t;
+
+typedef struct {
+    const char *name;
+    void *(*alloc)(size_t size);
+    void (*release)(void *p);
+    void *(*resize)(void *p, size_t size);
+} backend_t;
+
+/*******************************************************************************
+ * Trace Building
+ ******************************************************************************/
+static const char *const phase_names[] = {
+    "home screen", "wifi rebuilds", "dialogs", "screen switches", "captured"
+};
+
+enum { PHASE_HOME, PHASE_WIFI, PHASE_DIALOG, PHASE_SWITCH, PHASE_CAPTURED };
+
+static uint32_t rng_state = 0x2545F491U;
+
+static uint32_t rng_range(uint32_t lo, uint32_t hi)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return lo + rng_state % (hi - lo + 1U);
+}
+
+static void trace_push(trace_t *t, op_kind_t kind, uint32_t id, uint32_t size)
+{
+    if (t->count == t->cap) {
+        t->cap = (t->cap != 0U) ? t->cap * 2U : 4096U;
+        t->ops = realloc(t->ops, t->cap * sizeof(op_t));
+        if (t->ops == NULL) {
+            printf("out of memory\n");
+            exit(2);
+        }
+    }
+    t->ops[t->count++] = (op_t){ (uint8_t)kind, id, size };
+}
+
+static uint32_t trace_alloc(trace_t *t, uint32_t size)
+{
+    uint32_t id = t->ids++;
+    if (size > AIC_ALLOC_TLSF_MAX) {
+        t->big_allocs++;
+    }
+    trace_push(t, OP_ALLOC, id, size);
+    return id;
+}
+
+/* One widget as LVGL 9 allocates it: the object, optional spec_attr,
+ * a style array grown by add_style, a local style with a few properties
+ * and, for labels, the text */
+#define WIDGET_BLOCKS       6U
+
+typedef struct {
+    uint32_t ids[WIDGET_BLOCKS];
+    uint32_t count;
+} widget_t;
+
+static void widget_create(trace_t *t, widget_t *w, bool label)
+{
+    w->count = 0;
+    w->ids[w->count++] = trace_alloc(t, rng_range(60U, 180U));     /* lv_obj_t + class */
+
+    if (rng_range(0U, 3U) == 0U) {
+        w->ids[w->count++] = trace_alloc(t, 56U);                   /* spec_attr */
+    }
+
+    uint32_t styles = trace_alloc(t, 16U);
+    uint32_t style_count = rng_range(1U, 3U);
+    w->ids[w->count++] = styles;
+    for (uint32_t n = 2U; n <= style_count; n++) {
+        trace_push(t, OP_REALLOC, styles, 16U * n);
+    }
+
+    w->ids[w->count++] = trace_alloc(t, 24U);                      /* lv_style_t */
+    uint32_t values = trace_alloc(t, 8U);
+    uint32_t prop_count = rng_range(2U, 8U);
+    w->ids[w->count++] = values;
+    for (uint32_t n = 2U; n <= prop_count; n++) {
+        trace_push(t, OP_REALLOC, values, 8U * n);
+    }
+
+    if (label) {
+        w->ids[w->count++] = trace_alloc(t, rng_range(4U, 48U));    /* Label text */
+    }
+}
+
+static void widget_set_text(trace_t *t, const widget_t *w)
+{
+    /* lv_label_set_text reallocs the last block of a label */
+    trace_push(t, OP_REALLOC, w->ids[w->count - 1U], rng_range(4U, 48U));
+}
+
+static void widget_delete(trace_t *t, const widget_t *w)
+{
+    for (uint32_t i = 0; i < w->count; i++) {
+        trace_push(t, OP_FREE, w->ids[i], 0U);
+    }
+}
+
+static void build_synthetic(trace_t *t)
+{
+    static widget_t home[120];
+    static widget_t items[20][4];
+    static widget_t dialog[40];
+    static widget_t screen[150];
+
+    /* Home screen: stays live for the whole trace */
+    for (size_t i = 0; i < 120U; i++) {
+        widget_create(t, &home[i], (i % 3U) == 0U);
+    }
+    trace_push(t, OP_MARK, 0U, PHASE_HOME);
+
+    /* WiFi list: 20 rows of container + icon + SSID + status, rebuilt per scan;
+     * the status line of the home screen ticks in between */
+    for (uint32_t scan = 0; scan < 200U; scan++) {
+        for (size_t r = 0; r < 20U; r++) {
+            for (size_t k = 0; k < 4U; k++) {
+                widget_create(t, &items[r][k], k > 0U);
+            }
+        }
+        for (uint32_t tick = 0; tick < 5U; tick++) {
+            widget_set_text(t, &home[3U * rng_range(0U, 39U)]);
+        }
+        for (size_t r = 0; r < 20U; r++) {
+            for (size_t k = 0; k < 4U; k++) {
+                widget_delete(t, &items[r][k]);
+            }
+        }
+    }
+    trace_push(t, OP_MARK, 0U, PHASE_WIFI);
+
+    /* Password dialog: keyboard + button map, typed text grows */
+    for (uint32_t open = 0; open < 50U; open++) {
+        for (size_t i = 0; i < 40U; i++) {
+            widget_create(t, &dialog[i], (i % 2U) == 0U);
+        }
+        uint32_t map = trace_alloc(t, 2048U);
+        uint32_t text = trace_alloc(t, 1U);
+        uint32_t typed = rng_range(8U, 64U);
+        for (uint32_t len = 2U; len <= typed; len++) {
+            trace_push(t, OP_REALLOC, text, len);
+        }
+        trace_push(t, OP_FREE, text, 0U);
+        trace_push(t, OP_FREE, map, 0U);
+        for (size_t i = 0; i < 40U; i++) {
+            widget_delete(t, &dialog[i]);
+        }
+    }
+    trace_push(t, OP_MARK, 0U, PHASE_DIALOG);
+
+    /* Screen switches: build, a few frames with draw layers and an image
+     * cache entry, delete */
+    for (uint32_t sw = 0; sw < 50U; sw++) {
+        for (size_t i = 0; i < 150U; i++) {
+            widget_create(t, &screen[i], (i % 2U) == 0U);
+        }
+        uint32_t image = trace_alloc(t, 8192U);
+        for (uint32_t frame = 0; frame < 5U; frame++) {
+            uint32_t layer = trace_alloc(t, 48U * 1024U);
+            uint32_t task = trace_alloc(t, rng_range(300U, 900U));
+            trace_push(t, OP_FREE, task, 0U);
+            trace_push(t, OP_FREE, layer, 0U);
+        }
+        trace_push(t, OP_FREE, image, 0U);
+        for (size_t i = 0; i < 150U; i++) {
+            widget_delete(t, &screen[i]);
+        }
+    }
+    trace_push(t, OP_MARK, 0U, PHASE_SWITCH);
+
+    for (size_t i = 0; i < 120U; i++) {
+        widget_delete(t, &home[i]);
+    }
+}
+
+/*******************************************************************************
+ * Captured Trace
+ ******************************************************************************/
+
+/* Board pointer -> block id (open addressing, linear probing) */
+static uint64_t map_key[MAP_SIZE];
+static uint32_t map_id[MAP_SIZE];
+
+static size_t map_slot(uint64_t key, bool insert)
+{
+    size_t i = (size_t)((key >> 3) * 0x9E3779B97F4A7C15ULL >> (64U - MAP_BITS));
+
+    for (size_t n = 0; n < MAP_SIZE; n++, i = (i + 1U) & (MAP_SIZE - 1U)) {
+        if (map_key[i] == key || map_key[i] == MAP_EMPTY ||
+            (insert && map_key[i] == MAP_TOMBSTONE)) {
+            return i;
+        }
+    }
+    printf("trace map full\n");
+    exit(2);
+}
+
+static bool load_trace(trace_t *t, const char *path)
+{
+    FILE *f = fopen(path, "r");
+    char line[256];
+    unsigned long long ptr;
+    unsigned int size;
+
+    if (f == NULL) {
+        perror(path);
+        return false;
+    }
+
+    while (fgets(line, sizeof(line), f) != NULL) {
+        const char *rec = strstr(line, "[ALLOC] ");
+        if (rec == NULL) {
+            continue;       /* Other console output */
+        }
+        rec += 8;
+
+        if (sscanf(rec, "+ %llx %u", &ptr, &size) == 2) {
+            size_t i = map_slot(ptr, true);
+            map_key[i] = ptr;
+            map_id[i] = trace_alloc(t, size);
+        } else if (sscanf(rec, "- %llx", &ptr) == 1) {
+            size_t i = map_slot(ptr, false);
+            if (map_key[i] == ptr) {
+                trace_push(t, OP_FREE, map_id[i], 0U);
+                map_key[i] = MAP_TOMBSTONE;
+            }
+        } else if (sscanf(rec, "~ %llx %u", &ptr, &size) == 2) {
+            size_t i = map_slot(ptr, false);
+            if (map_key[i] == ptr) {
+                trace_push(t, OP_REALLOC, map_id[i], size);
+            }
+        }
+    }
+    fclose(f);
+
+    /* Blocks still live when the capture stopped are freed at the end */
+    for (size_t i = 0; i < MAP_SIZE; i++) {
+        if (map_key[i] > MAP_TOMBSTONE) {
+            trace_push(t, OP_FREE, map_id[i], 0U);
+        }
+    }
+    trace_push(t, OP_MARK, 0U, PHASE_CAPTURED);
+    return true;
+}
+
+/*******************************************************************************
+ * Replay
+ ******************************************************************************/
+static void *clib_alloc(size_t size)
+{
+    return malloc(size);
+}
+
+static void clib_release(void *p)
+{
+    free(p);
+}
+
+static void *clib_resize(void *p, size_t size)
+{
+    return realloc(p, size);
+}
+
+static const backend_t backends[] = {
+    { "aic_alloc", lv_malloc_core, lv_free_core, lv_realloc_core },
+    { "C library", clib_alloc, clib_release, clib_resize },
+};
+
+static int failures = 0;
+
+static void expect(bool ok, const char *what)
+{
+    if (!ok) {
+        printf("FAIL %s\n", what);
+        failures++;
+    }
+}
+
+static bool check_fill(const uint8_t *p, uint32_t size, uint32_t id)
+{
+    for (uint32_t i = 0; i < size; i++) {
+        if (p[i] != (uint8_t)(id + i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void fill(uint8_t *p, uint32_t size, uint32_t id)
+{
+    for (uint32_t i = 0; i < size; i++) {
+        p[i] = (uint8_t)(id + i);
+    }
+}
+
+static void print_mark(uint32_t phase)
+{
+    aic_alloc_stats_t st;
+    aic_alloc_get_stats(&st);
+
+    printf("  after %-16s live %5lu B (%4lu blocks)  peak %6lu B  "
+           "TLSF free %6lu B largest %6lu B frag %3u%%  heap %lu\n",
+           phase_names[phase], (unsigned long)st.used_bytes,
+           (unsigned long)st.live_count, (unsigned long)st.peak_bytes,
+           (unsigned long)st.tlsf_free, (unsigned long)st.tlsf_largest,
+           st.frag_pct, (unsigned long)st.heap_fallbacks);
+    expect(lv_mem_test_core() == LV_RESULT_OK, "TLSF chain inconsistent");
+}
+
+/* Returns the replay time in ns; verify fills every block and checks it
+ * before it is resized or freed */
+static double replay(const trace_t *t, const backend_t *b, void **ptr, uint32_t *size,
+                     bool verify)
+{
+    struct timespec t0, t1;
+    uint32_t corrupt = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    for (size_t i = 0; i < t->count; i++) {
+        const op_t *op = &t->ops[i];
+
+        switch (op->kind) {
+            case OP_ALLOC:
+                ptr[op->id] = b->alloc(op->size);
+                size[op->id] = op->size;
+                if (verify) {
+                    fill(ptr[op->id], op->size, op->id);
+                }
+                break;
+            case OP_FREE:
+                if (verify && !check_fill(ptr[op->id], size[op->id], op->id)) {
+                    corrupt++;
+                }
+                b->release(ptr[op->id]);
+                break;
+            case OP_REALLOC: {
+                uint32_t keep = (size[op->id] < op->size) ? size[op->id] : op->size;
+                if (verify && !check_fill(ptr[op->id], size[op->id], op->id)) {
+                    corrupt++;
+                }
+                ptr[op->id] = b->resize(ptr[op->id], op->size);
+                size[op->id] = op->size;
+                if (verify) {
+                    expect(check_fill(ptr[op->id], keep, op->id), "realloc lost contents");
+                    fill(ptr[op->id], op->size, op->id);
+                }
+                break;
+            }
+            default:
+                if (verify) {
+                    print_mark(op->size);
+                }
+                break;
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    expect(corrupt == 0U, "block contents overwritten before free");
+    return (double)(t1.tv_sec - t0.tv_sec) * 1e9 + (double)(t1.tv_nsec - t0.tv_nsec);
+}
+
+/*******************************************************************************
+ * Main
+ ******************************************************************************/
+int main(int argc, char **argv)
+{
+    trace_t trace = { 0 };
+    aic_alloc_stats_t st;
+
+    if (argc > 1) {
+        if (!load_trace(&trace, argv[1])) {
+            return 2;
+        }
+        printf("trace %s: %zu calls, %lu blocks\n", argv[1], trace.count,
+               (unsigned long)trace.ids);
+    } else {
+        build_synthetic(&trace);
+        printf("synthetic trace: %zu calls, %lu blocks\n", trace.count,
+               (unsigned long)trace.ids);
+    }
+
+    void **ptr = calloc(trace.ids, sizeof(void *));
+    uint32_t *size = calloc(trace.ids, sizeof(uint32_t));
+    if (ptr == NULL || size == NULL) {
+        printf("out of memory\n");
+        return 2;
+    }
+
+    /* Correctness pass */
+    lv_mem_init();
+    (void)replay(&trace, &backends[0], ptr, size, true);
+    aic_alloc_get_stats(&st);
+    expect(st.live_count == 0U && st.used_bytes == 0U, "blocks live after the trace");
+    expect(st.heap_live == 0U, "C heap blocks live after the trace");
+    expect(st.tlsf_free == st.tlsf_largest, "TLSF heap not coalesced after the trace");
+    if (argc == 1) {
+        /* The region is large enough for the synthetic trace */
+        expect(st.heap_fallbacks == trace.big_allocs, "C heap used below AIC_ALLOC_TLSF_MAX");
+    }
+    for (uint32_t i = 0; i < AIC_ALLOC_CLASS_COUNT; i++) {
+        printf("  pool %3lu B  slots %4lu  peak %4lu\n",
+               (unsigned long)st.classes[i].size, (unsigned long)st.classes[i].slots,
+               (unsigned long)st.classes[i].peak);
+    }
+    lv_mem_deinit();
+
+    /* Timing: best of TIMING_RUNS, fresh region per run */
+    for (size_t b = 0; b < sizeof(backends) / sizeof(backends[0]); b++) {
+        double best = 0.0;
+        for (uint32_t run = 0; run < TIMING_RUNS; run++) {
+            lv_mem_init();
+            double ns = replay(&trace, &backends[b], ptr, size, false);
+            lv_mem_deinit();
+            if (run == 0U || ns < best) {
+                best = ns;
+            }
+        }
+        printf("%-10s %6.1f ns/call\n", backends[b].name, best / (double)trace.count);
+    }
+
+    free(ptr);
+    free(size);
+    free(trace.ops);
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("aic_alloc: OK\n");
+    return 0;
+}
@@ -0,0 +1,423 @@
+/*******************************************************************************
+ * File: bt_adv_parser_test.c
+ * Description: Host test for proj_cm33_ns/source/bt_adv_parser.c
+ *
+ * bt_task.c, the only caller, needs the BT stack, so the parser is checked
+ * here on its own:
+ *
+ *   samples     advertisements and scan responses as real devices send
+ *               them (heart rate sensor, iBeacon, Eddystone, a phone);
+ *               every field, UUID matching across 16/32/128-bit forms,
+ *               the scan filter rules and name copying
+ *   malformed   truncated structures keep the fields before them, a zero
+ *               length ends the data, nothing past max_len or
+ *               BT_ADV_MAX_LEN is read
+ *   random      random buffers, and valid advertisements with random
+ *               bytes changed, each in a heap block of exactly its size;
+ *               the result matches a reference walk of the structures
+ *               and every reference stays inside the parsed bytes
+ *
+ * Build with "make SANITIZE=1" to run it under AddressSanitizer and
+ * UBSan, which turn a read past the block into a failure.
+ *
+ * Part of BiiL Course: Embedded C for IoT - Week 7
+ ******************************************************************************/
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "bt_adv_parser.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define RANDOM_BUFFERS      1000000U
+#define MUTATED_BUFFERS     1000000U
+
+/*******************************************************************************
+ * Helpers
+ ******************************************************************************/
+static uint32_t rng_state = 0xAD5EED01U;
+
+static uint32_t rng_next(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static int failures = 0;
+
+static void expect(bool ok, const char *step, const char *what)
+{
+    if (!ok) {
+        printf("FAIL %s: %s\n", step, what);
+        failures++;
+    }
+}
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Copy into a heap block of exactly len bytes, so a sanitizer sees any
+ * read past the end */
+static uint8_t *exact_copy(const uint8_t *data, uint32_t len)
+{
+    uint8_t *p = malloc((len > 0U) ? len : 1U);
+    if (p == NULL) {
+        printf("out of memory\n");
+        exit(1);
+    }
+    memcpy(p, data, len);
+    return p;
+}
+
+static bool parse_exact(const uint8_t *data, uint32_t len, bt_adv_info_t *info)
+{
+    uint8_t *p = exact_copy(data, len);
+    bool ok = bt_adv_parse(p, len, info);
+    free(p);
+    info->data = data;          /* References stay valid for the checks */
+    return ok;
+}
+
+/*******************************************************************************
+ * Sample Advertisements
+ ******************************************************************************/
+
+/* Heart rate sensor: flags, 16-bit services, short name, TX power,
+ * appearance, manufacturer data, 128-bit service on the base UUID */
+static const uint8_t adv_hrm[] = {
+    0x02, 0x01, 0x06,
+    0x05, 0x03, 0x0D, 0x18, 0x0F, 0x18,
+    0x05, 0x08, 'H', 'R', 'M', '1',
+    0x02, 0x0A, 0xF4,
+    0x03, 0x19, 0x41, 0x03,
+    0x05, 0xFF, 0x59, 0x00, 0xAA, 0xBB,
+    0x11, 0x07, 0xFB, 0x34, 0x9B, 0x5F, 0x80, 0x00, 0x00, 0x80,
+                0x00, 0x10, 0x00, 0x00, 0x0A, 0x18, 0x00, 0x00,
+};
+
+/* Scan response of the same device: the complete name */
+static const uint8_t rsp_hrm[] = {
+    0x0E, 0x09, 'H', 'R', 'M', '1', ' ', 'C', 'h', 'e', 's', 't', ' ', 'R', 'X',
+};
+
+/* iBeacon: flags and Apple manufacturer data, no name */
+static const uint8_t adv_ibeacon[] = {
+    0x02, 0x01, 0x06,
+    0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15,
+    0xE2, 0xC5, 0x6D, 0xB5, 0xDF, 0xFB, 0x48, 0xD2,
+    0xB0, 0x60, 0xD0, 0xF5, 0xA7, 0x10, 0x96, 0xE0,
+    0x00, 0x01, 0x00, 0x02, 0xC5,
+};
+
+/* Eddystone: 16-bit service FEAA and its service data (type 0x16, not
+ * parsed); zero padding after the data, as the stack delivers it */
+static const uint8_t adv_eddystone[] = {
+    0x02, 0x01, 0x06,
+    0x03, 0x03, 0xAA, 0xFE,
+    0x0B, 0x16, 0xAA, 0xFE, 0x10, 0xEB, 0x03, 'b', 'i', 'i', 'l', 0x07,
+    0x00, 0x00, 0x00, 0x00,
+};
+
+/* Phone: 32-bit service list, a second 16-bit list (ignored), dual mode */
+static const uint8_t adv_phone[] = {
+    0x02, 0x01, 0x1A,
+    0x03, 0x02, 0x12, 0x18,
+    0x05, 0x05, 0x78, 0x56, 0x34, 0x12,
+    0x03, 0x03, 0x0F, 0x18,
+    0x01, 0x09,
+};
+
+static const uint8_t uuid_hr16[2] = { 0x0D, 0x18 };
+static const uint8_t uuid_bat16[2] = { 0x0F, 0x18 };
+static const uint8_t uuid_dev16[2] = { 0x0A, 0x18 };
+static const uint8_t uuid_hid16[2] = { 0x12, 0x18 };
+static const uint8_t uuid_hr128[16] = {
+    0xFB, 0x34, 0x9B, 0x5F, 0x80, 0x00, 0x00, 0x80,
+    0x00, 0x10, 0x00, 0x00, 0x0D, 0x18, 0x00, 0x00,
+};
+static const uint8_t uuid_x32[4] = { 0x78, 0x56, 0x34, 0x12 };
+
+static bool ref_is(const bt_adv_info_t *info, bt_adv_ref_t ref, const void *bytes, uint32_t len)
+{
+    return (ref.len == len) && (memcmp(&info->data[ref.offset], bytes, len) == 0);
+}
+
+static void test_samples(void)
+{
+    const char *step = "samples";
+    bt_adv_info_t info;
+    char name[32];
+
+    expect(parse_exact(adv_hrm, sizeof(adv_hrm), &info), step, "HRM parses");
+    expect(info.length == sizeof(adv_hrm), step, "HRM length");
+    expect(info.present == (BT_ADV_HAS_FLAGS | BT_ADV_HAS_NAME | BT_ADV_HAS_UUID16 |
+                            BT_ADV_HAS_UUID128 | BT_ADV_HAS_MANUFACTURER |
+                            BT_ADV_HAS_TX_POWER | BT_ADV_HAS_APPEARANCE), step, "HRM fields");
+    expect(info.flags == (BT_AD_FLAG_LE_GENERAL | BT_AD_FLAG_NO_BREDR), step, "HRM flags");
+    expect(info.tx_power == -12, step, "HRM TX power");
+    expect(info.appearance == 0x0341, step, "HRM appearance");
+    expect(info.company_id == 0x0059, step, "HRM company");
+    expect(ref_is(&info, info.manufacturer, "\xAA\xBB", 2), step, "HRM manufacturer payload");
+    expect(!info.name_complete && ref_is(&info, info.name, "HRM1", 4), step, "HRM short name");
+    expect(bt_adv_has_uuid(&info, uuid_hr16, 2) && bt_adv_has_uuid(&info, uuid_bat16, 2),
+           step, "HRM 16-bit services");
+    expect(bt_adv_has_uuid(&info, uuid_hr128, 16), step, "16-bit service as 128-bit");
+    expect(bt_adv_has_uuid(&info, uuid_dev16, 2), step, "128-bit service as 16-bit");
+    expect(!bt_adv_has_uuid(&info, uuid_hid16, 2), step, "absent service");
+    expect(!bt_adv_has_uuid(&info, uuid_hr16, 3), step, "bad UUID size");
+    expect(bt_adv_copy_name(&info, name, sizeof(name)) == 4 && strcmp(name, "HRM1") == 0,
+           step, "HRM name copy");
+
+    /* Advertisement and scan response together, as bt_task.c parses them */
+    uint8_t both[BT_ADV_MAX_LEN];
+    memcpy(both, adv_hrm, sizeof(adv_hrm));
+    memcpy(&both[sizeof(adv_hrm)], rsp_hrm, sizeof(rsp_hrm));
+    expect(parse_exact(both, sizeof(adv_hrm) + sizeof(rsp_hrm), &info), step, "HRM + response");
+    expect(info.name_complete && ref_is(&info, info.name, "HRM1 Chest RX", 13), step,
+           "complete name replaces the short one");
+
+    expect(parse_exact(adv_ibeacon, sizeof(adv_ibeacon), &info), step, "iBeacon parses");
+    expect(info.present == (BT_ADV_HAS_FLAGS | BT_ADV_HAS_MANUFACTURER), step, "iBeacon fields");
+    expect(info.company_id == 0x004C && info.manufacturer.len == 23, step, "iBeacon payload");
+    expect(bt_adv_copy_name(&info, name, sizeof(name)) == 0 && name[0] == '\0', step,
+           "no name copies as empty");
+
+    expect(parse_exact(adv_eddystone, sizeof(adv_eddystone), &info), step, "Eddystone parses");
+    expect(info.length == sizeof(adv_eddystone) - 4U, step, "padding ends the data");
+    expect(bt_adv_has_uuid(&info, (const uint8_t *)"\xAA\xFE", 2), step, "Eddystone service");
+
+    expect(parse_exact(adv_phone, sizeof(adv_phone), &info), step, "phone parses");
+    expect(info.flags == (BT_AD_FLAG_LE_GENERAL | BT_AD_FLAG_DUAL_MODE), step, "phone flags");
+    expect(bt_adv_has_uuid(&info, uuid_hid16, 2), step, "first 16-bit list kept");
+    expect(!bt_adv_has_uuid(&info, uuid_bat16, 2), step, "second 16-bit list ignored");
+    expect(bt_adv_has_uuid(&info, uuid_x32, 4), step, "32-bit service");
+    expect((info.present & BT_ADV_HAS_NAME) && info.name.len == 0, step, "empty name");
+
+    /* Scan filter */
+    ipc_bt_scan_filter_t f;
+    memset(&f, 0, sizeof(f));
+    f.min_rssi = BT_SCAN_FILTER_RSSI_ANY;
+    (void)parse_exact(adv_hrm, sizeof(adv_hrm), &info);
+    expect(bt_adv_filter_match(&f, &info), step, "empty filter matches");
+    f.match = BT_SCAN_FILTER_COMPANY;
+    f.company_id = 0x0059;
+    expect(bt_adv_filter_match(&f, &info), step, "company rule");
+    f.company_id = 0x004C;
+    expect(!bt_adv_filter_match(&f, &info), step, "company rule, other company");
+    f.match = BT_SCAN_FILTER_UUID | BT_SCAN_FILTER_NAMED;
+    f.uuid_len = 16;
+    memcpy(f.uuid, uuid_hr128, 16);
+    expect(bt_adv_filter_match(&f, &info), step, "UUID and name rules");
+    f.uuid_len = 7;
+    expect(!bt_adv_filter_match(&f, &info), step, "filter with a bad UUID size");
+    f.match = BT_SCAN_FILTER_NAMED;
+    (void)parse_exact(adv_ibeacon, sizeof(adv_ibeacon), &info);
+    expect(!bt_adv_filter_match(&f, &info), step, "name rule, no name");
+    (void)parse_exact(adv_phone, sizeof(adv_phone), &info);
+    expect(!bt_adv_filter_match(&f, &info), step, "name rule, empty name");
+
+    /* Name copy truncation */
+    (void)parse_exact(rsp_hrm, sizeof(rsp_hrm), &info);
+    expect(bt_adv_copy_name(&info, name, 5) == 4 && strcmp(name, "HRM1") == 0, step,
+           "name truncated to the buffer");
+    expect(bt_adv_copy_name(&info, name, 1) == 0 && name[0] == '\0', step, "1-byte buffer");
+    expect(bt_adv_copy_name(&info, name, 0) == 0, step, "0-byte buffer");
+}
+
+static void test_malformed(void)
+{
+    const char *step = "malformed";
+    bt_adv_info_t info;
+
+    /* Name runs 2 bytes past the end: flags before it are kept */
+    static const uint8_t truncated[] = { 0x02, 0x01, 0x06, 0x06, 0x09, 'a', 'b', 'c' };
+    expect(!parse_exact(truncated, sizeof(truncated), &info), step, "truncated fails");
+    expect(info.length == 3 && info.present == BT_ADV_HAS_FLAGS && info.flags == 0x06,
+           step, "fields before the truncation kept");
+
+    /* A length byte as the last byte */
+    static const uint8_t dangling[] = { 0x02, 0x01, 0x06, 0x03 };
+    expect(!parse_exact(dangling, sizeof(dangling), &info), step, "dangling length fails");
+    expect(info.length == 3, step, "dangling length not counted");
+
+    /* Zero length ends the data, the rest is not looked at */
+    static const uint8_t ended[] = { 0x02, 0x01, 0x06, 0x00, 0x05, 0x09, 'x' };
+    expect(parse_exact(ended, sizeof(ended), &info), step, "zero length ends");
+    expect(info.length == 3 && (info.present & BT_ADV_HAS_NAME) == 0, step,
+           "nothing after the end");
+
+    /* Type without data, short fixed-size fields */
+    static const uint8_t empty_fields[] = {
+        0x01, 0x01,  0x01, 0x0A,  0x02, 0x19, 0x41,  0x02, 0xFF, 0x4C,  0x01, 0x03,
+    };
+    expect(parse_exact(empty_fields, sizeof(empty_fields), &info), step, "empty fields parse");
+    expect((info.present & (BT_ADV_HAS_FLAGS | BT_ADV_HAS_TX_POWER | BT_ADV_HAS_APPEARANCE |
+                            BT_ADV_HAS_MANUFACTURER)) == 0, step, "short fields ignored");
+    expect((info.present & BT_ADV_HAS_UUID16) && info.uuid16.len == 0 &&
+           !bt_adv_has_uuid(&info, uuid_hr16, 2), step, "empty UUID list");
+
+    /* Odd-sized UUID list: the partial UUID is not compared */
+    static const uint8_t odd_list[] = { 0x04, 0x03, 0x0D, 0x18, 0x0F };
+    expect(parse_exact(odd_list, sizeof(odd_list), &info), step, "odd list parses");
+    expect(bt_adv_has_uuid(&info, uuid_hr16, 2), step, "whole UUID of an odd list");
+
+    /* Structure ending exactly at max_len */
+    static const uint8_t exact[] = { 0x02, 0x01, 0x06, 0x03, 0x03, 0x0D, 0x18 };
+    expect(parse_exact(exact, sizeof(exact), &info), step, "exact fit parses");
+    expect(info.length == sizeof(exact), step, "exact fit length");
+
+    /* max_len above BT_ADV_MAX_LEN: only BT_ADV_MAX_LEN bytes are read */
+    uint8_t full[BT_ADV_MAX_LEN];
+    memset(full, 0, sizeof(full));
+    for (uint32_t pos = 0; pos + 3U < BT_ADV_MAX_LEN; pos += 3U) {
+        full[pos] = 0x02;
+        full[pos + 1U] = 0xAB;      /* Unknown type */
+    }
+    full[BT_ADV_MAX_LEN - 2U] = 0x01;
+    full[BT_ADV_MAX_LEN - 1U] = 0xAB;
+    uint8_t *block = exact_copy(full, BT_ADV_MAX_LEN);
+    expect(bt_adv_parse(block, 1000U, &info), step, "oversized max_len clamped");
+    expect(info.length == BT_ADV_MAX_LEN, step, "BT_ADV_MAX_LEN bytes parsed");
+    free(block);
+
+    expect(parse_exact(full, 0U, &info) && info.length == 0U, step, "zero max_len");
+    expect(bt_adv_parse(NULL, 10U, &info) && info.present == 0U, step, "NULL data");
+}
+
+/*******************************************************************************
+ * Random Buffers
+ ******************************************************************************/
+
+/* Structure walk written from the spec, to compare with the parser */
+static bool reference_walk(const uint8_t *data, uint32_t len, uint32_t *parsed)
+{
+    uint32_t pos = 0;
+
+    *parsed = 0;
+    while (pos < len && data[pos] != 0U) {
+        if (pos + 1U + data[pos] > len) {
+            return false;
+        }
+        pos += 1U + data[pos];
+        *parsed = pos;
+    }
+    return true;
+}
+
+static bool ref_inside(const bt_adv_info_t *info, bt_adv_ref_t ref)
+{
+    return (uint32_t)ref.offset + ref.len <= info->length;
+}
+
+static void check_random(const uint8_t *data, uint32_t len, uint32_t *mismatches)
+{
+    bt_adv_info_t info;
+    char name[BT_ADV_MAX_LEN + 1];
+    uint8_t *block = exact_copy(data, len);
+    bool ok = bt_adv_parse(block, len, &info);
+
+    uint32_t parsed;
+    bool ref_ok = reference_walk(data, len, &parsed);
+    bool good = (ok == ref_ok) && (info.length == parsed) && (info.length <= len);
+
+    good = good && ref_inside(&info, info.name) && ref_inside(&info, info.uuid16) &&
+           ref_inside(&info, info.uuid32) && ref_inside(&info, info.uuid128) &&
+           ref_inside(&info, info.manufacturer);
+
+    /* Exercise the readers on the block while it is still allocated */
+    uint32_t n = bt_adv_copy_name(&info, name, sizeof(name));
+    good = good && (name[n] == '\0');
+    (void)bt_adv_has_uuid(&info, uuid_hr16, 2);
+    (void)bt_adv_has_uuid(&info, uuid_x32, 4);
+    (void)bt_adv_has_uuid(&info, uuid_hr128, 16);
+
+    ipc_bt_scan_filter_t f;
+    memset(&f, 0, sizeof(f));
+    f.match = (uint8_t)(rng_next() & 0x07U);
+    f.company_id = 0x004C;
+    f.uuid_len = (uint8_t)(rng_next() % 18U);
+    memcpy(f.uuid, uuid_hr128, sizeof(uuid_hr128));
+    (void)bt_adv_filter_match(&f, &info);
+
+    free(block);
+    if (!good) {
+        (*mismatches)++;
+    }
+}
+
+static void test_random(void)
+{
+    const char *step = "random";
+    static const uint8_t *const seeds[] = { adv_hrm, rsp_hrm, adv_ibeacon, adv_eddystone,
+                                            adv_phone };
+    static const uint32_t seed_len[] = { sizeof(adv_hrm), sizeof(rsp_hrm), sizeof(adv_ibeacon),
+                                         sizeof(adv_eddystone), sizeof(adv_phone) };
+    uint8_t buf[BT_ADV_MAX_LEN];
+    uint32_t mismatches = 0;
+    double t0 = now_s();
+
+    /* Random bytes; small length bytes are made common so that buffers
+     * hold several structures */
+    for (uint32_t i = 0; i < RANDOM_BUFFERS; i++) {
+        uint32_t len = rng_next() % (BT_ADV_MAX_LEN + 1U);
+        for (uint32_t k = 0; k < len; k++) {
+            uint32_t r = rng_next();
+            buf[k] = (r & 0x100U) ? (uint8_t)(r % 20U) : (uint8_t)r;
+        }
+        check_random(buf, len, &mismatches);
+    }
+
+    /* Valid advertisements with 1-3 bytes changed, cut at random */
+    for (uint32_t i = 0; i < MUTATED_BUFFERS; i++) {
+        uint32_t s = rng_next() % (sizeof(seeds) / sizeof(seeds[0]));
+        uint32_t len = seed_len[s];
+        memcpy(buf, seeds[s], len);
+
+        uint32_t changes = 1U + (rng_next() % 3U);
+        for (uint32_t c = 0; c < changes; c++) {
+            buf[rng_next() % len] = (uint8_t)rng_next();
+        }
+        if ((rng_next() & 3U) == 0U) {
+            len = rng_next() % (len + 1U);
+        }
+        check_random(buf, len, &mismatches);
+    }
+
+    double dt = now_s() - t0;
+    uint32_t total = RANDOM_BUFFERS + MUTATED_BUFFERS;
+
+    printf("  %lu buffers, %lu mismatches, %.0f ns per buffer (parse, readers, malloc)\n",
+           (unsigned long)total, (unsigned long)mismatches, dt * 1e9 / total);
+    expect(mismatches == 0U, step, "parser disagrees with the reference walk");
+}
+
+/*******************************************************************************
+ * Main
+ ******************************************************************************/
+int main(void)
+{
+    test_samples();
+    test_malformed();
+    test_random();
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("bt_adv_parser: OK\n");
+    return 0;
+}
@@ -0,0 +1,337 @@
+/*******************************************************************************
+ * File: bt_scan_table_bench.c
+ * Description: Host advertisement-flood benchmark for
+ *              proj_cm33_ns/source/bt_scan_table.c
+ *
+ * Feeds synthetic advertisement streams through the scan table and
+ * through the list it replaced (linear memcmp search, first come first
+ * kept, BT_SCAN_MAX_RESULTS entries, as bt_task.c had it):
+ *
+ *   quiet       16 devices advertising
+ *   busy        BT_SCAN_TABLE_SIZE devices advertising
+ *   flood       a flood of one-shot random addresses (beacons, phones
+ *               rotating their private address) is already on the air
+ *               when PERSISTENT devices start advertising among it
+ *
+ * and reports time per advertisement, probes per lookup, evictions and
+ * how many of the persistent devices each keeps.
+ *
+ * Checks: the table holds exactly the devices an LRU reference model
+ * holds, address type is part of the key, the persistent devices survive
+ * the flood, lookups stay short at every load, RSSI is smoothed and the
+ * export is strongest first.
+ *
+ * Timings are host figures: use them to compare the two structures, not
+ * as Cortex-M33 cycle counts. The old list is cheaper per advertisement
+ * only because it stops tracking after SCAN_RESULTS devices; the "kept"
+ * column shows what that costs.
+ *
+ * Part of BiiL Course: Embedded C for IoT - Week 7
+ ******************************************************************************/
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "bt_scan_table.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define ADVERTS             2000000U    /* Per benchmark stream */
+#define PERSISTENT          20U         /* Devices that keep advertising */
+#define FLOOD_LEAD          1000U       /* Flood-only adverts before they appear */
+#define SCAN_RESULTS        16U         /* BT_SCAN_MAX_RESULTS (bt_task.h) */
+
+/* Linear probing at the table's 50% load averages 1.5 probes to find a
+ * device and 2.5 to miss one */
+#define MAX_AVG_PROBES      2.5
+
+/*******************************************************************************
+ * Helpers
+ ******************************************************************************/
+static uint32_t rng_state = 0x9E3779B9U;
+
+static uint32_t rng_next(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static void random_addr(uint8_t *addr)
+{
+    for (uint32_t k = 0; k < BT_ADDR_LEN; k++) {
+        addr[k] = (uint8_t)rng_next();
+    }
+}
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/*******************************************************************************
+ * LRU Reference Model
+ ******************************************************************************/
+typedef struct {
+    uint8_t addr[BT_ADDR_LEN];
+    uint8_t addr_type;
+    uint32_t used;
+} ref_dev_t;
+
+static ref_dev_t ref[BT_SCAN_TABLE_SIZE];
+static uint32_t ref_count;
+static uint32_t ref_clock;
+
+static void ref_update(const uint8_t *addr, uint8_t addr_type)
+{
+    uint32_t victim = 0;
+
+    ref_clock++;
+    for (uint32_t i = 0; i < ref_count; i++) {
+        if ((ref[i].addr_type == addr_type) && (memcmp(ref[i].addr, addr, BT_ADDR_LEN) == 0)) {
+            ref[i].used = ref_clock;
+            return;
+        }
+    }
+
+    if (ref_count < BT_SCAN_TABLE_SIZE) {
+        victim = ref_count++;
+    } else {
+        for (uint32_t i = 1; i < ref_count; i++) {
+            if (ref[i].used < ref[victim].used) {
+                victim = i;
+            }
+        }
+    }
+    memcpy(ref[victim].addr, addr, BT_ADDR_LEN);
+    ref[victim].addr_type = addr_type;
+    ref[victim].used = ref_clock;
+}
+
+/*******************************************************************************
+ * Old List (bt_task.c before the table)
+ ******************************************************************************/
+static ipc_bt_device_t old_list[SCAN_RESULTS];
+static uint32_t old_count;
+
+static void old_update(const uint8_t *addr, int8_t rssi)
+{
+    for (uint32_t i = 0; i < old_count; i++) {
+        if (memcmp(old_list[i].addr, addr, BT_ADDR_LEN) == 0) {
+            old_list[i].rssi = rssi;
+            return;
+        }
+    }
+    if (old_count < SCAN_RESULTS) {
+        memset(&old_list[old_count], 0, sizeof(ipc_bt_device_t));
+        memcpy(old_list[old_count].addr, addr, BT_ADDR_LEN);
+        old_list[old_count].rssi = rssi;
+        old_count++;
+    }
+}
+
+static bool old_has(const uint8_t *addr)
+{
+    for (uint32_t i = 0; i < old_count; i++) {
+        if (memcmp(old_list[i].addr, addr, BT_ADDR_LEN) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*******************************************************************************
+ * Streams
+ ******************************************************************************/
+typedef enum {
+    STREAM_QUIET,
+    STREAM_BUSY,
+    STREAM_FLOOD
+} stream_t;
+
+static uint8_t devices[BT_SCAN_TABLE_SIZE][BT_ADDR_LEN];
+static uint8_t (*stream)[BT_ADDR_LEN];
+static int8_t *stream_rssi;
+
+static void build_stream(stream_t kind)
+{
+    for (uint32_t i = 0; i < ADVERTS; i++) {
+        switch (kind) {
+        case STREAM_QUIET:
+            memcpy(stream[i], devices[rng_next() % 16U], BT_ADDR_LEN);
+            break;
+        case STREAM_BUSY:
+            memcpy(stream[i], devices[rng_next() % BT_SCAN_TABLE_SIZE], BT_ADDR_LEN);
+            break;
+        case STREAM_FLOOD:
+            /* Half flood; the persistent devices take turns in the other half */
+            if ((i < FLOOD_LEAD) || ((i & 1U) == 0U)) {
+                random_addr(stream[i]);
+            } else {
+                memcpy(stream[i], devices[(i / 2U) % PERSISTENT], BT_ADDR_LEN);
+            }
+            break;
+        }
+        stream_rssi[i] = (int8_t)(-40 - (int32_t)(rng_next() % 50U));
+    }
+}
+
+/*******************************************************************************
+ * Main
+ ******************************************************************************/
+static int failures = 0;
+
+static void expect(bool ok, const char *step, const char *what)
+{
+    if (!ok) {
+        printf("FAIL %s: %s\n", step, what);
+        failures++;
+    }
+}
+
+/* Probes per lookup: an eviction adds two lookups to its advert (the
+ * victim, then the insert slot again) */
+static double avg_probes(void)
+{
+    bt_scan_table_stats_t st;
+    bt_scan_table_get_stats(&st);
+    uint32_t lookups = st.adverts + 2U * st.evictions;
+    return (lookups != 0U) ? (double)st.probes / (double)lookups : 0.0;
+}
+
+int main(void)
+{
+    bt_scan_table_stats_t st;
+
+    for (uint32_t i = 0; i < BT_SCAN_TABLE_SIZE; i++) {
+        random_addr(devices[i]);
+    }
+
+    /* Contents against the LRU reference: regulars plus passers-by */
+    static uint8_t pool[300][BT_ADDR_LEN];
+    for (uint32_t i = 0; i < 300U; i++) {
+        random_addr(pool[i]);
+    }
+    bt_scan_table_reset();
+    for (uint32_t i = 0; i < 200000U; i++) {
+        uint32_t d = ((rng_next() % 3U) != 0U) ? rng_next() % 20U : rng_next() % 300U;
+        uint8_t type = (uint8_t)(d & 1U);
+        ipc_bt_device_t *dev = bt_scan_table_update(pool[d], type, -60, NULL);
+        ref_update(pool[d], type);
+        if ((dev == NULL) || (memcmp(dev->addr, pool[d], BT_ADDR_LEN) != 0) || (dev->addr_type != type)) {
+            expect(false, "reference", "update returned the wrong entry");
+            break;
+        }
+    }
+    uint32_t missing = 0;
+    for (uint32_t i = 0; i < ref_count; i++) {
+        if (bt_scan_table_find(ref[i].addr, ref[i].addr_type) == NULL) {
+            missing++;
+        }
+    }
+    bt_scan_table_get_stats(&st);
+    printf("reference: %u adverts, %u devices added, %u evicted, %u missing\n",
+           st.adverts, st.devices, st.evictions, missing);
+    expect(bt_scan_table_count() == ref_count, "reference", "device count differs");
+    expect(missing == 0U, "reference", "table does not hold the LRU set");
+
+    /* Address type is part of the key */
+    bt_scan_table_reset();
+    bool is_new = false;
+    (void)bt_scan_table_update(devices[0], 0U, -50, &is_new);
+    (void)bt_scan_table_update(devices[0], 1U, -50, &is_new);
+    expect(is_new && (bt_scan_table_count() == 2U), "addr type", "public and random address merged");
+
+    /* RSSI smoothing: alternating -60/-70 settles in between */
+    bt_scan_table_reset();
+    ipc_bt_device_t *dev = NULL;
+    for (uint32_t i = 0; i < 40U; i++) {
+        dev = bt_scan_table_update(devices[0], 0U, (int8_t)(((i & 1U) != 0U) ? -60 : -70), NULL);
+    }
+    printf("smoothing: alternating -60/-70 dBm -> %d dBm\n", dev->rssi);
+    expect((dev->rssi >= -67) && (dev->rssi <= -63), "smoothing", "average outside -67..-63 dBm");
+
+    /* Streams */
+    stream = malloc((size_t)ADVERTS * BT_ADDR_LEN);
+    stream_rssi = malloc(ADVERTS);
+    if ((stream == NULL) || (stream_rssi == NULL)) {
+        printf("out of memory\n");
+        return 1;
+    }
+
+    static const struct {
+        stream_t kind;
+        const char *name;
+    } streams[] = {
+        { STREAM_QUIET, "quiet (16)" },
+        { STREAM_BUSY,  "busy (64)" },
+        { STREAM_FLOOD, "flood" },
+    };
+
+    printf("%-12s %12s %10s %10s %10s %12s %10s\n", "stream", "table", "probes", "max", "evicted",
+           "old list", "kept");
+    for (size_t k = 0; k < sizeof(streams) / sizeof(streams[0]); k++) {
+        build_stream(streams[k].kind);
+
+        bt_scan_table_reset();
+        double t0 = now_s();
+        for (uint32_t i = 0; i < ADVERTS; i++) {
+            (void)bt_scan_table_update(stream[i], 0U, stream_rssi[i], NULL);
+        }
+        double t1 = now_s();
+
+        old_count = 0;
+        double t2 = now_s();
+        for (uint32_t i = 0; i < ADVERTS; i++) {
+            old_update(stream[i], stream_rssi[i]);
+        }
+        double t3 = now_s();
+
+        uint32_t kept = 0;
+        uint32_t old_kept = 0;
+        uint32_t expected = (streams[k].kind == STREAM_QUIET) ? 16U :
+                            (streams[k].kind == STREAM_BUSY) ? BT_SCAN_TABLE_SIZE : PERSISTENT;
+        for (uint32_t i = 0; i < expected; i++) {
+            kept += (bt_scan_table_find(devices[i], 0U) != NULL) ? 1U : 0U;
+            old_kept += old_has(devices[i]) ? 1U : 0U;
+        }
+
+        double probes = avg_probes();
+        bt_scan_table_get_stats(&st);
+        printf("%-12s %9.1f ns %10.2f %10u %10u %9.1f ns %4u / %-4u (old %u)\n", streams[k].name,
+               (t1 - t0) / ADVERTS * 1e9, probes, st.max_probe, st.evictions,
+               (t3 - t2) / ADVERTS * 1e9, kept, expected, old_kept);
+
+        expect(kept == expected, streams[k].name, "advertising device dropped");
+        expect(probes <= MAX_AVG_PROBES, streams[k].name, "lookups average more than 2.5 probes");
+
+        /* Export: strongest first */
+        ipc_bt_device_t out[SCAN_RESULTS];
+        uint32_t n = bt_scan_table_export(out, SCAN_RESULTS);
+        bool ordered = (n == SCAN_RESULTS);
+        for (uint32_t i = 1; i < n; i++) {
+            ordered = ordered && (out[i].rssi <= out[i - 1U].rssi);
+        }
+        expect(ordered, streams[k].name, "export not full or not strongest first");
+    }
+
+    free(stream);
+    free(stream_rssi);
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("bt_scan_table: OK\n");
+    return 0;
+}
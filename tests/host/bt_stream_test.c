@@ -0,0 +1,414 @@
+/*******************************************************************************
+ * File: bt_stream_test.c
+ * Description: Host test for proj_cm33_ns/source/bt_stream.c
+ *
+ * Drives the packetizer the way bt_sensor_gatt.c does (add, flush, next,
+ * sent, released) and decodes every packet it hands out, as a phone
+ * would:
+ *
+ *   round trip  IMU samples at the BMI270 ODR with clock jitter, gaps
+ *               longer than dt can encode and the 32-bit us clock
+ *               wrapping; samples arrive complete and in order, decoded
+ *               timestamps are within half a dt unit, seq has no gaps
+ *   packing     packets never exceed the payload of the MTU and close
+ *               only when full or flushed; an MTU drop closes a packet
+ *               built for the larger MTU; flush closes a stale packet
+ *   ring        a full ring drops (and counts) new samples, unsent
+ *               gives a packet back, and a reset drops only what the
+ *               stack does not hold: packets in flight keep their bytes
+ *               and are released in order
+ *   link        a simulated connection (credits per interval, packets
+ *               transmitted at the next connection event) carries the
+ *               100 Hz IMU and ADC streams without drops
+ *
+ * Part of BiiL Course: Embedded C for IoT - Week 7
+ ******************************************************************************/
+
+#include "bt_stream.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define IMU_SAMPLE_SIZE     12U         /* bt_sensor_imu_t */
+#define ADC_SAMPLE_SIZE     2U          /* bt_sensor_adc_t */
+#define ODR_US              10000U      /* IMU_STREAM_INTERVAL_MS */
+#define ODR_JITTER_US       300U        /* Task release jitter */
+#define FLUSH_US            100000U     /* BT_SENSOR_FLUSH_MS */
+#define NOTIFY_PER_INTERVAL 4U          /* BT_SENSOR_NOTIFY_PER_INTERVAL */
+
+#define ROUND_TRIP_SAMPLES  20000U
+#define GAP_EVERY           2000U       /* Samples between long gaps */
+#define GAP_US              8000000U    /* Above the 6.5 s dt range */
+
+/*******************************************************************************
+ * Helpers
+ ******************************************************************************/
+static uint32_t rng_state = 0xC0FFEE11U;
+
+static uint32_t rng_next(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static int failures = 0;
+
+static void expect(bool ok, const char *step, const char *what)
+{
+    if (!ok) {
+        printf("FAIL %s: %s\n", step, what);
+        failures++;
+    }
+}
+
+static uint32_t read_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+           ((uint32_t)p[3] << 24);
+}
+
+/* Sample contents derived from its index, so the decoder can check them */
+static void make_sample(uint8_t *sample, uint32_t size, uint32_t index)
+{
+    for (uint32_t k = 0; k < size; k++) {
+        sample[k] = (uint8_t)(index * 7U + k);
+    }
+}
+
+/*******************************************************************************
+ * Decoder (the phone side)
+ ******************************************************************************/
+typedef struct {
+    uint32_t sample_size;
+    uint32_t next_index;        /* Index of the next sample expected */
+    uint8_t  next_seq;
+    bool     seq_started;
+    uint32_t packets;
+    uint32_t worst_ts_err_us;
+    bool     ok;
+    const uint32_t *times;      /* True sample times by index */
+} decoder_t;
+
+static void decode(decoder_t *d, const uint8_t *p, uint16_t len, uint16_t payload_max)
+{
+    uint32_t count = p[1];
+    uint32_t t = read_le32(&p[2]);
+
+    if ((len > payload_max) ||
+        (len != BT_STREAM_HEADER_SIZE + count * (BT_STREAM_DT_SIZE + d->sample_size)) ||
+        (count == 0U) || (d->seq_started && (p[0] != d->next_seq))) {
+        d->ok = false;
+    }
+    d->next_seq = (uint8_t)(p[0] + 1U);
+    d->seq_started = true;
+    d->packets++;
+
+    const uint8_t *q = &p[BT_STREAM_HEADER_SIZE];
+    for (uint32_t j = 0; j < count; j++) {
+        uint8_t expected[BT_STREAM_MAX_PAYLOAD];
+        uint32_t dt = (uint32_t)q[0] | ((uint32_t)q[1] << 8);
+
+        if ((j == 0U) && (dt != 0U)) {
+            d->ok = false;
+        }
+        t += dt * BT_STREAM_DT_UNIT_US;
+
+        int32_t err = (int32_t)(t - d->times[d->next_index]);
+        uint32_t mag = (err < 0) ? (uint32_t)(-err) : (uint32_t)err;
+        if (mag > d->worst_ts_err_us) {
+            d->worst_ts_err_us = mag;
+        }
+
+        make_sample(expected, d->sample_size, d->next_index);
+        if (memcmp(&q[BT_STREAM_DT_SIZE], expected, d->sample_size) != 0) {
+            d->ok = false;
+        }
+        d->next_index++;
+        q += BT_STREAM_DT_SIZE + d->sample_size;
+    }
+}
+
+/*******************************************************************************
+ * Tests
+ ******************************************************************************/
+static uint32_t times[ROUND_TRIP_SAMPLES];
+
+static void test_round_trip(void)
+{
+    static bt_stream_t s;
+    decoder_t d = { IMU_SAMPLE_SIZE, 0, 0, false, 0, 0, true, times };
+    uint8_t sample[IMU_SAMPLE_SIZE];
+    uint32_t t = 0xFFFFFFFFU - 3000000U;        /* Wraps after 3 s */
+    uint32_t accepted = 0;
+
+    bt_stream_init(&s, IMU_SAMPLE_SIZE);
+    bt_stream_set_mtu(&s, BT_STREAM_MAX_MTU);
+
+    for (uint32_t i = 0; i < ROUND_TRIP_SAMPLES; i++) {
+        t += ODR_US - ODR_JITTER_US + (rng_next() % (2U * ODR_JITTER_US + 1U));
+        if ((i % GAP_EVERY) == GAP_EVERY - 1U) {
+            t += GAP_US;
+        }
+
+        times[accepted] = t;
+        make_sample(sample, IMU_SAMPLE_SIZE, accepted);
+        if (bt_stream_add(&s, t, sample)) {
+            accepted++;
+        }
+        bt_stream_flush(&s, t, FLUSH_US);
+
+        uint16_t len = 0;
+        uint8_t *p;
+        while ((p = bt_stream_next(&s, &len)) != NULL) {
+            bt_stream_sent(&s);
+            decode(&d, p, len, s.payload_max);
+            bt_stream_released(&s);
+        }
+    }
+    bt_stream_flush(&s, t + FLUSH_US, FLUSH_US);
+    uint16_t len = 0;
+    uint8_t *p = bt_stream_next(&s, &len);
+    if (p != NULL) {
+        bt_stream_sent(&s);
+        decode(&d, p, len, s.payload_max);
+        bt_stream_released(&s);
+    }
+
+    /* A packet closes when full or when its first sample is FLUSH_US old */
+    uint32_t per_packet_max = (BT_STREAM_MAX_PAYLOAD - BT_STREAM_HEADER_SIZE) /
+                              (BT_STREAM_DT_SIZE + IMU_SAMPLE_SIZE);
+    uint32_t per_flush = FLUSH_US / ODR_US + 1U;
+    uint32_t per_packet_expected = (per_flush < per_packet_max) ? per_flush : per_packet_max;
+    double per_packet = (double)d.next_index / (double)d.packets;
+
+    printf("round trip: %u samples, %u packets (%.1f samples each, full %u, flush age %u), "
+           "worst timestamp error %u us, %u dropped\n",
+           d.next_index, d.packets, per_packet, per_packet_max, per_flush,
+           d.worst_ts_err_us, s.dropped);
+    expect(d.ok, "round trip", "packet malformed, sample corrupted or seq gap");
+    expect(accepted == ROUND_TRIP_SAMPLES, "round trip", "samples dropped with a drained ring");
+    expect(d.next_index == accepted, "round trip", "samples lost");
+    expect(d.worst_ts_err_us <= BT_STREAM_DT_UNIT_US / 2U, "round trip",
+           "timestamp error above half a dt unit");
+    /* Release jitter moves a sample across the flush age now and then */
+    expect(per_packet > (double)per_packet_expected - 1.0, "round trip", "packets closed early");
+}
+
+static void test_mtu_and_flush(void)
+{
+    static bt_stream_t s;
+    uint8_t sample[IMU_SAMPLE_SIZE] = { 0 };
+    uint16_t len = 0;
+
+    bt_stream_init(&s, IMU_SAMPLE_SIZE);
+    expect(s.payload_max == BT_STREAM_DEFAULT_MTU - BT_STREAM_ATT_HEADER, "mtu",
+           "default payload");
+
+    /* Default MTU: one IMU sample per packet */
+    (void)bt_stream_add(&s, 1000U, sample);
+    expect(bt_stream_pending(&s) == 1U, "mtu", "full packet at the default MTU not closed");
+
+    /* Open packet built for 247, MTU drops to 23 */
+    bt_stream_reset(&s);
+    bt_stream_set_mtu(&s, BT_STREAM_MAX_MTU);
+    for (uint32_t i = 0; i < 5U; i++) {
+        (void)bt_stream_add(&s, 1000U + i * ODR_US, sample);
+    }
+    expect(bt_stream_pending(&s) == 0U, "mtu", "packet closed before it was full");
+    bt_stream_set_mtu(&s, BT_STREAM_DEFAULT_MTU);
+    uint8_t *p = bt_stream_next(&s, &len);
+    expect((p != NULL) && (p[1] == 5U), "mtu", "oversized open packet not closed on MTU drop");
+
+    /* Flush: a partly filled packet goes out once its first sample is old */
+    bt_stream_reset(&s);
+    bt_stream_set_mtu(&s, BT_STREAM_MAX_MTU);
+    (void)bt_stream_add(&s, 50000U, sample);
+    bt_stream_flush(&s, 50000U + FLUSH_US - 1U, FLUSH_US);
+    expect(bt_stream_pending(&s) == 0U, "flush", "flushed before max age");
+    bt_stream_flush(&s, 50000U + FLUSH_US, FLUSH_US);
+    expect(bt_stream_pending(&s) == 1U, "flush", "not flushed at max age");
+}
+
+static void test_ring(void)
+{
+    static bt_stream_t s;
+    uint8_t sample[ADC_SAMPLE_SIZE] = { 0 };
+    uint8_t copy[2][BT_STREAM_MAX_PAYLOAD];
+    uint16_t len = 0;
+    uint8_t *p;
+
+    /* Nothing drained: the ring fills, then samples are dropped */
+    bt_stream_init(&s, ADC_SAMPLE_SIZE);
+    uint32_t accepted = 0;
+    for (uint32_t i = 0; i < 100U; i++) {
+        accepted += bt_stream_add(&s, i * ODR_US, sample) ? 1U : 0U;
+    }
+    uint32_t per_packet = (BT_STREAM_DEFAULT_MTU - BT_STREAM_ATT_HEADER - BT_STREAM_HEADER_SIZE) /
+                          (BT_STREAM_DT_SIZE + ADC_SAMPLE_SIZE);
+    printf("ring: %u accepted, %u dropped, %u pending\n", accepted, s.dropped,
+           bt_stream_pending(&s));
+    expect(accepted == BT_STREAM_QUEUE_DEPTH * per_packet, "ring", "accepted more than the ring holds");
+    expect(s.dropped == 100U - accepted, "ring", "drops not counted");
+
+    /* Refused by the stack: unsent gives the same packet back */
+    p = bt_stream_next(&s, &len);
+    bt_stream_sent(&s);
+    bt_stream_unsent(&s);
+    expect(bt_stream_next(&s, &len) == p, "ring", "unsent packet not offered again");
+
+    /* Two packets held by the stack, two queued, then a reset */
+    for (uint32_t k = 0; k < 2U; k++) {
+        p = bt_stream_next(&s, &len);
+        memcpy(copy[k], p, len);
+        bt_stream_sent(&s);
+    }
+    uint8_t seq_after = (uint8_t)(copy[1][0] + 3U);     /* Gap of the two dropped */
+    bt_stream_reset(&s);
+    expect((bt_stream_pending(&s) == 0U) && (s.in_flight == 2U), "reset",
+           "queued packets kept or in-flight packets dropped");
+
+    /* New samples fill the free slots only */
+    sample[0] = 0xA5U;
+    accepted = 0;
+    for (uint32_t i = 0; i < 100U; i++) {
+        accepted += bt_stream_add(&s, 2000000U + i * ODR_US, sample) ? 1U : 0U;
+    }
+    expect(accepted == (BT_STREAM_QUEUE_DEPTH - 2U) * per_packet, "reset",
+           "new packets took the slots of packets in flight");
+    expect(memcmp(s.pkt[s.head], copy[0], 1U) == 0, "reset", "oldest in-flight packet moved");
+
+    /* The stack reports them transmitted, oldest first */
+    for (uint32_t k = 0; k < 2U; k++) {
+        uint32_t slot = s.head;
+        expect(memcmp(s.pkt[slot], copy[k], s.pkt_len[slot]) == 0, "reset",
+               "in-flight packet overwritten");
+        bt_stream_released(&s);
+    }
+    p = bt_stream_next(&s, &len);
+    expect((p != NULL) && (p[0] == seq_after) && (p[BT_STREAM_HEADER_SIZE + 2U] == 0xA5U),
+           "reset", "first packet after the reset wrong");
+}
+
+/* Connection: credits per interval, the stack holds what it was given
+ * until the next connection event */
+static uint32_t simulate_link(uint16_t mtu, uint32_t interval_us, uint32_t *packets)
+{
+    static bt_stream_t imu;
+    static bt_stream_t adc;
+    bt_stream_t *streams[2] = { &imu, &adc };
+    bt_stream_rate_t rate;
+    uint8_t imu_sample[IMU_SAMPLE_SIZE] = { 0 };
+    uint8_t adc_sample[ADC_SAMPLE_SIZE] = { 0 };
+    uint32_t next_event = interval_us;
+    uint32_t next_stream = 0;
+
+    bt_stream_init(&imu, IMU_SAMPLE_SIZE);
+    bt_stream_init(&adc, ADC_SAMPLE_SIZE);
+    bt_stream_set_mtu(&imu, mtu);
+    bt_stream_set_mtu(&adc, mtu);
+    bt_stream_rate_init(&rate, NOTIFY_PER_INTERVAL, interval_us, 0U);
+
+    for (uint32_t t = 0; t < 60000000U; t += 500U) {
+        if ((t % ODR_US) == 0U) {
+            (void)bt_stream_add(&imu, t, imu_sample);
+            (void)bt_stream_add(&adc, t, adc_sample);
+        }
+
+        /* Connection event: what the stack held went out */
+        if (t >= next_event) {
+            next_event += interval_us;
+            for (uint32_t k = 0; k < 2U; k++) {
+                while (streams[k]->in_flight > 0U) {
+                    bt_stream_released(streams[k]);
+                }
+                bt_stream_flush(streams[k], t, FLUSH_US);
+            }
+        }
+
+        /* Pump, round-robin between the streams */
+        for (uint32_t n = 0; n < 2U; n++) {
+            bt_stream_t *st = streams[(next_stream + n) % 2U];
+            uint16_t len = 0;
+            while ((bt_stream_next(st, &len) != NULL) && bt_stream_rate_take(&rate, t)) {
+                bt_stream_sent(st);
+            }
+        }
+        next_stream ^= 1U;
+    }
+
+    *packets = imu.packets + adc.packets;
+    return imu.dropped + adc.dropped;
+}
+
+static void test_link(void)
+{
+    static const struct {
+        uint16_t mtu;
+        uint32_t interval_us;
+        bool must_keep_up;
+    } links[] = {
+        { BT_STREAM_MAX_MTU,     7500U,  true },    /* After the MTU exchange */
+        { BT_STREAM_MAX_MTU,     15000U, true },    /* BT_SENSOR_CONN_INTERVAL_MAX */
+        { BT_STREAM_MAX_MTU,     30000U, true },    /* Before the parameter update */
+        { BT_STREAM_DEFAULT_MTU, 15000U, true },    /* Central without MTU exchange */
+        { BT_STREAM_DEFAULT_MTU, 30000U, false },   /* At capacity: 133 notifications/s */
+    };
+
+    printf("%-6s %10s %10s %10s\n", "mtu", "interval", "packets/s", "dropped");
+    for (size_t i = 0; i < sizeof(links) / sizeof(links[0]); i++) {
+        uint32_t packets = 0;
+        uint32_t dropped = simulate_link(links[i].mtu, links[i].interval_us, &packets);
+        printf("%-6u %8uus %10u %10u\n", links[i].mtu, links[i].interval_us, packets / 60U, dropped);
+        if (links[i].must_keep_up) {
+            expect(dropped == 0U, "link", "100 Hz IMU + ADC streams dropped samples");
+        }
+    }
+}
+
+static void test_rate(void)
+{
+    bt_stream_rate_t r;
+    uint32_t granted = 0;
+
+    bt_stream_rate_init(&r, NOTIFY_PER_INTERVAL, 7500U, 0U);
+    for (uint32_t now = 0; now < 75000U; now += 500U) {
+        granted += bt_stream_rate_take(&r, now) ? 1U : 0U;
+    }
+    expect(granted == 10U * NOTIFY_PER_INTERVAL, "rate", "credits per interval");
+
+    /* Idle for a while: no saved-up burst */
+    granted = 0;
+    for (uint32_t k = 0; k < 3U * NOTIFY_PER_INTERVAL; k++) {
+        granted += bt_stream_rate_take(&r, 1000000U) ? 1U : 0U;
+    }
+    expect(granted == NOTIFY_PER_INTERVAL, "rate", "idle intervals saved up");
+
+    bt_stream_rate_return(&r);
+    expect(bt_stream_rate_take(&r, 1000000U), "rate", "returned credit not usable");
+}
+
+/*******************************************************************************
+ * Main
+ ******************************************************************************/
+int main(void)
+{
+    test_round_trip();
+    test_mtu_and_flush();
+    test_ring();
+    test_link();
+    test_rate();
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("bt_stream: OK\n");
+    return 0;
+}
@@ -0,0 +1,388 @@
+/*******************************************************************************
+ * File: sntp_client_test.c
+ * Description: Host test for proj_cm33_ns/source/sntp_client.c against a
+ *              local UDP stand-in server
+ *
+ * Every exchange goes over loopback UDP the way wifi_task.c does it: the
+ * request is built by sntp_build_request(), sent to a stand-in server
+ * socket, answered there and parsed by sntp_parse_reply(). The stand-in
+ * runs in the same thread, so the test needs no threads or timing luck.
+ *
+ * Time is simulated rather than read from the host clock, so a run covers
+ * hours of polling in milliseconds:
+ *
+ *   true time   Unix microseconds the servers stamp (plus their skew)
+ *   local clock starts at an arbitrary value and runs LOCAL_RATE_PPB fast,
+ *               like an uncalibrated board oscillator
+ *   path        each direction takes PATH_US +- PATH_JITTER_US
+ *
+ * Checks:
+ *   - malformed, stale, kiss-o'-death and unsynchronized replies are
+ *     rejected with their own result, and a round without samples counts
+ *     as a failure
+ *   - a falseticker among three servers is voted out
+ *   - the first round sets the clock within the path asymmetry
+ *   - the drift estimate converges on the local clock rate error and the
+ *     poll interval grows to its maximum while the clock holds
+ *   - a clock step is followed without corrupting the drift, and the poll
+ *     interval drops back
+ *
+ * Part of BiiL Course: Embedded C for IoT - Week 7
+ ******************************************************************************/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include "sntp_client.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define NUM_SERVERS         3U
+
+#define TRUE_START_US       1760000000000000LL  /* 2025-10 */
+#define LOCAL_START_US      5000000ULL          /* Board uptime at the first round */
+#define LOCAL_RATE_PPB      80000               /* Local clock 80 ppm fast */
+
+#define PATH_US             8000                /* One way */
+#define PATH_JITTER_US      400
+#define SERVER_PROC_US      300
+
+#define FALSETICKER_US      3000000LL           /* Server 2 is 3 s off */
+#define STEP_US             1000000LL           /* True time jumps by 1 s */
+
+#define ROUNDS              24U
+
+#define NTP_UNIX_OFFSET_S   2208988800ULL
+
+/*******************************************************************************
+ * Stand-in Server
+ ******************************************************************************/
+typedef enum {
+    SERVE_OK,
+    SERVE_SHORT,                /* Truncated reply */
+    SERVE_CLIENT_MODE,          /* Echo of a client packet */
+    SERVE_STALE,                /* Answers an older request */
+    SERVE_KOD,                  /* Stratum 0, "RATE" */
+    SERVE_UNSYNC                /* Leap indicator 3 */
+} serve_mode_t;
+
+typedef struct {
+    int fd;
+    struct sockaddr_in addr;
+    int64_t skew_us;
+    serve_mode_t mode;
+} server_t;
+
+static server_t servers[NUM_SERVERS];
+static int client_fd = -1;
+
+static int64_t true_us = TRUE_START_US;
+
+/* Deterministic path jitter (xorshift32) */
+static uint32_t rng_state = 0x2545F491U;
+
+static int32_t rng_jitter(int32_t range)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (int32_t)(rng_state % (uint32_t)(2 * range + 1)) - range;
+}
+
+static uint64_t local_us(void)
+{
+    int64_t elapsed = true_us - TRUE_START_US;
+    return LOCAL_START_US + (uint64_t)(elapsed + (elapsed * LOCAL_RATE_PPB) / 1000000000LL);
+}
+
+static int open_udp(struct sockaddr_in *bound)
+{
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct timeval tv = { 1, 0 };
+    (void)setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    struct sockaddr_in a;
+    memset(&a, 0, sizeof(a));
+    a.sin_family = AF_INET;
+    a.sin_port = 0;                                 /* Any free port */
+    a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(a);
+    if ((bind(fd, (struct sockaddr *)&a, sizeof(a)) != 0) ||
+        (getsockname(fd, (struct sockaddr *)&a, &len) != 0)) {
+        close(fd);
+        return -1;
+    }
+    if (bound != NULL) {
+        *bound = a;
+    }
+    return fd;
+}
+
+static void write_ntp(uint8_t *p, int64_t unix_us)
+{
+    uint64_t sec = (uint64_t)(unix_us / 1000000LL) + NTP_UNIX_OFFSET_S;
+    uint64_t frac = ((uint64_t)(unix_us % 1000000LL) << 32) / 1000000ULL;
+    for (int i = 0; i < 4; i++) {
+        p[i] = (uint8_t)(sec >> (24 - 8 * i));
+        p[4 + i] = (uint8_t)(frac >> (24 - 8 * i));
+    }
+}
+
+/* Answer one request on a server socket; the clock advances by the
+ * server processing time */
+static bool serve(server_t *srv)
+{
+    static uint8_t last_origin[8];
+    uint8_t req[64];
+    struct sockaddr_in from;
+    socklen_t from_len = sizeof(from);
+
+    ssize_t n = recvfrom(srv->fd, req, sizeof(req), 0, (struct sockaddr *)&from, &from_len);
+    if (n < (ssize_t)SNTP_PACKET_SIZE) {
+        return false;
+    }
+
+    uint8_t rep[SNTP_PACKET_SIZE];
+    memset(rep, 0, sizeof(rep));
+    rep[0] = (0U << 6) | (4U << 3) | 4U;            /* LI=0, VN=4, server */
+    rep[1] = 2U;                                    /* Stratum */
+    rep[2] = 6U;
+    rep[3] = 0xE9U;
+    memcpy(&rep[12], "GPS ", 4);
+
+    int64_t t2 = true_us + srv->skew_us;
+    true_us += SERVER_PROC_US;
+    int64_t t3 = true_us + srv->skew_us;
+
+    write_ntp(&rep[16], t2 - 16000000LL);           /* Reference */
+    memcpy(&rep[24], &req[40], 8);                  /* Origin = request transmit */
+    write_ntp(&rep[32], t2);
+    write_ntp(&rep[40], t3);
+
+    int len = (int)sizeof(rep);
+    switch (srv->mode) {
+    case SERVE_OK:
+        break;
+    case SERVE_SHORT:
+        len = 40;
+        break;
+    case SERVE_CLIENT_MODE:
+        rep[0] = (4U << 3) | 3U;
+        break;
+    case SERVE_STALE:
+        memcpy(&rep[24], last_origin, 8);
+        break;
+    case SERVE_KOD:
+        rep[1] = 0U;
+        memcpy(&rep[12], "RATE", 4);
+        break;
+    case SERVE_UNSYNC:
+        rep[0] |= 3U << 6;
+        break;
+    }
+    memcpy(last_origin, &req[40], 8);
+
+    return sendto(srv->fd, rep, (size_t)len, 0, (struct sockaddr *)&from, from_len) == len;
+}
+
+/*******************************************************************************
+ * Client Side (as in wifi_task.c)
+ ******************************************************************************/
+static sntp_result_t exchange(uint32_t index, sntp_sample_t *sample)
+{
+    server_t *srv = &servers[index];
+    uint8_t packet[SNTP_PACKET_SIZE + 16];
+    sntp_request_t req;
+
+    sntp_build_request(packet, local_us(), &req);
+    if (sendto(client_fd, packet, SNTP_PACKET_SIZE, 0,
+               (struct sockaddr *)&srv->addr, sizeof(srv->addr)) != (ssize_t)SNTP_PACKET_SIZE) {
+        return SNTP_ERR_SHORT;
+    }
+    true_us += PATH_US + rng_jitter(PATH_JITTER_US);
+
+    if (!serve(srv)) {
+        return SNTP_ERR_SHORT;
+    }
+    true_us += PATH_US + rng_jitter(PATH_JITTER_US);
+
+    ssize_t len = recv(client_fd, packet, sizeof(packet), 0);
+    sntp_result_t r = sntp_parse_reply(packet, (int)len, &req, local_us(), sample);
+    sample->server = (uint8_t)index;
+    return r;
+}
+
+/* One round over every server; returns what sntp_client_update() did */
+static bool run_round(uint32_t *used)
+{
+    sntp_sample_t samples[NUM_SERVERS];
+    uint32_t n = 0;
+
+    for (uint32_t i = 0; i < NUM_SERVERS; i++) {
+        if (exchange(i, &samples[n]) == SNTP_OK) {
+            n++;
+        }
+    }
+    if (used != NULL) {
+        *used = n;
+    }
+    return sntp_client_update(samples, n);
+}
+
+/* Client clock minus true time */
+static int64_t clock_error_us(void)
+{
+    int64_t unix_us = 0;
+    if (!sntp_client_now_us(local_us(), &unix_us)) {
+        return INT64_MAX;
+    }
+    return unix_us - true_us;
+}
+
+static int64_t abs64(int64_t v)
+{
+    return (v < 0) ? -v : v;
+}
+
+/*******************************************************************************
+ * Main
+ ******************************************************************************/
+static int failures = 0;
+
+static void expect(bool ok, const char *step, const char *what)
+{
+    if (!ok) {
+        printf("FAIL %s: %s\n", step, what);
+        failures++;
+    }
+}
+
+int main(void)
+{
+    client_fd = open_udp(NULL);
+    for (uint32_t i = 0; i < NUM_SERVERS; i++) {
+        servers[i].fd = open_udp(&servers[i].addr);
+        servers[i].skew_us = 0;
+        servers[i].mode = SERVE_OK;
+        if (servers[i].fd < 0) {
+            client_fd = -1;
+        }
+    }
+    if (client_fd < 0) {
+        perror("loopback UDP");
+        return 1;
+    }
+
+    sntp_client_reset();
+    sntp_status_t st;
+    sntp_sample_t smp;
+
+    /* Replies that must not be used */
+    static const struct {
+        serve_mode_t mode;
+        sntp_result_t expected;
+    } bad[] = {
+        { SERVE_SHORT,       SNTP_ERR_SHORT },
+        { SERVE_CLIENT_MODE, SNTP_ERR_MODE },
+        { SERVE_STALE,       SNTP_ERR_ORIGIN },
+        { SERVE_KOD,         SNTP_ERR_KOD },
+        { SERVE_UNSYNC,      SNTP_ERR_UNSYNC },
+    };
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        servers[0].mode = bad[i].mode;
+        sntp_result_t r = exchange(0, &smp);
+        printf("%-24s -> %s\n", sntp_result_str(bad[i].expected), sntp_result_str(r));
+        expect(r == bad[i].expected, "bad reply", "wrong parse result");
+    }
+    servers[0].mode = SERVE_OK;
+
+    expect(!sntp_client_update(&smp, 0U), "empty round", "update accepted no samples");
+    sntp_client_get_status(&st);
+    expect(!st.synced && (st.failures == 1U), "empty round", "not counted as a failure");
+    expect(st.poll_s == (1UL << SNTP_MIN_POLL_LOG2), "empty round", "poll not at minimum");
+
+    /* First round with a falseticker */
+    servers[2].skew_us = FALSETICKER_US;
+    uint32_t used = 0;
+    bool ok = run_round(&used);
+    sntp_client_get_status(&st);
+    int64_t err = clock_error_us();
+    printf("first round: %u samples, server %u, error %lld us, delay %u us, rejected %u\n",
+           used, st.server, (long long)err, st.delay_us, st.rejected);
+    expect(ok && st.synced && (used == NUM_SERVERS), "first round", "no sync");
+    expect(st.server != 2U, "first round", "falseticker used");
+    expect(st.rejected == 1U, "first round", "falseticker not rejected");
+    expect(abs64(err) <= PATH_JITTER_US + SERVER_PROC_US, "first round", "error above path asymmetry");
+
+    /* Poll on: drift converges, poll interval grows */
+    int64_t expected_ppb = -((int64_t)LOCAL_RATE_PPB * 1000000000LL) /
+                           (1000000000LL + LOCAL_RATE_PPB);   /* d(offset)/d(local) */
+    int64_t worst_late = 0;
+    uint32_t max_poll = 0;
+
+    printf("%5s %8s %12s %12s %10s\n", "round", "poll_s", "err_before", "residual", "drift_ppb");
+    for (uint32_t r = 0; r < ROUNDS; r++) {
+        true_us += (int64_t)sntp_client_poll_s() * 1000000LL;
+        int64_t before = clock_error_us();
+
+        ok = run_round(NULL);
+        sntp_client_get_status(&st);
+        printf("%5u %8u %12lld %12d %10d\n", r + 1U, st.poll_s, (long long)before,
+               st.residual_us, st.drift_ppb);
+        expect(ok, "polling", "round failed");
+
+        if (r >= ROUNDS / 2U && abs64(before) > worst_late) {
+            worst_late = abs64(before);
+        }
+        if (st.poll_s > max_poll) {
+            max_poll = st.poll_s;
+        }
+    }
+    printf("drift %d ppb (expected %lld), worst error before a late round %lld us\n",
+           st.drift_ppb, (long long)expected_ppb, (long long)worst_late);
+    expect(abs64((int64_t)st.drift_ppb - expected_ppb) < 2000, "polling", "drift off by 2 ppm or more");
+    expect(max_poll == (1UL << SNTP_MAX_POLL_LOG2), "polling", "poll interval never reached maximum");
+    expect(worst_late < SNTP_STABLE_US, "polling", "clock drifted past SNTP_STABLE_US between rounds");
+
+    /* True time steps (clock set on the servers' side) */
+    int32_t drift_before = st.drift_ppb;
+    for (uint32_t i = 0; i < NUM_SERVERS; i++) {
+        servers[i].skew_us += STEP_US;
+    }
+    true_us += (int64_t)sntp_client_poll_s() * 1000000LL;
+    ok = run_round(NULL);
+    sntp_client_get_status(&st);
+    err = clock_error_us() - STEP_US;
+    printf("step: residual %d us, error %lld us, drift %d ppb, poll %u s\n",
+           st.residual_us, (long long)err, st.drift_ppb, st.poll_s);
+    expect(ok, "step", "round failed");
+    expect(abs64(err) <= PATH_JITTER_US + SERVER_PROC_US, "step", "step not followed");
+    expect(st.drift_ppb == drift_before, "step", "step taken as drift");
+    expect(st.poll_s == (1UL << SNTP_MIN_POLL_LOG2), "step", "poll not back at minimum");
+
+    close(client_fd);
+    for (uint32_t i = 0; i < NUM_SERVERS; i++) {
+        close(servers[i].fd);
+    }
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("sntp_client: OK\n");
+    return 0;
+}
@@ -0,0 +1,24 @@
+/*******************************************************************************
+ * File: cy_syslib.h
+ * Description: Host stand-in for the PDL system library (single thread:
+ *              critical sections are no-ops)
+ *
+ * Part of BiiL Course: Embedded C for IoT
+ ******************************************************************************/
+
+#ifndef HOST_STUB_CY_SYSLIB_H
+#define HOST_STUB_CY_SYSLIB_H
+
+#include <stdint.h>
+
+static inline uint32_t Cy_SysLib_EnterCriticalSection(void)
+{
+    return 0U;
+}
+
+static inline void Cy_SysLib_ExitCriticalSection(uint32_t state)
+{
+    (void)state;
+}
+
+#endif /* HOST_STUB_CY_SYSLIB_H */
@@ -0,0 +1,56 @@
+/*******************************************************************************
+ * File: lvgl.h
+ * Description: Host stand-in for the parts of LVGL used by the modules
+ *              under test (memory core types, asserts)
+ *
+ * Part of BiiL Course: Embedded C for IoT
+ ******************************************************************************/
+
+#ifndef HOST_STUB_LVGL_H
+#define HOST_STUB_LVGL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define LV_STDLIB_BUILTIN       0
+#define LV_STDLIB_CLIB          1
+#define LV_STDLIB_CUSTOM        255
+#define LV_USE_STDLIB_MALLOC    LV_STDLIB_CUSTOM
+
+typedef void *lv_mem_pool_t;
+
+typedef enum {
+    LV_RESULT_INVALID = 0,
+    LV_RESULT_OK,
+} lv_result_t;
+
+typedef struct {
+    size_t total_size;
+    size_t free_cnt;
+    size_t free_size;
+    size_t free_biggest_size;
+    size_t used_cnt;
+    size_t max_used;
+    uint8_t used_pct;
+    uint8_t frag_pct;
+} lv_mem_monitor_t;
+
+#define LV_ASSERT_MSG(expr, msg)                                    \
+    do {                                                            \
+        if (!(expr)) {                                              \
+            printf("ASSERT %s (%s:%d)\n", msg, __FILE__, __LINE__); \
+            abort();                                                \
+        }                                                           \
+    } while (0)
+
+void lv_mem_init(void);
+void lv_mem_deinit(void);
+void *lv_malloc_core(size_t size);
+void lv_free_core(void *p);
+void *lv_realloc_core(void *p, size_t new_size);
+void lv_mem_monitor_core(lv_mem_monitor_t *mon_p);
+lv_result_t lv_mem_test_core(void);
+
+#endif /* HOST_STUB_LVGL_H */
@@ -0,0 +1,221 @@
+/*******************************************************************************
+ * File: touch_filter_test.c
+ * Description: Host trace-replay test for proj_cm55/aic-eec/touch_filter.h
+ *
+ * Replays synthetic touch traces (finger at rest, straight drag, circle)
+ * sampled at the reader task period with controller-like noise, through
+ * each per-display tuning of lv_port_indev.c, and measures:
+ *
+ *   jitter  RMS distance from the true point while the finger rests (px)
+ *   lag     how far the shown point trails the finger when the frame is
+ *           on screen, converted to ms along the motion
+ *
+ * The frame is assumed on screen predict_ms after the sample was read
+ * (the latency the prediction horizon was tuned to).
+ *
+ * Part of BiiL Course: Embedded C for IoT
+ ******************************************************************************/
+
+#include "touch_filter.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define SAMPLE_MS           20U         /* INDEV_READ_PERIOD_MS */
+#define NOISE_PX            1.5f        /* Controller noise, 1 sigma */
+#define SETTLE_MS           200U        /* Ignored at the start of a trace */
+
+#define DRAG_SPEED_PX_S     600.0f
+#define CIRCLE_RADIUS_PX    120.0f
+#define CIRCLE_HZ           1.0f
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef struct {
+    const char *name;
+    touch_filter_cfg_t cfg;
+} tuning_t;
+
+typedef enum {
+    TRACE_REST,
+    TRACE_DRAG,
+    TRACE_CIRCLE
+} trace_t;
+
+typedef struct {
+    float jitter_px;
+    float lag_ms;
+} result_t;
+
+/* Same values as lv_port_indev.c */
+static const tuning_t tunings[] = {
+    { "FT5406 4.3\"",  { 1.0f, 0.010f, 1.0f, 30.0f, 24.0f } },
+    { "GT911 7\"",     { 1.5f, 0.007f, 1.0f, 30.0f, 24.0f } },
+    { "ILI2511 10.1\"", { 1.5f, 0.007f, 1.0f, 20.0f, 24.0f } },
+};
+
+/*******************************************************************************
+ * Helpers
+ ******************************************************************************/
+
+/* Deterministic Gaussian noise (xorshift32 + Box-Muller) */
+static uint32_t rng_state = 0x12345678U;
+
+static float rng_uniform(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return ((float)(rng_state >> 8) + 0.5f) / 16777216.0f;
+}
+
+static float rng_gauss(void)
+{
+    float u1 = rng_uniform();
+    float u2 = rng_uniform();
+    return sqrtf(-2.0f * logf(u1)) * cosf(2.0f * 3.14159265f * u2);
+}
+
+static void trace_point(trace_t trace, float t_s, float *x, float *y,
+                        float *vx, float *vy)
+{
+    switch (trace) {
+        case TRACE_DRAG:
+            *x = 100.0f + DRAG_SPEED_PX_S * t_s;
+            *y = 240.0f;
+            *vx = DRAG_SPEED_PX_S;
+            *vy = 0.0f;
+            break;
+        case TRACE_CIRCLE: {
+            float w = 2.0f * 3.14159265f * CIRCLE_HZ;
+            *x = 400.0f + CIRCLE_RADIUS_PX * cosf(w * t_s);
+            *y = 240.0f + CIRCLE_RADIUS_PX * sinf(w * t_s);
+            *vx = -CIRCLE_RADIUS_PX * w * sinf(w * t_s);
+            *vy =  CIRCLE_RADIUS_PX * w * cosf(w * t_s);
+            break;
+        }
+        case TRACE_REST:
+        default:
+            *x = 400.0f;
+            *y = 240.0f;
+            *vx = 0.0f;
+            *vy = 0.0f;
+            break;
+    }
+}
+
+/**
+ * Replay one trace. cfg = NULL measures the raw samples. The frame is on
+ * screen latency_ms after the sample was read.
+ */
+static result_t replay(trace_t trace, uint32_t duration_ms,
+                       const touch_filter_cfg_t *cfg, uint32_t latency_ms)
+{
+    static const touch_filter_cfg_t pass = { 1.0f, 0.0f, 1.0f, 0.0f, 0.0f };
+    touch_filter_t tf;
+    double err2 = 0.0;
+    double lag_ms = 0.0;
+    uint32_t n = 0;
+
+    touch_filter_init(&tf, (cfg != NULL) ? cfg : &pass);
+    rng_state = 0x12345678U;        /* Same noise for every run */
+
+    for (uint32_t t = 0; t <= duration_ms; t += SAMPLE_MS) {
+        float x, y, vx, vy;
+        trace_point(trace, (float)t / 1000.0f, &x, &y, &vx, &vy);
+
+        int32_t raw_x = (int32_t)lroundf(x + NOISE_PX * rng_gauss());
+        int32_t raw_y = (int32_t)lroundf(y + NOISE_PX * rng_gauss());
+        int32_t out_x = raw_x;
+        int32_t out_y = raw_y;
+        if (cfg != NULL) {
+            touch_filter_update(&tf, raw_x, raw_y, t, &out_x, &out_y);
+        }
+
+        if (t < SETTLE_MS) {
+            continue;
+        }
+
+        /* Finger position when the frame is on screen */
+        float sx, sy, svx, svy;
+        trace_point(trace, (float)(t + latency_ms) / 1000.0f,
+                    &sx, &sy, &svx, &svy);
+        float ex = sx - (float)out_x;
+        float ey = sy - (float)out_y;
+
+        err2 += (double)(ex * ex + ey * ey);
+        float speed = sqrtf(svx * svx + svy * svy);
+        if (speed > 0.0f) {
+            /* Error along the motion, in time */
+            lag_ms += 1000.0 * (double)((ex * svx + ey * svy) / speed) / (double)speed;
+        }
+        n++;
+    }
+
+    result_t r;
+    r.jitter_px = (float)sqrt(err2 / (double)n);
+    r.lag_ms = (float)(lag_ms / (double)n);
+    return r;
+}
+
+/*******************************************************************************
+ * Main
+ ******************************************************************************/
+static int failures = 0;
+
+static void expect(bool ok, const char *tuning, const char *what)
+{
+    if (!ok) {
+        printf("FAIL %s: %s\n", tuning, what);
+        failures++;
+    }
+}
+
+int main(void)
+{
+    printf("%-14s %-12s %10s %10s %12s\n", "tuning", "trace", "raw", "filter", "filter+pred");
+
+    for (size_t i = 0; i < sizeof(tunings) / sizeof(tunings[0]); i++) {
+        const tuning_t *tu = &tunings[i];
+        uint32_t latency_ms = (uint32_t)tu->cfg.predict_ms;
+        touch_filter_cfg_t no_pred = tu->cfg;
+        no_pred.predict_ms = 0.0f;
+
+        /* At rest: jitter (the shown point should stay still) */
+        result_t raw = replay(TRACE_REST, 2000U, NULL, latency_ms);
+        result_t flt = replay(TRACE_REST, 2000U, &tu->cfg, latency_ms);
+        printf("%-14s %-12s %8.2fpx %8.2fpx %10s\n", tu->name, "rest jitter",
+               raw.jitter_px, flt.jitter_px, "-");
+        expect(flt.jitter_px < 0.6f * raw.jitter_px, tu->name, "rest jitter above 60% of raw");
+
+        /* Moving: lag when the frame is on screen */
+        static const trace_t moving[] = { TRACE_DRAG, TRACE_CIRCLE };
+        static const char *const names[] = { "drag lag", "circle lag" };
+        for (size_t k = 0; k < 2U; k++) {
+            raw = replay(moving[k], 1000U, NULL, latency_ms);
+            result_t np = replay(moving[k], 1000U, &no_pred, latency_ms);
+            flt = replay(moving[k], 1000U, &tu->cfg, latency_ms);
+            printf("%-14s %-12s %8.1fms %8.1fms %10.1fms\n", tu->name, names[k],
+                   raw.lag_ms, np.lag_ms, flt.lag_ms);
+            expect(flt.lag_ms < np.lag_ms, tu->name, "prediction does not reduce the filter lag");
+            if (moving[k] == TRACE_DRAG) {
+                /* Straight line: prediction should catch up with the finger */
+                expect(flt.lag_ms < 0.5f * raw.lag_ms, tu->name, "drag lag above half of raw");
+            } else {
+                /* Curve: linear prediction overshoots the tangent, stay near raw */
+                expect(flt.lag_ms < 1.5f * raw.lag_ms, tu->name, "circle lag above 1.5x raw");
+            }
+        }
+    }
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("touch_filter: OK\n");
+    return 0;
+}